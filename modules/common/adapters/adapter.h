@@ -23,9 +23,7 @@
 
 #include <functional>
 #include <limits>
-#include <list>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -35,6 +33,7 @@
 #include "google/protobuf/message.h"
 
 #include "modules/common/adapters/adapter_gflags.h"
+#include "modules/common/adapters/snapshot_queue.h"
 #include "modules/common/proto/header.pb.h"
 #include "modules/common/time/time.h"
 #include "modules/common/util/file.h"
@@ -118,7 +117,8 @@ class AdapterBase {
  * \par
  * Under the hood, a queue is used to store the current and historical
  * messages. In most cases, the underlying data type is a proto, though
- * this is not necessary.
+ * this is not necessary. Observe() takes a snapshot of the queue in O(1),
+ * without blocking the thread receiving messages.
  *
  * \note
  * Adapter::Observe() is thread-safe, but calling it from
@@ -133,7 +133,7 @@ class Adapter : public AdapterBase {
   typedef D DataType;
   typedef boost::shared_ptr<D const> DataPtr;
 
-  typedef typename std::list<DataPtr>::const_iterator Iterator;
+  typedef typename SnapshotQueue<DataPtr>::Iterator Iterator;
   typedef typename std::function<void(const D&)> Callback;
 
   /**
@@ -150,6 +150,8 @@ class Adapter : public AdapterBase {
           size_t message_num, const std::string& dump_dir = "/tmp")
       : topic_name_(topic_name),
         message_num_(message_num),
+        data_queue_(message_num),
+        observed_queue_(data_queue_.GetSnapshot()),
         enable_dump_(FLAGS_enable_adapter_dump),
         dump_path_(dump_dir + "/" + adapter_name) {
     if (HasSequenceNumber<D>()) {
@@ -205,28 +207,23 @@ class Adapter : public AdapterBase {
   }
 
   /**
-   * @brief copy the data_queue_ into the observing queue to create a
-   * view of data up to the call time for the user.
+   * @brief take a snapshot of the data_queue_ as the observing queue to
+   * create a view of data up to the call time for the user.
    */
   void Observe() override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    observed_queue_ = data_queue_;
+    std::atomic_store(&observed_queue_, data_queue_.GetSnapshot());
   }
 
   /**
    * @brief returns TRUE if the observing queue is empty.
    */
-  bool Empty() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return observed_queue_.empty();
-  }
+  bool Empty() const override { return observed()->empty(); }
 
   /**
    * @brief returns TRUE if the adapter has received any message.
    */
   bool HasReceived() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return !data_queue_.empty();
+    return !data_queue_.GetSnapshot()->empty();
   }
 
   /**
@@ -237,12 +234,12 @@ class Adapter : public AdapterBase {
    * queue before calling GetLatestObserved().
    */
   const D& GetLatestObserved() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    DCHECK(!observed_queue_.empty())
+    const auto observed_queue = observed();
+    DCHECK(!observed_queue->empty())
         << "The view of data queue is empty. No data is received yet or you "
            "forgot to call Observe()"
         << ":" << topic_name_;
-    return *observed_queue_.front();
+    return *observed_queue->front();
   }
   /**
    * @brief returns the most recent message pointer in the observing queue.
@@ -252,12 +249,12 @@ class Adapter : public AdapterBase {
    * queue before calling GetLatestObservedPtr().
    */
   DataPtr GetLatestObservedPtr() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    DCHECK(!observed_queue_.empty())
+    const auto observed_queue = observed();
+    DCHECK(!observed_queue->empty())
         << "The view of data queue is empty. No data is received yet or you "
            "forgot to call Observe()"
         << ":" << topic_name_;
-    return observed_queue_.front();
+    return observed_queue->front();
   }
   /**
    * @brief returns the oldest message in the observing queue.
@@ -267,11 +264,11 @@ class Adapter : public AdapterBase {
    * queue before calling GetOldestObserved().
    */
   const D& GetOldestObserved() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    DCHECK(!observed_queue_.empty())
+    const auto observed_queue = observed();
+    DCHECK(!observed_queue->empty())
         << "The view of data queue is empty. No data is received yet or you "
            "forgot to call Observe().";
-    return *observed_queue_.back();
+    return *observed_queue->back();
   }
 
   /**
@@ -279,14 +276,25 @@ class Adapter : public AdapterBase {
    * queue. The caller can use it to iterate over the observed data
    * from the head. The API also supports range based for loop.
    */
-  Iterator begin() const { return observed_queue_.begin(); }
+  Iterator begin() const { return observed()->begin(); }
 
   /**
    * @brief returns an iterator representing the tail of the observing
    * queue. The caller can use it to iterate over the observed data
    * from the head. The API also supports range based for loop.
    */
-  Iterator end() const { return observed_queue_.end(); }
+  Iterator end() const { return observed()->end(); }
+
+  /**
+   * @brief returns the observing queue, i.e. the snapshot taken by the last
+   * call to Observe(). The snapshot and its iterators stay valid after
+   * later calls to Observe() or ClearData(), and all of them see the same
+   * data.
+   */
+  std::shared_ptr<const typename SnapshotQueue<DataPtr>::Snapshot> observed()
+      const {
+    return std::atomic_load(&observed_queue_);
+  }
 
   /**
    * @brief registers the provided callback function to the adapter,
@@ -347,10 +355,8 @@ class Adapter : public AdapterBase {
    * @brief Clear the data received so far.
    */
   void ClearData() override {
-    // Lock the queue.
-    std::lock_guard<std::mutex> lock(mutex_);
-    data_queue_.clear();
-    observed_queue_.clear();
+    data_queue_.Clear();
+    Observe();
   }
 
   /**
@@ -504,12 +510,7 @@ class Adapter : public AdapterBase {
       return;
     }
 
-    // Lock the queue.
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (data_queue_.size() + 1 > message_num_) {
-      data_queue_.pop_back();
-    }
-    data_queue_.push_front(data);
+    data_queue_.PushFront(std::move(data));
   }
 
   /// The topic name that the adapter listens to.
@@ -519,18 +520,16 @@ class Adapter : public AdapterBase {
   size_t message_num_ = 0;
 
   /// The received data. Its size is no more than message_num_
-  std::list<DataPtr> data_queue_;
+  SnapshotQueue<DataPtr> data_queue_;
 
   /// It is the snapshot of the data queue. The snapshot is taken when
   /// Observe() is called.
-  std::list<DataPtr> observed_queue_;
+  std::shared_ptr<const typename SnapshotQueue<DataPtr>::Snapshot>
+      observed_queue_;
 
   /// User defined function when receiving a message
   std::vector<Callback> receive_callbacks_;
 
-  /// The mutex guarding data_queue_ and observed_queue_
-  mutable std::mutex mutex_;
-
   /// Whether dumping is enabled.
   bool enable_dump_ = false;
 
@@ -125,6 +125,59 @@ TEST(AdapterTest, History) {
   }
 }
 
+TEST(AdapterTest, ObserveWhileIterating) {
+  IntegerAdapter adapter("Integer", "integer_topic", 3);
+  adapter.OnReceive(1);
+  adapter.OnReceive(2);
+  adapter.Observe();
+
+  std::vector<int> history;
+  for (const auto& data : adapter) {
+    // A new observation does not change the snapshot being iterated.
+    adapter.OnReceive(3);
+    adapter.OnReceive(4);
+    adapter.Observe();
+    history.push_back(*data);
+  }
+  EXPECT_EQ(std::vector<int>({2, 1}), history);
+  EXPECT_EQ(4, adapter.GetLatestObserved());
+}
+
+TEST(AdapterTest, ObserveBetweenBeginAndEnd) {
+  IntegerAdapter adapter("Integer", "integer_topic", 3);
+  adapter.OnReceive(1);
+  adapter.OnReceive(2);
+  adapter.Observe();
+
+  // begin() and end() taken around an Observe() still bound the loop.
+  std::vector<int> history;
+  auto iter = adapter.begin();
+  adapter.OnReceive(3);
+  adapter.Observe();
+  for (; iter != adapter.end(); ++iter) {
+    history.push_back(**iter);
+  }
+  EXPECT_EQ(std::vector<int>({2, 1}), history);
+}
+
+TEST(AdapterTest, ClearData) {
+  IntegerAdapter adapter("Integer", "integer_topic", 3);
+  adapter.OnReceive(1);
+  adapter.Observe();
+  EXPECT_TRUE(adapter.HasReceived());
+  EXPECT_FALSE(adapter.Empty());
+
+  adapter.ClearData();
+  EXPECT_FALSE(adapter.HasReceived());
+  EXPECT_TRUE(adapter.Empty());
+  EXPECT_EQ(adapter.begin(), adapter.end());
+
+  adapter.OnReceive(2);
+  adapter.Observe();
+  EXPECT_EQ(2, adapter.GetLatestObserved());
+  EXPECT_EQ(2, adapter.GetOldestObserved());
+}
+
 TEST(AdapterTest, Callback) {
   IntegerAdapter adapter("Integer", "integer_topic", 3);
 
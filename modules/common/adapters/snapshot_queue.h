@@ -0,0 +1,242 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ */
+
+#ifndef MODULES_COMMON_ADAPTERS_SNAPSHOT_QUEUE_H_
+#define MODULES_COMMON_ADAPTERS_SNAPSHOT_QUEUE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace apollo::common::adapter
+ * @brief apollo::common::adapter
+ */
+namespace apollo {
+namespace common {
+namespace adapter {
+
+/**
+ * @class SnapshotQueue
+ * @brief A bounded queue of the latest values, newest first, of which
+ * immutable snapshots are taken in O(1).
+ *
+ * \par
+ * Values are appended to fixed size segments, and a slot is never written
+ * again once it has been published. A snapshot is the last two segments
+ * and how many values they hold, so it stays valid while newer values are
+ * pushed. Taking a snapshot only copies the shared_ptr to the latest one,
+ * and never waits for a push to finish copying values.
+ *
+ * \note
+ * This is not lock-free: pushes are serialized by a mutex, and the
+ * std::atomic_load/atomic_store on the latest snapshot pointer are
+ * implemented with a small pool of mutexes in libstdc++. A segment is
+ * freed once no snapshot refers to it, so up to twice the capacity of
+ * values may be kept alive.
+ */
+template <typename T>
+class SnapshotQueue {
+ private:
+  struct Segment {
+    explicit Segment(const size_t capacity) : slots(capacity) {}
+    std::vector<T> slots;
+  };
+
+ public:
+  class Snapshot;
+
+  /**
+   * @class Iterator
+   * @brief Iterates over a snapshot from the newest value to the oldest.
+   * The iterator shares the ownership of its snapshot, so it stays valid
+   * after the snapshot is replaced by a newer one. All past-the-end
+   * iterators compare equal, so a loop from begin() of one snapshot to
+   * end() of a newer one still stops at the end of the first.
+   */
+  class Iterator {
+   public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    Iterator() = default;
+    Iterator(std::shared_ptr<const Snapshot> snapshot, const size_t index)
+        : snapshot_(std::move(snapshot)), index_(index) {}
+
+    reference operator*() const { return (*snapshot_)[index_]; }
+    pointer operator->() const { return &(*snapshot_)[index_]; }
+
+    Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator iter = *this;
+      ++index_;
+      return iter;
+    }
+    Iterator& operator--() {
+      --index_;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator iter = *this;
+      --index_;
+      return iter;
+    }
+
+    bool operator==(const Iterator& other) const {
+      if (AtEnd() && other.AtEnd()) {
+        return true;
+      }
+      return snapshot_.get() == other.snapshot_.get() &&
+             index_ == other.index_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    bool AtEnd() const {
+      return snapshot_ == nullptr || index_ >= snapshot_->size();
+    }
+
+    std::shared_ptr<const Snapshot> snapshot_;
+    size_t index_ = 0;
+  };
+
+  /**
+   * @class Snapshot
+   * @brief The values of the queue at the time the snapshot is taken.
+   * Snapshots are only created through std::make_shared, so that iterators
+   * can share their ownership.
+   */
+  class Snapshot : public std::enable_shared_from_this<Snapshot> {
+   public:
+    Snapshot() = default;
+    Snapshot(std::shared_ptr<const Segment> current,
+             std::shared_ptr<const Segment> previous,
+             const size_t current_size, const size_t size)
+        : current_(std::move(current)),
+          previous_(std::move(previous)),
+          current_size_(current_size),
+          size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief returns the index-th newest value.
+     */
+    const T& operator[](const size_t index) const {
+      if (index < current_size_) {
+        return current_->slots[current_size_ - 1 - index];
+      }
+      return previous_->slots[previous_->slots.size() - 1 -
+                              (index - current_size_)];
+    }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    Iterator begin() const { return Iterator(this->shared_from_this(), 0); }
+    Iterator end() const { return Iterator(this->shared_from_this(), size_); }
+
+   private:
+    std::shared_ptr<const Segment> current_;
+    std::shared_ptr<const Segment> previous_;
+    size_t current_size_ = 0;
+    size_t size_ = 0;
+  };
+
+  /**
+   * @brief Construct the \class SnapshotQueue object.
+   * @param capacity the maximum number of values in a snapshot.
+   */
+  explicit SnapshotQueue(const size_t capacity)
+      : capacity_(capacity), latest_(std::make_shared<const Snapshot>()) {}
+
+  size_t capacity() const { return capacity_; }
+
+  /**
+   * @brief pushes a value as the newest one, and drops the oldest value if
+   * the queue is full.
+   */
+  void PushFront(T value) {
+    if (capacity_ == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (current_ == nullptr || current_size_ == capacity_) {
+      previous_ = std::move(current_);
+      current_ = std::make_shared<Segment>(capacity_);
+      current_size_ = 0;
+    }
+    current_->slots[current_size_++] = std::move(value);
+    size_ = std::min(size_ + 1, capacity_);
+    std::atomic_store(&latest_,
+                      std::make_shared<const Snapshot>(
+                          current_, previous_, current_size_, size_));
+  }
+
+  /**
+   * @brief removes all the values. Snapshots taken before are not changed.
+   */
+  void Clear() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    current_.reset();
+    previous_.reset();
+    current_size_ = 0;
+    size_ = 0;
+    std::atomic_store(&latest_, std::make_shared<const Snapshot>());
+  }
+
+  /**
+   * @brief returns a snapshot of the values pushed so far.
+   */
+  std::shared_ptr<const Snapshot> GetSnapshot() const {
+    return std::atomic_load(&latest_);
+  }
+
+ private:
+  const size_t capacity_;
+
+  /// The mutex serializing PushFront() and Clear().
+  std::mutex write_mutex_;
+
+  /// The segment being filled, and the one filled before it.
+  std::shared_ptr<Segment> current_;
+  std::shared_ptr<Segment> previous_;
+  size_t current_size_ = 0;
+  size_t size_ = 0;
+
+  /// The snapshot published by the last update.
+  std::shared_ptr<const Snapshot> latest_;
+};
+
+}  // namespace adapter
+}  // namespace common
+}  // namespace apollo
+
+#endif  // MODULES_COMMON_ADAPTERS_SNAPSHOT_QUEUE_H_
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/adapters/snapshot_queue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace adapter {
+
+using IntegerQueue = SnapshotQueue<int>;
+
+std::vector<int> ToVector(const IntegerQueue::Snapshot &snapshot) {
+  return std::vector<int>(snapshot.begin(), snapshot.end());
+}
+
+TEST(SnapshotQueueTest, Empty) {
+  IntegerQueue queue(3);
+  EXPECT_EQ(3, queue.capacity());
+  const auto snapshot = queue.GetSnapshot();
+  EXPECT_TRUE(snapshot->empty());
+  EXPECT_EQ(0, snapshot->size());
+  EXPECT_EQ(snapshot->begin(), snapshot->end());
+}
+
+TEST(SnapshotQueueTest, ZeroCapacity) {
+  IntegerQueue queue(0);
+  queue.PushFront(1);
+  EXPECT_TRUE(queue.GetSnapshot()->empty());
+}
+
+TEST(SnapshotQueueTest, NewestFirst) {
+  IntegerQueue queue(3);
+  for (int i = 1; i <= 10; ++i) {
+    queue.PushFront(i);
+    const auto snapshot = queue.GetSnapshot();
+    EXPECT_EQ(std::min(i, 3), snapshot->size());
+    EXPECT_EQ(i, snapshot->front());
+    EXPECT_EQ(std::max(1, i - 2), snapshot->back());
+    for (size_t k = 0; k < snapshot->size(); ++k) {
+      EXPECT_EQ(i - static_cast<int>(k), (*snapshot)[k]);
+    }
+  }
+}
+
+TEST(SnapshotQueueTest, SnapshotIsStable) {
+  IntegerQueue queue(3);
+  queue.PushFront(1);
+  queue.PushFront(2);
+  const auto snapshot = queue.GetSnapshot();
+  for (int i = 3; i <= 10; ++i) {
+    queue.PushFront(i);
+  }
+  EXPECT_EQ(std::vector<int>({2, 1}), ToVector(*snapshot));
+  EXPECT_EQ(std::vector<int>({10, 9, 8}), ToVector(*queue.GetSnapshot()));
+
+  queue.Clear();
+  EXPECT_TRUE(queue.GetSnapshot()->empty());
+  EXPECT_EQ(std::vector<int>({2, 1}), ToVector(*snapshot));
+}
+
+TEST(SnapshotQueueTest, Iterator) {
+  IntegerQueue queue(4);
+  for (int i = 1; i <= 6; ++i) {
+    queue.PushFront(i);
+  }
+  const auto snapshot = queue.GetSnapshot();
+  auto iter = snapshot->end();
+  --iter;
+  EXPECT_EQ(3, *iter);
+  iter--;
+  EXPECT_EQ(4, *iter);
+  EXPECT_EQ(4, *iter++);
+  EXPECT_EQ(3, *iter);
+}
+
+TEST(SnapshotQueueTest, IteratorOwnsSnapshot) {
+  IntegerQueue queue(2);
+  queue.PushFront(1);
+  queue.PushFront(2);
+  // The temporary snapshot is only owned by the iterator.
+  auto iter = queue.GetSnapshot()->begin();
+  for (int i = 3; i <= 10; ++i) {
+    queue.PushFront(i);
+  }
+  queue.Clear();
+  EXPECT_EQ(2, *iter++);
+  EXPECT_EQ(1, *iter);
+}
+
+TEST(SnapshotQueueTest, EndOfAnotherSnapshot) {
+  IntegerQueue queue(3);
+  queue.PushFront(1);
+  queue.PushFront(2);
+  const auto snapshot = queue.GetSnapshot();
+  queue.PushFront(3);
+  // A loop to the end of a newer snapshot stops at the end of its own.
+  std::vector<int> values;
+  for (auto iter = snapshot->begin(); iter != queue.GetSnapshot()->end();
+       ++iter) {
+    values.push_back(*iter);
+  }
+  EXPECT_EQ(std::vector<int>({2, 1}), values);
+  EXPECT_NE(snapshot->begin(), queue.GetSnapshot()->begin());
+  EXPECT_EQ(IntegerQueue::Iterator(), snapshot->end());
+}
+
+TEST(SnapshotQueueTest, ConcurrentReaders) {
+  constexpr int kNumValues = 100000;
+  constexpr size_t kCapacity = 7;
+  IntegerQueue queue(kCapacity);
+  std::atomic<bool> done(false);
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r) {
+    readers.emplace_back([&queue, &done]() {
+      while (!done) {
+        // Each snapshot holds consecutive values, newest first.
+        const auto snapshot = queue.GetSnapshot();
+        ASSERT_LE(snapshot->size(), queue.capacity());
+        int expected = snapshot->empty() ? 0 : snapshot->front();
+        for (const int value : *snapshot) {
+          ASSERT_EQ(expected--, value);
+        }
+      }
+    });
+  }
+  for (int i = 1; i <= kNumValues; ++i) {
+    queue.PushFront(i);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(kNumValues, queue.GetSnapshot()->front());
+}
+
+}  // namespace adapter
+}  // namespace common
+}  // namespace apollo
@@ -25,6 +25,22 @@ DEFINE_string(test_base_map_filename, "",
 
 DEFINE_string(base_map_filename, "base_map.bin|base_map.xml|base_map.txt",
               "Base map files in the map_dir, search in order.");
+DEFINE_string(base_map_kdtree_cache_filename, "base_map.kdtree",
+              "KD-tree cache of the base map in the map_dir. If it exists and "
+              "is built from the current base map file, HDMapUtil adopts its "
+              "kdtrees instead of building them. The base map file is still "
+              "parsed. Regenerate it with map_kdtree_cache_generator after "
+              "map changes.");
+DEFINE_string(base_map_tile_dirname, "",
+              "If not empty, HDMapUtil serves the base map from the tiles in "
+              "this directory of the map_dir, generated by "
+              "map_tile_generator. Only the tiles around the ego vehicle are "
+              "loaded, and the tiles along the routing are prefetched.");
+DEFINE_double(base_map_tile_active_radius, 500.0,
+              "Tiles of the base map within this distance to the ego vehicle "
+              "are loaded, in meters.");
+DEFINE_int32(base_map_tile_cache_mb, 512,
+             "Memory budget of the loaded base map tiles, in MB.");
 DEFINE_string(sim_map_filename, "sim_map.bin|sim_map.txt",
               "Simulation map files in the map_dir, search in order.");
 DEFINE_string(routing_map_filename, "routing_map.bin|routing_map.txt",
@@ -26,6 +26,10 @@ DECLARE_int32(local_utm_zone_id);
 
 DECLARE_string(test_base_map_filename);
 DECLARE_string(base_map_filename);
+DECLARE_string(base_map_kdtree_cache_filename);
+DECLARE_string(base_map_tile_dirname);
+DECLARE_double(base_map_tile_active_radius);
+DECLARE_int32(base_map_tile_cache_mb);
 DECLARE_string(sim_map_filename);
 DECLARE_string(routing_map_filename);
 DECLARE_string(end_way_point_filename);
@@ -18,11 +18,20 @@
 #include <leveldb/env.h>
 #include <leveldb/options.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 #include "gflags/gflags.h"
 #include "modules/common/util/file.h"
 #include "modules/common/util/util.h"
 
 DEFINE_string(kv_db_path, "/apollo/data/kv_db", "Path to param DB file.");
+DEFINE_int32(kv_db_idle_close_ms, 1000,
+             "Close the KV DB after it has been idle for this long, so that "
+             "other processes can open it. 0 closes it after every operation.");
 
 namespace apollo {
 namespace common {
@@ -50,61 +59,318 @@ leveldb::Options DBOptions() {
   return options;
 }
 
-}  // namespace
+/**
+ * The DB handle of the process, shared by all the operations until it is
+ * idle, and the updates waiting to be written behind. The handle counts its
+ * users, and is closed only when none is left, so the process never holds the
+ * DB lock twice.
+ */
+class KVDBHandle {
+ public:
+  static KVDBHandle *Instance() {
+    static KVDBHandle instance;
+    return &instance;
+  }
 
-std::unique_ptr<leveldb::DB> KVDB::GetDB() {
-  if (!apollo::common::util::EnsureDirectory(FLAGS_kv_db_path)) {
-    AERROR << "Cannot create KV DB directory: " << FLAGS_kv_db_path;
-    return nullptr;
+  ~KVDBHandle() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+    // The worker has written the updates pending when it stopped, but not
+    // the ones made since.
+    if (!WritePending()) {
+      AERROR << "Failed to write the KV DB updates pending on exit.";
+    }
   }
 
-  static const auto options = DBOptions();
-  leveldb::DB *db = nullptr;
-  const auto status = leveldb::DB::Open(options, FLAGS_kv_db_path, &db);
-  if (!status.ok()) {
-    AERROR << "Unable to open DB path " << FLAGS_kv_db_path << ": "
-           << status.ToString();
-    return nullptr;
+  // Gets the DB, opening it if needed. The DB stays open while the returned
+  // pointer is in use, and until it has been idle for
+  // FLAGS_kv_db_idle_close_ms. Once the handle is stopped, the DB stays open
+  // until the handle is destroyed.
+  std::shared_ptr<leveldb::DB> GetDB() {
+    std::lock_guard<std::mutex> open_lock(open_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (db_ == nullptr) {
+      // Another process may hold the DB, so do not block the pending
+      // updates meanwhile.
+      lock.unlock();
+      auto db = OpenDB();
+      lock.lock();
+      if (db == nullptr) {
+        return nullptr;
+      }
+      db_ = std::move(db);
+      if (FLAGS_kv_db_idle_close_ms > 0) {
+        StartWorker();
+        cv_.notify_all();
+      }
+    }
+    ++num_users_;
+    last_used_time_ = Clock::now();
+    return std::shared_ptr<leveldb::DB>(db_.get(),
+                                        [this](leveldb::DB *) { Release(); });
   }
 
-  return std::unique_ptr<leveldb::DB>(db);
-}
+  // Writes a batch of updates, which replace the pending ones of its keys.
+  bool Write(leveldb::WriteBatch *batch, const std::vector<std::string> &keys,
+             const bool sync) {
+    std::lock_guard<std::mutex> write_lock(write_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto &key : keys) {
+        pending_updates_.erase(key);
+      }
+    }
+    return WriteToDB(batch, sync);
+  }
 
-bool KVDB::Put(const std::string &key, const std::string &value,
-               const bool sync) {
-  auto db = GetDB();
-  if (db == nullptr) {
+  void WriteAsync(const std::string &key, const std::string &value,
+                  const bool is_delete) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto &update = pending_updates_[key];
+      update.value = value;
+      update.is_delete = is_delete;
+      StartWorker();
+    }
+    cv_.notify_all();
+  }
+
+  // Writes the pending updates in one batch.
+  bool WritePending() {
+    std::lock_guard<std::mutex> write_lock(write_mutex_);
+    leveldb::WriteBatch batch;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_updates_.empty()) {
+        return true;
+      }
+      writing_updates_.swap(pending_updates_);
+      for (const auto &update : writing_updates_) {
+        if (update.second.is_delete) {
+          batch.Delete(update.first);
+        } else {
+          batch.Put(update.first, update.second.value);
+        }
+      }
+    }
+    const bool success = WriteToDB(&batch, false);
+    std::lock_guard<std::mutex> lock(mutex_);
+    writing_updates_.clear();
+    return success;
+  }
+
+  // Looks up a key in the updates not written yet.
+  bool GetPending(const std::string &key, std::string *value,
+                  bool *is_delete) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto *updates : {&pending_updates_, &writing_updates_}) {
+      const auto iter = updates->find(key);
+      if (iter != updates->end()) {
+        *value = iter->second.value;
+        *is_delete = iter->second.is_delete;
+        return true;
+      }
+    }
     return false;
   }
 
-  leveldb::WriteOptions options;
-  options.sync = sync;
-  const auto status = db->Put(options, key, value);
-  AERROR_IF(!status.ok()) << status.ToString();
-  return status.ok();
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Update {
+    std::string value;
+    bool is_delete = false;
+  };
+
+  KVDBHandle() : options_(DBOptions()) {}
+
+  std::unique_ptr<leveldb::DB> OpenDB() const {
+    if (!apollo::common::util::EnsureDirectory(FLAGS_kv_db_path)) {
+      AERROR << "Cannot create KV DB directory: " << FLAGS_kv_db_path;
+      return nullptr;
+    }
+
+    leveldb::DB *db = nullptr;
+    const auto status = leveldb::DB::Open(options_, FLAGS_kv_db_path, &db);
+    if (!status.ok()) {
+      AERROR << "Unable to open DB path " << FLAGS_kv_db_path << ": "
+             << status.ToString();
+      return nullptr;
+    }
+    return std::unique_ptr<leveldb::DB>(db);
+  }
+
+  // Called when a user of the DB is done with it.
+  void Release() {
+    const bool close_on_release = FLAGS_kv_db_idle_close_ms <= 0;
+    std::unique_lock<std::mutex> open_lock(open_mutex_, std::defer_lock);
+    if (close_on_release) {
+      open_lock.lock();
+    }
+    std::unique_ptr<leveldb::DB> db;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --num_users_;
+      last_used_time_ = Clock::now();
+      if (num_users_ > 0) {
+        return;
+      }
+      if (close_on_release) {
+        db = std::move(db_);
+      }
+    }
+    cv_.notify_all();
+  }
+
+  bool WriteToDB(leveldb::WriteBatch *batch, const bool sync) {
+    auto db = GetDB();
+    if (db == nullptr) {
+      return false;
+    }
+    leveldb::WriteOptions options;
+    options.sync = sync;
+    const auto status = db->Write(options, batch);
+    AERROR_IF(!status.ok()) << status.ToString();
+    return status.ok();
+  }
+
+  // Must be called with mutex_ held.
+  void StartWorker() {
+    if (!worker_.joinable() && !stop_) {
+      worker_ = std::thread(&KVDBHandle::Run, this);
+    }
+  }
+
+  // Writes the pending updates behind, and closes the DB once it is idle.
+  // The updates still pending when the handle is stopped are written before
+  // the worker returns, opening the DB again if it has been closed.
+  void Run() {
+    const auto idle_close_time =
+        std::chrono::milliseconds(FLAGS_kv_db_idle_close_ms);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (!pending_updates_.empty()) {
+        lock.unlock();
+        WritePending();
+        lock.lock();
+        continue;
+      }
+      if (stop_) {
+        break;
+      }
+      if (db_ == nullptr || num_users_ > 0) {
+        cv_.wait(lock);
+        continue;
+      }
+      const auto close_time = last_used_time_ + idle_close_time;
+      if (Clock::now() < close_time) {
+        cv_.wait_until(lock, close_time);
+        continue;
+      }
+      // Close the DB outside mutex_, but with open_mutex_ held, so that it
+      // is not opened again before it is closed.
+      lock.unlock();
+      std::lock_guard<std::mutex> open_lock(open_mutex_);
+      lock.lock();
+      if (num_users_ == 0 &&
+          Clock::now() >= last_used_time_ + idle_close_time) {
+        auto db = std::move(db_);
+        lock.unlock();
+        db.reset();
+        lock.lock();
+      }
+    }
+  }
+
+  // Owned by the handle, so that the DB can still be opened by the
+  // destructor of the handle.
+  const leveldb::Options options_;
+  // Serializes the writes, so that the updates of a key are applied in the
+  // order they are made.
+  std::mutex write_mutex_;
+  // Serializes opening and closing the DB, and is locked before mutex_.
+  std::mutex open_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unique_ptr<leveldb::DB> db_;
+  int num_users_ = 0;
+  Clock::time_point last_used_time_;
+  std::unordered_map<std::string, Update> pending_updates_;
+  std::unordered_map<std::string, Update> writing_updates_;
+  std::thread worker_;
+  bool stop_ = false;
+};
+
+}  // namespace
+
+void KVDB::WriteBatch::Put(const std::string &key, const std::string &value) {
+  batch_.Put(key, value);
+  keys_.push_back(key);
+}
+
+void KVDB::WriteBatch::Delete(const std::string &key) {
+  batch_.Delete(key);
+  keys_.push_back(key);
+}
+
+void KVDB::WriteBatch::Clear() {
+  batch_.Clear();
+  keys_.clear();
+}
+
+bool KVDB::Write(leveldb::WriteBatch *batch,
+                 const std::vector<std::string> &keys, const bool sync) {
+  return KVDBHandle::Instance()->Write(batch, keys, sync);
+}
+
+bool KVDB::Put(const std::string &key, const std::string &value,
+               const bool sync) {
+  leveldb::WriteBatch batch;
+  batch.Put(key, value);
+  return Write(&batch, {key}, sync);
 }
 
 bool KVDB::Delete(const std::string &key, const bool sync) {
-  auto db = GetDB();
-  if (db == nullptr) {
-    return false;
-  }
+  leveldb::WriteBatch batch;
+  batch.Delete(key);
+  return Write(&batch, {key}, sync);
+}
 
-  leveldb::WriteOptions options;
-  options.sync = sync;
-  const auto status = db->Delete(options, key);
-  AERROR_IF(!status.ok()) << status.ToString();
-  return status.ok();
+bool KVDB::Write(const WriteBatch &batch, const bool sync) {
+  // leveldb takes a mutable batch, but does not change it.
+  leveldb::WriteBatch updates = batch.batch_;
+  return Write(&updates, batch.keys_, sync);
+}
+
+void KVDB::PutAsync(const std::string &key, const std::string &value) {
+  KVDBHandle::Instance()->WriteAsync(key, value, false);
+}
+
+void KVDB::DeleteAsync(const std::string &key) {
+  KVDBHandle::Instance()->WriteAsync(key, "", true);
 }
 
+bool KVDB::Flush() { return KVDBHandle::Instance()->WritePending(); }
+
 bool KVDB::Has(const std::string &key) {
-  auto db = GetDB();
+  std::string value;
+  bool is_delete = false;
+  if (KVDBHandle::Instance()->GetPending(key, &value, &is_delete)) {
+    return !is_delete;
+  }
+
+  auto db = KVDBHandle::Instance()->GetDB();
   if (db == nullptr) {
     return false;
   }
 
   static leveldb::ReadOptions options;
-  std::string value;
   const auto status = db->Get(options, key, &value);
   // Log error except IsNotFound.
   AERROR_IF(!status.ok() && !status.IsNotFound()) << status.ToString();
@@ -113,13 +379,18 @@ bool KVDB::Has(const std::string &key) {
 
 std::string KVDB::Get(const std::string &key,
                       const std::string &default_value) {
-  auto db = GetDB();
+  std::string value;
+  bool is_delete = false;
+  if (KVDBHandle::Instance()->GetPending(key, &value, &is_delete)) {
+    return is_delete ? default_value : value;
+  }
+
+  auto db = KVDBHandle::Instance()->GetDB();
   if (db == nullptr) {
     return default_value;
   }
 
   static leveldb::ReadOptions options;
-  std::string value;
   const auto status = db->Get(options, key, &value);
   // Log error except IsNotFound.
   AERROR_IF(!status.ok() && !status.IsNotFound()) << status.ToString();
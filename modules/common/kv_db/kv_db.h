@@ -18,8 +18,10 @@
 #define MODULES_COMMON_KV_DB_KV_DB_H_
 
 #include <leveldb/db.h>
+#include <leveldb/write_batch.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 /**
  * @namespace apollo::common
@@ -33,9 +35,28 @@ namespace common {
  *
  * @brief Lightweight key-value database to store system-wide parameters.
  *        We prefer keys like "apollo:data:commit_id".
+ *        The DB is shared by processes, so a process keeps it open only while
+ *        it is in use, see FLAGS_kv_db_idle_close_ms.
  */
 class KVDB {
  public:
+  /**
+   * @class WriteBatch
+   * @brief Updates of several keys, which are applied atomically by
+   *        KVDB::Write().
+   */
+  class WriteBatch {
+   public:
+    void Put(const std::string &key, const std::string &value);
+    void Delete(const std::string &key);
+    void Clear();
+
+   private:
+    friend class KVDB;
+    leveldb::WriteBatch batch_;
+    std::vector<std::string> keys_;
+  };
+
   /**
    * @brief Store {key, value} to DB.
    * @param sync Whether flush right after writing.
@@ -52,13 +73,39 @@ class KVDB {
   static bool Delete(const std::string &key,
                      const bool sync = false);
 
+  /**
+   * @brief Apply all the updates of a batch, or none of them.
+   * @param sync Whether flush right after writing.
+   * @return Success or not.
+   */
+  static bool Write(const WriteBatch &batch, const bool sync = false);
+
+  /**
+   * @brief Store {key, value} to DB in the background, for keys which may be
+   *        lost on a crash. Get() and Has() of this process see the value
+   *        right away, and pending updates of the same key are merged.
+   */
+  static void PutAsync(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Delete a key in the background, see PutAsync().
+   */
+  static void DeleteAsync(const std::string &key);
+
+  /**
+   * @brief Write the pending asynchronous updates.
+   * @return Success or not.
+   */
+  static bool Flush();
+
   static bool Has(const std::string &key);
 
   static std::string Get(const std::string &key,
                          const std::string &default_value = "");
 
  private:
-  static std::unique_ptr<leveldb::DB> GetDB();
+  static bool Write(leveldb::WriteBatch *batch,
+                    const std::vector<std::string> &keys, const bool sync);
 };
 
 }  // namespace common
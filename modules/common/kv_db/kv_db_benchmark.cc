@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Compares KVDB operations when the DB is opened for every operation
+ *        (Arg 0) with a DB kept open while it is in use (Arg 1000).
+ */
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "modules/common/kv_db/kv_db.h"
+#include "modules/common/log.h"
+
+DECLARE_string(kv_db_path);
+DECLARE_int32(kv_db_idle_close_ms);
+
+namespace apollo {
+namespace common {
+namespace {
+
+constexpr int kNumKeys = 100;
+
+std::string Key(const int i) {
+  return "apollo:benchmark:key_" + std::to_string(i);
+}
+
+void SetUp(const benchmark::State &state) {
+  FLAGS_kv_db_path = "/tmp/kv_db_benchmark";
+  FLAGS_kv_db_idle_close_ms = state.range(0);
+}
+
+void BM_Put(benchmark::State &state) {  // NOLINT
+  SetUp(state);
+  int i = 0;
+  while (state.KeepRunning()) {
+    CHECK(KVDB::Put(Key(i++ % kNumKeys), "value"));
+  }
+}
+
+void BM_Get(benchmark::State &state) {  // NOLINT
+  SetUp(state);
+  for (int i = 0; i < kNumKeys; ++i) {
+    CHECK(KVDB::Put(Key(i), "value"));
+  }
+  int i = 0;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(KVDB::Get(Key(i++ % kNumKeys)));
+  }
+}
+
+// Writes kNumKeys keys at once, compared to kNumKeys Put() in BM_Put.
+void BM_WriteBatch(benchmark::State &state) {  // NOLINT
+  SetUp(state);
+  while (state.KeepRunning()) {
+    KVDB::WriteBatch batch;
+    for (int i = 0; i < kNumKeys; ++i) {
+      batch.Put(Key(i), "value");
+    }
+    CHECK(KVDB::Write(batch));
+  }
+  state.SetItemsProcessed(state.iterations() * kNumKeys);
+}
+
+void BM_PutAsync(benchmark::State &state) {  // NOLINT
+  SetUp(state);
+  int i = 0;
+  while (state.KeepRunning()) {
+    KVDB::PutAsync(Key(i++ % kNumKeys), "value");
+  }
+  CHECK(KVDB::Flush());
+}
+
+BENCHMARK(BM_Put)->Arg(0)->Arg(1000);
+BENCHMARK(BM_Get)->Arg(0)->Arg(1000);
+BENCHMARK(BM_WriteBatch)->Arg(0)->Arg(1000);
+BENCHMARK(BM_PutAsync)->Arg(0)->Arg(1000);
+
+}  // namespace
+}  // namespace common
+}  // namespace apollo
+
+BENCHMARK_MAIN();
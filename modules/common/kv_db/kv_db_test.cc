@@ -15,12 +15,28 @@
  *****************************************************************************/
 #include "modules/common/kv_db/kv_db.h"
 
+#include <chrono>
+#include <cstdlib>
+#include <string>
 #include <thread>
 
+#include "gflags/gflags.h"
 #include "gtest/gtest.h"
 
+DECLARE_int32(kv_db_idle_close_ms);
+
 namespace apollo {
 namespace common {
+namespace {
+
+// The DB handle is shared by all the tests, and its worker reads the flag, so
+// it is set before the first test opens the DB.
+const bool kIdleCloseSet = []() {
+  FLAGS_kv_db_idle_close_ms = 1;
+  return true;
+}();
+
+}  // namespace
 
 TEST(KVDBTest, CRUD) {
   EXPECT_TRUE(KVDB::Delete("test_key"));
@@ -46,6 +62,67 @@ TEST(KVDBTest, GetDefault) {
   EXPECT_EQ("default", KVDB::Get("test_key", "default"));
 }
 
+TEST(KVDBTest, WriteBatch) {
+  EXPECT_TRUE(KVDB::Put("test_key", "val0"));
+
+  KVDB::WriteBatch batch;
+  batch.Put("test_key_0", "val0");
+  batch.Put("test_key_1", "val1");
+  batch.Delete("test_key");
+  EXPECT_FALSE(KVDB::Has("test_key_0"));
+  EXPECT_TRUE(KVDB::Write(batch));
+  EXPECT_EQ("val0", KVDB::Get("test_key_0"));
+  EXPECT_EQ("val1", KVDB::Get("test_key_1"));
+  EXPECT_FALSE(KVDB::Has("test_key"));
+
+  batch.Clear();
+  batch.Delete("test_key_0");
+  batch.Delete("test_key_1");
+  EXPECT_TRUE(KVDB::Write(batch, true));
+  EXPECT_FALSE(KVDB::Has("test_key_0"));
+  EXPECT_FALSE(KVDB::Has("test_key_1"));
+}
+
+TEST(KVDBTest, Async) {
+  EXPECT_TRUE(KVDB::Delete("test_key"));
+
+  // Pending updates are visible right away.
+  KVDB::PutAsync("test_key", "val0");
+  KVDB::PutAsync("test_key", "val1");
+  EXPECT_TRUE(KVDB::Has("test_key"));
+  EXPECT_EQ("val1", KVDB::Get("test_key"));
+  EXPECT_TRUE(KVDB::Flush());
+  EXPECT_EQ("val1", KVDB::Get("test_key"));
+
+  KVDB::DeleteAsync("test_key");
+  EXPECT_FALSE(KVDB::Has("test_key"));
+  EXPECT_EQ("default", KVDB::Get("test_key", "default"));
+  EXPECT_TRUE(KVDB::Flush());
+  EXPECT_FALSE(KVDB::Has("test_key"));
+
+  // A later synchronous update wins over a pending one.
+  KVDB::PutAsync("test_key", "val0");
+  EXPECT_TRUE(KVDB::Put("test_key", "val1"));
+  EXPECT_TRUE(KVDB::Flush());
+  EXPECT_EQ("val1", KVDB::Get("test_key"));
+  EXPECT_TRUE(KVDB::Delete("test_key"));
+}
+
+TEST(KVDBTest, AsyncOnExit) {
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  EXPECT_TRUE(KVDB::Delete("test_key"));
+
+  // The updates still pending on exit are written.
+  EXPECT_EXIT(
+      {
+        KVDB::PutAsync("test_key", "val0");
+        std::exit(0);
+      },
+      ::testing::ExitedWithCode(0), "");
+  EXPECT_EQ("val0", KVDB::Get("test_key"));
+  EXPECT_TRUE(KVDB::Delete("test_key"));
+}
+
 TEST(KVDBTest, MultiThreads) {
   static const int N_THREADS = 3;
 
@@ -64,5 +141,28 @@ TEST(KVDBTest, MultiThreads) {
   }
 }
 
+TEST(KVDBTest, IdleClose) {
+  static const int N_THREADS = 3;
+
+  // The DB is closed after 1 ms idle while other threads keep using it.
+  EXPECT_EQ(1, FLAGS_kv_db_idle_close_ms);
+  std::vector<std::unique_ptr<std::thread>> threads(N_THREADS);
+  for (int i = 0; i < N_THREADS; ++i) {
+    threads[i].reset(new std::thread([i]() {
+      const std::string key = "test_key_" + std::to_string(i);
+      for (int j = 0; j < 20; ++j) {
+        const std::string value = "val" + std::to_string(j);
+        EXPECT_TRUE(KVDB::Put(key, value));
+        EXPECT_EQ(value, KVDB::Get(key));
+        std::this_thread::sleep_for(std::chrono::milliseconds(j % 3));
+      }
+      EXPECT_TRUE(KVDB::Delete(key));
+    }));
+  }
+  for (auto &th : threads) {
+    th->join();
+  }
+}
+
 }  // namespace common
 }  // namespace apollo
@@ -23,6 +23,8 @@
 #define MODULES_COMMON_MATH_AABOXKDTREE2D_H_
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -53,6 +55,303 @@ struct AABoxKDTreeParams {
   double max_leaf_dimension = -1.0;
 };
 
+/**
+ * @class AABoxKDTree2dFlatNode
+ * @brief A position-independent record of one KD-tree node. Sub-nodes and
+ *        objects are referenced by index instead of pointer, so an array of
+ *        these records can be written to a file and mapped back in directly.
+ */
+struct AABoxKDTree2dFlatNode {
+  double min_x = 0.0;
+  double max_x = 0.0;
+  double min_y = 0.0;
+  double max_y = 0.0;
+  double mid_x = 0.0;
+  double mid_y = 0.0;
+  double partition_position = 0.0;
+  /// 1 for partition along x, 2 for partition along y.
+  int32_t partition = 1;
+  /// Index of the left sub-node, -1 if there is none.
+  int32_t left_subnode = -1;
+  /// Index of the right sub-node, -1 if there is none.
+  int32_t right_subnode = -1;
+  /// Offset of the objects of this node in the sorted object arrays.
+  int32_t objects_begin = 0;
+  int32_t num_objects = 0;
+  int32_t reserved = 0;
+};
+
+/**
+ * @class AABoxKDTree2dFlatView
+ * @brief A read-only view of a flattened KD-tree. The arrays are not owned by
+ *        the view; the root node is the first node.
+ */
+struct AABoxKDTree2dFlatView {
+  const AABoxKDTree2dFlatNode *nodes = nullptr;
+  int num_nodes = 0;
+  /// Indices of the objects held by every node, sorted by min bound.
+  const int32_t *objects_sorted_by_min = nullptr;
+  /// Indices of the objects held by every node, sorted by max bound.
+  const int32_t *objects_sorted_by_max = nullptr;
+  const double *objects_sorted_by_min_bound = nullptr;
+  const double *objects_sorted_by_max_bound = nullptr;
+  int num_objects = 0;
+
+  /**
+   * @brief Check that all node and object indices stay within the arrays.
+   * @return True if the view can be traversed safely.
+   */
+  bool IsValid() const {
+    if (num_nodes < 0 || num_objects < 0) {
+      return false;
+    }
+    for (int i = 0; i < num_nodes; ++i) {
+      const AABoxKDTree2dFlatNode &node = nodes[i];
+      if (node.left_subnode >= num_nodes || node.right_subnode >= num_nodes ||
+          (node.left_subnode >= 0 && node.left_subnode <= i) ||
+          (node.right_subnode >= 0 && node.right_subnode <= i)) {
+        return false;
+      }
+      if (node.partition != 1 && node.partition != 2) {
+        return false;
+      }
+      if (node.objects_begin < 0 || node.num_objects < 0 ||
+          node.objects_begin + node.num_objects > num_objects) {
+        return false;
+      }
+    }
+    for (int i = 0; i < num_objects; ++i) {
+      if (objects_sorted_by_min[i] < 0 ||
+          objects_sorted_by_min[i] >= num_objects ||
+          objects_sorted_by_max[i] < 0 ||
+          objects_sorted_by_max[i] >= num_objects) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+/**
+ * @class AABoxKDTree2dFlatData
+ * @brief Owns the arrays of a flattened KD-tree.
+ */
+struct AABoxKDTree2dFlatData {
+  std::vector<AABoxKDTree2dFlatNode> nodes;
+  std::vector<int32_t> objects_sorted_by_min;
+  std::vector<int32_t> objects_sorted_by_max;
+  std::vector<double> objects_sorted_by_min_bound;
+  std::vector<double> objects_sorted_by_max_bound;
+
+  AABoxKDTree2dFlatView View() const {
+    AABoxKDTree2dFlatView view;
+    view.nodes = nodes.data();
+    view.num_nodes = static_cast<int>(nodes.size());
+    view.objects_sorted_by_min = objects_sorted_by_min.data();
+    view.objects_sorted_by_max = objects_sorted_by_max.data();
+    view.objects_sorted_by_min_bound = objects_sorted_by_min_bound.data();
+    view.objects_sorted_by_max_bound = objects_sorted_by_max_bound.data();
+    view.num_objects = static_cast<int>(objects_sorted_by_min.size());
+    return view;
+  }
+};
+
+/**
+ * @class AABoxKDTree2dBatchQuery
+ * @brief The state of a batched range query, which walks a KD-tree once for
+ *        a batch of points. The points still reaching into a node are kept
+ *        as a range of a shared query stack together with their bounding
+ *        box, so a node out of range of the whole range is skipped with a
+ *        single test. The distances of an object are computed for all points
+ *        of a range at once by the batched
+ *        ObjectType::DistanceSquareTo(xs, ys, num_points, distance_sqrs).
+ */
+template <class ObjectType>
+class AABoxKDTree2dBatchQuery {
+ public:
+  using ObjectPtr = const ObjectType *;
+
+  /**
+   * @brief A range of the query stack and the bounding box of its points.
+   */
+  struct QueryRange {
+    int begin = 0;
+    int end = 0;
+    double min_x = std::numeric_limits<double>::infinity();
+    double max_x = -std::numeric_limits<double>::infinity();
+    double min_y = std::numeric_limits<double>::infinity();
+    double max_y = -std::numeric_limits<double>::infinity();
+
+    bool empty() const { return begin >= end; }
+    void AddPoint(const Vec2d &point) {
+      min_x = std::min(min_x, point.x());
+      max_x = std::max(max_x, point.x());
+      min_y = std::min(min_y, point.y());
+      max_y = std::max(max_y, point.y());
+    }
+  };
+
+  AABoxKDTree2dBatchQuery(const std::vector<Vec2d> &points,
+                          const double distance,
+                          std::vector<std::vector<ObjectPtr>> *const results)
+      : points_(points),
+        distance_(distance),
+        distance_sqr_(Square(distance)),
+        results_(results) {
+    results_->assign(points.size(), std::vector<ObjectPtr>());
+    query_stack_.reserve(points.size() * 2);
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+      query_stack_.push_back(i);
+    }
+  }
+
+  /**
+   * @brief Get the range of all queries.
+   */
+  QueryRange AllQueries() const {
+    QueryRange range;
+    range.end = static_cast<int>(points_.size());
+    for (const Vec2d &point : points_) {
+      range.AddPoint(point);
+    }
+    return range;
+  }
+
+  /**
+   * @brief Whether a range has too few queries to walk the KD-tree together,
+   *        so they are better searched one by one.
+   */
+  static bool IsSmall(const QueryRange &range) {
+    return range.end - range.begin < kMinBatchedQueries;
+  }
+
+  int query(const int index) const { return query_stack_[index]; }
+  const Vec2d &point(const int query) const { return points_[query]; }
+  double distance() const { return distance_; }
+  double distance_sqr() const { return distance_sqr_; }
+  std::vector<ObjectPtr> *result(const int query) {
+    return &(*results_)[query];
+  }
+
+  /**
+   * @brief Select the queries of a range which reach into a node. Queries
+   *        covering the whole node are kept as covering queries until the
+   *        next selection, the others are pushed on the query stack.
+   * @return The range of the pushed queries.
+   */
+  QueryRange SelectQueries(const QueryRange &range, const double min_x,
+                           const double max_x, const double min_y,
+                           const double max_y, const double mid_x,
+                           const double mid_y) {
+    covering_queries_.clear();
+    QueryRange selected;
+    selected.begin = static_cast<int>(query_stack_.size());
+    selected.end = selected.begin;
+    const double range_dx =
+        std::max(0.0, std::max(min_x - range.max_x, range.min_x - max_x));
+    const double range_dy =
+        std::max(0.0, std::max(min_y - range.max_y, range.min_y - max_y));
+    if (range_dx * range_dx + range_dy * range_dy > distance_sqr_) {
+      return selected;
+    }
+    for (int i = range.begin; i < range.end; ++i) {
+      const int query = query_stack_[i];
+      const Vec2d &point = points_[query];
+      const double lower_dx =
+          std::max(0.0, std::max(min_x - point.x(), point.x() - max_x));
+      const double lower_dy =
+          std::max(0.0, std::max(min_y - point.y(), point.y() - max_y));
+      if (lower_dx * lower_dx + lower_dy * lower_dy > distance_sqr_) {
+        continue;
+      }
+      const double upper_dx =
+          (point.x() > mid_x ? (point.x() - min_x) : (point.x() - max_x));
+      const double upper_dy =
+          (point.y() > mid_y ? (point.y() - min_y) : (point.y() - max_y));
+      if (upper_dx * upper_dx + upper_dy * upper_dy <= distance_sqr_) {
+        covering_queries_.push_back(query);
+      } else {
+        query_stack_.push_back(query);
+        selected.AddPoint(point);
+      }
+    }
+    selected.end = static_cast<int>(query_stack_.size());
+    return selected;
+  }
+
+  bool has_covering_queries() const { return !covering_queries_.empty(); }
+
+  /**
+   * @brief Add objects to the results of the covering queries.
+   */
+  void AddToCoveringQueries(const std::vector<ObjectPtr> &objects) {
+    for (const int query : covering_queries_) {
+      auto &result = (*results_)[query];
+      result.insert(result.end(), objects.begin(), objects.end());
+    }
+  }
+
+  /**
+   * @brief Gather the points of a range into contiguous coordinate arrays,
+   *        which are checked against objects by CheckObject.
+   */
+  void GatherPoints(const QueryRange &range) {
+    gathered_begin_ = range.begin;
+    const int num_gathered = range.end - range.begin;
+    xs_.resize(num_gathered);
+    ys_.resize(num_gathered);
+    distance_sqrs_.resize(num_gathered);
+    hits_.resize(num_gathered);
+    for (int i = 0; i < num_gathered; ++i) {
+      const int query = query_stack_[range.begin + i];
+      xs_[i] = points_[query].x();
+      ys_[i] = points_[query].y();
+    }
+  }
+
+  /**
+   * @brief Check an object against all gathered points at once and add it
+   *        to the results of the points within the query distance.
+   */
+  void CheckObject(ObjectPtr object) {
+    const int num_gathered = static_cast<int>(xs_.size());
+    object->DistanceSquareTo(xs_.data(), ys_.data(), num_gathered,
+                             distance_sqrs_.data());
+    // Collect the hits without branches, most of them are hard to predict.
+    int num_hits = 0;
+    for (int i = 0; i < num_gathered; ++i) {
+      hits_[num_hits] = i;
+      num_hits += (distance_sqrs_[i] <= distance_sqr_);
+    }
+    for (int k = 0; k < num_hits; ++k) {
+      (*results_)[query_stack_[gathered_begin_ + hits_[k]]].push_back(object);
+    }
+  }
+
+  /**
+   * @brief Pop the queries of a range returned by SelectQueries.
+   */
+  void PopQueries(const QueryRange &range) { query_stack_.resize(range.begin); }
+
+ private:
+  // Walking the KD-tree together does not pay off for fewer queries.
+  static constexpr int kMinBatchedQueries = 4;
+
+ private:
+  const std::vector<Vec2d> &points_;
+  const double distance_;
+  const double distance_sqr_;
+  std::vector<std::vector<ObjectPtr>> *const results_;
+
+  std::vector<int> query_stack_;
+  std::vector<int> covering_queries_;
+  int gathered_begin_ = 0;
+  std::vector<double> xs_;
+  std::vector<double> ys_;
+  std::vector<double> distance_sqrs_;
+  std::vector<int> hits_;
+};
+
 /**
  * @class AABoxKDTree2dNode
  * @brief The class of KD-tree node of axis-aligned bounding box.
@@ -61,6 +360,7 @@ template <class ObjectType>
 class AABoxKDTree2dNode {
  public:
   using ObjectPtr = const ObjectType *;
+  using BatchQuery = AABoxKDTree2dBatchQuery<ObjectType>;
   /**
    * @brief Constructor which takes a vector of objects,
    *        parameters and depth of the node.
@@ -122,6 +422,46 @@ class AABoxKDTree2dNode {
     return result_objects;
   }
 
+  /**
+   * @brief Get objects within a distance to each of a batch of points by the
+   *        KD-tree rooted at this node, walking the KD-tree once.
+   * @param range The queries reaching the parent node.
+   * @param query The batched query.
+   */
+  void GetObjectsBatch(const typename BatchQuery::QueryRange &range,
+                       BatchQuery *const query) const {
+    if (BatchQuery::IsSmall(range)) {
+      for (int i = range.begin; i < range.end; ++i) {
+        const int index = query->query(i);
+        GetObjectsInternal(query->point(index), query->distance(),
+                           query->distance_sqr(), query->result(index));
+      }
+      return;
+    }
+    auto selected = query->SelectQueries(range, min_x_, max_x_, min_y_, max_y_,
+                                         mid_x_, mid_y_);
+    if (query->has_covering_queries()) {
+      std::vector<ObjectPtr> all_objects;
+      GetAllObjects(&all_objects);
+      query->AddToCoveringQueries(all_objects);
+    }
+    if (!selected.empty()) {
+      if (num_objects_ > 0) {
+        query->GatherPoints(selected);
+        for (ObjectPtr object : objects_sorted_by_min_) {
+          query->CheckObject(object);
+        }
+      }
+      if (left_subnode_ != nullptr) {
+        left_subnode_->GetObjectsBatch(selected, query);
+      }
+      if (right_subnode_ != nullptr) {
+        right_subnode_->GetObjectsBatch(selected, query);
+      }
+    }
+    query->PopQueries(selected);
+  }
+
   /**
    * @brief Get the axis-aligned bounding box of the objects.
    * @return The axis-aligned bounding box of the objects.
@@ -130,6 +470,49 @@ class AABoxKDTree2dNode {
     return AABox2d({min_x_, min_y_}, {max_x_, max_y_});
   }
 
+  /**
+   * @brief Append the sub-tree rooted at this node to a flattened KD-tree.
+   * @param first_object The first object of the array the tree is built on.
+   *        Objects are recorded by their offset to it.
+   * @param data The flattened KD-tree to append to.
+   * @return The index of this node in the flattened KD-tree.
+   */
+  int Flatten(ObjectPtr first_object, AABoxKDTree2dFlatData *const data) const {
+    const int index = static_cast<int>(data->nodes.size());
+    data->nodes.emplace_back();
+
+    AABoxKDTree2dFlatNode node;
+    node.min_x = min_x_;
+    node.max_x = max_x_;
+    node.min_y = min_y_;
+    node.max_y = max_y_;
+    node.mid_x = mid_x_;
+    node.mid_y = mid_y_;
+    node.partition_position = partition_position_;
+    node.partition = static_cast<int32_t>(partition_);
+    node.objects_begin =
+        static_cast<int32_t>(data->objects_sorted_by_min.size());
+    node.num_objects = num_objects_;
+    for (int i = 0; i < num_objects_; ++i) {
+      data->objects_sorted_by_min.push_back(
+          static_cast<int32_t>(objects_sorted_by_min_[i] - first_object));
+      data->objects_sorted_by_max.push_back(
+          static_cast<int32_t>(objects_sorted_by_max_[i] - first_object));
+      data->objects_sorted_by_min_bound.push_back(
+          objects_sorted_by_min_bound_[i]);
+      data->objects_sorted_by_max_bound.push_back(
+          objects_sorted_by_max_bound_[i]);
+    }
+    if (left_subnode_ != nullptr) {
+      node.left_subnode = left_subnode_->Flatten(first_object, data);
+    }
+    if (right_subnode_ != nullptr) {
+      node.right_subnode = right_subnode_->Flatten(first_object, data);
+    }
+    data->nodes[index] = node;
+    return index;
+  }
+
  private:
   void InitObjects(const std::vector<ObjectPtr> &objects) {
     num_objects_ = objects.size();
@@ -416,6 +799,7 @@ template <class ObjectType>
 class AABoxKDTree2d {
  public:
   using ObjectPtr = const ObjectType *;
+  using BatchQuery = AABoxKDTree2dBatchQuery<ObjectType>;
 
   /**
    * @brief Contructor which takes a vector of objects and parameters.
@@ -428,17 +812,44 @@ class AABoxKDTree2d {
       for (const auto &object : objects) {
         object_ptrs.push_back(&object);
       }
+      first_object_ = objects.data();
       root_.reset(new AABoxKDTree2dNode<ObjectType>(object_ptrs, params, 0));
     }
   }
 
+  /**
+   * @brief Contructor which adopts a previously flattened KD-tree instead of
+   *        building one. The flattened arrays are not copied, they must
+   *        outlive this KD-tree, as must the objects.
+   * @param objects The objects the flattened KD-tree was built on, in the
+   *        same order.
+   * @param flat_view The flattened KD-tree.
+   */
+  AABoxKDTree2d(const std::vector<ObjectType> &objects,
+                const AABoxKDTree2dFlatView &flat_view)
+      : flat_view_(flat_view) {
+    CHECK_EQ(flat_view_.num_objects, static_cast<int>(objects.size()));
+    if (!objects.empty()) {
+      first_object_ = objects.data();
+    }
+  }
+
   /**
    * @brief Get the nearest object to a target point.
    * @param point The target point. Search it's nearest object.
    * @return The nearest object to the target point.
    */
   ObjectPtr GetNearestObject(const Vec2d &point) const {
-    return root_ == nullptr ? nullptr : root_->GetNearestObject(point);
+    if (root_ != nullptr) {
+      return root_->GetNearestObject(point);
+    }
+    if (flat_view_.num_nodes == 0) {
+      return nullptr;
+    }
+    ObjectPtr nearest_object = nullptr;
+    double min_distance_sqr = std::numeric_limits<double>::infinity();
+    GetNearestObjectFlat(0, point, &min_distance_sqr, &nearest_object);
+    return nearest_object;
   }
 
   /**
@@ -449,10 +860,38 @@ class AABoxKDTree2d {
    */
   std::vector<ObjectPtr> GetObjects(const Vec2d &point,
                                     const double distance) const {
-    if (root_ == nullptr) {
-      return {};
+    if (root_ != nullptr) {
+      return root_->GetObjects(point, distance);
+    }
+    std::vector<ObjectPtr> result_objects;
+    if (flat_view_.num_nodes > 0) {
+      GetObjectsFlat(0, point, distance, Square(distance), &result_objects);
+    }
+    return result_objects;
+  }
+
+  /**
+   * @brief Get objects within a distance to each of a batch of points. The
+   *        KD-tree is walked once for the whole batch, and the distances of
+   *        each object are computed for all points reaching it at once, so
+   *        ObjectType needs a batched DistanceSquareTo(xs, ys, num_points,
+   *        distance_sqrs).
+   * @param points The center points of the ranges to search objects.
+   * @param distance The radius of the ranges to search objects.
+   * @param results Output of the objects within the distance, one vector per
+   *        point. Each vector holds the same objects as GetObjects, possibly
+   *        in a different order.
+   */
+  void GetObjectsBatch(
+      const std::vector<Vec2d> &points, const double distance,
+      std::vector<std::vector<ObjectPtr>> *const results) const {
+    CHECK_NOTNULL(results);
+    BatchQuery query(points, distance, results);
+    if (root_ != nullptr) {
+      root_->GetObjectsBatch(query.AllQueries(), &query);
+    } else if (flat_view_.num_nodes > 0) {
+      GetObjectsBatchFlat(0, query.AllQueries(), &query);
     }
-    return root_->GetObjects(point, distance);
   }
 
   /**
@@ -460,11 +899,237 @@ class AABoxKDTree2d {
    * @return The axis-aligned bounding box of the objects.
    */
   AABox2d GetBoundingBox() const {
-    return root_ == nullptr ? AABox2d() : root_->GetBoundingBox();
+    if (root_ != nullptr) {
+      return root_->GetBoundingBox();
+    }
+    if (flat_view_.num_nodes == 0) {
+      return AABox2d();
+    }
+    const AABoxKDTree2dFlatNode &root = flat_view_.nodes[0];
+    return AABox2d({root.min_x, root.min_y}, {root.max_x, root.max_y});
+  }
+
+  /**
+   * @brief Flatten the KD-tree into index based arrays, which can be written
+   *        to a file and adopted later without rebuilding the KD-tree.
+   * @param data Output of the flattened KD-tree.
+   */
+  void Flatten(AABoxKDTree2dFlatData *const data) const {
+    CHECK_NOTNULL(data);
+    *data = AABoxKDTree2dFlatData();
+    if (root_ != nullptr) {
+      root_->Flatten(first_object_, data);
+      return;
+    }
+    const AABoxKDTree2dFlatView &view = flat_view_;
+    data->nodes.assign(view.nodes, view.nodes + view.num_nodes);
+    data->objects_sorted_by_min.assign(
+        view.objects_sorted_by_min,
+        view.objects_sorted_by_min + view.num_objects);
+    data->objects_sorted_by_max.assign(
+        view.objects_sorted_by_max,
+        view.objects_sorted_by_max + view.num_objects);
+    data->objects_sorted_by_min_bound.assign(
+        view.objects_sorted_by_min_bound,
+        view.objects_sorted_by_min_bound + view.num_objects);
+    data->objects_sorted_by_max_bound.assign(
+        view.objects_sorted_by_max_bound,
+        view.objects_sorted_by_max_bound + view.num_objects);
+  }
+
+ private:
+  // The traversals below mirror the ones in AABoxKDTree2dNode, walking the
+  // flattened node array instead of the linked nodes.
+  static double LowerDistanceSquareToPoint(const AABoxKDTree2dFlatNode &node,
+                                           const Vec2d &point) {
+    double dx = 0.0;
+    if (point.x() < node.min_x) {
+      dx = node.min_x - point.x();
+    } else if (point.x() > node.max_x) {
+      dx = point.x() - node.max_x;
+    }
+    double dy = 0.0;
+    if (point.y() < node.min_y) {
+      dy = node.min_y - point.y();
+    } else if (point.y() > node.max_y) {
+      dy = point.y() - node.max_y;
+    }
+    return dx * dx + dy * dy;
+  }
+
+  static double UpperDistanceSquareToPoint(const AABoxKDTree2dFlatNode &node,
+                                           const Vec2d &point) {
+    const double dx = (point.x() > node.mid_x ? (point.x() - node.min_x)
+                                              : (point.x() - node.max_x));
+    const double dy = (point.y() > node.mid_y ? (point.y() - node.min_y)
+                                              : (point.y() - node.max_y));
+    return dx * dx + dy * dy;
+  }
+
+  void GetAllObjectsFlat(const int node_index,
+                         std::vector<ObjectPtr> *const result_objects) const {
+    const AABoxKDTree2dFlatNode &node = flat_view_.nodes[node_index];
+    for (int i = 0; i < node.num_objects; ++i) {
+      result_objects->push_back(
+          first_object_ +
+          flat_view_.objects_sorted_by_min[node.objects_begin + i]);
+    }
+    if (node.left_subnode >= 0) {
+      GetAllObjectsFlat(node.left_subnode, result_objects);
+    }
+    if (node.right_subnode >= 0) {
+      GetAllObjectsFlat(node.right_subnode, result_objects);
+    }
+  }
+
+  void GetObjectsFlat(const int node_index, const Vec2d &point,
+                      const double distance, const double distance_sqr,
+                      std::vector<ObjectPtr> *const result_objects) const {
+    const AABoxKDTree2dFlatNode &node = flat_view_.nodes[node_index];
+    if (LowerDistanceSquareToPoint(node, point) > distance_sqr) {
+      return;
+    }
+    if (UpperDistanceSquareToPoint(node, point) <= distance_sqr) {
+      GetAllObjectsFlat(node_index, result_objects);
+      return;
+    }
+    const int32_t *sorted_by_min =
+        flat_view_.objects_sorted_by_min + node.objects_begin;
+    const int32_t *sorted_by_max =
+        flat_view_.objects_sorted_by_max + node.objects_begin;
+    const double *min_bound =
+        flat_view_.objects_sorted_by_min_bound + node.objects_begin;
+    const double *max_bound =
+        flat_view_.objects_sorted_by_max_bound + node.objects_begin;
+    const double pvalue = (node.partition == 1 ? point.x() : point.y());
+    if (pvalue < node.partition_position) {
+      const double limit = pvalue + distance;
+      for (int i = 0; i < node.num_objects; ++i) {
+        if (min_bound[i] > limit) {
+          break;
+        }
+        ObjectPtr object = first_object_ + sorted_by_min[i];
+        if (object->DistanceSquareTo(point) <= distance_sqr) {
+          result_objects->push_back(object);
+        }
+      }
+    } else {
+      const double limit = pvalue - distance;
+      for (int i = 0; i < node.num_objects; ++i) {
+        if (max_bound[i] < limit) {
+          break;
+        }
+        ObjectPtr object = first_object_ + sorted_by_max[i];
+        if (object->DistanceSquareTo(point) <= distance_sqr) {
+          result_objects->push_back(object);
+        }
+      }
+    }
+    if (node.left_subnode >= 0) {
+      GetObjectsFlat(node.left_subnode, point, distance, distance_sqr,
+                     result_objects);
+    }
+    if (node.right_subnode >= 0) {
+      GetObjectsFlat(node.right_subnode, point, distance, distance_sqr,
+                     result_objects);
+    }
+  }
+
+  void GetObjectsBatchFlat(const int node_index,
+                           const typename BatchQuery::QueryRange &range,
+                           BatchQuery *const query) const {
+    if (BatchQuery::IsSmall(range)) {
+      for (int i = range.begin; i < range.end; ++i) {
+        const int index = query->query(i);
+        GetObjectsFlat(node_index, query->point(index), query->distance(),
+                       query->distance_sqr(), query->result(index));
+      }
+      return;
+    }
+    const AABoxKDTree2dFlatNode &node = flat_view_.nodes[node_index];
+    auto selected =
+        query->SelectQueries(range, node.min_x, node.max_x, node.min_y,
+                             node.max_y, node.mid_x, node.mid_y);
+    if (query->has_covering_queries()) {
+      std::vector<ObjectPtr> all_objects;
+      GetAllObjectsFlat(node_index, &all_objects);
+      query->AddToCoveringQueries(all_objects);
+    }
+    if (!selected.empty()) {
+      if (node.num_objects > 0) {
+        query->GatherPoints(selected);
+        for (int i = 0; i < node.num_objects; ++i) {
+          query->CheckObject(
+              first_object_ +
+              flat_view_.objects_sorted_by_min[node.objects_begin + i]);
+        }
+      }
+      if (node.left_subnode >= 0) {
+        GetObjectsBatchFlat(node.left_subnode, selected, query);
+      }
+      if (node.right_subnode >= 0) {
+        GetObjectsBatchFlat(node.right_subnode, selected, query);
+      }
+    }
+    query->PopQueries(selected);
+  }
+
+  void GetNearestObjectFlat(const int node_index, const Vec2d &point,
+                            double *const min_distance_sqr,
+                            ObjectPtr *const nearest_object) const {
+    const AABoxKDTree2dFlatNode &node = flat_view_.nodes[node_index];
+    if (LowerDistanceSquareToPoint(node, point) >=
+        *min_distance_sqr - kMathEpsilon) {
+      return;
+    }
+    const double pvalue = (node.partition == 1 ? point.x() : point.y());
+    const bool search_left_first = (pvalue < node.partition_position);
+    const int first_subnode =
+        search_left_first ? node.left_subnode : node.right_subnode;
+    const int second_subnode =
+        search_left_first ? node.right_subnode : node.left_subnode;
+    if (first_subnode >= 0) {
+      GetNearestObjectFlat(first_subnode, point, min_distance_sqr,
+                           nearest_object);
+    }
+    if (*min_distance_sqr <= kMathEpsilon) {
+      return;
+    }
+
+    const int32_t *sorted_objects =
+        (search_left_first ? flat_view_.objects_sorted_by_min
+                           : flat_view_.objects_sorted_by_max) +
+        node.objects_begin;
+    const double *bounds =
+        (search_left_first ? flat_view_.objects_sorted_by_min_bound
+                           : flat_view_.objects_sorted_by_max_bound) +
+        node.objects_begin;
+    for (int i = 0; i < node.num_objects; ++i) {
+      const double bound = bounds[i];
+      const bool beyond = search_left_first ? bound > pvalue : bound < pvalue;
+      if (beyond && Square(bound - pvalue) > *min_distance_sqr) {
+        break;
+      }
+      ObjectPtr object = first_object_ + sorted_objects[i];
+      const double distance_sqr = object->DistanceSquareTo(point);
+      if (distance_sqr < *min_distance_sqr) {
+        *min_distance_sqr = distance_sqr;
+        *nearest_object = object;
+      }
+    }
+    if (*min_distance_sqr <= kMathEpsilon) {
+      return;
+    }
+    if (second_subnode >= 0) {
+      GetNearestObjectFlat(second_subnode, point, min_distance_sqr,
+                           nearest_object);
+    }
   }
 
  private:
   std::unique_ptr<AABoxKDTree2dNode<ObjectType>> root_ = nullptr;
+  ObjectPtr first_object_ = nullptr;
+  AABoxKDTree2dFlatView flat_view_;
 };
 
 }  // namespace math
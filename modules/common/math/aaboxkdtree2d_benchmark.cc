@@ -0,0 +1,193 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Compares build time and query latency of AABoxKDTree2d and
+ *        CompactAABoxKDTree2d on synthetic lane segments of a city grid.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/aaboxkdtree2d.h"
+#include "modules/common/math/compact_aaboxkdtree2d.h"
+#include "modules/common/math/line_segment2d.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+// Parameters of the lane segment KD-tree in HDMapImpl.
+constexpr double kMaxLeafDimension = 5.0;
+constexpr int kMaxLeafSize = 16;
+
+// Roads of the synthetic city run along a grid with this spacing, and lanes
+// are sampled into segments of this length.
+constexpr double kBlockLength = 150.0;
+constexpr double kSegmentLength = 2.0;
+constexpr double kLaneWidth = 3.5;
+constexpr int kLanesPerRoad = 4;
+
+constexpr int kNumQueries = 1024;
+constexpr double kQueryDistance = 5.0;
+
+class LaneSegment {
+ public:
+  LaneSegment(const Vec2d &start, const Vec2d &end)
+      : segment_(start, end), aabox_(start, end) {}
+  const AABox2d &aabox() const { return aabox_; }
+  double DistanceSquareTo(const Vec2d &point) const {
+    return segment_.DistanceSquareTo(point);
+  }
+
+ private:
+  LineSegment2d segment_;
+  AABox2d aabox_;
+};
+
+// Lane segments of a square city with about num_segments segments. Lanes
+// run in both directions along a grid of slightly wavy roads.
+std::vector<LaneSegment> GenerateCity(const int num_segments) {
+  // Each of the num_roads roads along x and along y has kLanesPerRoad lanes
+  // of num_roads * kBlockLength meters.
+  const int num_roads = std::max(
+      1, static_cast<int>(std::sqrt(num_segments * kSegmentLength /
+                                    (2.0 * kLanesPerRoad * kBlockLength))));
+  const double city_length = num_roads * kBlockLength;
+  const int segments_per_lane =
+      std::max(1, static_cast<int>(city_length / kSegmentLength));
+
+  std::vector<LaneSegment> segments;
+  segments.reserve(2 * num_roads * kLanesPerRoad * segments_per_lane);
+  for (int road = 0; road < num_roads; ++road) {
+    for (int lane = 0; lane < kLanesPerRoad; ++lane) {
+      const double offset = road * kBlockLength + lane * kLaneWidth;
+      for (int horizontal = 0; horizontal < 2; ++horizontal) {
+        Vec2d start;
+        for (int i = 0; i <= segments_per_lane; ++i) {
+          const double s = i * kSegmentLength;
+          const double l = offset + 0.5 * std::sin(s / 40.0);
+          const Vec2d point = horizontal ? Vec2d(s, l) : Vec2d(l, s);
+          if (i > 0) {
+            segments.emplace_back(start, point);
+          }
+          start = point;
+        }
+      }
+    }
+  }
+  return segments;
+}
+
+std::vector<Vec2d> GenerateQueries(const std::vector<LaneSegment> &segments) {
+  std::mt19937 random_engine(0);
+  std::uniform_int_distribution<int> segment_index(
+      0, static_cast<int>(segments.size()) - 1);
+  std::uniform_real_distribution<double> offset(-3.0, 3.0);
+  std::vector<Vec2d> queries;
+  for (int i = 0; i < kNumQueries; ++i) {
+    const AABox2d &aabox = segments[segment_index(random_engine)].aabox();
+    queries.emplace_back(aabox.center_x() + offset(random_engine),
+                         aabox.center_y() + offset(random_engine));
+  }
+  return queries;
+}
+
+AABoxKDTreeParams LaneSegmentParams() {
+  AABoxKDTreeParams params;
+  params.max_leaf_dimension = kMaxLeafDimension;
+  params.max_leaf_size = kMaxLeafSize;
+  return params;
+}
+
+template <class KDTree>
+void BM_Build(benchmark::State &state) {  // NOLINT
+  const auto segments = GenerateCity(state.range(0));
+  const auto params = LaneSegmentParams();
+  while (state.KeepRunning()) {
+    KDTree kdtree(segments, params);
+    benchmark::DoNotOptimize(kdtree.GetBoundingBox());
+  }
+  state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+template <class KDTree>
+void BM_GetObjects(benchmark::State &state) {  // NOLINT
+  const auto segments = GenerateCity(state.range(0));
+  const auto queries = GenerateQueries(segments);
+  const KDTree kdtree(segments, LaneSegmentParams());
+  while (state.KeepRunning()) {
+    for (const Vec2d &point : queries) {
+      benchmark::DoNotOptimize(kdtree.GetObjects(point, kQueryDistance));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+template <class KDTree>
+void BM_GetNearestObject(benchmark::State &state) {  // NOLINT
+  const auto segments = GenerateCity(state.range(0));
+  const auto queries = GenerateQueries(segments);
+  const KDTree kdtree(segments, LaneSegmentParams());
+  while (state.KeepRunning()) {
+    for (const Vec2d &point : queries) {
+      benchmark::DoNotOptimize(kdtree.GetNearestObject(point));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+using LinkedTree = AABoxKDTree2d<LaneSegment>;
+using CompactTree = CompactAABoxKDTree2d<LaneSegment>;
+
+// From a district to a large city: 10k to 1M lane segments.
+BENCHMARK_TEMPLATE(BM_Build, LinkedTree)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_Build, CompactTree)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_GetObjects, LinkedTree)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_GetObjects, CompactTree)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_GetNearestObject, LinkedTree)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_GetNearestObject, CompactTree)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+
+}  // namespace
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -16,6 +16,7 @@
 
 #include "modules/common/math/aaboxkdtree2d.h"
 
+#include <algorithm>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -43,6 +44,11 @@ class Object {
   double DistanceSquareTo(const Vec2d &point) const {
     return line_segment_.DistanceSquareTo(point);
   }
+  void DistanceSquareTo(const double *xs, const double *ys,
+                        const int num_points,
+                        double *const distance_sqrs) const {
+    line_segment_.DistanceSquareTo(xs, ys, num_points, distance_sqrs);
+  }
   int id() const { return id_; }
 
  private:
@@ -118,6 +124,105 @@ TEST(AABoxKDTree2dNode, OverallTests) {
   }
 }
 
+TEST(AABoxKDTree2d, FlattenedTree) {
+  const int kNumBoxes = 200;
+  const int kNumQueries = 1000;
+  const double kSize = 100;
+  AABoxKDTreeParams params;
+  params.max_leaf_size = 4;
+
+  std::vector<Object> objects;
+  for (int i = 0; i < kNumBoxes; ++i) {
+    const double cx = RandomDouble(-kSize, kSize);
+    const double cy = RandomDouble(-kSize, kSize);
+    const double dx = RandomDouble(-kSize / 10.0, kSize / 10.0);
+    const double dy = RandomDouble(-kSize / 10.0, kSize / 10.0);
+    objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+  }
+  AABoxKDTree2d<Object> kdtree(objects, params);
+  AABoxKDTree2dFlatData flat_data;
+  kdtree.Flatten(&flat_data);
+  const AABoxKDTree2dFlatView flat_view = flat_data.View();
+  EXPECT_TRUE(flat_view.IsValid());
+  EXPECT_EQ(kNumBoxes, flat_view.num_objects);
+
+  AABoxKDTree2d<Object> flat_kdtree(objects, flat_view);
+  const AABox2d box = kdtree.GetBoundingBox();
+  const AABox2d flat_box = flat_kdtree.GetBoundingBox();
+  EXPECT_DOUBLE_EQ(box.min_x(), flat_box.min_x());
+  EXPECT_DOUBLE_EQ(box.max_y(), flat_box.max_y());
+
+  for (int i = 0; i < kNumQueries; ++i) {
+    const Vec2d point(RandomDouble(-kSize * 1.5, kSize * 1.5),
+                      RandomDouble(-kSize * 1.5, kSize * 1.5));
+    EXPECT_EQ(kdtree.GetNearestObject(point),
+              flat_kdtree.GetNearestObject(point));
+    const double distance = RandomDouble(0, kSize);
+    std::vector<const Object *> expected = kdtree.GetObjects(point, distance);
+    std::vector<const Object *> actual =
+        flat_kdtree.GetObjects(point, distance);
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(expected, actual);
+  }
+
+  AABoxKDTree2dFlatData copied_data;
+  flat_kdtree.Flatten(&copied_data);
+  EXPECT_EQ(flat_data.nodes.size(), copied_data.nodes.size());
+  EXPECT_EQ(flat_data.objects_sorted_by_min, copied_data.objects_sorted_by_min);
+
+  flat_data.nodes[0].left_subnode = static_cast<int>(flat_data.nodes.size());
+  EXPECT_FALSE(flat_data.View().IsValid());
+}
+
+TEST(AABoxKDTree2d, BatchQueries) {
+  const int kNumBoxes = 200;
+  const int kNumQueries = 500;
+  const double kSize = 100;
+  AABoxKDTreeParams params;
+  params.max_leaf_size = 4;
+
+  std::vector<Object> objects;
+  for (int i = 0; i < kNumBoxes; ++i) {
+    const double cx = RandomDouble(-kSize, kSize);
+    const double cy = RandomDouble(-kSize, kSize);
+    const double dx = RandomDouble(-kSize / 10.0, kSize / 10.0);
+    const double dy = RandomDouble(-kSize / 10.0, kSize / 10.0);
+    objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+  }
+  AABoxKDTree2d<Object> kdtree(objects, params);
+  AABoxKDTree2dFlatData flat_data;
+  kdtree.Flatten(&flat_data);
+  AABoxKDTree2d<Object> flat_kdtree(objects, flat_data.View());
+
+  std::vector<Vec2d> points;
+  for (int i = 0; i < kNumQueries; ++i) {
+    points.emplace_back(RandomDouble(-kSize * 1.5, kSize * 1.5),
+                        RandomDouble(-kSize * 1.5, kSize * 1.5));
+  }
+  for (const double distance : {0.0, 1.0, 10.0, kSize}) {
+    std::vector<std::vector<const Object *>> results;
+    std::vector<std::vector<const Object *>> flat_results;
+    kdtree.GetObjectsBatch(points, distance, &results);
+    flat_kdtree.GetObjectsBatch(points, distance, &flat_results);
+    ASSERT_EQ(points.size(), results.size());
+    ASSERT_EQ(points.size(), flat_results.size());
+    for (int i = 0; i < kNumQueries; ++i) {
+      std::vector<const Object *> expected =
+          kdtree.GetObjects(points[i], distance);
+      std::sort(expected.begin(), expected.end());
+      std::sort(results[i].begin(), results[i].end());
+      std::sort(flat_results[i].begin(), flat_results[i].end());
+      EXPECT_EQ(expected, results[i]);
+      EXPECT_EQ(expected, flat_results[i]);
+    }
+  }
+
+  std::vector<std::vector<const Object *>> results;
+  kdtree.GetObjectsBatch({}, kSize, &results);
+  EXPECT_TRUE(results.empty());
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
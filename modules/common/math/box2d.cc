@@ -90,6 +90,10 @@ void Box2d::InitCorners() {
   corners_.emplace_back(center_.x() - dx1 - dx2, center_.y() - dy1 - dy2);
   corners_.emplace_back(center_.x() - dx1 + dx2, center_.y() - dy1 + dy2);
 
+  max_x_ = std::numeric_limits<double>::lowest();
+  min_x_ = std::numeric_limits<double>::max();
+  max_y_ = std::numeric_limits<double>::lowest();
+  min_y_ = std::numeric_limits<double>::max();
   for (auto &corner : corners_) {
     max_x_ = std::fmax(corner.x(), max_x_);
     min_x_ = std::fmin(corner.x(), min_x_);
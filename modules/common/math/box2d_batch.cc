@@ -0,0 +1,415 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+// The box checked against a batch, with the half axes along its heading and
+// its width, and its corners.
+struct QueryBox {
+  explicit QueryBox(const Box2d &box)
+      : center_x(box.center_x()),
+        center_y(box.center_y()),
+        cos_heading(box.cos_heading()),
+        sin_heading(box.sin_heading()),
+        half_length(box.half_length()),
+        half_width(box.half_width()),
+        dx1(cos_heading * half_length),
+        dy1(sin_heading * half_length),
+        dx2(sin_heading * half_width),
+        dy2(-cos_heading * half_width),
+        half_extent_x(std::abs(dx1) + std::abs(dx2)),
+        half_extent_y(std::abs(dy1) + std::abs(dy2)) {
+    const double signs1[4] = {1.0, 1.0, -1.0, -1.0};
+    const double signs2[4] = {1.0, -1.0, -1.0, 1.0};
+    for (int k = 0; k < 4; ++k) {
+      corner_x[k] = center_x + signs1[k] * dx1 + signs2[k] * dx2;
+      corner_y[k] = center_y + signs1[k] * dy1 + signs2[k] * dy2;
+    }
+  }
+
+  double center_x;
+  double center_y;
+  double cos_heading;
+  double sin_heading;
+  double half_length;
+  double half_width;
+  double dx1;
+  double dy1;
+  double dx2;
+  double dy2;
+  double half_extent_x;
+  double half_extent_y;
+  double corner_x[4];
+  double corner_y[4];
+};
+
+// The separating axis test of Box2d::HasOverlap() between the query box and
+// the box with center (x, y), heading (c, s) and half sizes (hl, hw). Like
+// Box2d::HasOverlap(), it first rejects the boxes whose bounding boxes are
+// apart.
+bool HasOverlap(const QueryBox &a, const double x, const double y,
+                const double c, const double s, const double hl,
+                const double hw) {
+  const double shift_x = x - a.center_x;
+  const double shift_y = y - a.center_y;
+  if (std::abs(shift_x) >
+          a.half_extent_x + std::abs(c) * hl + std::abs(s) * hw ||
+      std::abs(shift_y) >
+          a.half_extent_y + std::abs(s) * hl + std::abs(c) * hw) {
+    return false;
+  }
+  const double dx3 = c * hl;
+  const double dy3 = s * hl;
+  const double dx4 = s * hw;
+  const double dy4 = -c * hw;
+  const double ca = a.cos_heading;
+  const double sa = a.sin_heading;
+  return std::abs(shift_x * ca + shift_y * sa) <=
+             std::abs(dx3 * ca + dy3 * sa) + std::abs(dx4 * ca + dy4 * sa) +
+                 a.half_length &&
+         std::abs(shift_x * sa - shift_y * ca) <=
+             std::abs(dx3 * sa - dy3 * ca) + std::abs(dx4 * sa - dy4 * ca) +
+                 a.half_width &&
+         std::abs(shift_x * c + shift_y * s) <=
+             std::abs(a.dx1 * c + a.dy1 * s) +
+                 std::abs(a.dx2 * c + a.dy2 * s) + hl &&
+         std::abs(shift_x * s - shift_y * c) <=
+             std::abs(a.dx1 * s - a.dy1 * c) +
+                 std::abs(a.dx2 * s - a.dy2 * c) + hw;
+}
+
+// The squared distance from a point to a box, as in Box2d::DistanceTo().
+double PointDistanceSquare(const double px, const double py, const double x,
+                           const double y, const double c, const double s,
+                           const double hl, const double hw) {
+  const double x0 = px - x;
+  const double y0 = py - y;
+  const double dx = std::max(std::abs(x0 * c + y0 * s) - hl, 0.0);
+  const double dy = std::max(std::abs(x0 * s - y0 * c) - hw, 0.0);
+  return dx * dx + dy * dy;
+}
+
+// The distance between two separate boxes is reached at a corner of one of
+// them, so it is the shortest distance from a corner to the other box.
+double DistanceTo(const QueryBox &a, const double x, const double y,
+                  const double c, const double s, const double hl,
+                  const double hw) {
+  if (HasOverlap(a, x, y, c, s, hl, hw)) {
+    return 0.0;
+  }
+  const double dx3 = c * hl;
+  const double dy3 = s * hl;
+  const double dx4 = s * hw;
+  const double dy4 = -c * hw;
+  const double signs1[4] = {1.0, 1.0, -1.0, -1.0};
+  const double signs2[4] = {1.0, -1.0, -1.0, 1.0};
+  double distance_sqr = std::numeric_limits<double>::infinity();
+  for (int k = 0; k < 4; ++k) {
+    distance_sqr = std::min(
+        distance_sqr, PointDistanceSquare(a.corner_x[k], a.corner_y[k], x, y,
+                                          c, s, hl, hw));
+    distance_sqr = std::min(
+        distance_sqr,
+        PointDistanceSquare(x + signs1[k] * dx3 + signs2[k] * dx4,
+                            y + signs1[k] * dy3 + signs2[k] * dy4,
+                            a.center_x, a.center_y, a.cos_heading,
+                            a.sin_heading, a.half_length, a.half_width));
+  }
+  return std::sqrt(distance_sqr);
+}
+
+#ifdef __x86_64__
+
+// Two boxes of a batch, and the query box broadcast to both lanes.
+struct BoxPair {
+  __m128d x;
+  __m128d y;
+  __m128d c;
+  __m128d s;
+  __m128d hl;
+  __m128d hw;
+};
+
+struct QueryBoxPair {
+  explicit QueryBoxPair(const QueryBox &a)
+      : center_x(_mm_set1_pd(a.center_x)),
+        center_y(_mm_set1_pd(a.center_y)),
+        cos_heading(_mm_set1_pd(a.cos_heading)),
+        sin_heading(_mm_set1_pd(a.sin_heading)),
+        half_length(_mm_set1_pd(a.half_length)),
+        half_width(_mm_set1_pd(a.half_width)),
+        dx1(_mm_set1_pd(a.dx1)),
+        dy1(_mm_set1_pd(a.dy1)),
+        dx2(_mm_set1_pd(a.dx2)),
+        dy2(_mm_set1_pd(a.dy2)),
+        half_extent_x(_mm_set1_pd(a.half_extent_x)),
+        half_extent_y(_mm_set1_pd(a.half_extent_y)) {
+    for (int k = 0; k < 4; ++k) {
+      corner_x[k] = _mm_set1_pd(a.corner_x[k]);
+      corner_y[k] = _mm_set1_pd(a.corner_y[k]);
+    }
+  }
+
+  __m128d center_x;
+  __m128d center_y;
+  __m128d cos_heading;
+  __m128d sin_heading;
+  __m128d half_length;
+  __m128d half_width;
+  __m128d dx1;
+  __m128d dy1;
+  __m128d dx2;
+  __m128d dy2;
+  __m128d half_extent_x;
+  __m128d half_extent_y;
+  __m128d corner_x[4];
+  __m128d corner_y[4];
+};
+
+inline __m128d Abs(const __m128d v) {
+  return _mm_andnot_pd(_mm_set1_pd(-0.0), v);
+}
+
+// a * b + c * d and a * b - c * d.
+inline __m128d Dot(const __m128d a, const __m128d b, const __m128d c,
+                   const __m128d d) {
+  return _mm_add_pd(_mm_mul_pd(a, b), _mm_mul_pd(c, d));
+}
+
+inline __m128d Cross(const __m128d a, const __m128d b, const __m128d c,
+                     const __m128d d) {
+  return _mm_sub_pd(_mm_mul_pd(a, b), _mm_mul_pd(c, d));
+}
+
+// Whether the bounding boxes overlap, as a mask of the two lanes.
+__m128d HasAABoxOverlap(const QueryBoxPair &a, const BoxPair &b) {
+  const __m128d abs_c = Abs(b.c);
+  const __m128d abs_s = Abs(b.s);
+  const __m128d overlap_x = _mm_cmple_pd(
+      Abs(_mm_sub_pd(b.x, a.center_x)),
+      _mm_add_pd(a.half_extent_x, Dot(abs_c, b.hl, abs_s, b.hw)));
+  const __m128d overlap_y = _mm_cmple_pd(
+      Abs(_mm_sub_pd(b.y, a.center_y)),
+      _mm_add_pd(a.half_extent_y, Dot(abs_s, b.hl, abs_c, b.hw)));
+  return _mm_and_pd(overlap_x, overlap_y);
+}
+
+// Same as the separating axis test of HasOverlap(), as a mask of the two
+// lanes.
+__m128d HasOverlap(const QueryBoxPair &a, const BoxPair &b) {
+  const __m128d shift_x = _mm_sub_pd(b.x, a.center_x);
+  const __m128d shift_y = _mm_sub_pd(b.y, a.center_y);
+  const __m128d dx3 = _mm_mul_pd(b.c, b.hl);
+  const __m128d dy3 = _mm_mul_pd(b.s, b.hl);
+  const __m128d dx4 = _mm_mul_pd(b.s, b.hw);
+  const __m128d dy4 = _mm_sub_pd(_mm_setzero_pd(), _mm_mul_pd(b.c, b.hw));
+  const __m128d ca = a.cos_heading;
+  const __m128d sa = a.sin_heading;
+  const __m128d overlap1 = _mm_cmple_pd(
+      Abs(Dot(shift_x, ca, shift_y, sa)),
+      _mm_add_pd(_mm_add_pd(Abs(Dot(dx3, ca, dy3, sa)),
+                            Abs(Dot(dx4, ca, dy4, sa))),
+                 a.half_length));
+  const __m128d overlap2 = _mm_cmple_pd(
+      Abs(Cross(shift_x, sa, shift_y, ca)),
+      _mm_add_pd(_mm_add_pd(Abs(Cross(dx3, sa, dy3, ca)),
+                            Abs(Cross(dx4, sa, dy4, ca))),
+                 a.half_width));
+  const __m128d overlap3 = _mm_cmple_pd(
+      Abs(Dot(shift_x, b.c, shift_y, b.s)),
+      _mm_add_pd(_mm_add_pd(Abs(Dot(a.dx1, b.c, a.dy1, b.s)),
+                            Abs(Dot(a.dx2, b.c, a.dy2, b.s))),
+                 b.hl));
+  const __m128d overlap4 = _mm_cmple_pd(
+      Abs(Cross(shift_x, b.s, shift_y, b.c)),
+      _mm_add_pd(_mm_add_pd(Abs(Cross(a.dx1, b.s, a.dy1, b.c)),
+                            Abs(Cross(a.dx2, b.s, a.dy2, b.c))),
+                 b.hw));
+  return _mm_and_pd(_mm_and_pd(overlap1, overlap2),
+                    _mm_and_pd(overlap3, overlap4));
+}
+
+// Same as PointDistanceSquare().
+__m128d PointDistanceSquare(const __m128d px, const __m128d py,
+                            const __m128d x, const __m128d y,
+                            const __m128d c, const __m128d s,
+                            const __m128d hl, const __m128d hw) {
+  const __m128d x0 = _mm_sub_pd(px, x);
+  const __m128d y0 = _mm_sub_pd(py, y);
+  const __m128d dx = _mm_max_pd(
+      _mm_sub_pd(Abs(Dot(x0, c, y0, s)), hl), _mm_setzero_pd());
+  const __m128d dy = _mm_max_pd(
+      _mm_sub_pd(Abs(Cross(x0, s, y0, c)), hw), _mm_setzero_pd());
+  return Dot(dx, dx, dy, dy);
+}
+
+// Same as DistanceTo().
+__m128d DistanceTo(const QueryBoxPair &a, const BoxPair &b) {
+  const __m128d dx3 = _mm_mul_pd(b.c, b.hl);
+  const __m128d dy3 = _mm_mul_pd(b.s, b.hl);
+  const __m128d dx4 = _mm_mul_pd(b.s, b.hw);
+  const __m128d dy4 = _mm_sub_pd(_mm_setzero_pd(), _mm_mul_pd(b.c, b.hw));
+  const __m128d corner_x[4] = {
+      _mm_add_pd(_mm_add_pd(b.x, dx3), dx4),
+      _mm_sub_pd(_mm_add_pd(b.x, dx3), dx4),
+      _mm_sub_pd(_mm_sub_pd(b.x, dx3), dx4),
+      _mm_add_pd(_mm_sub_pd(b.x, dx3), dx4)};
+  const __m128d corner_y[4] = {
+      _mm_add_pd(_mm_add_pd(b.y, dy3), dy4),
+      _mm_sub_pd(_mm_add_pd(b.y, dy3), dy4),
+      _mm_sub_pd(_mm_sub_pd(b.y, dy3), dy4),
+      _mm_add_pd(_mm_sub_pd(b.y, dy3), dy4)};
+  __m128d distance_sqr = _mm_set1_pd(std::numeric_limits<double>::infinity());
+  for (int k = 0; k < 4; ++k) {
+    distance_sqr = _mm_min_pd(
+        distance_sqr, PointDistanceSquare(a.corner_x[k], a.corner_y[k], b.x,
+                                          b.y, b.c, b.s, b.hl, b.hw));
+    distance_sqr = _mm_min_pd(
+        distance_sqr,
+        PointDistanceSquare(corner_x[k], corner_y[k], a.center_x, a.center_y,
+                            a.cos_heading, a.sin_heading, a.half_length,
+                            a.half_width));
+  }
+  return _mm_andnot_pd(HasOverlap(a, b), _mm_sqrt_pd(distance_sqr));
+}
+
+#endif
+
+}  // namespace
+
+Box2dBatch::Box2dBatch(const std::vector<Box2d> &boxes) {
+  center_x_.reserve(boxes.size());
+  center_y_.reserve(boxes.size());
+  cos_heading_.reserve(boxes.size());
+  sin_heading_.reserve(boxes.size());
+  half_length_.reserve(boxes.size());
+  half_width_.reserve(boxes.size());
+  for (const Box2d &box : boxes) {
+    Add(box);
+  }
+}
+
+void Box2dBatch::Add(const Box2d &box) {
+  center_x_.push_back(box.center_x());
+  center_y_.push_back(box.center_y());
+  cos_heading_.push_back(box.cos_heading());
+  sin_heading_.push_back(box.sin_heading());
+  half_length_.push_back(box.half_length());
+  half_width_.push_back(box.half_width());
+}
+
+void Box2dBatch::Clear() {
+  center_x_.clear();
+  center_y_.clear();
+  cos_heading_.clear();
+  sin_heading_.clear();
+  half_length_.clear();
+  half_width_.clear();
+}
+
+void Box2dBatch::HasOverlap(const Box2d &box, bool *const overlaps) const {
+  const QueryBox a(box);
+  const std::size_t num_boxes = size();
+  std::size_t i = 0;
+#ifdef __x86_64__
+  const QueryBoxPair a2(a);
+  for (; i + 1 < num_boxes; i += 2) {
+    const BoxPair b = {
+        _mm_loadu_pd(&center_x_[i]),    _mm_loadu_pd(&center_y_[i]),
+        _mm_loadu_pd(&cos_heading_[i]), _mm_loadu_pd(&sin_heading_[i]),
+        _mm_loadu_pd(&half_length_[i]), _mm_loadu_pd(&half_width_[i])};
+    const __m128d aabox_overlap = HasAABoxOverlap(a2, b);
+    const int mask =
+        _mm_movemask_pd(aabox_overlap) == 0
+            ? 0
+            : _mm_movemask_pd(
+                  _mm_and_pd(aabox_overlap, math::HasOverlap(a2, b)));
+    overlaps[i] = (mask & 1) != 0;
+    overlaps[i + 1] = (mask & 2) != 0;
+  }
+#endif
+  for (; i < num_boxes; ++i) {
+    overlaps[i] = math::HasOverlap(a, center_x_[i], center_y_[i],
+                                   cos_heading_[i], sin_heading_[i],
+                                   half_length_[i], half_width_[i]);
+  }
+}
+
+bool Box2dBatch::HasOverlap(const Box2d &box) const {
+  const QueryBox a(box);
+  const std::size_t num_boxes = size();
+  std::size_t i = 0;
+#ifdef __x86_64__
+  const QueryBoxPair a2(a);
+  for (; i + 1 < num_boxes; i += 2) {
+    const BoxPair b = {
+        _mm_loadu_pd(&center_x_[i]),    _mm_loadu_pd(&center_y_[i]),
+        _mm_loadu_pd(&cos_heading_[i]), _mm_loadu_pd(&sin_heading_[i]),
+        _mm_loadu_pd(&half_length_[i]), _mm_loadu_pd(&half_width_[i])};
+    const __m128d aabox_overlap = HasAABoxOverlap(a2, b);
+    if (_mm_movemask_pd(aabox_overlap) != 0 &&
+        _mm_movemask_pd(_mm_and_pd(aabox_overlap, math::HasOverlap(a2, b))) !=
+            0) {
+      return true;
+    }
+  }
+#endif
+  for (; i < num_boxes; ++i) {
+    if (math::HasOverlap(a, center_x_[i], center_y_[i], cos_heading_[i],
+                         sin_heading_[i], half_length_[i], half_width_[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Box2dBatch::DistanceTo(const Box2d &box, double *const distances) const {
+  const QueryBox a(box);
+  const std::size_t num_boxes = size();
+  std::size_t i = 0;
+#ifdef __x86_64__
+  const QueryBoxPair a2(a);
+  for (; i + 1 < num_boxes; i += 2) {
+    const BoxPair b = {
+        _mm_loadu_pd(&center_x_[i]),    _mm_loadu_pd(&center_y_[i]),
+        _mm_loadu_pd(&cos_heading_[i]), _mm_loadu_pd(&sin_heading_[i]),
+        _mm_loadu_pd(&half_length_[i]), _mm_loadu_pd(&half_width_[i])};
+    _mm_storeu_pd(distances + i, math::DistanceTo(a2, b));
+  }
+#endif
+  for (; i < num_boxes; ++i) {
+    distances[i] = math::DistanceTo(a, center_x_[i], center_y_[i],
+                                    cos_heading_[i], sin_heading_[i],
+                                    half_length_[i], half_width_[i]);
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
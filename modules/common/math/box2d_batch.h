@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Defines the Box2dBatch class.
+ */
+
+#ifndef MODULES_COMMON_MATH_BOX2D_BATCH_H_
+#define MODULES_COMMON_MATH_BOX2D_BATCH_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "modules/common/math/box2d.h"
+
+/**
+ * @namespace apollo::common::math
+ * @brief apollo::common::math
+ */
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @class Box2dBatch
+ * @brief A batch of boxes, which a box is checked against all at once.
+ *
+ *        The centers, headings and half sizes of the boxes are stored as
+ *        separate arrays, so the overlap and distance computations are
+ *        vectorized. They use SSE2 on x86_64 and a scalar loop elsewhere,
+ *        and give the same results as Box2d::HasOverlap() and
+ *        Box2d::DistanceTo() up to rounding.
+ */
+class Box2dBatch {
+ public:
+  Box2dBatch() = default;
+
+  /**
+   * @brief Constructor which takes the boxes of the batch.
+   * @param boxes The boxes.
+   */
+  explicit Box2dBatch(const std::vector<Box2d> &boxes);
+
+  /**
+   * @brief Appends a box to the batch.
+   * @param box The box.
+   */
+  void Add(const Box2d &box);
+
+  /**
+   * @brief Removes all the boxes.
+   */
+  void Clear();
+
+  std::size_t size() const { return center_x_.size(); }
+
+  bool empty() const { return center_x_.empty(); }
+
+  /**
+   * @brief Determines whether a box overlaps each of the boxes.
+   * @param box The box to check.
+   * @param overlaps Output of whether it overlaps, one per box of the batch.
+   */
+  void HasOverlap(const Box2d &box, bool *const overlaps) const;
+
+  /**
+   * @brief Determines whether a box overlaps any of the boxes.
+   * @param box The box to check.
+   * @return True if it overlaps one of the boxes.
+   */
+  bool HasOverlap(const Box2d &box) const;
+
+  /**
+   * @brief Compute the shortest distances from a box to each of the boxes,
+   *        which are zero for the overlapping ones.
+   * @param box The box to compute the distances from.
+   * @param distances Output of the distances, one per box of the batch.
+   */
+  void DistanceTo(const Box2d &box, double *const distances) const;
+
+ private:
+  std::vector<double> center_x_;
+  std::vector<double> center_y_;
+  std::vector<double> cos_heading_;
+  std::vector<double> sin_heading_;
+  std::vector<double> half_length_;
+  std::vector<double> half_width_;
+};
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+#endif /* MODULES_COMMON_MATH_BOX2D_BATCH_H_ */
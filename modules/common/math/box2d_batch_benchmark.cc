@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Compares the overlap and distance checks of a box against obstacle
+ *        boxes one by one with Box2d and all at once with Box2dBatch.
+ */
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/box2d_batch.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+constexpr int kNumQueries = 256;
+
+// Vehicle sized boxes around the queries, so that some of them overlap.
+std::vector<Box2d> GenerateBoxes(const int num_boxes, const int seed) {
+  std::mt19937 random_engine(seed);
+  std::uniform_real_distribution<double> position(-30.0, 30.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> length(3.0, 6.0);
+  std::uniform_real_distribution<double> width(1.5, 2.5);
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < num_boxes; ++i) {
+    boxes.emplace_back(Vec2d(position(random_engine), position(random_engine)),
+                       heading(random_engine), length(random_engine),
+                       width(random_engine));
+  }
+  return boxes;
+}
+
+void BM_HasOverlap(benchmark::State &state) {  // NOLINT
+  const auto boxes = GenerateBoxes(state.range(0), 0);
+  const auto queries = GenerateBoxes(kNumQueries, 1);
+  std::vector<char> overlaps(boxes.size());
+  while (state.KeepRunning()) {
+    for (const Box2d &query : queries) {
+      for (std::size_t i = 0; i < boxes.size(); ++i) {
+        overlaps[i] = query.HasOverlap(boxes[i]);
+      }
+      benchmark::DoNotOptimize(overlaps.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries * boxes.size());
+}
+
+void BM_HasOverlapBatch(benchmark::State &state) {  // NOLINT
+  const Box2dBatch batch(GenerateBoxes(state.range(0), 0));
+  const auto queries = GenerateBoxes(kNumQueries, 1);
+  std::vector<char> overlaps(batch.size());
+  while (state.KeepRunning()) {
+    for (const Box2d &query : queries) {
+      batch.HasOverlap(query, reinterpret_cast<bool *>(overlaps.data()));
+      benchmark::DoNotOptimize(overlaps.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries * batch.size());
+}
+
+void BM_DistanceTo(benchmark::State &state) {  // NOLINT
+  const auto boxes = GenerateBoxes(state.range(0), 0);
+  const auto queries = GenerateBoxes(kNumQueries, 1);
+  std::vector<double> distances(boxes.size());
+  while (state.KeepRunning()) {
+    for (const Box2d &query : queries) {
+      for (std::size_t i = 0; i < boxes.size(); ++i) {
+        distances[i] = query.DistanceTo(boxes[i]);
+      }
+      benchmark::DoNotOptimize(distances.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries * boxes.size());
+}
+
+void BM_DistanceToBatch(benchmark::State &state) {  // NOLINT
+  const Box2dBatch batch(GenerateBoxes(state.range(0), 0));
+  const auto queries = GenerateBoxes(kNumQueries, 1);
+  std::vector<double> distances(batch.size());
+  while (state.KeepRunning()) {
+    for (const Box2d &query : queries) {
+      batch.DistanceTo(query, distances.data());
+      benchmark::DoNotOptimize(distances.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries * batch.size());
+}
+
+BENCHMARK(BM_HasOverlap)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_HasOverlapBatch)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_DistanceTo)->Arg(8)->Arg(64)->Arg(512);
+BENCHMARK(BM_DistanceToBatch)->Arg(8)->Arg(64)->Arg(512);
+
+}  // namespace
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_batch.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+Box2d RandomBox(std::mt19937 *random_engine) {
+  std::uniform_real_distribution<double> position(-20.0, 20.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> size(0.5, 10.0);
+  return Box2d({position(*random_engine), position(*random_engine)},
+               heading(*random_engine), size(*random_engine),
+               size(*random_engine));
+}
+
+}  // namespace
+
+TEST(Box2dBatchTest, Empty) {
+  Box2dBatch batch;
+  EXPECT_TRUE(batch.empty());
+  EXPECT_FALSE(batch.HasOverlap(Box2d({0, 0}, 0.0, 1.0, 1.0)));
+  batch.Add(Box2d({0, 0}, 0.0, 4.0, 2.0));
+  EXPECT_EQ(1, batch.size());
+  batch.Clear();
+  EXPECT_TRUE(batch.empty());
+}
+
+TEST(Box2dBatchTest, HasOverlapAndDistance) {
+  const Box2dBatch batch({Box2d({0, 0}, 0.0, 4.0, 2.0),
+                          Box2d({10, 0}, M_PI_4, 2.0, 2.0),
+                          Box2d({0, 10}, 0.0, 2.0, 2.0)});
+  const Box2d box({1.5, 1.5}, 0.0, 1.5, 1.5);
+  bool overlaps[3];
+  batch.HasOverlap(box, overlaps);
+  EXPECT_TRUE(overlaps[0]);
+  EXPECT_FALSE(overlaps[1]);
+  EXPECT_FALSE(overlaps[2]);
+  EXPECT_TRUE(batch.HasOverlap(box));
+  EXPECT_FALSE(batch.HasOverlap(Box2d({5, 5}, 0.0, 1.0, 1.0)));
+
+  double distances[3];
+  batch.DistanceTo(box, distances);
+  EXPECT_DOUBLE_EQ(0.0, distances[0]);
+  EXPECT_NEAR(std::hypot(10.0 - std::sqrt(2.0) - 2.25, 0.75), distances[1],
+              1e-9);
+  EXPECT_NEAR(6.75, distances[2], 1e-9);
+}
+
+TEST(Box2dBatchTest, RandomBoxes) {
+  std::mt19937 random_engine(0);
+  // An odd number of boxes, so the last one is left to the scalar loop.
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < 101; ++i) {
+    boxes.push_back(RandomBox(&random_engine));
+  }
+  const Box2dBatch batch(boxes);
+  std::unique_ptr<bool[]> overlaps(new bool[boxes.size()]);
+  std::vector<double> distances(boxes.size());
+  for (int i = 0; i < 200; ++i) {
+    const Box2d box = RandomBox(&random_engine);
+    batch.HasOverlap(box, overlaps.get());
+    batch.DistanceTo(box, distances.data());
+    bool expected_any = false;
+    for (std::size_t j = 0; j < boxes.size(); ++j) {
+      const bool expected = box.HasOverlap(boxes[j]);
+      EXPECT_EQ(expected, overlaps[j]);
+      EXPECT_NEAR(box.DistanceTo(boxes[j]), distances[j], 1e-9);
+      expected_any = expected_any || expected;
+    }
+    EXPECT_EQ(expected_any, batch.HasOverlap(box));
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_sweep_and_prune.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace apollo {
+namespace common {
+namespace math {
+
+Box2dSweepAndPrune::Box2dSweepAndPrune(std::vector<Box2d> boxes) {
+  if (boxes.empty()) {
+    return;
+  }
+  // Sweeps along the axis on which the boxes spread the most, so that a
+  // query visits few boxes whatever the heading of the road.
+  double min_center_x = boxes.front().center_x();
+  double max_center_x = min_center_x;
+  double min_center_y = boxes.front().center_y();
+  double max_center_y = min_center_y;
+  for (const Box2d &box : boxes) {
+    min_center_x = std::min(min_center_x, box.center_x());
+    max_center_x = std::max(max_center_x, box.center_x());
+    min_center_y = std::min(min_center_y, box.center_y());
+    max_center_y = std::max(max_center_y, box.center_y());
+  }
+  sweep_y_ = max_center_y - min_center_y > max_center_x - min_center_x;
+
+  // Sorts the indices rather than the boxes, which are moved only once.
+  std::vector<std::size_t> order(boxes.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [this, &boxes](const std::size_t i, const std::size_t j) {
+              return MinSweep(boxes[i]) < MinSweep(boxes[j]);
+            });
+  boxes_.reserve(boxes.size());
+  min_sweep_.reserve(boxes.size());
+  max_sweep_.reserve(boxes.size());
+  max_sweep_reach_.reserve(boxes.size());
+  min_cross_.reserve(boxes.size());
+  max_cross_.reserve(boxes.size());
+  for (const std::size_t i : order) {
+    boxes_.push_back(std::move(boxes[i]));
+    const Box2d &box = boxes_.back();
+    min_sweep_.push_back(MinSweep(box));
+    max_sweep_.push_back(MaxSweep(box));
+    max_sweep_reach_.push_back(
+        max_sweep_reach_.empty()
+            ? max_sweep_.back()
+            : std::max(max_sweep_reach_.back(), max_sweep_.back()));
+    min_cross_.push_back(MinCross(box));
+    max_cross_.push_back(MaxCross(box));
+  }
+}
+
+bool Box2dSweepAndPrune::HasOverlap(const Box2d &box) const {
+  const double min_sweep = MinSweep(box);
+  const double max_sweep = MaxSweep(box);
+  const double min_cross = MinCross(box);
+  const double max_cross = MaxCross(box);
+  // The boxes before begin end before the box along the sweep axis, and
+  // the boxes from end start after it.
+  const std::size_t begin =
+      std::lower_bound(max_sweep_reach_.begin(), max_sweep_reach_.end(),
+                       min_sweep) -
+      max_sweep_reach_.begin();
+  const std::size_t end =
+      std::upper_bound(min_sweep_.begin() + begin, min_sweep_.end(),
+                       max_sweep) -
+      min_sweep_.begin();
+  for (std::size_t i = begin; i < end; ++i) {
+    if (max_sweep_[i] < min_sweep || max_cross_[i] < min_cross ||
+        min_cross_[i] > max_cross) {
+      continue;
+    }
+    if (box.HasOverlap(boxes_[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+double Box2dSweepAndPrune::MinSweep(const Box2d &box) const {
+  return sweep_y_ ? box.min_y() : box.min_x();
+}
+
+double Box2dSweepAndPrune::MaxSweep(const Box2d &box) const {
+  return sweep_y_ ? box.max_y() : box.max_x();
+}
+
+double Box2dSweepAndPrune::MinCross(const Box2d &box) const {
+  return sweep_y_ ? box.min_x() : box.min_y();
+}
+
+double Box2dSweepAndPrune::MaxCross(const Box2d &box) const {
+  return sweep_y_ ? box.max_x() : box.max_y();
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
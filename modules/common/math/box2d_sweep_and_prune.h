@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Defines the Box2dSweepAndPrune class.
+ */
+
+#ifndef MODULES_COMMON_MATH_BOX2D_SWEEP_AND_PRUNE_H_
+#define MODULES_COMMON_MATH_BOX2D_SWEEP_AND_PRUNE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "modules/common/math/box2d.h"
+
+/**
+ * @namespace apollo::common::math
+ * @brief apollo::common::math
+ */
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @class Box2dSweepAndPrune
+ * @brief A set of boxes indexed for overlap queries.
+ *
+ *        The boxes are sorted along the sweep axis, x or y, whichever the
+ *        box centers spread the most on, by the lower bound of their
+ *        axis-aligned bounding boxes. The bounding boxes are stored as
+ *        separate arrays per coordinate. A query only visits the boxes
+ *        between the first one which may reach it and the last one which
+ *        starts before its end along the sweep axis, and only runs the
+ *        separating axis test of Box2d::HasOverlap() on the boxes whose
+ *        bounding boxes overlap its own.
+ */
+class Box2dSweepAndPrune {
+ public:
+  Box2dSweepAndPrune() = default;
+
+  /**
+   * @brief Constructor which takes the boxes to index.
+   * @param boxes The boxes, which are reordered.
+   */
+  explicit Box2dSweepAndPrune(std::vector<Box2d> boxes);
+
+  /**
+   * @brief Determines whether a box overlaps any of the boxes.
+   * @param box The box to check.
+   * @return True if it overlaps one of the boxes.
+   */
+  bool HasOverlap(const Box2d &box) const;
+
+  /**
+   * @brief Gets the boxes, sorted by the lower bound of their bounding boxes
+   *        along the sweep axis.
+   * @return The boxes.
+   */
+  const std::vector<Box2d> &boxes() const { return boxes_; }
+
+  std::size_t size() const { return boxes_.size(); }
+
+  bool empty() const { return boxes_.empty(); }
+
+ private:
+  double MinSweep(const Box2d &box) const;
+  double MaxSweep(const Box2d &box) const;
+  double MinCross(const Box2d &box) const;
+  double MaxCross(const Box2d &box) const;
+
+  bool sweep_y_ = false;
+  std::vector<Box2d> boxes_;
+  std::vector<double> min_sweep_;
+  std::vector<double> max_sweep_;
+  // The largest upper bound along the sweep axis of the boxes up to each one.
+  std::vector<double> max_sweep_reach_;
+  std::vector<double> min_cross_;
+  std::vector<double> max_cross_;
+};
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+#endif /* MODULES_COMMON_MATH_BOX2D_SWEEP_AND_PRUNE_H_ */
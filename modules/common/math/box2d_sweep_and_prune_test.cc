@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_sweep_and_prune.h"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+Box2d RandomBox(std::mt19937 *random_engine) {
+  std::uniform_real_distribution<double> position(-50.0, 50.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> size(0.5, 20.0);
+  return Box2d({position(*random_engine), position(*random_engine)},
+               heading(*random_engine), size(*random_engine),
+               size(*random_engine));
+}
+
+}  // namespace
+
+TEST(Box2dSweepAndPruneTest, Empty) {
+  Box2dSweepAndPrune index;
+  EXPECT_TRUE(index.empty());
+  EXPECT_FALSE(index.HasOverlap(Box2d({0, 0}, 0.0, 1.0, 1.0)));
+}
+
+TEST(Box2dSweepAndPruneTest, HasOverlap) {
+  Box2dSweepAndPrune index({Box2d({0, 0}, 0.0, 4.0, 2.0),
+                            Box2d({10, 0}, M_PI_4, 2.0, 2.0)});
+  EXPECT_EQ(2, index.size());
+  EXPECT_DOUBLE_EQ(0.0, index.boxes()[0].center_x());
+  EXPECT_TRUE(index.HasOverlap(Box2d({1.5, 1.5}, 0.0, 1.5, 1.5)));
+  EXPECT_FALSE(index.HasOverlap(Box2d({0, 3}, 0.0, 2.0, 2.0)));
+  EXPECT_TRUE(index.HasOverlap(Box2d({11, 0}, 0.0, 1.0, 1.0)));
+  // Overlaps the bounding box of the second box only.
+  EXPECT_FALSE(index.HasOverlap(Box2d({11.2, 1.2}, 0.0, 0.4, 0.4)));
+  EXPECT_FALSE(index.HasOverlap(Box2d({5, 0}, 0.0, 2.0, 2.0)));
+}
+
+TEST(Box2dSweepAndPruneTest, RandomBoxes) {
+  std::mt19937 random_engine(0);
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < 200; ++i) {
+    boxes.push_back(RandomBox(&random_engine));
+  }
+  const Box2dSweepAndPrune index(boxes);
+  for (int i = 0; i < 1000; ++i) {
+    const Box2d box = RandomBox(&random_engine);
+    bool expected = false;
+    for (const Box2d &other : boxes) {
+      expected = expected || box.HasOverlap(other);
+    }
+    EXPECT_EQ(expected, index.HasOverlap(box));
+  }
+}
+
+TEST(Box2dSweepAndPruneTest, RoadAlongY) {
+  // Boxes along a road heading north, with a long one among them.
+  std::mt19937 random_engine(0);
+  std::uniform_real_distribution<double> s(0.0, 300.0);
+  std::uniform_real_distribution<double> l(-7.0, 7.0);
+  std::uniform_real_distribution<double> heading(-0.2, 0.2);
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < 200; ++i) {
+    boxes.emplace_back(Vec2d(l(random_engine), s(random_engine)),
+                       M_PI_2 + heading(random_engine), 4.5, 2.0);
+  }
+  boxes.emplace_back(Vec2d(0.0, 10.0), M_PI_2, 40.0, 3.0);
+  const Box2dSweepAndPrune index(boxes);
+  for (int i = 0; i < 1000; ++i) {
+    const Box2d box(Vec2d(l(random_engine), s(random_engine)),
+                    M_PI_2 + heading(random_engine), 5.0, 2.1);
+    bool expected = false;
+    for (const Box2d &other : boxes) {
+      expected = expected || box.HasOverlap(other);
+    }
+    EXPECT_EQ(expected, index.HasOverlap(box));
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -224,6 +224,14 @@ TEST(Box2dTest, RotateFromCenterAndShift) {
   EXPECT_NEAR(corners[2].y(), 38.0, 1e-5);
   EXPECT_NEAR(corners[3].x(), 31.0, 1e-5);
   EXPECT_NEAR(corners[3].y(), 38.0, 1e-5);
+  EXPECT_NEAR(box.min_x(), 29.0, 1e-5);
+  EXPECT_NEAR(box.max_x(), 31.0, 1e-5);
+  EXPECT_NEAR(box.min_y(), 38.0, 1e-5);
+  EXPECT_NEAR(box.max_y(), 42.0, 1e-5);
+
+  box.Shift({-60, -80});
+  EXPECT_NEAR(box.max_x(), -29.0, 1e-5);
+  EXPECT_NEAR(box.max_y(), -38.0, 1e-5);
 }
 
 TEST(Box2dTest, TestByRandom) {
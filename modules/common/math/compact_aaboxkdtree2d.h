@@ -0,0 +1,531 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Defines the templated CompactAABoxKDTree2d class.
+ */
+
+#ifndef MODULES_COMMON_MATH_COMPACT_AABOXKDTREE2D_H_
+#define MODULES_COMMON_MATH_COMPACT_AABOXKDTREE2D_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "modules/common/log.h"
+#include "modules/common/math/aabox2d.h"
+#include "modules/common/math/aaboxkdtree2d.h"
+#include "modules/common/math/math_utils.h"
+
+/**
+ * @namespace apollo::common::math
+ * @brief The math namespace deals with a number of useful mathematical objects.
+ */
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @class CompactAABoxKDTree2d
+ * @brief A KD-tree of axis-aligned bounding boxes with the same structure
+ *        and queries as AABoxKDTree2d, stored in a few contiguous arrays
+ *        instead of individually allocated nodes.
+ *
+ *        The tree is built into, or adopted from, the flattened layout of
+ *        AABoxKDTree2dFlatData, whose nodes and objects are in pre-order: the
+ *        left sub-node of a node directly follows it, and the objects of a
+ *        sub-tree are contiguous. For the queries, the node records are
+ *        split into one array per field, and the end of every sub-tree is
+ *        added, so range queries walk the node array forward without a
+ *        stack.
+ */
+template <class ObjectType>
+class CompactAABoxKDTree2d {
+ public:
+  using ObjectPtr = const ObjectType *;
+
+  /**
+   * @brief Contructor which takes a vector of objects and parameters.
+   * @param objects Objects to build the KD-tree. They must outlive the
+   *        KD-tree.
+   * @param params Parameters to build the KD-tree.
+   */
+  CompactAABoxKDTree2d(const std::vector<ObjectType> &objects,
+                       const AABoxKDTreeParams &params) {
+    AABoxKDTree2dFlatData data;
+    if (!objects.empty()) {
+      std::vector<ObjectPtr> object_ptrs;
+      object_ptrs.reserve(objects.size());
+      for (const auto &object : objects) {
+        object_ptrs.push_back(&object);
+      }
+      data.objects_sorted_by_min.reserve(objects.size());
+      data.objects_sorted_by_max.reserve(objects.size());
+      data.objects_sorted_by_min_bound.reserve(objects.size());
+      data.objects_sorted_by_max_bound.reserve(objects.size());
+      std::vector<ObjectPtr> buffer(object_ptrs.size());
+      BuildNode(params, 0, 0, static_cast<int>(object_ptrs.size()),
+                objects.data(), &object_ptrs, &buffer, &data);
+    }
+    Init(objects, data.View());
+  }
+
+  /**
+   * @brief Contructor which takes a flattened KD-tree, such as the one
+   *        written by AABoxKDTree2d::Flatten(). The flattened arrays are
+   *        copied, but the objects must outlive the KD-tree.
+   * @param objects The objects the flattened KD-tree was built on, in the
+   *        same order.
+   * @param flat_view The flattened KD-tree, with nodes in pre-order.
+   */
+  CompactAABoxKDTree2d(const std::vector<ObjectType> &objects,
+                       const AABoxKDTree2dFlatView &flat_view) {
+    CHECK_EQ(flat_view.num_objects, static_cast<int>(objects.size()));
+    Init(objects, flat_view);
+  }
+
+  /**
+   * @brief Get the nearest object to a target point.
+   * @param point The target point. Search it's nearest object.
+   * @return The nearest object to the target point.
+   */
+  ObjectPtr GetNearestObject(const Vec2d &point) const {
+    ObjectPtr nearest_object = nullptr;
+    if (num_nodes() > 0) {
+      double min_distance_sqr = std::numeric_limits<double>::infinity();
+      GetNearestObjectInternal(0, point, &min_distance_sqr, &nearest_object);
+    }
+    return nearest_object;
+  }
+
+  /**
+   * @brief Get objects within a distance to a point.
+   * @param point The center point of the range to search objects.
+   * @param distance The radius of the range to search objects.
+   * @return All objects within the specified distance to the specified point.
+   */
+  std::vector<ObjectPtr> GetObjects(const Vec2d &point,
+                                    const double distance) const {
+    std::vector<ObjectPtr> result_objects;
+    const double distance_sqr = Square(distance);
+    int node = 0;
+    while (node < num_nodes()) {
+      if (LowerDistanceSquareToPoint(node, point) > distance_sqr) {
+        node = subtree_end_[node];
+        continue;
+      }
+      if (UpperDistanceSquareToPoint(node, point) <= distance_sqr) {
+        result_objects.insert(
+            result_objects.end(),
+            objects_by_min_.begin() + objects_begin_[node],
+            objects_by_min_.begin() + objects_begin_[subtree_end_[node]]);
+        node = subtree_end_[node];
+        continue;
+      }
+      GetNodeObjects(node, point, distance, distance_sqr, &result_objects);
+      // The next node in pre-order is the first sub-node, if any, or the
+      // next sub-tree of an ancestor.
+      ++node;
+    }
+    return result_objects;
+  }
+
+  /**
+   * @brief Get the axis-aligned bounding box of the objects.
+   * @return The axis-aligned bounding box of the objects.
+   */
+  AABox2d GetBoundingBox() const {
+    if (num_nodes() == 0) {
+      return AABox2d();
+    }
+    return AABox2d({min_x_[0], min_y_[0]}, {max_x_[0], max_y_[0]});
+  }
+
+  int num_nodes() const { return static_cast<int>(subtree_end_.size()); }
+
+ private:
+  // Builds the sub-tree of objects [begin, end) in the same way as
+  // AABoxKDTree2dNode, and appends it to data like
+  // AABoxKDTree2dNode::Flatten(). The objects are partitioned in place, with
+  // buffer as scratch space, so no vector is allocated per node.
+  static int BuildNode(const AABoxKDTreeParams &params, const int depth,
+                       const int begin, const int end,
+                       const ObjectType *first_object,
+                       std::vector<ObjectPtr> *const objects,
+                       std::vector<ObjectPtr> *const buffer,
+                       AABoxKDTree2dFlatData *const data) {
+    CHECK_LT(begin, end);
+    const int index = static_cast<int>(data->nodes.size());
+    data->nodes.emplace_back();
+
+    AABoxKDTree2dFlatNode node;
+    ComputeBoundary(*objects, begin, end, &node);
+    ComputePartition(&node);
+    if (!SplitToSubNodes(node, params, depth, end - begin)) {
+      InitObjects(*objects, begin, end, first_object, &node, data);
+      data->nodes[index] = node;
+      return index;
+    }
+    // Reorder objects into [left | right | others], keeping their relative
+    // order like AABoxKDTree2dNode::PartitionObjects.
+    const bool partition_x = (node.partition == 1);
+    const double position = node.partition_position;
+    int num_left = 0;
+    for (int i = begin; i < end; ++i) {
+      const AABox2d &aabox = (*objects)[i]->aabox();
+      if ((partition_x ? aabox.max_x() : aabox.max_y()) <= position) {
+        (*buffer)[begin + num_left++] = (*objects)[i];
+      }
+    }
+    int num_right = 0;
+    for (int i = begin; i < end; ++i) {
+      const AABox2d &aabox = (*objects)[i]->aabox();
+      if ((partition_x ? aabox.max_x() : aabox.max_y()) > position &&
+          (partition_x ? aabox.min_x() : aabox.min_y()) >= position) {
+        (*buffer)[begin + num_left + num_right++] = (*objects)[i];
+      }
+    }
+    int num_others = 0;
+    for (int i = begin; i < end; ++i) {
+      const AABox2d &aabox = (*objects)[i]->aabox();
+      if ((partition_x ? aabox.max_x() : aabox.max_y()) > position &&
+          (partition_x ? aabox.min_x() : aabox.min_y()) < position) {
+        (*buffer)[begin + num_left + num_right + num_others++] =
+            (*objects)[i];
+      }
+    }
+    std::copy(buffer->begin() + begin, buffer->begin() + end,
+              objects->begin() + begin);
+
+    const int right_begin = begin + num_left;
+    const int others_begin = right_begin + num_right;
+    InitObjects(*objects, others_begin, end, first_object, &node, data);
+    if (num_left > 0) {
+      node.left_subnode = BuildNode(params, depth + 1, begin, right_begin,
+                                    first_object, objects, buffer, data);
+    }
+    if (num_right > 0) {
+      node.right_subnode = BuildNode(params, depth + 1, right_begin,
+                                     others_begin, first_object, objects,
+                                     buffer, data);
+    }
+    data->nodes[index] = node;
+    return index;
+  }
+
+  static void ComputeBoundary(const std::vector<ObjectPtr> &objects,
+                              const int begin, const int end,
+                              AABoxKDTree2dFlatNode *const node) {
+    double min_x = std::numeric_limits<double>::infinity();
+    double min_y = std::numeric_limits<double>::infinity();
+    double max_x = -std::numeric_limits<double>::infinity();
+    double max_y = -std::numeric_limits<double>::infinity();
+    for (int i = begin; i < end; ++i) {
+      const AABox2d &aabox = objects[i]->aabox();
+      min_x = std::fmin(min_x, aabox.min_x());
+      max_x = std::fmax(max_x, aabox.max_x());
+      min_y = std::fmin(min_y, aabox.min_y());
+      max_y = std::fmax(max_y, aabox.max_y());
+    }
+    CHECK(!std::isinf(max_x) && !std::isinf(max_y) && !std::isinf(min_x) &&
+          !std::isinf(min_y))
+        << "the provided object box size is infinity";
+    node->min_x = min_x;
+    node->max_x = max_x;
+    node->min_y = min_y;
+    node->max_y = max_y;
+    node->mid_x = (min_x + max_x) / 2.0;
+    node->mid_y = (min_y + max_y) / 2.0;
+  }
+
+  static void ComputePartition(AABoxKDTree2dFlatNode *const node) {
+    if (node->max_x - node->min_x >= node->max_y - node->min_y) {
+      node->partition = 1;
+      node->partition_position = node->mid_x;
+    } else {
+      node->partition = 2;
+      node->partition_position = node->mid_y;
+    }
+  }
+
+  static bool SplitToSubNodes(const AABoxKDTree2dFlatNode &node,
+                              const AABoxKDTreeParams &params,
+                              const int depth, const int num_objects) {
+    if (params.max_depth >= 0 && depth >= params.max_depth) {
+      return false;
+    }
+    if (num_objects <= std::max(1, params.max_leaf_size)) {
+      return false;
+    }
+    if (params.max_leaf_dimension >= 0.0 &&
+        std::max(node.max_x - node.min_x, node.max_y - node.min_y) <=
+            params.max_leaf_dimension) {
+      return false;
+    }
+    return true;
+  }
+
+  // Appends the objects [begin, end) held by a node to the object arrays of
+  // data, sorted by their min and max bounds along the partition axis.
+  static void InitObjects(const std::vector<ObjectPtr> &objects,
+                          const int begin, const int end,
+                          const ObjectType *first_object,
+                          AABoxKDTree2dFlatNode *const node,
+                          AABoxKDTree2dFlatData *const data) {
+    const bool partition_x = (node->partition == 1);
+    node->objects_begin =
+        static_cast<int32_t>(data->objects_sorted_by_min.size());
+    node->num_objects = end - begin;
+    auto *sorted_by_min = &data->objects_sorted_by_min;
+    auto *sorted_by_max = &data->objects_sorted_by_max;
+    for (int i = begin; i < end; ++i) {
+      sorted_by_min->push_back(static_cast<int32_t>(objects[i] - first_object));
+      sorted_by_max->push_back(static_cast<int32_t>(objects[i] - first_object));
+    }
+    std::sort(sorted_by_min->begin() + node->objects_begin,
+              sorted_by_min->end(),
+              [first_object, partition_x](const int32_t i1, const int32_t i2) {
+                const AABox2d &aabox1 = first_object[i1].aabox();
+                const AABox2d &aabox2 = first_object[i2].aabox();
+                return partition_x ? aabox1.min_x() < aabox2.min_x()
+                                   : aabox1.min_y() < aabox2.min_y();
+              });
+    std::sort(sorted_by_max->begin() + node->objects_begin,
+              sorted_by_max->end(),
+              [first_object, partition_x](const int32_t i1, const int32_t i2) {
+                const AABox2d &aabox1 = first_object[i1].aabox();
+                const AABox2d &aabox2 = first_object[i2].aabox();
+                return partition_x ? aabox1.max_x() > aabox2.max_x()
+                                   : aabox1.max_y() > aabox2.max_y();
+              });
+    for (int i = node->objects_begin; i < node->objects_begin + end - begin;
+         ++i) {
+      const AABox2d &min_aabox = first_object[(*sorted_by_min)[i]].aabox();
+      data->objects_sorted_by_min_bound.push_back(
+          partition_x ? min_aabox.min_x() : min_aabox.min_y());
+      const AABox2d &max_aabox = first_object[(*sorted_by_max)[i]].aabox();
+      data->objects_sorted_by_max_bound.push_back(
+          partition_x ? max_aabox.max_x() : max_aabox.max_y());
+    }
+  }
+
+  // Splits the node records of a flattened KD-tree into the query arrays.
+  void Init(const std::vector<ObjectType> &objects,
+            const AABoxKDTree2dFlatView &flat_view) {
+    const int num_nodes = flat_view.num_nodes;
+    min_x_.resize(num_nodes);
+    max_x_.resize(num_nodes);
+    min_y_.resize(num_nodes);
+    max_y_.resize(num_nodes);
+    mid_x_.resize(num_nodes);
+    mid_y_.resize(num_nodes);
+    partition_x_.resize(num_nodes);
+    partition_position_.resize(num_nodes);
+    right_subnode_.resize(num_nodes);
+    subtree_end_.resize(num_nodes);
+    objects_begin_.resize(num_nodes + 1);
+    num_objects_.resize(num_nodes);
+    // Sub-trees end where the sub-tree of their last sub-node ends, so the
+    // nodes are visited backward.
+    for (int i = num_nodes - 1; i >= 0; --i) {
+      const AABoxKDTree2dFlatNode &node = flat_view.nodes[i];
+      CHECK(node.left_subnode < 0 || node.left_subnode == i + 1)
+          << "the nodes of the flattened KD-tree are not in pre-order";
+      const int left_end =
+          node.left_subnode < 0 ? i + 1 : subtree_end_[node.left_subnode];
+      CHECK(node.right_subnode < 0 || node.right_subnode == left_end)
+          << "the nodes of the flattened KD-tree are not in pre-order";
+      min_x_[i] = node.min_x;
+      max_x_[i] = node.max_x;
+      min_y_[i] = node.min_y;
+      max_y_[i] = node.max_y;
+      mid_x_[i] = node.mid_x;
+      mid_y_[i] = node.mid_y;
+      partition_x_[i] = (node.partition == 1);
+      partition_position_[i] = node.partition_position;
+      right_subnode_[i] = node.right_subnode;
+      subtree_end_[i] = node.right_subnode < 0
+                            ? left_end
+                            : subtree_end_[node.right_subnode];
+      objects_begin_[i] = node.objects_begin;
+      num_objects_[i] = node.num_objects;
+    }
+    // A sentinel, so the objects of node i's sub-tree always end at
+    // objects_begin_[subtree_end_[i]].
+    objects_begin_[num_nodes] = flat_view.num_objects;
+    for (int i = 0; i < num_nodes; ++i) {
+      CHECK_EQ(objects_begin_[i] + num_objects_[i], objects_begin_[i + 1])
+          << "the objects of the flattened KD-tree are not in pre-order";
+    }
+
+    const ObjectType *first_object = objects.data();
+    const int num_objects = flat_view.num_objects;
+    objects_by_min_.resize(num_objects);
+    objects_by_max_.resize(num_objects);
+    for (int i = 0; i < num_objects; ++i) {
+      objects_by_min_[i] = first_object + flat_view.objects_sorted_by_min[i];
+      objects_by_max_[i] = first_object + flat_view.objects_sorted_by_max[i];
+    }
+    min_bounds_.assign(flat_view.objects_sorted_by_min_bound,
+                       flat_view.objects_sorted_by_min_bound + num_objects);
+    max_bounds_.assign(flat_view.objects_sorted_by_max_bound,
+                       flat_view.objects_sorted_by_max_bound + num_objects);
+  }
+
+  double LowerDistanceSquareToPoint(const int node, const Vec2d &point) const {
+    double dx = 0.0;
+    if (point.x() < min_x_[node]) {
+      dx = min_x_[node] - point.x();
+    } else if (point.x() > max_x_[node]) {
+      dx = point.x() - max_x_[node];
+    }
+    double dy = 0.0;
+    if (point.y() < min_y_[node]) {
+      dy = min_y_[node] - point.y();
+    } else if (point.y() > max_y_[node]) {
+      dy = point.y() - max_y_[node];
+    }
+    return dx * dx + dy * dy;
+  }
+
+  double UpperDistanceSquareToPoint(const int node, const Vec2d &point) const {
+    const double dx = (point.x() > mid_x_[node] ? (point.x() - min_x_[node])
+                                                : (point.x() - max_x_[node]));
+    const double dy = (point.y() > mid_y_[node] ? (point.y() - min_y_[node])
+                                                : (point.y() - max_y_[node]));
+    return dx * dx + dy * dy;
+  }
+
+  int LeftSubnode(const int node) const {
+    const int left_end =
+        right_subnode_[node] >= 0 ? right_subnode_[node] : subtree_end_[node];
+    return node + 1 < left_end ? node + 1 : -1;
+  }
+
+  void GetNodeObjects(const int node, const Vec2d &point,
+                      const double distance, const double distance_sqr,
+                      std::vector<ObjectPtr> *const result_objects) const {
+    const int begin = objects_begin_[node];
+    const int end = begin + num_objects_[node];
+    const double pvalue = (partition_x_[node] ? point.x() : point.y());
+    if (pvalue < partition_position_[node]) {
+      const double limit = pvalue + distance;
+      for (int i = begin; i < end; ++i) {
+        if (min_bounds_[i] > limit) {
+          break;
+        }
+        ObjectPtr object = objects_by_min_[i];
+        if (object->DistanceSquareTo(point) <= distance_sqr) {
+          result_objects->push_back(object);
+        }
+      }
+    } else {
+      const double limit = pvalue - distance;
+      for (int i = begin; i < end; ++i) {
+        if (max_bounds_[i] < limit) {
+          break;
+        }
+        ObjectPtr object = objects_by_max_[i];
+        if (object->DistanceSquareTo(point) <= distance_sqr) {
+          result_objects->push_back(object);
+        }
+      }
+    }
+  }
+
+  void GetNearestObjectInternal(const int node, const Vec2d &point,
+                                double *const min_distance_sqr,
+                                ObjectPtr *const nearest_object) const {
+    if (LowerDistanceSquareToPoint(node, point) >=
+        *min_distance_sqr - kMathEpsilon) {
+      return;
+    }
+    const double pvalue = (partition_x_[node] ? point.x() : point.y());
+    const bool search_left_first = (pvalue < partition_position_[node]);
+    const int left_subnode = LeftSubnode(node);
+    const int right_subnode = right_subnode_[node];
+    const int first_subnode = search_left_first ? left_subnode : right_subnode;
+    const int second_subnode = search_left_first ? right_subnode : left_subnode;
+    if (first_subnode >= 0) {
+      GetNearestObjectInternal(first_subnode, point, min_distance_sqr,
+                               nearest_object);
+    }
+    if (*min_distance_sqr <= kMathEpsilon) {
+      return;
+    }
+
+    const int begin = objects_begin_[node];
+    const int end = begin + num_objects_[node];
+    const std::vector<ObjectPtr> &objects =
+        search_left_first ? objects_by_min_ : objects_by_max_;
+    const std::vector<double> &bounds =
+        search_left_first ? min_bounds_ : max_bounds_;
+    for (int i = begin; i < end; ++i) {
+      const double bound = bounds[i];
+      const bool beyond = search_left_first ? bound > pvalue : bound < pvalue;
+      if (beyond && Square(bound - pvalue) > *min_distance_sqr) {
+        break;
+      }
+      ObjectPtr object = objects[i];
+      const double distance_sqr = object->DistanceSquareTo(point);
+      if (distance_sqr < *min_distance_sqr) {
+        *min_distance_sqr = distance_sqr;
+        *nearest_object = object;
+      }
+    }
+    if (*min_distance_sqr <= kMathEpsilon) {
+      return;
+    }
+    if (second_subnode >= 0) {
+      GetNearestObjectInternal(second_subnode, point, min_distance_sqr,
+                               nearest_object);
+    }
+  }
+
+ private:
+  // Node boundaries, one array per coordinate, indexed by node.
+  std::vector<double> min_x_;
+  std::vector<double> max_x_;
+  std::vector<double> min_y_;
+  std::vector<double> max_y_;
+  std::vector<double> mid_x_;
+  std::vector<double> mid_y_;
+
+  // Node partitions and topology. The left sub-node, if any, is the next
+  // node; right_subnode_ is -1 if there is none.
+  std::vector<uint8_t> partition_x_;
+  std::vector<double> partition_position_;
+  std::vector<int32_t> right_subnode_;
+  std::vector<int32_t> subtree_end_;
+
+  // Objects held by each node, in [objects_begin_, objects_begin_ +
+  // num_objects_) of the object arrays.
+  std::vector<int32_t> objects_begin_;
+  std::vector<int32_t> num_objects_;
+  std::vector<ObjectPtr> objects_by_min_;
+  std::vector<ObjectPtr> objects_by_max_;
+  std::vector<double> min_bounds_;
+  std::vector<double> max_bounds_;
+};
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+#endif /* MODULES_COMMON_MATH_COMPACT_AABOXKDTREE2D_H_ */
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/compact_aaboxkdtree2d.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/math/line_segment2d.h"
+#include "modules/common/math/math_utils.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+class Object {
+ public:
+  Object(const double x1, const double y1, const double x2, const double y2,
+         const int id)
+      : aabox_({x1, y1}, {x2, y2}),
+        line_segment_({x1, y1}, {x2, y2}),
+        id_(id) {}
+  const AABox2d &aabox() const { return aabox_; }
+  double DistanceTo(const Vec2d &point) const {
+    return line_segment_.DistanceTo(point);
+  }
+  double DistanceSquareTo(const Vec2d &point) const {
+    return line_segment_.DistanceSquareTo(point);
+  }
+  int id() const { return id_; }
+
+ private:
+  AABox2d aabox_;
+  LineSegment2d line_segment_;
+  int id_ = 0;
+};
+
+std::vector<int> SortedIds(const std::vector<const Object *> &objects) {
+  std::vector<int> ids;
+  for (const Object *object : objects) {
+    ids.push_back(object->id());
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+}  // namespace
+
+TEST(CompactAABoxKDTree2d, SameAsAABoxKDTree2d) {
+  const int kNumBoxes[4] = {1, 10, 50, 500};
+  const int kNumQueries = 1000;
+  const double kSize = 100;
+  const int kNumTrees = 4;
+  AABoxKDTreeParams kdtree_params[kNumTrees];
+  kdtree_params[1].max_depth = 2;
+  kdtree_params[2].max_leaf_dimension = kSize / 4.0;
+  kdtree_params[3].max_leaf_size = 4;
+
+  for (int num_boxes : kNumBoxes) {
+    std::vector<Object> objects;
+    for (int i = 0; i < num_boxes; ++i) {
+      const double cx = RandomDouble(-kSize, kSize);
+      const double cy = RandomDouble(-kSize, kSize);
+      const double dx = RandomDouble(-kSize / 10.0, kSize / 10.0);
+      const double dy = RandomDouble(-kSize / 10.0, kSize / 10.0);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    for (int k = 0; k < kNumTrees; ++k) {
+      const AABoxKDTree2d<Object> kdtree(objects, kdtree_params[k]);
+      const CompactAABoxKDTree2d<Object> compact_kdtree(objects,
+                                                        kdtree_params[k]);
+      const AABox2d box = kdtree.GetBoundingBox();
+      const AABox2d compact_box = compact_kdtree.GetBoundingBox();
+      EXPECT_DOUBLE_EQ(box.min_x(), compact_box.min_x());
+      EXPECT_DOUBLE_EQ(box.max_x(), compact_box.max_x());
+      EXPECT_DOUBLE_EQ(box.min_y(), compact_box.min_y());
+      EXPECT_DOUBLE_EQ(box.max_y(), compact_box.max_y());
+
+      for (int i = 0; i < kNumQueries; ++i) {
+        const Vec2d point(RandomDouble(-kSize * 1.5, kSize * 1.5),
+                          RandomDouble(-kSize * 1.5, kSize * 1.5));
+        const Object *nearest_object = kdtree.GetNearestObject(point);
+        const Object *compact_nearest_object =
+            compact_kdtree.GetNearestObject(point);
+        ASSERT_NE(compact_nearest_object, nullptr);
+        EXPECT_NEAR(compact_nearest_object->DistanceTo(point),
+                    nearest_object->DistanceTo(point), 1e-6);
+
+        const double distance = RandomDouble(0, kSize);
+        EXPECT_EQ(SortedIds(compact_kdtree.GetObjects(point, distance)),
+                  SortedIds(kdtree.GetObjects(point, distance)));
+      }
+    }
+  }
+}
+
+TEST(CompactAABoxKDTree2d, FromFlatView) {
+  const int kNumBoxes = 500;
+  const int kNumQueries = 1000;
+  const double kSize = 100;
+  std::vector<Object> objects;
+  for (int i = 0; i < kNumBoxes; ++i) {
+    const double cx = RandomDouble(-kSize, kSize);
+    const double cy = RandomDouble(-kSize, kSize);
+    const double dx = RandomDouble(-kSize / 10.0, kSize / 10.0);
+    const double dy = RandomDouble(-kSize / 10.0, kSize / 10.0);
+    objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+  }
+  AABoxKDTreeParams params;
+  params.max_leaf_size = 4;
+  const AABoxKDTree2d<Object> kdtree(objects, params);
+  AABoxKDTree2dFlatData flat_data;
+  kdtree.Flatten(&flat_data);
+  const CompactAABoxKDTree2d<Object> compact_kdtree(objects,
+                                                    flat_data.View());
+  EXPECT_EQ(compact_kdtree.num_nodes(),
+            static_cast<int>(flat_data.nodes.size()));
+
+  for (int i = 0; i < kNumQueries; ++i) {
+    const Vec2d point(RandomDouble(-kSize * 1.5, kSize * 1.5),
+                      RandomDouble(-kSize * 1.5, kSize * 1.5));
+    EXPECT_EQ(compact_kdtree.GetNearestObject(point),
+              kdtree.GetNearestObject(point));
+    const double distance = RandomDouble(0, kSize);
+    EXPECT_EQ(SortedIds(compact_kdtree.GetObjects(point, distance)),
+              SortedIds(kdtree.GetObjects(point, distance)));
+  }
+}
+
+TEST(CompactAABoxKDTree2d, Empty) {
+  const std::vector<Object> objects;
+  const CompactAABoxKDTree2d<Object> kdtree(objects, AABoxKDTreeParams());
+  EXPECT_EQ(kdtree.num_nodes(), 0);
+  EXPECT_EQ(kdtree.GetNearestObject({0.0, 0.0}), nullptr);
+  EXPECT_TRUE(kdtree.GetObjects({0.0, 0.0}, 100.0).empty());
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -20,6 +20,10 @@
 #include <cmath>
 #include <utility>
 
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
+
 #include "modules/common/log.h"
 #include "modules/common/util/string_util.h"
 
@@ -110,6 +114,68 @@ double LineSegment2d::DistanceSquareTo(const Vec2d &point) const {
   return Square(x0 * unit_direction_.y() - y0 * unit_direction_.x());
 }
 
+void LineSegment2d::DistanceSquareTo(const double *xs, const double *ys,
+                                     const int num_points,
+                                     double *const distance_sqrs) const {
+  // Same as the single point version, but the three cases are selected by
+  // masks instead of branches. A degenerated segment has a zero unit
+  // direction, so every projection is zero and the distance to the start
+  // point is taken.
+  const double start_x = start_.x();
+  const double start_y = start_.y();
+  const double end_x = end_.x();
+  const double end_y = end_.y();
+  const double unit_x = unit_direction_.x();
+  const double unit_y = unit_direction_.y();
+  int i = 0;
+#ifdef __x86_64__
+  const __m128d start_x2 = _mm_set1_pd(start_x);
+  const __m128d start_y2 = _mm_set1_pd(start_y);
+  const __m128d end_x2 = _mm_set1_pd(end_x);
+  const __m128d end_y2 = _mm_set1_pd(end_y);
+  const __m128d unit_x2 = _mm_set1_pd(unit_x);
+  const __m128d unit_y2 = _mm_set1_pd(unit_y);
+  const __m128d length2 = _mm_set1_pd(length_);
+  const __m128d zero2 = _mm_setzero_pd();
+  for (; i + 1 < num_points; i += 2) {
+    const __m128d x = _mm_loadu_pd(xs + i);
+    const __m128d y = _mm_loadu_pd(ys + i);
+    const __m128d x0 = _mm_sub_pd(x, start_x2);
+    const __m128d y0 = _mm_sub_pd(y, start_y2);
+    const __m128d x1 = _mm_sub_pd(x, end_x2);
+    const __m128d y1 = _mm_sub_pd(y, end_y2);
+    const __m128d proj =
+        _mm_add_pd(_mm_mul_pd(x0, unit_x2), _mm_mul_pd(y0, unit_y2));
+    const __m128d cross =
+        _mm_sub_pd(_mm_mul_pd(x0, unit_y2), _mm_mul_pd(y0, unit_x2));
+    const __m128d to_start =
+        _mm_add_pd(_mm_mul_pd(x0, x0), _mm_mul_pd(y0, y0));
+    const __m128d to_end = _mm_add_pd(_mm_mul_pd(x1, x1), _mm_mul_pd(y1, y1));
+    const __m128d to_line = _mm_mul_pd(cross, cross);
+    const __m128d before_start = _mm_cmple_pd(proj, zero2);
+    const __m128d after_end = _mm_cmpge_pd(proj, length2);
+    const __m128d beyond_start_or_end =
+        _mm_or_pd(_mm_and_pd(after_end, to_end),
+                  _mm_andnot_pd(after_end, to_line));
+    _mm_storeu_pd(distance_sqrs + i,
+                  _mm_or_pd(_mm_and_pd(before_start, to_start),
+                            _mm_andnot_pd(before_start, beyond_start_or_end)));
+  }
+#endif
+  for (; i < num_points; ++i) {
+    const double x0 = xs[i] - start_x;
+    const double y0 = ys[i] - start_y;
+    const double x1 = xs[i] - end_x;
+    const double y1 = ys[i] - end_y;
+    const double proj = x0 * unit_x + y0 * unit_y;
+    const double cross = x0 * unit_y - y0 * unit_x;
+    distance_sqrs[i] = proj <= 0.0
+                           ? x0 * x0 + y0 * y0
+                           : (proj >= length_ ? x1 * x1 + y1 * y1
+                                              : cross * cross);
+  }
+}
+
 double LineSegment2d::DistanceSquareTo(const Vec2d &point,
                                        Vec2d *const nearest_pt) const {
   CHECK_NOTNULL(nearest_pt);
@@ -145,6 +145,19 @@ class LineSegment2d {
    */
   double DistanceSquareTo(const Vec2d &point, Vec2d *const nearest_pt) const;
 
+  /**
+   * @brief Compute the squares of the shortest distances from the line
+   *        segment to a batch of points in 2-D. The points are passed as
+   *        separate coordinate arrays, so the computation is vectorized.
+   * @param xs The x coordinates of the points.
+   * @param ys The y coordinates of the points.
+   * @param num_points The number of points.
+   * @param distance_sqrs Output of the squared distances, one per point.
+   */
+  void DistanceSquareTo(const double *xs, const double *ys,
+                        const int num_points,
+                        double *const distance_sqrs) const;
+
   /**
    * @brief Check if a point is within the line segment.
    * @param point The point to check if it is within the line segment.
@@ -17,6 +17,7 @@
 #include "modules/common/math/line_segment2d.h"
 
 #include <cmath>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -116,6 +117,20 @@ TEST(LineSegment2dTest, IsPointIn) {
   EXPECT_FALSE(ls.IsPointIn({6, 6}));
 }
 
+TEST(LineSegment2dTest, BatchDistanceSquareTo) {
+  const LineSegment2d segments[] = {{{1, 2}, {5, 4}}, {{1, 1}, {1, 1}}};
+  const std::vector<double> xs = {1, 5, 3, -1, 7, 0, 6, 3, 2.5};
+  const std::vector<double> ys = {2, 4, 3, 1, 5, 0, 6, -1, 7};
+  std::vector<double> distance_sqrs(xs.size());
+  for (const auto &ls : segments) {
+    ls.DistanceSquareTo(xs.data(), ys.data(), xs.size(), distance_sqrs.data());
+    for (size_t i = 0; i < xs.size(); ++i) {
+      EXPECT_NEAR(ls.DistanceSquareTo({xs[i], ys[i]}), distance_sqrs[i],
+                  1e-9);
+    }
+  }
+}
+
 }  // namespace math
 }  // namespace common
 }  // namespace apollo
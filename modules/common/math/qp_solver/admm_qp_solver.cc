@@ -0,0 +1,497 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/common/math/qp_solver/admm_qp_solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "modules/common/log.h"
+#include "modules/common/math/qp_solver/qp_solver_gflags.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+using Eigen::SparseMatrix;
+using Eigen::VectorXd;
+
+// Scaling factors and step sizes are kept in these ranges.
+constexpr double kMinScaling = 1e-4;
+constexpr double kMaxScaling = 1e4;
+constexpr double kMinRho = 1e-6;
+constexpr double kMaxRho = 1e6;
+// Equality constraints get a larger step size.
+constexpr double kEqualityRhoScale = 1e3;
+constexpr double kEqualityTolerance = 1e-4;
+// Residuals are checked every kCheckInterval iterations, and the step size
+// is updated every kRhoUpdateInterval iterations if it is off by more than
+// kRhoUpdateRatio.
+constexpr int kCheckInterval = 10;
+constexpr int kRhoUpdateInterval = 50;
+constexpr double kRhoUpdateRatio = 5.0;
+// Polishing is tried every kPolishInterval iterations, with the KKT system
+// regularized by kPolishDelta and refined kPolishRefinement times, and the
+// guessed active set corrected at most kMaxPolishSteps times.
+constexpr int kPolishInterval = 50;
+constexpr int kMaxPolishSteps = 10;
+constexpr double kPolishDelta = 1e-7;
+constexpr int kPolishRefinement = 3;
+
+double InfNorm(const VectorXd& v) {
+  return v.size() == 0 ? 0.0 : v.lpNorm<Eigen::Infinity>();
+}
+
+// Infinity norms of the columns of m, which are accumulated into norms.
+void ColumnInfNorms(const SparseMatrix<double>& m, VectorXd* norms) {
+  for (int c = 0; c < m.outerSize(); ++c) {
+    for (SparseMatrix<double>::InnerIterator it(m, c); it; ++it) {
+      (*norms)(c) = std::max((*norms)(c), std::fabs(it.value()));
+    }
+  }
+}
+
+VectorXd RowInfNorms(const SparseMatrix<double>& m) {
+  VectorXd norms = VectorXd::Zero(m.rows());
+  for (int c = 0; c < m.outerSize(); ++c) {
+    for (SparseMatrix<double>::InnerIterator it(m, c); it; ++it) {
+      norms(it.row()) = std::max(norms(it.row()), std::fabs(it.value()));
+    }
+  }
+  return norms;
+}
+
+// Turns norms into the scaling factors which equilibrate them.
+VectorXd ScalingFactors(const VectorXd& norms) {
+  VectorXd factors(norms.size());
+  for (int i = 0; i < norms.size(); ++i) {
+    factors(i) = norms(i) < kMinScaling
+                     ? 1.0
+                     : 1.0 / std::sqrt(std::min(norms(i), kMaxScaling));
+  }
+  return factors;
+}
+
+}  // namespace
+
+bool AdmmQpSolver::SolveAffine(
+    const Eigen::MatrixXd& kernel_matrix, const Eigen::MatrixXd& offset,
+    const Eigen::MatrixXd& affine_inequality_matrix,
+    const Eigen::MatrixXd& affine_inequality_boundary,
+    const Eigen::MatrixXd& affine_equality_matrix,
+    const Eigen::MatrixXd& affine_equality_boundary,
+    const double variable_lower_bound, const double variable_upper_bound,
+    const double inequality_upper_bound) {
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  const int n = kernel_matrix.rows();
+  const int num_equality = affine_equality_matrix.rows();
+  const int num_inequality = affine_inequality_matrix.rows();
+  const int num_variable_bound =
+      variable_lower_bound > -kInfinity || variable_upper_bound < kInfinity
+          ? n
+          : 0;
+  const int m = num_equality + num_inequality + num_variable_bound;
+  if ((num_equality > 0 && affine_equality_matrix.cols() != n) ||
+      (num_inequality > 0 && affine_inequality_matrix.cols() != n) ||
+      affine_equality_boundary.rows() != num_equality ||
+      affine_inequality_boundary.rows() != num_inequality) {
+    AERROR << "Inconsistent QP dimensions: " << n << " variables, equality "
+           << affine_equality_matrix.rows() << "x"
+           << affine_equality_matrix.cols() << ", inequality "
+           << affine_inequality_matrix.rows() << "x"
+           << affine_inequality_matrix.cols();
+    return false;
+  }
+
+  // Rows of the equality, inequality, and variable bound constraints.
+  std::vector<Eigen::Triplet<double>> triplets;
+  VectorXd lower_bound(m);
+  VectorXd upper_bound(m);
+  for (int r = 0; r < num_equality; ++r) {
+    for (int c = 0; c < n; ++c) {
+      if (affine_equality_matrix(r, c) != 0.0) {
+        triplets.emplace_back(r, c, affine_equality_matrix(r, c));
+      }
+    }
+    lower_bound(r) = affine_equality_boundary(r, 0);
+    upper_bound(r) = affine_equality_boundary(r, 0);
+  }
+  for (int r = 0; r < num_inequality; ++r) {
+    const int row = num_equality + r;
+    for (int c = 0; c < n; ++c) {
+      if (affine_inequality_matrix(r, c) != 0.0) {
+        triplets.emplace_back(row, c, affine_inequality_matrix(r, c));
+      }
+    }
+    lower_bound(row) = affine_inequality_boundary(r, 0);
+    upper_bound(row) = inequality_upper_bound;
+  }
+  for (int i = 0; i < num_variable_bound; ++i) {
+    const int row = num_equality + num_inequality + i;
+    triplets.emplace_back(row, i, 1.0);
+    lower_bound(row) = variable_lower_bound;
+    upper_bound(row) = variable_upper_bound;
+  }
+  SparseMatrix<double> constraint_matrix(m, n);
+  constraint_matrix.setFromTriplets(triplets.begin(), triplets.end());
+
+  return Solve(kernel_matrix.sparseView(), offset.col(0), constraint_matrix,
+               lower_bound, upper_bound);
+}
+
+void AdmmQpSolver::Reset() {
+  x_.resize(0);
+  z_.resize(0);
+  y_.resize(0);
+  rho_ = 0.0;
+}
+
+void AdmmQpSolver::ScaleProblem(
+    const SparseMatrix<double>& kernel_matrix, const VectorXd& offset,
+    const SparseMatrix<double>& constraint_matrix,
+    const VectorXd& lower_bound, const VectorXd& upper_bound) {
+  const int n = kernel_matrix.rows();
+  const int m = constraint_matrix.rows();
+  scaled_kernel_ = kernel_matrix;
+  scaled_offset_ = offset;
+  scaled_constraint_ = constraint_matrix;
+  d_ = VectorXd::Ones(n);
+  e_ = VectorXd::Ones(m);
+
+  for (int i = 0; i < FLAGS_default_admm_scaling_iteration; ++i) {
+    VectorXd column_norms = VectorXd::Zero(n);
+    ColumnInfNorms(scaled_kernel_, &column_norms);
+    ColumnInfNorms(scaled_constraint_, &column_norms);
+    const VectorXd d = ScalingFactors(column_norms);
+    const VectorXd e = ScalingFactors(RowInfNorms(scaled_constraint_));
+    scaled_kernel_ = d.asDiagonal() * scaled_kernel_ * d.asDiagonal();
+    scaled_constraint_ = e.asDiagonal() * scaled_constraint_ * d.asDiagonal();
+    scaled_offset_ = scaled_offset_.cwiseProduct(d);
+    d_ = d_.cwiseProduct(d);
+    e_ = e_.cwiseProduct(e);
+  }
+
+  VectorXd kernel_norms = VectorXd::Zero(n);
+  ColumnInfNorms(scaled_kernel_, &kernel_norms);
+  const double cost_norm =
+      std::max(n == 0 ? 0.0 : kernel_norms.mean(), InfNorm(scaled_offset_));
+  c_ = cost_norm < kMinScaling ? 1.0
+                               : 1.0 / std::min(cost_norm, kMaxScaling);
+  scaled_kernel_ *= c_;
+  scaled_offset_ *= c_;
+
+  scaled_constraint_transpose_ = scaled_constraint_.transpose();
+  scaled_lower_bound_ = lower_bound.cwiseProduct(e_);
+  scaled_upper_bound_ = upper_bound.cwiseProduct(e_);
+}
+
+void AdmmQpSolver::UpdateRho(const VectorXd& lower_bound,
+                             const VectorXd& upper_bound) {
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  rho_vector_.resize(lower_bound.size());
+  for (int i = 0; i < lower_bound.size(); ++i) {
+    if (lower_bound(i) == -kInfinity && upper_bound(i) == kInfinity) {
+      rho_vector_(i) = kMinRho;
+    } else if (upper_bound(i) - lower_bound(i) < kEqualityTolerance) {
+      rho_vector_(i) = kEqualityRhoScale * rho_;
+    } else {
+      rho_vector_(i) = rho_;
+    }
+  }
+}
+
+bool AdmmQpSolver::Factorize() {
+  const int n = scaled_kernel_.rows();
+  SparseMatrix<double> identity(n, n);
+  identity.setIdentity();
+  const SparseMatrix<double> system =
+      scaled_kernel_ + FLAGS_default_admm_sigma * identity +
+      SparseMatrix<double>(scaled_constraint_transpose_ *
+                           rho_vector_.asDiagonal() * scaled_constraint_);
+  linear_solver_.compute(system);
+  if (linear_solver_.info() != Eigen::Success) {
+    AERROR << "Failed to factorize the ADMM linear system.";
+    return false;
+  }
+  return true;
+}
+
+bool AdmmQpSolver::IsSolved(const VectorXd& x, const VectorXd& z,
+                            const VectorXd& y) const {
+  // Residuals of the unscaled problem.
+  const VectorXd ax = scaled_constraint_ * x;
+  const VectorXd px = scaled_kernel_ * x;
+  const VectorXd aty = scaled_constraint_transpose_ * y;
+  const VectorXd d_inverse = d_.cwiseInverse();
+  const VectorXd e_inverse = e_.cwiseInverse();
+  const double primal_residual = InfNorm((ax - z).cwiseProduct(e_inverse));
+  const double primal_scale = std::max(InfNorm(ax.cwiseProduct(e_inverse)),
+                                       InfNorm(z.cwiseProduct(e_inverse)));
+  const double dual_residual =
+      InfNorm((px + scaled_offset_ + aty).cwiseProduct(d_inverse)) / c_;
+  const double dual_scale =
+      std::max({InfNorm(px.cwiseProduct(d_inverse)),
+                InfNorm(aty.cwiseProduct(d_inverse)),
+                InfNorm(scaled_offset_.cwiseProduct(d_inverse))}) /
+      c_;
+  const double eps_abs = FLAGS_default_admm_eps_abs;
+  const double eps_rel = FLAGS_default_admm_eps_rel;
+  return primal_residual <= eps_abs + eps_rel * primal_scale &&
+         dual_residual <= eps_abs + eps_rel * dual_scale;
+}
+
+bool AdmmQpSolver::Polish(VectorXd* x, VectorXd* z, VectorXd* y) const {
+  const int n = scaled_kernel_.rows();
+  const int m = scaled_constraint_.rows();
+  // The bound each constraint is active at, -1 for the lower one, 1 for the
+  // upper one and 0 if inactive, guessed from the signs of the duals.
+  std::vector<int> active(m, 0);
+  std::vector<bool> is_equality(m, false);
+  for (int i = 0; i < m; ++i) {
+    is_equality[i] =
+        scaled_upper_bound_(i) - scaled_lower_bound_(i) < kEqualityTolerance;
+    if ((*z)(i) - scaled_lower_bound_(i) < -(*y)(i)) {
+      active[i] = -1;
+    } else if (scaled_upper_bound_(i) - (*z)(i) < (*y)(i)) {
+      active[i] = 1;
+    } else if (is_equality[i]) {
+      active[i] = -1;
+    }
+  }
+
+  VectorXd polished_x;
+  VectorXd polished_y;
+  for (int step = 0; step < kMaxPolishSteps; ++step) {
+    std::vector<int> active_index(m, -1);
+    std::vector<int> active_rows;
+    for (int i = 0; i < m; ++i) {
+      if (active[i] != 0) {
+        active_index[i] = static_cast<int>(active_rows.size());
+        active_rows.push_back(i);
+      }
+    }
+    const int num_active = static_cast<int>(active_rows.size());
+
+    // Solves [P, A_active^T; A_active, 0] * [x; y_active] = [-q; b_active],
+    // regularized to be quasi-definite and refined against the exact system.
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int c = 0; c < n; ++c) {
+      for (SparseMatrix<double>::InnerIterator it(scaled_kernel_, c); it;
+           ++it) {
+        triplets.emplace_back(it.row(), c, it.value());
+      }
+      for (SparseMatrix<double>::InnerIterator it(scaled_constraint_, c); it;
+           ++it) {
+        const int row = active_index[it.row()];
+        if (row >= 0) {
+          triplets.emplace_back(n + row, c, it.value());
+          triplets.emplace_back(c, n + row, it.value());
+        }
+      }
+    }
+    SparseMatrix<double> kkt(n + num_active, n + num_active);
+    kkt.setFromTriplets(triplets.begin(), triplets.end());
+    SparseMatrix<double> regularization(n + num_active, n + num_active);
+    VectorXd rhs(n + num_active);
+    rhs.head(n) = -scaled_offset_;
+    for (int i = 0; i < n + num_active; ++i) {
+      regularization.insert(i, i) = i < n ? kPolishDelta : -kPolishDelta;
+    }
+    for (int i = 0; i < num_active; ++i) {
+      const int row = active_rows[i];
+      rhs(n + i) = active[row] < 0 ? scaled_lower_bound_(row)
+                                   : scaled_upper_bound_(row);
+    }
+    Eigen::SimplicialLDLT<SparseMatrix<double>> kkt_solver(kkt +
+                                                           regularization);
+    if (kkt_solver.info() != Eigen::Success) {
+      return false;
+    }
+    VectorXd solution = kkt_solver.solve(rhs);
+    for (int i = 0; i < kPolishRefinement; ++i) {
+      solution += kkt_solver.solve(rhs - kkt * solution);
+    }
+    if (!solution.allFinite()) {
+      return false;
+    }
+    polished_x = solution.head(n);
+    polished_y = VectorXd::Zero(m);
+    for (int i = 0; i < num_active; ++i) {
+      polished_y(active_rows[i]) = solution(n + i);
+    }
+
+    // Releases the inequality constraints pulled away from their bounds, and
+    // activates the violated ones.
+    const VectorXd ax = scaled_constraint_ * polished_x;
+    bool changed = false;
+    for (int i = 0; i < m; ++i) {
+      if (is_equality[i]) {
+        continue;
+      }
+      if (active[i] * polished_y(i) < 0.0) {
+        active[i] = 0;
+        changed = true;
+      } else if (active[i] == 0 &&
+                 (scaled_lower_bound_(i) - ax(i)) / e_(i) >
+                     FLAGS_default_admm_eps_abs) {
+        active[i] = -1;
+        changed = true;
+      } else if (active[i] == 0 &&
+                 (ax(i) - scaled_upper_bound_(i)) / e_(i) >
+                     FLAGS_default_admm_eps_abs) {
+        active[i] = 1;
+        changed = true;
+      }
+    }
+    if (!changed) {
+      break;
+    }
+  }
+
+  const VectorXd polished_z = (scaled_constraint_ * polished_x)
+                                  .cwiseMax(scaled_lower_bound_)
+                                  .cwiseMin(scaled_upper_bound_);
+  for (int i = 0; i < m; ++i) {
+    if (!is_equality[i] && active[i] * polished_y(i) < 0.0) {
+      return false;
+    }
+  }
+  if (!IsSolved(polished_x, polished_z, polished_y)) {
+    return false;
+  }
+  *x = std::move(polished_x);
+  *z = polished_z;
+  *y = std::move(polished_y);
+  return true;
+}
+
+bool AdmmQpSolver::Solve(const SparseMatrix<double>& kernel_matrix,
+                         const VectorXd& offset,
+                         const SparseMatrix<double>& constraint_matrix,
+                         const VectorXd& lower_bound,
+                         const VectorXd& upper_bound) {
+  const int n = kernel_matrix.rows();
+  const int m = constraint_matrix.rows();
+  if (kernel_matrix.cols() != n || offset.size() != n ||
+      (m > 0 && constraint_matrix.cols() != n) || lower_bound.size() != m ||
+      upper_bound.size() != m) {
+    AERROR << "Inconsistent QP dimensions: kernel " << kernel_matrix.rows()
+           << "x" << kernel_matrix.cols() << ", offset " << offset.size()
+           << ", constraint " << constraint_matrix.rows() << "x"
+           << constraint_matrix.cols() << ", bounds " << lower_bound.size()
+           << " and " << upper_bound.size();
+    return false;
+  }
+
+  ScaleProblem(kernel_matrix, offset, constraint_matrix, lower_bound,
+               upper_bound);
+
+  // Warm start from the previous solution of a problem of the same size.
+  VectorXd x = VectorXd::Zero(n);
+  VectorXd z = VectorXd::Zero(m);
+  VectorXd y = VectorXd::Zero(m);
+  if (x_.size() == n && z_.size() == m && rho_ > 0.0) {
+    x = x_.cwiseQuotient(d_);
+    z = z_.cwiseProduct(e_);
+    y = c_ * y_.cwiseQuotient(e_);
+  } else {
+    rho_ = FLAGS_default_admm_rho;
+  }
+  UpdateRho(scaled_lower_bound_, scaled_upper_bound_);
+  if (!Factorize()) {
+    return false;
+  }
+
+  const double sigma = FLAGS_default_admm_sigma;
+  const double alpha = FLAGS_default_admm_alpha;
+  bool converged = false;
+  num_iterations_ = 0;
+  while (num_iterations_ < FLAGS_default_admm_max_iteration) {
+    ++num_iterations_;
+    const VectorXd rhs =
+        sigma * x - scaled_offset_ +
+        scaled_constraint_transpose_ * (rho_vector_.cwiseProduct(z) - y);
+    const VectorXd x_tilde = linear_solver_.solve(rhs);
+    const VectorXd z_relaxed =
+        alpha * (scaled_constraint_ * x_tilde) + (1.0 - alpha) * z;
+    x = alpha * x_tilde + (1.0 - alpha) * x;
+    const VectorXd z_next =
+        (z_relaxed + y.cwiseQuotient(rho_vector_))
+            .cwiseMax(scaled_lower_bound_)
+            .cwiseMin(scaled_upper_bound_);
+    y += rho_vector_.cwiseProduct(z_relaxed - z_next);
+    z = z_next;
+
+    if (num_iterations_ % kCheckInterval != 0) {
+      continue;
+    }
+    if (IsSolved(x, z, y)) {
+      converged = true;
+      break;
+    }
+    if (num_iterations_ % kPolishInterval == 0 && Polish(&x, &z, &y)) {
+      converged = true;
+      break;
+    }
+
+    if (num_iterations_ % kRhoUpdateInterval != 0) {
+      continue;
+    }
+    // Balances the residuals of the scaled problem.
+    const VectorXd ax = scaled_constraint_ * x;
+    const VectorXd px = scaled_kernel_ * x;
+    const VectorXd aty = scaled_constraint_transpose_ * y;
+    const double scaled_primal =
+        InfNorm(ax - z) / std::max(std::max(InfNorm(ax), InfNorm(z)), 1e-10);
+    const double scaled_dual =
+        InfNorm(px + scaled_offset_ + aty) /
+        std::max({InfNorm(px), InfNorm(aty), InfNorm(scaled_offset_), 1e-10});
+    const double ratio =
+        std::sqrt(scaled_primal / std::max(scaled_dual, 1e-10));
+    if (ratio > kRhoUpdateRatio || ratio < 1.0 / kRhoUpdateRatio) {
+      rho_ = std::min(std::max(rho_ * ratio, kMinRho), kMaxRho);
+      UpdateRho(scaled_lower_bound_, scaled_upper_bound_);
+      if (!Factorize()) {
+        return false;
+      }
+    }
+  }
+
+  if (!converged) {
+    AERROR << "ADMM QP solver did not converge in " << num_iterations_
+           << " iterations.";
+    return false;
+  }
+  // Only a converged solution warm starts the next problem.
+  x_ = x.cwiseProduct(d_);
+  z_ = z.cwiseQuotient(e_);
+  y_ = y.cwiseProduct(e_) / c_;
+  ADEBUG << "ADMM QP solver converged in " << num_iterations_
+         << " iterations.";
+  return true;
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
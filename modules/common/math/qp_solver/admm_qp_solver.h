@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file: admm_qp_solver.h
+ * @brief: sparse quadratic programming solver based on ADMM
+ *
+ *        min_x  : q(x) = 0.5 * x^T * P * x  + x^T q
+ *        with respect to:  l <= A * x <= u
+ *
+ *        Equality constraints are rows with l == u. The matrices are sparse,
+ *        and each iteration solves a linear system whose factorization is
+ *        reused until the step size changes, so banded problems such as
+ *        smoothing splines are solved in about linear time in their size.
+ **/
+
+#ifndef MODULES_COMMON_MATH_QP_SOLVER_ADMM_QP_SOLVER_H_
+#define MODULES_COMMON_MATH_QP_SOLVER_ADMM_QP_SOLVER_H_
+
+#include <limits>
+
+#include "Eigen/Core"
+#include "Eigen/SparseCholesky"
+#include "Eigen/SparseCore"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+class AdmmQpSolver {
+ public:
+  AdmmQpSolver() = default;
+
+  /**
+   * @brief solves the problem. It is warm started from the previous solution
+   * if the problem has the same size. The solution is kept only if it has
+   * converged.
+   * @param kernel_matrix P, symmetric positive semi-definite.
+   * @param offset q.
+   * @param constraint_matrix A.
+   * @param lower_bound l, may be -infinity.
+   * @param upper_bound u, may be infinity.
+   * @return true if the solution has converged.
+   */
+  bool Solve(const Eigen::SparseMatrix<double>& kernel_matrix,
+             const Eigen::VectorXd& offset,
+             const Eigen::SparseMatrix<double>& constraint_matrix,
+             const Eigen::VectorXd& lower_bound,
+             const Eigen::VectorXd& upper_bound);
+
+  /**
+   * @brief solves the problem in the form of QpSolver, with all the
+   * variables in [variable_lower_bound, variable_upper_bound]:
+   *        min_x  : q(x) = 0.5 * x^T * Q * x  + x^T c
+   *        with respect to:  A * x = b (equality constraint)
+   *                          d <= C * x <= inequality_upper_bound
+   *                          (inequality constraint)
+   * The dense matrices are only read for their non-zero elements.
+   * @return true if the solution has converged.
+   */
+  bool SolveAffine(
+      const Eigen::MatrixXd& kernel_matrix, const Eigen::MatrixXd& offset,
+      const Eigen::MatrixXd& affine_inequality_matrix,
+      const Eigen::MatrixXd& affine_inequality_boundary,
+      const Eigen::MatrixXd& affine_equality_matrix,
+      const Eigen::MatrixXd& affine_equality_boundary,
+      const double variable_lower_bound =
+          -std::numeric_limits<double>::infinity(),
+      const double variable_upper_bound =
+          std::numeric_limits<double>::infinity(),
+      const double inequality_upper_bound =
+          std::numeric_limits<double>::infinity());
+
+  /**
+   * @brief forgets the previous solution, so that the next problem is not
+   * warm started.
+   */
+  void Reset();
+
+  const Eigen::VectorXd& primal_solution() const { return x_; }
+  const Eigen::VectorXd& dual_solution() const { return y_; }
+  int num_iterations() const { return num_iterations_; }
+
+ private:
+  // Scales the problem by Ruiz equilibration into the scaled_ members.
+  void ScaleProblem(const Eigen::SparseMatrix<double>& kernel_matrix,
+                    const Eigen::VectorXd& offset,
+                    const Eigen::SparseMatrix<double>& constraint_matrix,
+                    const Eigen::VectorXd& lower_bound,
+                    const Eigen::VectorXd& upper_bound);
+  void UpdateRho(const Eigen::VectorXd& lower_bound,
+                 const Eigen::VectorXd& upper_bound);
+  bool Factorize();
+  // Checks the residuals of the unscaled problem against the tolerances.
+  bool IsSolved(const Eigen::VectorXd& x, const Eigen::VectorXd& z,
+                const Eigen::VectorXd& y) const;
+  // Solves the KKT system of the constraints guessed to be active, and keeps
+  // the solution if it is accurate, as ADMM alone converges slowly.
+  bool Polish(Eigen::VectorXd* x, Eigen::VectorXd* z,
+              Eigen::VectorXd* y) const;
+
+  // Scaled problem: D P D * c, D q * c, E A D, E l, E u.
+  Eigen::SparseMatrix<double> scaled_kernel_;
+  Eigen::VectorXd scaled_offset_;
+  Eigen::SparseMatrix<double> scaled_constraint_;
+  Eigen::SparseMatrix<double> scaled_constraint_transpose_;
+  Eigen::VectorXd scaled_lower_bound_;
+  Eigen::VectorXd scaled_upper_bound_;
+  Eigen::VectorXd d_;
+  Eigen::VectorXd e_;
+  double c_ = 1.0;
+
+  // Step sizes of the constraints, and the factorization of
+  // P + sigma * I + A^T * diag(rho) * A.
+  double rho_ = 0.0;
+  Eigen::VectorXd rho_vector_;
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> linear_solver_;
+
+  // The unscaled solution, and A * x.
+  Eigen::VectorXd x_;
+  Eigen::VectorXd z_;
+  Eigen::VectorXd y_;
+  int num_iterations_ = 0;
+};
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+#endif  // MODULES_COMMON_MATH_QP_SOLVER_ADMM_QP_SOLVER_H_
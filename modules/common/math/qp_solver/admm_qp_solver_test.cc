@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+#include "modules/common/math/qp_solver/admm_qp_solver.h"
+
+#include <limits>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+using Eigen::MatrixXd;
+using Eigen::SparseMatrix;
+using Eigen::VectorXd;
+
+TEST(AdmmQpSolver, unconstrained) {
+  SparseMatrix<double> kernel_matrix(1, 1);
+  kernel_matrix.insert(0, 0) = 1.0;
+  VectorXd offset(1);
+  offset << -8.0;
+  AdmmQpSolver solver;
+  EXPECT_TRUE(solver.Solve(kernel_matrix, offset, SparseMatrix<double>(0, 1),
+                           VectorXd(0), VectorXd(0)));
+  EXPECT_NEAR(8.0, solver.primal_solution()(0), 1e-5);
+}
+
+TEST(AdmmQpSolver, constrained) {
+  // min (x0 - 1)^2 + (x1 - 2)^2 with x0 + x1 = 1, x1 <= 0.5 and x0 >= 0.
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  MatrixXd kernel_matrix = 2.0 * MatrixXd::Identity(2, 2);
+  VectorXd offset(2);
+  offset << -2.0, -4.0;
+  MatrixXd constraint_matrix(3, 2);
+  constraint_matrix << 1.0, 1.0, 0.0, 1.0, 1.0, 0.0;
+  VectorXd lower_bound(3);
+  lower_bound << 1.0, -kInfinity, 0.0;
+  VectorXd upper_bound(3);
+  upper_bound << 1.0, 0.5, kInfinity;
+
+  AdmmQpSolver solver;
+  EXPECT_TRUE(solver.Solve(kernel_matrix.sparseView(), offset,
+                           constraint_matrix.sparseView(), lower_bound,
+                           upper_bound));
+  EXPECT_NEAR(0.5, solver.primal_solution()(0), 1e-5);
+  EXPECT_NEAR(0.5, solver.primal_solution()(1), 1e-5);
+}
+
+TEST(AdmmQpSolver, not_converged) {
+  // min (x0 - 1)^2 + (x1 - 2)^2 with x0 + x1 = 1, then with x0 + x1 in
+  // [1, 1] and [3, 3], which is infeasible.
+  MatrixXd kernel_matrix = 2.0 * MatrixXd::Identity(2, 2);
+  VectorXd offset(2);
+  offset << -2.0, -4.0;
+  MatrixXd constraint_matrix(1, 2);
+  constraint_matrix << 1.0, 1.0;
+  VectorXd bound(1);
+  bound << 1.0;
+
+  AdmmQpSolver solver;
+  EXPECT_TRUE(solver.Solve(kernel_matrix.sparseView(), offset,
+                           constraint_matrix.sparseView(), bound, bound));
+  const VectorXd solution = solver.primal_solution();
+  EXPECT_NEAR(0.0, solution(0), 1e-5);
+  EXPECT_NEAR(1.0, solution(1), 1e-5);
+
+  MatrixXd infeasible_matrix(2, 2);
+  infeasible_matrix << 1.0, 1.0, 1.0, 1.0;
+  VectorXd infeasible_bound(2);
+  infeasible_bound << 1.0, 3.0;
+  EXPECT_FALSE(solver.Solve(kernel_matrix.sparseView(), offset,
+                            infeasible_matrix.sparseView(), infeasible_bound,
+                            infeasible_bound));
+  // The diverged iterates do not replace the previous solution.
+  EXPECT_EQ(solution, solver.primal_solution());
+  EXPECT_EQ(1, solver.dual_solution().size());
+}
+
+TEST(AdmmQpSolver, banded_equality_constrained) {
+  // A chain of n variables pulled towards a ramp, with smoothness costs
+  // between neighbors and the ends fixed.
+  const int n = 200;
+  std::vector<Eigen::Triplet<double>> kernel_triplets;
+  VectorXd offset(n);
+  for (int i = 0; i < n; ++i) {
+    kernel_triplets.emplace_back(i, i, i == 0 || i + 1 == n ? 2.0 : 3.0);
+    if (i + 1 < n) {
+      kernel_triplets.emplace_back(i, i + 1, -1.0);
+      kernel_triplets.emplace_back(i + 1, i, -1.0);
+    }
+    offset(i) = -0.1 * i;
+  }
+  SparseMatrix<double> kernel_matrix(n, n);
+  kernel_matrix.setFromTriplets(kernel_triplets.begin(),
+                                kernel_triplets.end());
+  SparseMatrix<double> constraint_matrix(2, n);
+  constraint_matrix.insert(0, 0) = 1.0;
+  constraint_matrix.insert(1, n - 1) = 1.0;
+  VectorXd bound(2);
+  bound << 1.0, 5.0;
+
+  // Reference solution of the KKT system.
+  MatrixXd kkt = MatrixXd::Zero(n + 2, n + 2);
+  kkt.topLeftCorner(n, n) = MatrixXd(kernel_matrix);
+  kkt.topRightCorner(n, 2) = MatrixXd(constraint_matrix).transpose();
+  kkt.bottomLeftCorner(2, n) = MatrixXd(constraint_matrix);
+  VectorXd rhs(n + 2);
+  rhs << -offset, bound;
+  const VectorXd expected = kkt.partialPivLu().solve(rhs).head(n);
+
+  AdmmQpSolver solver;
+  EXPECT_TRUE(solver.Solve(kernel_matrix, offset, constraint_matrix, bound,
+                           bound));
+  EXPECT_LT((solver.primal_solution() - expected).lpNorm<Eigen::Infinity>(),
+            1e-4);
+
+  // The same problem is warm started from its solution.
+  const int num_iterations = solver.num_iterations();
+  EXPECT_TRUE(solver.Solve(kernel_matrix, offset, constraint_matrix, bound,
+                           bound));
+  EXPECT_LT(solver.num_iterations(), num_iterations);
+  EXPECT_LT((solver.primal_solution() - expected).lpNorm<Eigen::Infinity>(),
+            1e-4);
+
+  solver.Reset();
+  EXPECT_TRUE(solver.Solve(kernel_matrix, offset, constraint_matrix, bound,
+                           bound));
+  EXPECT_EQ(num_iterations, solver.num_iterations());
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -26,3 +26,17 @@ DEFINE_double(default_active_set_eps_iter_ref, 1e-7,
 DEFINE_bool(default_enable_active_set_debug_info, false,
             "Enable print information");
 DEFINE_int32(default_qp_iteration_num, 1000, "Default qp oases iteration time");
+
+// math : admm solver
+DEFINE_double(default_admm_rho, 0.1, "ADMM qp solver initial step size");
+DEFINE_double(default_admm_sigma, 1e-6,
+              "ADMM qp solver regularization of the linear system");
+DEFINE_double(default_admm_alpha, 1.6, "ADMM qp solver relaxation parameter");
+DEFINE_double(default_admm_eps_abs, 1e-6,
+              "ADMM qp solver absolute tolerance of the residuals");
+DEFINE_double(default_admm_eps_rel, 1e-6,
+              "ADMM qp solver relative tolerance of the residuals");
+DEFINE_int32(default_admm_max_iteration, 4000,
+             "ADMM qp solver maximum number of iterations");
+DEFINE_int32(default_admm_scaling_iteration, 10,
+             "ADMM qp solver number of problem scaling iterations");
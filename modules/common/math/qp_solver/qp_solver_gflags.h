@@ -26,4 +26,13 @@ DECLARE_double(default_active_set_eps_iter_ref);
 DECLARE_bool(default_enable_active_set_debug_info);
 DECLARE_int32(default_qp_iteration_num);
 
+// math : admm solver
+DECLARE_double(default_admm_rho);
+DECLARE_double(default_admm_sigma);
+DECLARE_double(default_admm_alpha);
+DECLARE_double(default_admm_eps_abs);
+DECLARE_double(default_admm_eps_rel);
+DECLARE_int32(default_admm_max_iteration);
+DECLARE_int32(default_admm_scaling_iteration);
+
 #endif /* MODULES_PLANNING_MATH_QP_SOLVER_QP_SOLVER_GFLAGS_H_ */
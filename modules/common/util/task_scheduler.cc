@@ -0,0 +1,234 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/util/task_scheduler.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "modules/common/log.h"
+
+DEFINE_int32(task_scheduler_num_threads, -1,
+             "Number of threads of the shared task scheduler. If negative, "
+             "one per CPU of --task_scheduler_cpus, or one per CPU core but "
+             "the one of the thread waiting for the tasks.");
+DEFINE_string(task_scheduler_cpus, "",
+              "Comma separated CPUs the threads of the shared task scheduler "
+              "are pinned to, e.g. \"2,3,4,5\". Threads are not pinned if "
+              "empty.");
+
+namespace apollo {
+namespace common {
+namespace util {
+namespace {
+
+// The scheduler the calling thread works for, and the index of its queue.
+thread_local const TaskScheduler *current_scheduler = nullptr;
+thread_local int current_queue = -1;
+
+std::vector<int> ParseCpus(const std::string &cpus) {
+  std::vector<int> result;
+  std::stringstream ss(cpus);
+  std::string cpu;
+  while (std::getline(ss, cpu, ',')) {
+    if (!cpu.empty()) {
+      result.push_back(std::stoi(cpu));
+    }
+  }
+  return result;
+}
+
+void PinThread(std::thread *thread, const int cpu) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  const int error = pthread_setaffinity_np(thread->native_handle(),
+                                           sizeof(cpu_set_t), &cpu_set);
+  if (error != 0) {
+    AWARN << "Failed to pin a task scheduler thread to CPU " << cpu
+          << ", error " << error;
+  }
+}
+
+}  // namespace
+
+TaskGroup::TaskGroup(TaskScheduler *scheduler)
+    : scheduler_(scheduler != nullptr ? scheduler : TaskScheduler::Instance()),
+      num_pending_tasks_(0) {}
+
+TaskGroup::~TaskGroup() { Wait(); }
+
+void TaskGroup::Run(std::function<void()> task) {
+  ++num_pending_tasks_;
+  TaskScheduler::Task scheduled_task;
+  scheduled_task.function = std::move(task);
+  scheduled_task.group = this;
+  scheduler_->Submit(std::move(scheduled_task));
+}
+
+void TaskGroup::Wait() {
+  while (num_pending_tasks_ > 0) {
+    if (scheduler_->RunPendingTask()) {
+      continue;
+    }
+    // The remaining tasks are running on other threads, which may still
+    // schedule tasks to help with.
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait_for(lock, std::chrono::microseconds(100),
+                   [this]() { return num_pending_tasks_ == 0; });
+  }
+  // Makes sure the last OnTaskDone() is over before the group may go away.
+  std::lock_guard<std::mutex> lock(mutex_);
+}
+
+void TaskGroup::OnTaskDone() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (--num_pending_tasks_ == 0) {
+    done_.notify_all();
+  }
+}
+
+TaskScheduler::TaskScheduler(const int num_threads,
+                             const std::vector<int> &cpus)
+    : num_queued_tasks_(0), next_steal_queue_(0), num_sleeping_threads_(0) {
+  const int num_workers = std::max(num_threads, 0);
+  for (int i = 0; i <= num_workers; ++i) {
+    queues_.emplace_back(new TaskQueue());
+  }
+  for (int i = 0; i < num_workers; ++i) {
+    threads_.emplace_back(&TaskScheduler::WorkerLoop, this, i);
+    if (!cpus.empty()) {
+      PinThread(&threads_.back(), cpus[i % cpus.size()]);
+    }
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_up_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+TaskScheduler *TaskScheduler::Instance() {
+  // Never destroyed, as tasks may be run until the process exits.
+  static TaskScheduler *instance = []() {
+    const auto cpus = ParseCpus(FLAGS_task_scheduler_cpus);
+    int num_threads = FLAGS_task_scheduler_num_threads;
+    if (num_threads < 0) {
+      num_threads = cpus.empty()
+                        ? static_cast<int>(std::thread::hardware_concurrency())
+                        : static_cast<int>(cpus.size());
+      // The waiting thread runs tasks too.
+      num_threads = std::max(num_threads - 1, 1);
+    }
+    AINFO << "Task scheduler uses " << num_threads << " threads.";
+    return new TaskScheduler(num_threads, cpus);
+  }();
+  return instance;
+}
+
+void TaskScheduler::Submit(Task task) {
+  const int queue = current_scheduler == this
+                        ? current_queue
+                        : static_cast<int>(threads_.size());
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+    queues_[queue]->tasks.push_back(std::move(task));
+  }
+  ++num_queued_tasks_;
+  if (num_sleeping_threads_ > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    wake_up_.notify_one();
+  }
+}
+
+bool TaskScheduler::PopTask(Task *task) {
+  const int own_queue = current_scheduler == this
+                            ? current_queue
+                            : static_cast<int>(threads_.size());
+  {
+    auto *queue = queues_[own_queue].get();
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (!queue->tasks.empty()) {
+      *task = std::move(queue->tasks.back());
+      queue->tasks.pop_back();
+      --num_queued_tasks_;
+      return true;
+    }
+  }
+  if (num_queued_tasks_ == 0) {
+    return false;
+  }
+  const int num_queues = static_cast<int>(queues_.size());
+  const int first_queue = next_steal_queue_++ % num_queues;
+  for (int i = 0; i < num_queues; ++i) {
+    const int index = (first_queue + i) % num_queues;
+    if (index == own_queue) {
+      continue;
+    }
+    auto *queue = queues_[index].get();
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (!queue->tasks.empty()) {
+      *task = std::move(queue->tasks.front());
+      queue->tasks.pop_front();
+      --num_queued_tasks_;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TaskScheduler::RunPendingTask() {
+  Task task;
+  if (!PopTask(&task)) {
+    return false;
+  }
+  task.function();
+  task.group->OnTaskDone();
+  return true;
+}
+
+void TaskScheduler::WorkerLoop(const int index) {
+  current_scheduler = this;
+  current_queue = index;
+  while (true) {
+    if (RunPendingTask()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    ++num_sleeping_threads_;
+    wake_up_.wait(lock,
+                  [this]() { return stop_ || num_queued_tasks_ > 0; });
+    --num_sleeping_threads_;
+    if (stop_ && num_queued_tasks_ == 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace util
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A work-stealing task scheduler shared by the modules of a process.
+ */
+
+#ifndef MODULES_COMMON_UTIL_TASK_SCHEDULER_H_
+#define MODULES_COMMON_UTIL_TASK_SCHEDULER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+DECLARE_int32(task_scheduler_num_threads);
+DECLARE_string(task_scheduler_cpus);
+
+/**
+ * @namespace apollo::common::util
+ * @brief apollo::common::util
+ */
+namespace apollo {
+namespace common {
+namespace util {
+
+class TaskScheduler;
+
+/**
+ * @class TaskGroup
+ * @brief Tasks of a TaskScheduler which are waited for together, without
+ * futures.
+ */
+class TaskGroup {
+ public:
+  /**
+   * @brief Construct a group of tasks run by a scheduler.
+   * @param scheduler the scheduler, TaskScheduler::Instance() if null.
+   */
+  explicit TaskGroup(TaskScheduler *scheduler = nullptr);
+
+  /**
+   * @brief Waits for the remaining tasks.
+   */
+  ~TaskGroup();
+
+  /**
+   * @brief Schedules a task of the group.
+   */
+  void Run(std::function<void()> task);
+
+  /**
+   * @brief Waits until all the tasks of the group are done. The calling
+   * thread runs pending tasks meanwhile, so groups may be waited for from
+   * within tasks.
+   */
+  void Wait();
+
+ private:
+  friend class TaskScheduler;
+
+  void OnTaskDone();
+
+  TaskScheduler *scheduler_ = nullptr;
+  std::atomic<int> num_pending_tasks_;
+  std::mutex mutex_;
+  std::condition_variable done_;
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+};
+
+/**
+ * @class TaskScheduler
+ * @brief A pool of threads with a deque of tasks each. A thread runs the
+ * newest task of its own deque, and steals the oldest task of another deque
+ * when its own is empty, so that fine grained tasks do not contend on a
+ * single queue.
+ */
+class TaskScheduler {
+ public:
+  /**
+   * @brief Construct the \class TaskScheduler object.
+   * @param num_threads the number of worker threads. Tasks are run by the
+   * waiting thread only if it is 0.
+   * @param cpus the CPUs the worker threads are pinned to, in turn. Threads
+   * are not pinned if it is empty.
+   */
+  explicit TaskScheduler(const int num_threads,
+                         const std::vector<int> &cpus = {});
+  ~TaskScheduler();
+
+  /**
+   * @brief The scheduler shared by the modules of the process, configured
+   * by FLAGS_task_scheduler_num_threads and FLAGS_task_scheduler_cpus.
+   */
+  static TaskScheduler *Instance();
+
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+
+  /**
+   * @brief Calls function(i) for each i in [begin, end), in parallel. The
+   * range is split into chunks of grain_size indices, which are picked up
+   * by the calling thread and at most num_threads() tasks.
+   */
+  template <typename Function>
+  void ParallelFor(const size_t begin, const size_t end,
+                   const size_t grain_size, const Function &function);
+
+ private:
+  friend class TaskGroup;
+
+  struct Task {
+    std::function<void()> function;
+    TaskGroup *group = nullptr;
+  };
+
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Submit(Task task);
+  // Runs a task of the queue of the calling thread, or a stolen one.
+  bool RunPendingTask();
+  bool PopTask(Task *task);
+  void WorkerLoop(const int index);
+
+  // One queue per worker, the last one is shared by the other threads.
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<int> num_queued_tasks_;
+  std::atomic<unsigned int> next_steal_queue_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_up_;
+  std::atomic<int> num_sleeping_threads_;
+  bool stop_ = false;
+
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+};
+
+template <typename Function>
+void TaskScheduler::ParallelFor(const size_t begin, const size_t end,
+                                const size_t grain_size,
+                                const Function &function) {
+  if (begin >= end) {
+    return;
+  }
+  const size_t grain = std::max<size_t>(grain_size, 1);
+  const size_t num_chunks = (end - begin + grain - 1) / grain;
+  std::atomic<size_t> next_chunk(0);
+  auto run_chunks = [&]() {
+    for (size_t chunk = next_chunk++; chunk < num_chunks;
+         chunk = next_chunk++) {
+      const size_t chunk_begin = begin + chunk * grain;
+      const size_t chunk_end = std::min(end, chunk_begin + grain);
+      for (size_t i = chunk_begin; i < chunk_end; ++i) {
+        function(i);
+      }
+    }
+  };
+
+  const size_t num_tasks =
+      std::min(num_chunks - 1, static_cast<size_t>(num_threads()));
+  TaskGroup group(this);
+  for (size_t i = 0; i < num_tasks; ++i) {
+    group.Run(run_chunks);
+  }
+  run_chunks();
+  group.Wait();
+}
+
+/**
+ * @brief Calls function(i) for each i in [begin, end) in parallel on the
+ * shared TaskScheduler, see TaskScheduler::ParallelFor().
+ */
+template <typename Function>
+void ParallelFor(const size_t begin, const size_t end, const size_t grain_size,
+                 const Function &function) {
+  TaskScheduler::Instance()->ParallelFor(begin, end, grain_size, function);
+}
+
+}  // namespace util
+}  // namespace common
+}  // namespace apollo
+
+#endif  // MODULES_COMMON_UTIL_TASK_SCHEDULER_H_
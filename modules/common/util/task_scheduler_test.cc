@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/util/task_scheduler.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace util {
+
+TEST(TaskSchedulerTest, TaskGroup) {
+  TaskScheduler scheduler(4);
+  EXPECT_EQ(4, scheduler.num_threads());
+  std::atomic<int> sum(0);
+  TaskGroup group(&scheduler);
+  for (int i = 1; i <= 1000; ++i) {
+    group.Run([&sum, i]() { sum += i; });
+  }
+  group.Wait();
+  EXPECT_EQ(500500, sum.load());
+
+  // A group can be reused after Wait().
+  group.Run([&sum]() { sum = 0; });
+  group.Wait();
+  EXPECT_EQ(0, sum.load());
+}
+
+TEST(TaskSchedulerTest, NoThread) {
+  TaskScheduler scheduler(0);
+  EXPECT_EQ(0, scheduler.num_threads());
+  int sum = 0;
+  TaskGroup group(&scheduler);
+  for (int i = 1; i <= 10; ++i) {
+    group.Run([&sum, i]() { sum += i; });
+  }
+  group.Wait();
+  EXPECT_EQ(55, sum);
+}
+
+TEST(TaskSchedulerTest, NestedGroups) {
+  TaskScheduler scheduler(2);
+  std::atomic<int> count(0);
+  TaskGroup group(&scheduler);
+  for (int i = 0; i < 8; ++i) {
+    group.Run([&scheduler, &count]() {
+      // Waiting within a task runs the nested tasks instead of blocking.
+      TaskGroup nested_group(&scheduler);
+      for (int j = 0; j < 100; ++j) {
+        nested_group.Run([&count]() { ++count; });
+      }
+      nested_group.Wait();
+    });
+  }
+  group.Wait();
+  EXPECT_EQ(800, count.load());
+}
+
+TEST(TaskSchedulerTest, ParallelFor) {
+  TaskScheduler scheduler(3);
+  for (const size_t grain_size : {0, 1, 7, 1000, 5000}) {
+    std::vector<int> visits(1000, 0);
+    scheduler.ParallelFor(0, visits.size(), grain_size,
+                          [&visits](const size_t i) { ++visits[i]; });
+    EXPECT_EQ(std::vector<int>(1000, 1), visits);
+  }
+
+  std::vector<int> visits(10, 0);
+  scheduler.ParallelFor(5, 5, 1, [&visits](const size_t i) { ++visits[i]; });
+  scheduler.ParallelFor(3, 8, 2, [&visits](const size_t i) { ++visits[i]; });
+  EXPECT_EQ(std::vector<int>({0, 0, 0, 1, 1, 1, 1, 1, 0, 0}), visits);
+}
+
+TEST(TaskSchedulerTest, SharedInstance) {
+  EXPECT_EQ(TaskScheduler::Instance(), TaskScheduler::Instance());
+  std::atomic<int> sum(0);
+  ParallelFor(0, 100, 10, [&sum](const size_t i) { sum += i; });
+  EXPECT_EQ(4950, sum.load());
+}
+
+}  // namespace util
+}  // namespace common
+}  // namespace apollo
@@ -112,13 +112,15 @@ MapService::MapService(bool use_sim_map) : use_sim_map_(use_sim_map) {
 }
 
 bool MapService::ReloadMap(bool force_reload) {
-  boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
   bool ret = true;
   if (force_reload) {
+    // Readers keep using the current map snapshots until the new ones are
+    // published, so no lock is held while the maps are rebuilt.
     ret = HDMapUtil::ReloadMaps();
   }
 
   // Update the x,y-offsets if present.
+  boost::unique_lock<boost::shared_mutex> writer_lock(mutex_);
   UpdateOffsets();
   return ret;
 }
@@ -169,49 +171,51 @@ void MapService::UpdateOffsets() {
         << y_offset_;
 }
 
-const hdmap::HDMap *MapService::HDMap() const {
-  return HDMapUtil::BaseMapPtr();
+std::shared_ptr<const hdmap::HDMap> MapService::HDMap() const {
+  return HDMapUtil::BaseMapSnapshot();
 }
 
-const hdmap::HDMap *MapService::SimMap() const {
-  return use_sim_map_ ? HDMapUtil::SimMapPtr() : HDMapUtil::BaseMapPtr();
+std::shared_ptr<const hdmap::HDMap> MapService::SimMap() const {
+  return use_sim_map_ ? HDMapUtil::SimMapSnapshot()
+                      : HDMapUtil::BaseMapSnapshot();
 }
 
-bool MapService::MapReady() const { return HDMap() && SimMap(); }
-
 void MapService::CollectMapElementIds(const PointENU &point, double radius,
                                       MapElementIds *ids) const {
-  if (!MapReady()) {
+  // The map elements are collected around the ego vehicle, move the tiled
+  // base map, if any, along with it.
+  HDMapUtil::UpdateBaseMapPosition(point);
+  const auto sim_map = SimMap();
+  if (sim_map == nullptr) {
     return;
   }
-  boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
 
   std::vector<LaneInfoConstPtr> lanes;
-  if (SimMap()->GetLanes(point, radius, &lanes) != 0) {
+  if (sim_map->GetLanes(point, radius, &lanes) != 0) {
     AERROR << "Fail to get lanes from sim_map.";
   }
   ExtractRoadAndLaneIds(lanes, ids->mutable_lane(), ids->mutable_road());
 
   std::vector<ClearAreaInfoConstPtr> clear_areas;
-  if (SimMap()->GetClearAreas(point, radius, &clear_areas) != 0) {
+  if (sim_map->GetClearAreas(point, radius, &clear_areas) != 0) {
     AERROR << "Fail to get clear areas from sim_map.";
   }
   ExtractIds(clear_areas, ids->mutable_clear_area());
 
   std::vector<CrosswalkInfoConstPtr> crosswalks;
-  if (SimMap()->GetCrosswalks(point, radius, &crosswalks) != 0) {
+  if (sim_map->GetCrosswalks(point, radius, &crosswalks) != 0) {
     AERROR << "Fail to get crosswalks from sim_map.";
   }
   ExtractIds(crosswalks, ids->mutable_crosswalk());
 
   std::vector<JunctionInfoConstPtr> junctions;
-  if (SimMap()->GetJunctions(point, radius, &junctions) != 0) {
+  if (sim_map->GetJunctions(point, radius, &junctions) != 0) {
     AERROR << "Fail to get junctions from sim_map.";
   }
   ExtractIds(junctions, ids->mutable_junction());
 
   std::vector<SignalInfoConstPtr> signals;
-  if (SimMap()->GetSignals(point, radius, &signals) != 0) {
+  if (sim_map->GetSignals(point, radius, &signals) != 0) {
     AERROR << "Failed to get signals from sim_map.";
   }
 
@@ -219,31 +223,30 @@ void MapService::CollectMapElementIds(const PointENU &point, double radius,
   ExtractOverlapIds(signals, ids->mutable_overlap());
 
   std::vector<StopSignInfoConstPtr> stop_signs;
-  if (SimMap()->GetStopSigns(point, radius, &stop_signs) != 0) {
+  if (sim_map->GetStopSigns(point, radius, &stop_signs) != 0) {
     AERROR << "Failed to get stop signs from sim_map.";
   }
   ExtractIds(stop_signs, ids->mutable_stop_sign());
   ExtractOverlapIds(stop_signs, ids->mutable_overlap());
 
   std::vector<YieldSignInfoConstPtr> yield_signs;
-  if (SimMap()->GetYieldSigns(point, radius, &yield_signs) != 0) {
+  if (sim_map->GetYieldSigns(point, radius, &yield_signs) != 0) {
     AERROR << "Failed to get yield signs from sim_map.";
   }
   ExtractIds(yield_signs, ids->mutable_yield());
 }
 
 Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
-  boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
-
   Map result;
-  if (!MapReady()) {
+  const auto sim_map = SimMap();
+  if (sim_map == nullptr) {
     return result;
   }
   Id map_id;
 
   for (const auto &id : ids.lane()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetLaneById(map_id);
+    auto element = sim_map->GetLaneById(map_id);
     if (element) {
       auto lane = element->lane();
       lane.clear_left_sample();
@@ -256,7 +259,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.clear_area()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetClearAreaById(map_id);
+    auto element = sim_map->GetClearAreaById(map_id);
     if (element) {
       *result.add_clear_area() = element->clear_area();
     }
@@ -264,7 +267,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.crosswalk()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetCrosswalkById(map_id);
+    auto element = sim_map->GetCrosswalkById(map_id);
     if (element) {
       *result.add_crosswalk() = element->crosswalk();
     }
@@ -272,7 +275,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.junction()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetJunctionById(map_id);
+    auto element = sim_map->GetJunctionById(map_id);
     if (element) {
       *result.add_junction() = element->junction();
     }
@@ -280,7 +283,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.signal()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetSignalById(map_id);
+    auto element = sim_map->GetSignalById(map_id);
     if (element) {
       *result.add_signal() = element->signal();
     }
@@ -288,7 +291,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.stop_sign()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetStopSignById(map_id);
+    auto element = sim_map->GetStopSignById(map_id);
     if (element) {
       *result.add_stop_sign() = element->stop_sign();
     }
@@ -296,7 +299,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.yield()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetYieldSignById(map_id);
+    auto element = sim_map->GetYieldSignById(map_id);
     if (element) {
       *result.add_yield() = element->yield_sign();
     }
@@ -304,7 +307,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.road()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetRoadById(map_id);
+    auto element = sim_map->GetRoadById(map_id);
     if (element) {
       *result.add_road() = element->road();
     }
@@ -312,7 +315,7 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 
   for (const auto &id : ids.overlap()) {
     map_id.set_id(id);
-    auto element = SimMap()->GetOverlapById(map_id);
+    auto element = sim_map->GetOverlapById(map_id);
     if (element) {
       *result.add_overlap() = element->overlap();
     }
@@ -324,13 +327,12 @@ Map MapService::RetrieveMapElements(const MapElementIds &ids) const {
 bool MapService::GetNearestLane(const double x, const double y,
                                 LaneInfoConstPtr *nearest_lane,
                                 double *nearest_s, double *nearest_l) const {
-  boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
-
   PointENU point;
   point.set_x(x);
   point.set_y(y);
-  if (!MapReady() ||
-      HDMap()->GetNearestLane(point, nearest_lane, nearest_s, nearest_l) < 0) {
+  const auto base_map = HDMap();
+  if (base_map == nullptr ||
+      base_map->GetNearestLane(point, nearest_lane, nearest_s, nearest_l) < 0) {
     AERROR << "Failed to get nearest lane!";
     return false;
   }
@@ -402,14 +404,14 @@ bool MapService::CreatePathsFromRouting(const RoutingResponse &routing,
 
 bool MapService::AddPathFromPassageRegion(
     const routing::Passage &passage_region, std::vector<Path> *paths) const {
-  if (!MapReady()) {
+  const auto base_map = HDMap();
+  if (base_map == nullptr) {
     return false;
   }
-  boost::shared_lock<boost::shared_mutex> reader_lock(mutex_);
 
   RouteSegments segments;
   for (const auto &segment : passage_region.segment()) {
-    auto lane_ptr = HDMap()->GetLaneById(hdmap::MakeMapId(segment.id()));
+    auto lane_ptr = base_map->GetLaneById(hdmap::MakeMapId(segment.id()));
     if (!lane_ptr) {
       AERROR << "Failed to find lane: " << segment.id();
       return false;
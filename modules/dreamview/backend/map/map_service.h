@@ -21,6 +21,7 @@
 #ifndef MODULES_DREAMVIEW_BACKEND_MAP_MAP_SERVICE_H_
 #define MODULES_DREAMVIEW_BACKEND_MAP_MAP_SERVICE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -97,15 +98,17 @@ class MapService {
   static const char kMetaFileName[];
 
   const bool use_sim_map_;
-  const hdmap::HDMap *HDMap() const;
+  // Snapshots of the current maps. A reload does not affect a snapshot
+  // already taken, so each query works on a single consistent map.
+  std::shared_ptr<const hdmap::HDMap> HDMap() const;
   // A downsampled map for dreamview frontend display.
-  const hdmap::HDMap *SimMap() const;
-  bool MapReady() const;
+  std::shared_ptr<const hdmap::HDMap> SimMap() const;
 
   double x_offset_ = 0.0;
   double y_offset_ = 0.0;
 
-  // RW lock to protect map data
+  // Lock to protect the map offsets. Map data needs no lock, as it is
+  // accessed through immutable snapshots.
   mutable boost::shared_mutex mutex_;
 };
 
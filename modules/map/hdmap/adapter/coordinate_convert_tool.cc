@@ -19,9 +19,38 @@ limitations under the License.
 namespace apollo {
 namespace hdmap {
 namespace adapter {
+namespace {
+
+// The projections of one thread, with their own proj.4 context.
+struct ThreadProjections {
+  ~ThreadProjections() { Reset(); }
+
+  void Reset() {
+    if (pj_from) {
+      pj_free(pj_from);
+      pj_from = NULL;
+    }
+    if (pj_to) {
+      pj_free(pj_to);
+      pj_to = NULL;
+    }
+    if (ctx) {
+      pj_ctx_free(ctx);
+      ctx = NULL;
+    }
+    param_version = -1;
+  }
+
+  int param_version = -1;
+  projCtx ctx = NULL;
+  projPJ pj_from = NULL;
+  projPJ pj_to = NULL;
+};
+
+}  // namespace
 
 CoordinateConvertTool::CoordinateConvertTool()
-  : pj_from_(NULL), pj_to_(NULL) {}
+  : pj_from_(NULL), pj_to_(NULL), param_version_(0) {}
 
 CoordinateConvertTool::~CoordinateConvertTool() {
   if (pj_from_) {
@@ -66,6 +95,7 @@ Status CoordinateConvertTool::SetConvertParam(const std::string &source_param,
     return Status(apollo::common::ErrorCode::HDMAP_DATA_ERROR, err_msg);
   }
 
+  ++param_version_;
   return Status::OK();
 }
 
@@ -82,23 +112,42 @@ Status CoordinateConvertTool::CoordiateConvert(const double longitude,
       return Status(apollo::common::ErrorCode::HDMAP_DATA_ERROR, err_msg);
   }
 
+  thread_local ThreadProjections projections;
+  const int param_version = param_version_;
+  if (projections.param_version != param_version) {
+    projections.Reset();
+    projections.ctx = pj_ctx_alloc();
+    projections.pj_from =
+        pj_init_plus_ctx(projections.ctx, source_convert_param_.c_str());
+    projections.pj_to =
+        pj_init_plus_ctx(projections.ctx, dst_convert_param_.c_str());
+    if (!projections.pj_from || !projections.pj_to) {
+      projections.Reset();
+      std::string err_msg = "Fail to pj_init_plus_ctx";
+      return Status(apollo::common::ErrorCode::HDMAP_DATA_ERROR, err_msg);
+    }
+    projections.param_version = param_version;
+  }
+  projPJ pj_from = projections.pj_from;
+  projPJ pj_to = projections.pj_to;
+
   double gps_longitude = longitude;
   double gps_latitude = latitude;
   double gps_alt = height_ellipsoid;
 
-  if (pj_is_latlong(pj_from_)) {
+  if (pj_is_latlong(pj_from)) {
     gps_longitude *= DEG_TO_RAD;
     gps_latitude *= DEG_TO_RAD;
     gps_alt = height_ellipsoid;
   }
 
-  if (0 != pj_transform(pj_from_, pj_to_, 1, 1, &gps_longitude,
+  if (0 != pj_transform(pj_from, pj_to, 1, 1, &gps_longitude,
                           &gps_latitude, &gps_alt)) {
     std::string err_msg = "fail to transform coordinate";
     return Status(apollo::common::ErrorCode::HDMAP_DATA_ERROR, err_msg);
   }
 
-  if (pj_is_latlong(pj_to_)) {
+  if (pj_is_latlong(pj_to)) {
     gps_longitude *= RAD_TO_DEG;
     gps_latitude *= RAD_TO_DEG;
   }
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef MODULES_MAP_MAP_LOADER_ADAPTER_COORDINATE_CONVERT_TOOL_H_
 #define MODULES_MAP_MAP_LOADER_ADAPTER_COORDINATE_CONVERT_TOOL_H_
 #include <proj_api.h>
+#include <atomic>
 #include <string>
 #include "modules/map/hdmap/adapter/xml_parser/status.h"
 
@@ -33,6 +34,8 @@ class CoordinateConvertTool {
  public:
   Status SetConvertParam(const std::string &source_param,
                         const std::string &dst_param);
+  // Safe to call from several threads at once: proj.4 projections must not
+  // be shared between threads, so each thread converts with its own copies.
   Status CoordiateConvert(const double longitude, const double latitude,
                           const double height_ellipsoid, double* utm_x,
                           double* utm_y, double* utm_z);
@@ -43,6 +46,8 @@ class CoordinateConvertTool {
 
   projPJ pj_from_;
   projPJ pj_to_;
+  // Bumped by SetConvertParam() to rebuild the per-thread projections.
+  std::atomic<int> param_version_;
 };
 
 }  // namespace adapter
@@ -14,9 +14,13 @@ limitations under the License.
 =========================================================================*/
 #include "modules/map/hdmap/adapter/opendrive_adapter.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #include "modules/common/log.h"
+#include "modules/common/util/threadpool.h"
 #include "modules/map/hdmap/adapter/proto_organizer.h"
 #include "modules/map/hdmap/adapter/xml_parser/status.h"
 
@@ -24,8 +28,17 @@ namespace apollo {
 namespace hdmap {
 namespace adapter {
 
+using apollo::common::util::ThreadPool;
+
 bool OpendriveAdapter::LoadData(const std::string& filename,
                                 apollo::hdmap::Map* pb_map) {
+  return LoadData(filename, pb_map,
+                  std::max(1U, std::thread::hardware_concurrency()));
+}
+
+bool OpendriveAdapter::LoadData(const std::string& filename,
+                                apollo::hdmap::Map* pb_map,
+                                const int num_threads) {
   CHECK_NOTNULL(pb_map);
 
   tinyxml2::XMLDocument document;
@@ -45,9 +58,16 @@ bool OpendriveAdapter::LoadData(const std::string& filename,
     return false;
   }
 
+  // The header sets up the coordinate conversion, so the workers start after
+  // it is parsed.
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (num_threads > 1) {
+    thread_pool.reset(new ThreadPool(num_threads));
+  }
+
   // roads
   std::vector<RoadInternal> roads;
-  status = RoadsXmlParser::Parse(*root_node, &roads);
+  status = RoadsXmlParser::Parse(*root_node, thread_pool.get(), &roads);
   if (!status.ok()) {
     AERROR << "fail to parse opendrive road, " << status.error_message();
     return false;
@@ -64,7 +84,7 @@ bool OpendriveAdapter::LoadData(const std::string& filename,
   ProtoOrganizer proto_organizer;
   proto_organizer.GetRoadElements(&roads);
   proto_organizer.GetJunctionElements(junctions);
-  proto_organizer.GetOverlapElements(roads, junctions);
+  proto_organizer.GetOverlapElements(roads, junctions, thread_pool.get());
   proto_organizer.OutputData(pb_map);
 
   return true;
@@ -37,6 +37,10 @@ namespace adapter {
 class OpendriveAdapter {
  public:
   static bool LoadData(const std::string& filename, apollo::hdmap::Map* pb_map);
+  // Parses roads and builds lane overlaps on num_threads threads. The map is
+  // the same whatever the number of threads.
+  static bool LoadData(const std::string& filename, apollo::hdmap::Map* pb_map,
+                       const int num_threads);
 };
 
 }  // namespace adapter
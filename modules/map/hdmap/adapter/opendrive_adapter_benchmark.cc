@@ -0,0 +1,206 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+// Times OpendriveAdapter::LoadData on synthetic OpenDRIVE maps with a
+// growing number of threads, and checks that the map does not depend on
+// the number of threads.
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/log.h"
+#include "modules/map/hdmap/adapter/opendrive_adapter.h"
+
+namespace apollo {
+namespace hdmap {
+namespace adapter {
+namespace {
+
+// Roads are laid on a grid of kGridSize columns, kRoadSpacing degrees apart.
+constexpr int kGridSize = 100;
+constexpr double kWest = -122.0;
+constexpr double kSouth = 37.0;
+constexpr double kRoadSpacing = 0.002;
+constexpr double kRoadLength = 0.0015;
+constexpr double kLaneWidth = 0.00003;
+constexpr int kNumPoints = 30;
+// Every kRoadsPerJunction roads share a junction.
+constexpr int kRoadsPerJunction = 4;
+
+std::string LaneId(const int road, const int lane) {
+  return "road_" + std::to_string(road) + "_lane_" + std::to_string(lane);
+}
+
+void WritePointSet(const double x, const double y, std::ofstream* out) {
+  *out << "<geometry sOffset=\"0\" x=\"" << x << "\" y=\"" << y
+       << "\" length=\"120\"><pointSet>";
+  for (int i = 0; i < kNumPoints; ++i) {
+    *out << "<point x=\"" << x + kRoadLength * i / (kNumPoints - 1)
+         << "\" y=\"" << y << "\"/>";
+  }
+  *out << "</pointSet></geometry>";
+}
+
+void WriteLane(const int road, const int lane, const int num_roads,
+               const double x, const double y, std::ofstream* out) {
+  const double border_y = y - (-lane + 0.5) * kLaneWidth;
+  *out << "<lane id=\"" << lane << "\" uid=\"" << LaneId(road, lane)
+       << "\" type=\"driving\" direction=\"forward\" turnType=\"noTurn\">"
+       << "<border virtual=\"FALSE\">";
+  WritePointSet(x, border_y, out);
+  *out << "<borderType sOffset=\"0\" type=\"broken\" color=\"white\"/>"
+       << "</border>";
+  if (lane == 0) {
+    *out << "</lane>";
+    return;
+  }
+  *out << "<link>";
+  if (road > 0) {
+    *out << "<predecessor id=\"" << LaneId(road - 1, lane) << "\"/>";
+  }
+  if (road + 1 < num_roads) {
+    *out << "<successor id=\"" << LaneId(road + 1, lane) << "\"/>";
+  }
+  const int neighbor = lane == -1 ? -2 : -1;
+  *out << "<neighbor id=\"" << LaneId(road, neighbor) << "\" side=\""
+       << (lane == -1 ? "right" : "left") << "\" direction=\"same\"/>"
+       << "</link><centerLine>";
+  WritePointSet(x, y + lane * kLaneWidth, out);
+  *out << "</centerLine><speed max=\"40\"/>"
+       << "<sampleAssociates><sampleAssociate sOffset=\"0\" leftWidth=\"1.7\""
+       << " rightWidth=\"1.7\"/></sampleAssociates>"
+       << "<roadSampleAssociations><sampleAssociation sOffset=\"0\""
+       << " leftWidth=\"1.7\" rightWidth=\"5.1\"/></roadSampleAssociations>"
+       << "<objectOverlapGroup><objectReference id=\"crosswalk_" << road
+       << "\" startOffset=\"60\" endOffset=\"64\"/></objectOverlapGroup>"
+       << "<junctionOverlapGroup><junctionReference id=\"junction_"
+       << road / kRoadsPerJunction
+       << "\" startOffset=\"0\" endOffset=\"120\"/></junctionOverlapGroup>"
+       << "<laneOverlapGroup><laneReference id=\"" << LaneId(road, neighbor)
+       << "\" startOffset=\"100\" endOffset=\"110\"/></laneOverlapGroup>"
+       << "</lane>";
+}
+
+void WriteOutline(const double x, const double y, const double size,
+                  std::ofstream* out) {
+  *out << "<outline>"
+       << "<cornerGlobal x=\"" << x << "\" y=\"" << y << "\" z=\"0\"/>"
+       << "<cornerGlobal x=\"" << x + size << "\" y=\"" << y << "\" z=\"0\"/>"
+       << "<cornerGlobal x=\"" << x + size << "\" y=\"" << y + size
+       << "\" z=\"0\"/>"
+       << "<cornerGlobal x=\"" << x << "\" y=\"" << y + size << "\" z=\"0\"/>"
+       << "</outline>";
+}
+
+// Writes a map of num_roads roads with two lanes each, one crosswalk per
+// road and one junction per kRoadsPerJunction roads.
+std::string GenerateOpendrive(const int num_roads) {
+  const std::string filename =
+      "/tmp/opendrive_adapter_benchmark_" + std::to_string(num_roads) + ".xml";
+  std::ofstream out(filename);
+  CHECK(out.is_open()) << "Failed to open " << filename;
+  out.precision(10);
+  out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?><OpenDRIVE>"
+      << "<header revMajor=\"1\" revMinor=\"0\" name=\"synthetic\""
+      << " version=\"1\" date=\"20181016\" north=\"37.3\" south=\"37.0\""
+      << " east=\"-121.8\" west=\"-122.0\" vendor=\"apollo\"><geoReference>"
+      << "<![CDATA[+proj=longlat +ellps=WGS84 +datum=WGS84 +no_defs]]>"
+      << "</geoReference></header>";
+  for (int road = 0; road < num_roads; ++road) {
+    const double x = kWest + (road % kGridSize) * kRoadSpacing;
+    const double y = kSouth + (road / kGridSize) * kRoadSpacing;
+    out << "<road id=\"road_" << road << "\" junction=\"junction_"
+        << road / kRoadsPerJunction << "\"><lanes><laneSection>"
+        << "<boundaries><boundary type=\"leftBoundary\">";
+    WritePointSet(x, y + 0.5 * kLaneWidth, &out);
+    out << "</boundary><boundary type=\"rightBoundary\">";
+    WritePointSet(x, y - 2.5 * kLaneWidth, &out);
+    out << "</boundary></boundaries><center>";
+    WriteLane(road, 0, num_roads, x, y, &out);
+    out << "</center><right>";
+    WriteLane(road, -1, num_roads, x, y, &out);
+    WriteLane(road, -2, num_roads, x, y, &out);
+    out << "</right></laneSection></lanes><objects>"
+        << "<object id=\"crosswalk_" << road << "\" type=\"crosswalk\">";
+    WriteOutline(x + 0.5 * kRoadLength, y - 2.0 * kLaneWidth, kLaneWidth,
+                 &out);
+    out << "</object></objects></road>";
+  }
+  for (int road = 0; road < num_roads; road += kRoadsPerJunction) {
+    const double x = kWest + (road % kGridSize) * kRoadSpacing;
+    const double y = kSouth + (road / kGridSize) * kRoadSpacing;
+    out << "<junction id=\"junction_" << road / kRoadsPerJunction << "\">";
+    WriteOutline(x, y - kRoadSpacing / 2.0, kRoadSpacing, &out);
+    out << "<objectOverlapGroup><objectReference id=\"crosswalk_" << road
+        << "\"/></objectOverlapGroup></junction>";
+  }
+  out << "</OpenDRIVE>";
+  return filename;
+}
+
+// The map file and the single threaded result for each number of roads.
+struct SyntheticMap {
+  std::string filename;
+  std::string serialized_map;
+};
+
+const SyntheticMap& GetSyntheticMap(const int num_roads) {
+  static std::map<int, SyntheticMap> maps;
+  auto iter = maps.find(num_roads);
+  if (iter == maps.end()) {
+    SyntheticMap map;
+    map.filename = GenerateOpendrive(num_roads);
+    Map pb_map;
+    CHECK(OpendriveAdapter::LoadData(map.filename, &pb_map, 1));
+    map.serialized_map = pb_map.SerializeAsString();
+    iter = maps.emplace(num_roads, map).first;
+  }
+  return iter->second;
+}
+
+void BM_LoadData(benchmark::State& state) {  // NOLINT
+  const SyntheticMap& map = GetSyntheticMap(state.range(0));
+  const int num_threads = state.range(1);
+  while (state.KeepRunning()) {
+    Map pb_map;
+    CHECK(OpendriveAdapter::LoadData(map.filename, &pb_map, num_threads));
+    state.PauseTiming();
+    CHECK(pb_map.SerializeAsString() == map.serialized_map)
+        << "The map loaded with " << num_threads << " threads differs.";
+    state.ResumeTiming();
+  }
+}
+
+// From a district to a large city: 1k to 20k roads of 2 lanes.
+BENCHMARK(BM_LoadData)
+    ->Args({1000, 1})
+    ->Args({1000, 2})
+    ->Args({1000, 4})
+    ->Args({1000, 8})
+    ->Args({20000, 1})
+    ->Args({20000, 2})
+    ->Args({20000, 4})
+    ->Args({20000, 8})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace adapter
+}  // namespace hdmap
+}  // namespace apollo
+
+BENCHMARK_MAIN();
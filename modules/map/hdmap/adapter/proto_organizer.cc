@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "modules/map/hdmap/adapter/proto_organizer.h"
 
+#include <algorithm>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <string>
 #include <unordered_map>
@@ -28,11 +30,8 @@ limitations under the License.
 
 namespace {
 
-std::string CreateOverlapId() {
-  static int count = 0;
-  ++count;
-  return "overlap_" + std::to_string(count);
-}
+// Number of roads whose lane overlaps are built by one task.
+constexpr size_t kRoadsPerTask = 16;
 
 }  // namespace
 
@@ -41,6 +40,13 @@ namespace hdmap {
 namespace adapter {
 
 using apollo::common::util::PairHash;
+using apollo::common::util::ThreadPool;
+using google::protobuf::RepeatedPtrField;
+
+std::string ProtoOrganizer::CreateOverlapId() {
+  ++overlap_count_;
+  return "overlap_" + std::to_string(overlap_count_);
+}
 
 void ProtoOrganizer::GetRoadElements(std::vector<RoadInternal>* roads) {
   for (auto& road_internal : *roads) {
@@ -115,125 +121,120 @@ void ProtoOrganizer::GetJunctionElements(
   }
 }
 
+PbObjectOverlapInfo* ProtoOrganizer::AddLaneOverlap(
+    const std::string& lane_id, const OverlapWithLane& overlap_with_lane,
+    RepeatedPtrField<PbID>* object_overlap_ids,
+    std::deque<LaneOverlap>* lane_overlaps) {
+  lane_overlaps->emplace_back();
+  LaneOverlap& lane_overlap = lane_overlaps->back();
+  lane_overlap.lane_id = &lane_id;
+  lane_overlap.object_overlap_ids = object_overlap_ids;
+  PbObjectOverlapInfo* object_overlap = lane_overlap.overlap.add_object();
+  object_overlap->mutable_id()->set_id(lane_id);
+  object_overlap->mutable_lane_overlap_info()->set_start_s(
+      overlap_with_lane.start_s);
+  object_overlap->mutable_lane_overlap_info()->set_end_s(
+      overlap_with_lane.end_s);
+  object_overlap->mutable_lane_overlap_info()->set_is_merge(
+      overlap_with_lane.is_merge);
+  object_overlap = lane_overlap.overlap.add_object();
+  object_overlap->mutable_id()->set_id(overlap_with_lane.object_id);
+  return object_overlap;
+}
+
 void ProtoOrganizer::GetLaneObjectOverlapElements(
     const std::string& lane_id,
-    const std::vector<OverlapWithLane>& overlap_with_lanes) {
+    const std::vector<OverlapWithLane>& overlap_with_lanes,
+    std::deque<LaneOverlap>* lane_overlaps) {
   for (auto& overlap_object : overlap_with_lanes) {
-    std::string object_id = overlap_object.object_id;
-    if (proto_data_.pb_crosswalks.count(object_id) <= 0 &&
-        proto_data_.pb_clear_areas.count(object_id) <= 0 &&
-        proto_data_.pb_speed_bumps.count(object_id) <= 0 &&
-        proto_data_.pb_parking_spaces.count(object_id) <= 0) {
+    const std::string& object_id = overlap_object.object_id;
+    auto crosswalk = proto_data_.pb_crosswalks.find(object_id);
+    if (crosswalk != proto_data_.pb_crosswalks.end()) {
+      AddLaneOverlap(lane_id, overlap_object,
+                     crosswalk->second.mutable_overlap_id(), lane_overlaps)
+          ->mutable_crosswalk_overlap_info();
       continue;
     }
-    PbOverlap overlap;
-    std::string overlap_id = CreateOverlapId();
-    proto_data_.pb_lanes[lane_id].add_overlap_id()->set_id(overlap_id);
-    overlap.mutable_id()->set_id(overlap_id);
-    PbObjectOverlapInfo* object_overlap = overlap.add_object();
-    object_overlap->mutable_id()->set_id(lane_id);
-    object_overlap->mutable_lane_overlap_info()->set_start_s(
-        overlap_object.start_s);
-    object_overlap->mutable_lane_overlap_info()->set_end_s(
-        overlap_object.end_s);
-    object_overlap->mutable_lane_overlap_info()->set_is_merge(
-        overlap_object.is_merge);
-    object_overlap = overlap.add_object();
-    object_overlap->mutable_id()->set_id(object_id);
-    if (proto_data_.pb_crosswalks.count(object_id) > 0) {
-      proto_data_.pb_crosswalks[object_id].add_overlap_id()->set_id(overlap_id);
-      object_overlap->mutable_crosswalk_overlap_info();
-    } else if (proto_data_.pb_clear_areas.count(object_id) > 0) {
-      object_overlap->mutable_clear_area_overlap_info();
-      proto_data_.pb_clear_areas[object_id].add_overlap_id()->set_id(
-          overlap_id);
-    } else if (proto_data_.pb_speed_bumps.count(object_id)) {
-      object_overlap->mutable_speed_bump_overlap_info();
-      proto_data_.pb_speed_bumps[object_id].add_overlap_id()->set_id(
-          overlap_id);
-    } else if (proto_data_.pb_parking_spaces.count(object_id)) {
-      object_overlap->mutable_parking_space_overlap_info();
-      proto_data_.pb_parking_spaces[object_id].add_overlap_id()->set_id(
-          overlap_id);
-    } else {
-      AERROR << "unknown object, object id:" << object_id;
+    auto clear_area = proto_data_.pb_clear_areas.find(object_id);
+    if (clear_area != proto_data_.pb_clear_areas.end()) {
+      AddLaneOverlap(lane_id, overlap_object,
+                     clear_area->second.mutable_overlap_id(), lane_overlaps)
+          ->mutable_clear_area_overlap_info();
+      continue;
+    }
+    auto speed_bump = proto_data_.pb_speed_bumps.find(object_id);
+    if (speed_bump != proto_data_.pb_speed_bumps.end()) {
+      AddLaneOverlap(lane_id, overlap_object,
+                     speed_bump->second.mutable_overlap_id(), lane_overlaps)
+          ->mutable_speed_bump_overlap_info();
+      continue;
+    }
+    auto parking_space = proto_data_.pb_parking_spaces.find(object_id);
+    if (parking_space != proto_data_.pb_parking_spaces.end()) {
+      AddLaneOverlap(lane_id, overlap_object,
+                     parking_space->second.mutable_overlap_id(), lane_overlaps)
+          ->mutable_parking_space_overlap_info();
     }
-    proto_data_.pb_overlaps[overlap_id] = overlap;
   }
 }
 
 void ProtoOrganizer::GetLaneSignalOverlapElements(
     const std::string& lane_id,
-    const std::vector<OverlapWithLane>& overlap_with_lanes) {
+    const std::vector<OverlapWithLane>& overlap_with_lanes,
+    std::deque<LaneOverlap>* lane_overlaps) {
   for (auto& overlap_signal : overlap_with_lanes) {
-    std::string object_id = overlap_signal.object_id;
-    if (proto_data_.pb_signals.count(object_id) <= 0 &&
-        proto_data_.pb_stop_signs.count(object_id) <= 0 &&
-        proto_data_.pb_yield_signs.count(object_id) <= 0) {
-      AINFO << "cannot find signal object_id:" << object_id;
+    const std::string& object_id = overlap_signal.object_id;
+    auto signal = proto_data_.pb_signals.find(object_id);
+    if (signal != proto_data_.pb_signals.end()) {
+      AddLaneOverlap(lane_id, overlap_signal,
+                     signal->second.mutable_overlap_id(), lane_overlaps)
+          ->mutable_signal_overlap_info();
       continue;
     }
-    PbOverlap overlap;
-    std::string overlap_id = CreateOverlapId();
-    proto_data_.pb_lanes[lane_id].add_overlap_id()->set_id(overlap_id);
-    overlap.mutable_id()->set_id(overlap_id);
-    PbObjectOverlapInfo* object_overlap = overlap.add_object();
-    object_overlap->mutable_id()->set_id(lane_id);
-    object_overlap->mutable_lane_overlap_info()->set_start_s(
-        overlap_signal.start_s);
-    object_overlap->mutable_lane_overlap_info()->set_end_s(
-        overlap_signal.end_s);
-    object_overlap->mutable_lane_overlap_info()->set_is_merge(
-        overlap_signal.is_merge);
-    object_overlap = overlap.add_object();
-    object_overlap->mutable_id()->set_id(object_id);
-    if (proto_data_.pb_signals.count(object_id) > 0) {
-      object_overlap->mutable_signal_overlap_info();
-      proto_data_.pb_signals[object_id].add_overlap_id()->set_id(overlap_id);
-    } else if (proto_data_.pb_stop_signs.count(object_id) > 0) {
-      object_overlap->mutable_stop_sign_overlap_info();
-      proto_data_.pb_stop_signs[object_id].add_overlap_id()->set_id(overlap_id);
-    } else if (proto_data_.pb_yield_signs.count(object_id) > 0) {
-      object_overlap->mutable_yield_sign_overlap_info();
-      proto_data_.pb_yield_signs[object_id].add_overlap_id()->set_id(
-          overlap_id);
-    } else {
-      AERROR << "unknown signal, signal id:" << object_id;
+    auto stop_sign = proto_data_.pb_stop_signs.find(object_id);
+    if (stop_sign != proto_data_.pb_stop_signs.end()) {
+      AddLaneOverlap(lane_id, overlap_signal,
+                     stop_sign->second.mutable_overlap_id(), lane_overlaps)
+          ->mutable_stop_sign_overlap_info();
+      continue;
     }
-    proto_data_.pb_overlaps[overlap_id] = overlap;
+    auto yield_sign = proto_data_.pb_yield_signs.find(object_id);
+    if (yield_sign != proto_data_.pb_yield_signs.end()) {
+      AddLaneOverlap(lane_id, overlap_signal,
+                     yield_sign->second.mutable_overlap_id(), lane_overlaps)
+          ->mutable_yield_sign_overlap_info();
+      continue;
+    }
+    AINFO << "cannot find signal object_id:" << object_id;
   }
 }
 
 void ProtoOrganizer::GetLaneJunctionOverlapElements(
     const std::string& lane_id,
-    const std::vector<OverlapWithLane>& overlap_with_lanes) {
+    const std::vector<OverlapWithLane>& overlap_with_lanes,
+    std::deque<LaneOverlap>* lane_overlaps) {
   for (auto& overlap_junction : overlap_with_lanes) {
-    std::string object_id = overlap_junction.object_id;
-    if (proto_data_.pb_junctions.count(object_id) <= 0) {
+    const std::string& object_id = overlap_junction.object_id;
+    auto junction = proto_data_.pb_junctions.find(object_id);
+    if (junction == proto_data_.pb_junctions.end()) {
       AINFO << "cannot find junction object " << object_id;
       continue;
     }
-    PbOverlap overlap;
+    AddLaneOverlap(lane_id, overlap_junction,
+                   junction->second.mutable_overlap_id(), lane_overlaps)
+        ->mutable_junction_overlap_info();
+  }
+}
+
+void ProtoOrganizer::AddLaneOverlapElements(
+    std::deque<LaneOverlap>* lane_overlaps) {
+  for (auto& lane_overlap : *lane_overlaps) {
     std::string overlap_id = CreateOverlapId();
-    proto_data_.pb_lanes[lane_id].add_overlap_id()->set_id(overlap_id);
-    overlap.mutable_id()->set_id(overlap_id);
-    PbObjectOverlapInfo* object_overlap = overlap.add_object();
-    object_overlap->mutable_id()->set_id(lane_id);
-    object_overlap->mutable_lane_overlap_info()->set_start_s(
-        overlap_junction.start_s);
-    object_overlap->mutable_lane_overlap_info()->set_end_s(
-        overlap_junction.end_s);
-    object_overlap->mutable_lane_overlap_info()->set_is_merge(
-        overlap_junction.is_merge);
-    object_overlap = overlap.add_object();
-    object_overlap->mutable_id()->set_id(object_id);
-    if (proto_data_.pb_junctions.count(object_id) > 0) {
-      object_overlap->mutable_junction_overlap_info();
-      proto_data_.pb_junctions[object_id].add_overlap_id()->set_id(overlap_id);
-    } else {
-      AERROR << "unknown junction overlap, id:" << object_id;
-    }
-    proto_data_.pb_overlaps[overlap_id] = overlap;
+    proto_data_.pb_lanes[*lane_overlap.lane_id].add_overlap_id()->set_id(
+        overlap_id);
+    lane_overlap.object_overlap_ids->Add()->set_id(overlap_id);
+    lane_overlap.overlap.mutable_id()->set_id(overlap_id);
+    proto_data_.pb_overlaps[overlap_id].Swap(&lane_overlap.overlap);
   }
 }
 
@@ -328,18 +329,58 @@ void ProtoOrganizer::GetJunctionObjectOverlapElements(
 void ProtoOrganizer::GetOverlapElements(
     const std::vector<RoadInternal>& roads,
     const std::vector<JunctionInternal>& junctions) {
+  GetOverlapElements(roads, junctions, nullptr);
+}
+
+void ProtoOrganizer::GetOverlapElements(
+    const std::vector<RoadInternal>& roads,
+    const std::vector<JunctionInternal>& junctions, ThreadPool* thread_pool) {
+  // The overlaps of lanes with objects, signals and junctions only look up
+  // the elements, so they are built in parallel and numbered afterwards.
+  std::vector<std::deque<LaneOverlap>> road_lane_overlaps(
+      (roads.size() + kRoadsPerTask - 1) / kRoadsPerTask);
+  auto get_lane_overlaps = [&](const size_t task) {
+    const size_t begin = task * kRoadsPerTask;
+    const size_t end = std::min(begin + kRoadsPerTask, roads.size());
+    auto* lane_overlaps = &road_lane_overlaps[task];
+    for (size_t i = begin; i < end; ++i) {
+      for (auto& road_section : roads[i].sections) {
+        for (auto& lane_internal : road_section.lanes) {
+          const std::string& lane_id = lane_internal.lane.id().id();
+          GetLaneObjectOverlapElements(lane_id, lane_internal.overlap_objects,
+                                       lane_overlaps);
+          GetLaneSignalOverlapElements(lane_id, lane_internal.overlap_signals,
+                                       lane_overlaps);
+          GetLaneJunctionOverlapElements(
+              lane_id, lane_internal.overlap_junctions, lane_overlaps);
+        }
+      }
+    }
+  };
+  if (thread_pool == nullptr) {
+    for (size_t task = 0; task < road_lane_overlaps.size(); ++task) {
+      get_lane_overlaps(task);
+    }
+  } else {
+    std::vector<std::future<void>> results;
+    for (size_t task = 0; task < road_lane_overlaps.size(); ++task) {
+      results.push_back(thread_pool->enqueue(get_lane_overlaps, task));
+    }
+    for (auto& result : results) {
+      result.get();
+    }
+  }
+  for (auto& lane_overlaps : road_lane_overlaps) {
+    AddLaneOverlapElements(&lane_overlaps);
+  }
+
   std::unordered_map<std::pair<std::string, std::string>, OverlapWithLane,
                      PairHash>
       lane_lane_overlaps;
-  // overlap
   for (auto& road_internal : roads) {
     for (auto& road_section : road_internal.sections) {
       for (auto& lane_internal : road_section.lanes) {
-        std::string lane_id = lane_internal.lane.id().id();
-        GetLaneObjectOverlapElements(lane_id, lane_internal.overlap_objects);
-        GetLaneSignalOverlapElements(lane_id, lane_internal.overlap_signals);
-        GetLaneJunctionOverlapElements(lane_id,
-                                       lane_internal.overlap_junctions);
+        const std::string& lane_id = lane_internal.lane.id().id();
         for (auto& overlap_lane : lane_internal.overlap_lanes) {
           lane_lane_overlaps[make_pair(lane_id, overlap_lane.object_id)] =
               overlap_lane;
@@ -354,37 +395,37 @@ void ProtoOrganizer::GetOverlapElements(
 
 void ProtoOrganizer::OutputData(apollo::hdmap::Map* pb_map) {
   for (auto& road_pair : proto_data_.pb_roads) {
-    *(pb_map->add_road()) = road_pair.second;
+    pb_map->add_road()->Swap(&road_pair.second);
   }
   for (auto& lane_pair : proto_data_.pb_lanes) {
-    *(pb_map->add_lane()) = lane_pair.second;
+    pb_map->add_lane()->Swap(&lane_pair.second);
   }
   for (auto& crosswalk_pair : proto_data_.pb_crosswalks) {
-    *(pb_map->add_crosswalk()) = crosswalk_pair.second;
+    pb_map->add_crosswalk()->Swap(&crosswalk_pair.second);
   }
   for (auto& parking_space_pair : proto_data_.pb_parking_spaces) {
-    *(pb_map->add_parking_space()) = parking_space_pair.second;
+    pb_map->add_parking_space()->Swap(&parking_space_pair.second);
   }
   for (auto& clear_area_pair : proto_data_.pb_clear_areas) {
-    *(pb_map->add_clear_area()) = clear_area_pair.second;
+    pb_map->add_clear_area()->Swap(&clear_area_pair.second);
   }
   for (auto& speed_bump_pair : proto_data_.pb_speed_bumps) {
-    *(pb_map->add_speed_bump()) = speed_bump_pair.second;
+    pb_map->add_speed_bump()->Swap(&speed_bump_pair.second);
   }
   for (auto& signal_pair : proto_data_.pb_signals) {
-    *(pb_map->add_signal()) = signal_pair.second;
+    pb_map->add_signal()->Swap(&signal_pair.second);
   }
   for (auto& stop_sign_pair : proto_data_.pb_stop_signs) {
-    *(pb_map->add_stop_sign()) = stop_sign_pair.second;
+    pb_map->add_stop_sign()->Swap(&stop_sign_pair.second);
   }
   for (auto& yield_sign_pair : proto_data_.pb_yield_signs) {
-    *(pb_map->add_yield()) = yield_sign_pair.second;
+    pb_map->add_yield()->Swap(&yield_sign_pair.second);
   }
   for (auto& junction_pair : proto_data_.pb_junctions) {
-    *(pb_map->add_junction()) = junction_pair.second;
+    pb_map->add_junction()->Swap(&junction_pair.second);
   }
   for (auto& overlap_pair : proto_data_.pb_overlaps) {
-    *(pb_map->add_overlap()) = overlap_pair.second;
+    pb_map->add_overlap()->Swap(&overlap_pair.second);
   }
 
   AINFO << "hdmap statistics: roads-" << proto_data_.pb_roads.size()
@@ -16,12 +16,14 @@ limitations under the License.
 #ifndef MODULES_MAP_HDMAP_ADAPTER_PROTO_ORGANIZER_H_
 #define MODULES_MAP_HDMAP_ADAPTER_PROTO_ORGANIZER_H_
 
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "modules/common/util/threadpool.h"
 #include "modules/common/util/util.h"
 
 #include "modules/map/proto/map.pb.h"
@@ -54,18 +56,41 @@ class ProtoOrganizer {
   void GetJunctionElements(const std::vector<JunctionInternal>& junctions);
   void GetOverlapElements(const std::vector<RoadInternal>& roads,
                           const std::vector<JunctionInternal>& junctions);
+  // Builds the overlaps of lanes with objects, signals and junctions by
+  // chunks of roads on thread_pool, if it is not null. The overlaps are
+  // numbered in the order of the roads, the same as without a thread pool.
+  void GetOverlapElements(const std::vector<RoadInternal>& roads,
+                          const std::vector<JunctionInternal>& junctions,
+                          apollo::common::util::ThreadPool* thread_pool);
+  // Moves the organized elements to pb_map.
   void OutputData(apollo::hdmap::Map* pb_map);
 
  private:
+  // An overlap of a lane with another element, waiting for its id.
+  struct LaneOverlap {
+    const std::string* lane_id = nullptr;
+    google::protobuf::RepeatedPtrField<PbID>* object_overlap_ids = nullptr;
+    PbOverlap overlap;
+  };
+
+  std::string CreateOverlapId();
+  PbObjectOverlapInfo* AddLaneOverlap(
+      const std::string& lane_id, const OverlapWithLane& overlap_with_lane,
+      google::protobuf::RepeatedPtrField<PbID>* object_overlap_ids,
+      std::deque<LaneOverlap>* lane_overlaps);
   void GetLaneObjectOverlapElements(
       const std::string& lane_id,
-      const std::vector<OverlapWithLane>& overlap_with_lanes);
+      const std::vector<OverlapWithLane>& overlap_with_lanes,
+      std::deque<LaneOverlap>* lane_overlaps);
   void GetLaneSignalOverlapElements(
       const std::string& lane_id,
-      const std::vector<OverlapWithLane>& overlap_with_lanes);
+      const std::vector<OverlapWithLane>& overlap_with_lanes,
+      std::deque<LaneOverlap>* lane_overlaps);
   void GetLaneJunctionOverlapElements(
       const std::string& lane_id,
-      const std::vector<OverlapWithLane>& overlap_with_lanes);
+      const std::vector<OverlapWithLane>& overlap_with_lanes,
+      std::deque<LaneOverlap>* lane_overlaps);
+  void AddLaneOverlapElements(std::deque<LaneOverlap>* lane_overlaps);
   void GetLaneLaneOverlapElements(
       const std::unordered_map<std::pair<std::string, std::string>,
                                OverlapWithLane, apollo::common::util::PairHash>&
@@ -75,6 +100,7 @@ class ProtoOrganizer {
 
  private:
   ProtoData proto_data_;
+  int overlap_count_ = 0;
 };
 
 }  // namespace adapter
@@ -12,6 +12,8 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 =========================================================================*/
+#include <algorithm>
+#include <future>
 #include <string>
 #include <vector>
 
@@ -26,6 +28,9 @@ bool IsRoadBelongToJunction(const std::string& road_id) {
   CHECK(!road_id.empty());
   return road_id != "-1";
 }
+
+// Number of roads parsed by one task of the thread pool.
+constexpr size_t kRoadsPerTask = 16;
 }  // namespace
 
 namespace apollo {
@@ -34,60 +39,100 @@ namespace adapter {
 
 Status RoadsXmlParser::Parse(const tinyxml2::XMLElement& xml_node,
                              std::vector<RoadInternal>* roads) {
+  return Parse(xml_node, nullptr, roads);
+}
+
+Status RoadsXmlParser::Parse(const tinyxml2::XMLElement& xml_node,
+                             apollo::common::util::ThreadPool* thread_pool,
+                             std::vector<RoadInternal>* roads) {
   CHECK_NOTNULL(roads);
 
+  // Roads are independent subtrees of the document, so they are collected
+  // first and then parsed in place, each by a single thread.
+  std::vector<const tinyxml2::XMLElement*> road_nodes;
   auto road_node = xml_node.FirstChildElement("road");
   while (road_node) {
-    // road attributes
-    std::string id;
-    std::string junction_id;
-    int checker = UtilXmlParser::QueryStringAttribute(*road_node, "id", &id);
-    checker += UtilXmlParser::QueryStringAttribute(*road_node, "junction",
-                                                   &junction_id);
-    if (checker != tinyxml2::XML_SUCCESS) {
-      std::string err_msg = "Error parsing road attributes";
-      return Status(apollo::common::ErrorCode::HDMAP_DATA_ERROR, err_msg);
-    }
-    RoadInternal road_internal;
-    road_internal.id = id;
-    road_internal.road.mutable_id()->set_id(id);
-    if (IsRoadBelongToJunction(junction_id)) {
-      road_internal.road.mutable_junction_id()->set_id(junction_id);
-    }
-    // lanes
-    RETURN_IF_ERROR(LanesXmlParser::Parse(*road_node, road_internal.id,
-                                          &road_internal.sections));
-
-    // objects
-    auto sub_node = road_node->FirstChildElement("objects");
-    if (sub_node != nullptr) {
-      // stop line
-      ObjectsXmlParser::ParseStopLines(*sub_node, &road_internal.stop_lines);
-      // crosswalks
-      ObjectsXmlParser::ParseCrosswalks(*sub_node, &road_internal.crosswalks);
-      // clearareas
-      ObjectsXmlParser::ParseClearAreas(*sub_node, &road_internal.clear_areas);
-      // speed_bumps
-      ObjectsXmlParser::ParseSpeedBumps(*sub_node, &road_internal.speed_bumps);
-      // parking_spaces
-      ObjectsXmlParser::ParseParkingSpaces(
-                                    *sub_node, &road_internal.parking_spaces);
+    road_nodes.push_back(road_node);
+    road_node = road_node->NextSiblingElement("road");
+  }
+  const size_t first_road = roads->size();
+  roads->resize(first_road + road_nodes.size());
+
+  auto parse_roads = [&](const size_t begin, const size_t end) -> Status {
+    for (size_t i = begin; i < end; ++i) {
+      RETURN_IF_ERROR(ParseRoad(*road_nodes[i], &(*roads)[first_road + i]));
     }
+    return Status::OK();
+  };
+  if (thread_pool == nullptr) {
+    return parse_roads(0, road_nodes.size());
+  }
 
-    // signals
-    sub_node = road_node->FirstChildElement("signals");
-    if (sub_node != nullptr) {
-      // traffic lights
-      SignalsXmlParser::ParseTrafficLights(*sub_node,
-                                           &road_internal.traffic_lights);
-      // stop signs
-      SignalsXmlParser::ParseStopSigns(*sub_node, &road_internal.stop_signs);
-      // yield signs
-      SignalsXmlParser::ParseYieldSigns(*sub_node, &road_internal.yield_signs);
+  std::vector<std::future<Status>> results;
+  for (size_t begin = 0; begin < road_nodes.size(); begin += kRoadsPerTask) {
+    const size_t end = std::min(begin + kRoadsPerTask, road_nodes.size());
+    results.push_back(thread_pool->enqueue(parse_roads, begin, end));
+  }
+  // Wait for all the tasks, and report the first error in document order.
+  Status status = Status::OK();
+  for (auto& result : results) {
+    const Status result_status = result.get();
+    if (status.ok() && !result_status.ok()) {
+      status = result_status;
     }
+  }
+  return status;
+}
 
-    roads->push_back(road_internal);
-    road_node = road_node->NextSiblingElement("road");
+Status RoadsXmlParser::ParseRoad(const tinyxml2::XMLElement& road_node,
+                                 RoadInternal* road_internal) {
+  CHECK_NOTNULL(road_internal);
+
+  // road attributes
+  std::string id;
+  std::string junction_id;
+  int checker = UtilXmlParser::QueryStringAttribute(road_node, "id", &id);
+  checker += UtilXmlParser::QueryStringAttribute(road_node, "junction",
+                                                 &junction_id);
+  if (checker != tinyxml2::XML_SUCCESS) {
+    std::string err_msg = "Error parsing road attributes";
+    return Status(apollo::common::ErrorCode::HDMAP_DATA_ERROR, err_msg);
+  }
+  road_internal->id = id;
+  road_internal->road.mutable_id()->set_id(id);
+  if (IsRoadBelongToJunction(junction_id)) {
+    road_internal->road.mutable_junction_id()->set_id(junction_id);
+  }
+  // lanes
+  RETURN_IF_ERROR(LanesXmlParser::Parse(road_node, road_internal->id,
+                                        &road_internal->sections));
+
+  // objects
+  auto sub_node = road_node.FirstChildElement("objects");
+  if (sub_node != nullptr) {
+    // stop line
+    ObjectsXmlParser::ParseStopLines(*sub_node, &road_internal->stop_lines);
+    // crosswalks
+    ObjectsXmlParser::ParseCrosswalks(*sub_node, &road_internal->crosswalks);
+    // clearareas
+    ObjectsXmlParser::ParseClearAreas(*sub_node, &road_internal->clear_areas);
+    // speed_bumps
+    ObjectsXmlParser::ParseSpeedBumps(*sub_node, &road_internal->speed_bumps);
+    // parking_spaces
+    ObjectsXmlParser::ParseParkingSpaces(*sub_node,
+                                         &road_internal->parking_spaces);
+  }
+
+  // signals
+  sub_node = road_node.FirstChildElement("signals");
+  if (sub_node != nullptr) {
+    // traffic lights
+    SignalsXmlParser::ParseTrafficLights(*sub_node,
+                                         &road_internal->traffic_lights);
+    // stop signs
+    SignalsXmlParser::ParseStopSigns(*sub_node, &road_internal->stop_signs);
+    // yield signs
+    SignalsXmlParser::ParseYieldSigns(*sub_node, &road_internal->yield_signs);
   }
 
   return Status::OK();
@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "tinyxml2/tinyxml2.h"
 
+#include "modules/common/util/threadpool.h"
 #include "modules/map/hdmap/adapter/xml_parser/common_define.h"
 #include "modules/map/hdmap/adapter/xml_parser/status.h"
 
@@ -32,6 +33,16 @@ class RoadsXmlParser {
  public:
   static Status Parse(const tinyxml2::XMLElement& xml_node,
                       std::vector<RoadInternal>* roads);
+
+  // Parses chunks of roads in parallel on thread_pool, if it is not null.
+  // The roads are in the order of the document, the same as Parse() above.
+  static Status Parse(const tinyxml2::XMLElement& xml_node,
+                      apollo::common::util::ThreadPool* thread_pool,
+                      std::vector<RoadInternal>* roads);
+
+ private:
+  static Status ParseRoad(const tinyxml2::XMLElement& road_node,
+                          RoadInternal* road_internal);
 };
 
 }  // namespace adapter
@@ -25,16 +25,44 @@ int HDMap::LoadMapFromFile(const std::string& map_filename) {
   return impl_.LoadMapFromFile(map_filename);
 }
 
+int HDMap::LoadMapFromFile(const std::string& map_filename,
+                           const std::string& kdtree_cache_filename) {
+  AINFO << "Loading HDMap: " << map_filename << " with KD-tree cache "
+        << kdtree_cache_filename << " ...";
+  return impl_.LoadMapFromFile(map_filename, kdtree_cache_filename);
+}
+
 int HDMap::LoadMapFromProto(const Map& map_proto) {
   ADEBUG << "Loading HDMap with header: "
          << map_proto.header().ShortDebugString();
   return impl_.LoadMapFromProto(map_proto);
 }
 
+int HDMap::LoadMapFromTiles(
+    const std::vector<std::shared_ptr<const HDMap>>& tiles,
+    const std::vector<std::unordered_set<std::string>>& borrowed_ids) {
+  std::vector<std::shared_ptr<const HDMapImpl>> tile_impls;
+  tile_impls.reserve(tiles.size());
+  for (const auto& tile : tiles) {
+    tile_impls.emplace_back(tile, &tile->impl_);
+  }
+  return impl_.LoadMapFromTiles(tile_impls, borrowed_ids);
+}
+
+int64_t HDMap::SpaceUsed() const { return impl_.SpaceUsed(); }
+
+int HDMap::SaveKDTreeCache(const std::string& kdtree_cache_filename) const {
+  return impl_.SaveKDTreeCache(kdtree_cache_filename);
+}
+
 LaneInfoConstPtr HDMap::GetLaneById(const Id& id) const {
   return impl_.GetLaneById(id);
 }
 
+const LaneTopology& HDMap::lane_topology() const {
+  return impl_.lane_topology();
+}
+
 JunctionInfoConstPtr HDMap::GetJunctionById(const Id& id) const {
   return impl_.GetJunctionById(id);
 }
@@ -147,6 +175,33 @@ int HDMap::GetNearestLaneWithHeading(const apollo::common::PointENU& point,
                                          nearest_s, nearest_l);
 }
 
+int HDMap::GetLanesBatch(
+    const std::vector<apollo::common::PointENU>& points, const double distance,
+    std::vector<std::vector<LaneInfoConstPtr>>* lanes) const {
+  return impl_.GetLanesBatch(points, distance, lanes);
+}
+
+int HDMap::GetNearestLanesWithHeadingBatch(
+    const std::vector<apollo::common::PointENU>& points, const double distance,
+    const std::vector<double>& central_headings,
+    const double max_heading_difference,
+    std::vector<LaneInfoConstPtr>* nearest_lanes,
+    std::vector<double>* nearest_s, std::vector<double>* nearest_l) const {
+  return impl_.GetNearestLanesWithHeadingBatch(
+      points, distance, central_headings, max_heading_difference,
+      nearest_lanes, nearest_s, nearest_l);
+}
+
+int HDMap::GetLanesWithHeading(
+    const apollo::common::PointENU& point, const double distance,
+    const double central_heading, const double max_heading_difference,
+    const std::vector<LaneInfoConstPtr>& candidate_lanes,
+    std::vector<LaneInfoConstPtr>* lanes) const {
+  return impl_.GetLanesWithHeading(point, distance, central_heading,
+                                   max_heading_difference, candidate_lanes,
+                                   lanes);
+}
+
 int HDMap::GetLanesWithHeading(const apollo::common::PointENU& point,
                                const double distance,
                                const double central_heading,
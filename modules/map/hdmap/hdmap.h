@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "modules/common/macro.h"
@@ -58,6 +59,17 @@ class HDMap {
    */
   int LoadMapFromFile(const std::string& map_filename);
 
+  /**
+   * @brief load map from local file, adopting the spatial indices from a
+   *        KD-tree cache instead of building them. The map file is still
+   *        parsed as usual.
+   * @param map_filename path of map data file
+   * @param kdtree_cache_filename path of the KD-tree cache file
+   * @return 0:success, otherwise failed
+   */
+  int LoadMapFromFile(const std::string& map_filename,
+                      const std::string& kdtree_cache_filename);
+
   /**
    * @brief load map from a given protobuf message.
    * @param map_proto map data in protobuf format
@@ -65,6 +77,33 @@ class HDMap {
    */
   int LoadMapFromProto(const Map& map_proto);
 
+  /**
+   * @brief build the map from the maps of its tiles, sharing their elements
+   *        and kdtrees. See HDMapImpl::LoadMapFromTiles.
+   * @param tiles the maps of the tiles, which are held by this map
+   * @param borrowed_ids for each tile, the ids of the elements it only holds
+   *        for the overlaps of its own elements
+   * @return 0:success, otherwise failed
+   */
+  int LoadMapFromTiles(
+      const std::vector<std::shared_ptr<const HDMap>>& tiles,
+      const std::vector<std::unordered_set<std::string>>& borrowed_ids);
+
+  /**
+   * @brief estimate the memory used by the map, without the tiles it is
+   *        built from.
+   * @return the estimated memory in bytes
+   */
+  int64_t SpaceUsed() const;
+
+  /**
+   * @brief save the spatial indices of the map loaded from a file as a
+   *        KD-tree cache, which is used by LoadMapFromFile for the same file.
+   * @param kdtree_cache_filename path of the KD-tree cache file
+   * @return 0:success, otherwise failed
+   */
+  int SaveKDTreeCache(const std::string& kdtree_cache_filename) const;
+
   LaneInfoConstPtr GetLaneById(const Id& id) const;
   JunctionInfoConstPtr GetJunctionById(const Id& id) const;
   SignalInfoConstPtr GetSignalById(const Id& id) const;
@@ -77,6 +116,12 @@ class HDMap {
   RoadInfoConstPtr GetRoadById(const Id& id) const;
   ParkingSpaceInfoConstPtr GetParkingSpaceById(const Id& id) const;
 
+  /**
+   * @brief get the integer indexed lane graph of the map, built at load time
+   * @return the lane topology
+   */
+  const LaneTopology& lane_topology() const;
+
   /**
    * @brief get all lanes in certain range
    * @param point the central point of the range
@@ -210,6 +255,56 @@ class HDMap {
                           const double distance, const double central_heading,
                           const double max_heading_difference,
                           std::vector<LaneInfoConstPtr>* lanes) const;
+  /**
+   * @brief get all lanes in certain range of each of a batch of points. The
+   *        lane segments are searched once for the whole batch.
+   * @param points the central points of the ranges
+   * @param distance the search radius
+   * @param lanes store all lanes in target range, one vector per point
+   * @return 0:success, otherwise failed
+   */
+  int GetLanesBatch(const std::vector<apollo::common::PointENU>& points,
+                    const double distance,
+                    std::vector<std::vector<LaneInfoConstPtr>>* lanes) const;
+  /**
+   * @brief get the nearest lane within a certain range by pose for each of a
+   *        batch of poses. The lane segments are searched once for the whole
+   *        batch.
+   * @param points the target positions
+   * @param distance the search radius
+   * @param central_headings the base heading of each position
+   * @param max_heading_difference the heading range
+   * @param nearest_lanes the nearest lane that match search conditions for
+   *        each position, nullptr if there is none
+   * @param nearest_s the offset from lane start point along lane center line
+   *        for each position
+   * @param nearest_l the lateral offset from lane center line for each
+   *        position
+   * @return 0:success, otherwise, failed.
+   */
+  int GetNearestLanesWithHeadingBatch(
+      const std::vector<apollo::common::PointENU>& points,
+      const double distance, const std::vector<double>& central_headings,
+      const double max_heading_difference,
+      std::vector<LaneInfoConstPtr>* nearest_lanes,
+      std::vector<double>* nearest_s, std::vector<double>* nearest_l) const;
+  /**
+   * @brief get the lanes within a certain range by pose among candidate
+   *        lanes, such as the lanes found by GetLanesBatch with a radius no
+   *        smaller than distance.
+   * @param point the target position
+   * @param distance the search radius
+   * @param central_heading the base heading
+   * @param max_heading_difference the heading range
+   * @param candidate_lanes the lanes to select from
+   * @param lanes all candidate lanes that match search conditions
+   * @return 0:success, otherwise, failed.
+   */
+  int GetLanesWithHeading(const apollo::common::PointENU& point,
+                          const double distance, const double central_heading,
+                          const double max_heading_difference,
+                          const std::vector<LaneInfoConstPtr>& candidate_lanes,
+                          std::vector<LaneInfoConstPtr>* lanes) const;
   /**
    * @brief get all road and junctions boundaries within certain range
    * @param point the target position
@@ -61,6 +61,11 @@ class ObjectWithAABox {
   double DistanceSquareTo(const apollo::common::math::Vec2d &point) const {
     return geo_object_->DistanceSquareTo(point);
   }
+  void DistanceSquareTo(const double *xs, const double *ys,
+                        const int num_points,
+                        double *const distance_sqrs) const {
+    geo_object_->DistanceSquareTo(xs, ys, num_points, distance_sqrs);
+  }
   const Object *object() const { return object_; }
   const GeoObject *geo_object() const { return geo_object_; }
   int id() const { return id_; }
@@ -110,6 +115,8 @@ class LaneInfo {
   const Id &id() const { return lane_.id(); }
   const Id &road_id() const { return road_id_; }
   const Id &section_id() const { return section_id_; }
+  // Index of the lane in the LaneTopology of its map.
+  int index() const { return index_; }
   const Lane &lane() const { return lane_; }
   const std::vector<apollo::common::math::Vec2d> &points() const {
     return points_;
@@ -193,6 +200,7 @@ class LaneInfo {
   void CreateKDTree();
   void set_road_id(const Id &road_id) { road_id_ = road_id; }
   void set_section_id(const Id &section_id) { section_id_ = section_id; }
+  void set_index(const int index) { index_ = index; }
 
  private:
   const Lane &lane_;
@@ -224,6 +232,7 @@ class LaneInfo {
 
   Id road_id_;
   Id section_id_;
+  int index_ = -1;
 };
 
 class JunctionInfo {
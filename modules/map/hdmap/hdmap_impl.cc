@@ -19,6 +19,7 @@ limitations under the License.
 #include <iostream>
 #include <limits>
 #include <unordered_set>
+#include <utility>
 
 #include "modules/common/util/file.h"
 #include "modules/common/util/string_util.h"
@@ -29,7 +30,10 @@ namespace hdmap {
 namespace {
 
 using apollo::common::PointENU;
+using apollo::common::math::AABox2d;
 using apollo::common::math::AABoxKDTreeParams;
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Polygon2d;
 using apollo::common::math::Vec2d;
 
 Id CreateHDMapId(const std::string& string_id) {
@@ -43,9 +47,38 @@ constexpr double kLanesSearchRange = 10.0;
 // backward search distance in GetForwardNearestSignalsOnLane
 constexpr int kBackwardDistance = 4;
 
+// Rough memory costs used by HDMapImpl::SpaceUsed(): a node and a bucket of
+// an unordered_map, and the nodes of a kdtree amortized over its objects.
+constexpr int64_t kHashNodeBytes = 4 * sizeof(void*);
+constexpr int64_t kKDTreeBytesPerObject = 48;
+
+template <class Object>
+int64_t BoxTableSpaceUsed(
+    const std::vector<ObjectWithAABox<Object, LineSegment2d>>& box_table) {
+  return box_table.size() * (sizeof(box_table[0]) + sizeof(LineSegment2d) +
+                             kKDTreeBytesPerObject);
+}
+
+template <class Object>
+int64_t BoxTableSpaceUsed(
+    const std::vector<ObjectWithAABox<Object, Polygon2d>>& box_table) {
+  int64_t bytes = 0;
+  for (const auto& box : box_table) {
+    bytes += sizeof(box) + kKDTreeBytesPerObject +
+             box.geo_object()->num_points() *
+                 (sizeof(Vec2d) + sizeof(LineSegment2d));
+  }
+  return bytes;
+}
+
 }  // namespace
 
 int HDMapImpl::LoadMapFromFile(const std::string& map_filename) {
+  return LoadMapFromFile(map_filename, "");
+}
+
+int HDMapImpl::LoadMapFromFile(const std::string& map_filename,
+                               const std::string& kdtree_cache_filename) {
   Clear();
   // TODO(startcode) seems map_ can be changed to a local variable of this
   // function, but test will fail if I do so. if so.
@@ -56,7 +89,17 @@ int HDMapImpl::LoadMapFromFile(const std::string& map_filename) {
   } else if (!apollo::common::util::GetProtoFromFile(map_filename, &map_)) {
     return -1;
   }
-  return LoadMapFromProto(map_);
+  HDMapKDTreeCache::GetSource(map_filename, &map_source_);
+  if (kdtree_cache_filename.empty()) {
+    return LoadMapFromProto(map_);
+  }
+  InitTables();
+  if (!RestoreKDTrees(kdtree_cache_filename)) {
+    AWARN << "Build kdtrees without the KD-tree cache "
+          << kdtree_cache_filename;
+    BuildKDTrees();
+  }
+  return 0;
 }
 
 int HDMapImpl::LoadMapFromProto(const Map& map_proto) {
@@ -64,6 +107,167 @@ int HDMapImpl::LoadMapFromProto(const Map& map_proto) {
     Clear();
     map_ = map_proto;
   }
+  InitTables();
+  BuildKDTrees();
+  return 0;
+}
+
+int HDMapImpl::LoadMapFromTiles(
+    const std::vector<std::shared_ptr<const HDMapImpl>>& tiles,
+    const std::vector<std::unordered_set<std::string>>& borrowed_ids) {
+  Clear();
+  if (tiles.size() != borrowed_ids.size()) {
+    AERROR << "Got " << tiles.size() << " tiles but " << borrowed_ids.size()
+           << " sets of borrowed ids.";
+    return -1;
+  }
+  tiles_ = tiles;
+  // The tables take the elements a tile owns first, so an element borrowed
+  // by a tile is only taken from it if no loaded tile owns the element.
+  const std::unordered_set<std::string> no_ids;
+  for (const bool owned : {true, false}) {
+    for (size_t i = 0; i < tiles_.size(); ++i) {
+      const HDMapImpl& tile = *tiles_[i];
+      const auto& skip_ids = owned ? borrowed_ids[i] : no_ids;
+      MergeTileTable(tile.lane_table_, skip_ids, &lane_table_);
+      MergeTileTable(tile.junction_table_, skip_ids, &junction_table_);
+      MergeTileTable(tile.signal_table_, skip_ids, &signal_table_);
+      MergeTileTable(tile.crosswalk_table_, skip_ids, &crosswalk_table_);
+      MergeTileTable(tile.stop_sign_table_, skip_ids, &stop_sign_table_);
+      MergeTileTable(tile.yield_sign_table_, skip_ids, &yield_sign_table_);
+      MergeTileTable(tile.clear_area_table_, skip_ids, &clear_area_table_);
+      MergeTileTable(tile.speed_bump_table_, skip_ids, &speed_bump_table_);
+      MergeTileTable(tile.overlap_table_, skip_ids, &overlap_table_);
+      MergeTileTable(tile.parking_space_table_, skip_ids,
+                     &parking_space_table_);
+    }
+  }
+  MergeTileRoads();
+
+  // The lane indices of the tiles are not changed, since the tiles may be
+  // shared with other maps, so LaneTopology looks these lanes up by id.
+  std::vector<LaneInfoConstPtr> lanes;
+  std::unordered_set<const LaneInfo*> added_lanes;
+  for (const auto& tile : tiles_) {
+    const LaneTopology& tile_topology = tile->lane_topology_;
+    for (int i = 0; i < tile_topology.num_lanes(); ++i) {
+      const auto& lane = lane_table_[tile_topology.lane(i)->id().id()];
+      if (added_lanes.insert(lane.get()).second) {
+        lanes.push_back(lane);
+      }
+    }
+  }
+  lane_topology_.Build(lanes);
+  return 0;
+}
+
+int HDMapImpl::SaveKDTreeCache(const std::string& kdtree_cache_filename) const {
+  std::vector<KDTreeCacheTreeData> kdtrees(NUM_MAP_KDTREES);
+  FlattenKDTree(map_.lane(), lane_segment_boxes_, lane_segment_kdtree_,
+                &kdtrees[LANE_SEGMENT_KDTREE]);
+  FlattenKDTree(map_.junction(), junction_polygon_boxes_,
+                junction_polygon_kdtree_, &kdtrees[JUNCTION_POLYGON_KDTREE]);
+  FlattenKDTree(map_.signal(), signal_segment_boxes_, signal_segment_kdtree_,
+                &kdtrees[SIGNAL_SEGMENT_KDTREE]);
+  FlattenKDTree(map_.crosswalk(), crosswalk_polygon_boxes_,
+                crosswalk_polygon_kdtree_, &kdtrees[CROSSWALK_POLYGON_KDTREE]);
+  FlattenKDTree(map_.stop_sign(), stop_sign_segment_boxes_,
+                stop_sign_segment_kdtree_, &kdtrees[STOP_SIGN_SEGMENT_KDTREE]);
+  FlattenKDTree(map_.yield(), yield_sign_segment_boxes_,
+                yield_sign_segment_kdtree_,
+                &kdtrees[YIELD_SIGN_SEGMENT_KDTREE]);
+  FlattenKDTree(map_.clear_area(), clear_area_polygon_boxes_,
+                clear_area_polygon_kdtree_,
+                &kdtrees[CLEAR_AREA_POLYGON_KDTREE]);
+  FlattenKDTree(map_.speed_bump(), speed_bump_segment_boxes_,
+                speed_bump_segment_kdtree_,
+                &kdtrees[SPEED_BUMP_SEGMENT_KDTREE]);
+  FlattenKDTree(map_.parking_space(), parking_space_polygon_boxes_,
+                parking_space_polygon_kdtree_,
+                &kdtrees[PARKING_SPACE_POLYGON_KDTREE]);
+  return HDMapKDTreeCache::Write(kdtree_cache_filename, map_source_, kdtrees)
+             ? 0
+             : -1;
+}
+
+int64_t HDMapImpl::SpaceUsed() const {
+  const auto table_bytes = [](const size_t size) {
+    return static_cast<int64_t>(size) *
+           (kHashNodeBytes + sizeof(std::string) +
+            sizeof(std::shared_ptr<void>));
+  };
+  int64_t bytes = map_.SpaceUsed();
+  bytes += table_bytes(lane_table_.size());
+  bytes += table_bytes(junction_table_.size());
+  bytes += table_bytes(signal_table_.size());
+  bytes += table_bytes(crosswalk_table_.size());
+  bytes += table_bytes(stop_sign_table_.size());
+  bytes += table_bytes(yield_sign_table_.size());
+  bytes += table_bytes(clear_area_table_.size());
+  bytes += table_bytes(speed_bump_table_.size());
+  bytes += table_bytes(overlap_table_.size());
+  bytes += table_bytes(road_table_.size());
+  bytes += table_bytes(parking_space_table_.size());
+
+  // The lane topology: the lanes, their lengths, ids and related lanes.
+  for (int i = 0; i < lane_topology_.num_lanes(); ++i) {
+    bytes += sizeof(LaneInfoConstPtr) + sizeof(double) + kHashNodeBytes +
+             sizeof(std::string) + NUM_LANE_RELATIONS * sizeof(int32_t);
+    for (int r = 0; r < NUM_LANE_RELATIONS; ++r) {
+      const auto relation = static_cast<LaneRelation>(r);
+      bytes += lane_topology_.GetRelatedLanes(relation, i).size() *
+               sizeof(int32_t);
+    }
+  }
+  // Roads are copied into their infos, and a map built from tiles builds
+  // the roads crossing tiles again.
+  for (const auto& road_ptr_pair : road_table_) {
+    bytes += sizeof(RoadInfo) + road_ptr_pair.second->road().SpaceUsed();
+  }
+  if (!tiles_.empty()) {
+    // The other elements and the kdtrees are owned by the tiles.
+    return bytes;
+  }
+
+  // The geometry of the lanes, with the kdtree of the segments of each lane.
+  for (const auto& lane_ptr_pair : lane_table_) {
+    const LaneInfo& lane = *lane_ptr_pair.second;
+    bytes += sizeof(LaneInfo);
+    bytes += lane.points().size() *
+             (2 * sizeof(Vec2d) + 2 * sizeof(double) + sizeof(LaneSegmentBox) +
+              kKDTreeBytesPerObject);
+    bytes += (lane.sampled_left_width().size() +
+              lane.sampled_right_width().size() +
+              lane.sampled_left_road_width().size() +
+              lane.sampled_right_road_width().size()) *
+             sizeof(LaneInfo::SampledWidth);
+    // Each overlap is in the list of all overlaps and in one by its type.
+    bytes += lane.overlaps().size() * 2 * sizeof(OverlapInfoConstPtr);
+  }
+  bytes += junction_table_.size() * sizeof(JunctionInfo);
+  bytes += signal_table_.size() * sizeof(SignalInfo);
+  bytes += crosswalk_table_.size() * sizeof(CrosswalkInfo);
+  bytes += stop_sign_table_.size() * sizeof(StopSignInfo);
+  bytes += yield_sign_table_.size() * sizeof(YieldSignInfo);
+  bytes += clear_area_table_.size() * sizeof(ClearAreaInfo);
+  bytes += speed_bump_table_.size() * sizeof(SpeedBumpInfo);
+  bytes += overlap_table_.size() * sizeof(OverlapInfo);
+  bytes += parking_space_table_.size() * sizeof(ParkingSpaceInfo);
+
+  // The kdtrees of the map, with the segments or polygons of their objects.
+  bytes += BoxTableSpaceUsed(lane_segment_boxes_);
+  bytes += BoxTableSpaceUsed(junction_polygon_boxes_);
+  bytes += BoxTableSpaceUsed(signal_segment_boxes_);
+  bytes += BoxTableSpaceUsed(crosswalk_polygon_boxes_);
+  bytes += BoxTableSpaceUsed(stop_sign_segment_boxes_);
+  bytes += BoxTableSpaceUsed(yield_sign_segment_boxes_);
+  bytes += BoxTableSpaceUsed(clear_area_polygon_boxes_);
+  bytes += BoxTableSpaceUsed(speed_bump_segment_boxes_);
+  bytes += BoxTableSpaceUsed(parking_space_polygon_boxes_);
+  return bytes;
+}
+
+void HDMapImpl::InitTables() {
   for (const auto& lane : map_.lane()) {
     lane_table_[lane.id().id()].reset(new LaneInfo(lane));
   }
@@ -128,6 +332,20 @@ int HDMapImpl::LoadMapFromProto(const Map& map_proto) {
     stop_sign_ptr_pair.second->PostProcess(*this);
   }
 
+  // Lanes are indexed in the order of the map, skipping duplicated ids.
+  std::vector<LaneInfoConstPtr> lanes;
+  lanes.reserve(map_.lane_size());
+  for (const auto& lane : map_.lane()) {
+    const auto& lane_info = lane_table_[lane.id().id()];
+    if (&lane_info->lane() == &lane) {
+      lane_info->set_index(static_cast<int>(lanes.size()));
+      lanes.push_back(lane_info);
+    }
+  }
+  lane_topology_.Build(lanes);
+}
+
+void HDMapImpl::BuildKDTrees() {
   BuildLaneSegmentKDTree();
   BuildJunctionPolygonKDTree();
   BuildSignalSegmentKDTree();
@@ -137,8 +355,58 @@ int HDMapImpl::LoadMapFromProto(const Map& map_proto) {
   BuildClearAreaPolygonKDTree();
   BuildSpeedBumpSegmentKDTree();
   BuildParkingSpacePolygonKDTree();
+}
 
-  return 0;
+bool HDMapImpl::RestoreKDTrees(const std::string& kdtree_cache_filename) {
+  std::unique_ptr<HDMapKDTreeCache> kdtree_cache(new HDMapKDTreeCache());
+  if (!kdtree_cache->Load(kdtree_cache_filename)) {
+    return false;
+  }
+  if (!SameKDTreeCacheSource(kdtree_cache->source(), map_source_)) {
+    AWARN << "KD-tree cache " << kdtree_cache_filename
+          << " is not built from the loaded map file.";
+    return false;
+  }
+  const auto& cache = *kdtree_cache;
+  const bool restored =
+      RestoreSegmentKDTree(lane_table_, map_.lane(), cache,
+                           LANE_SEGMENT_KDTREE, &lane_segment_boxes_,
+                           &lane_segment_kdtree_) &&
+      RestorePolygonKDTree(junction_table_, map_.junction(), cache,
+                           JUNCTION_POLYGON_KDTREE, &junction_polygon_boxes_,
+                           &junction_polygon_kdtree_) &&
+      RestoreSegmentKDTree(signal_table_, map_.signal(), cache,
+                           SIGNAL_SEGMENT_KDTREE, &signal_segment_boxes_,
+                           &signal_segment_kdtree_) &&
+      RestorePolygonKDTree(crosswalk_table_, map_.crosswalk(), cache,
+                           CROSSWALK_POLYGON_KDTREE, &crosswalk_polygon_boxes_,
+                           &crosswalk_polygon_kdtree_) &&
+      RestoreSegmentKDTree(stop_sign_table_, map_.stop_sign(), cache,
+                           STOP_SIGN_SEGMENT_KDTREE, &stop_sign_segment_boxes_,
+                           &stop_sign_segment_kdtree_) &&
+      RestoreSegmentKDTree(yield_sign_table_, map_.yield(), cache,
+                           YIELD_SIGN_SEGMENT_KDTREE,
+                           &yield_sign_segment_boxes_,
+                           &yield_sign_segment_kdtree_) &&
+      RestorePolygonKDTree(clear_area_table_, map_.clear_area(), cache,
+                           CLEAR_AREA_POLYGON_KDTREE,
+                           &clear_area_polygon_boxes_,
+                           &clear_area_polygon_kdtree_) &&
+      RestoreSegmentKDTree(speed_bump_table_, map_.speed_bump(), cache,
+                           SPEED_BUMP_SEGMENT_KDTREE,
+                           &speed_bump_segment_boxes_,
+                           &speed_bump_segment_kdtree_) &&
+      RestorePolygonKDTree(parking_space_table_, map_.parking_space(), cache,
+                           PARKING_SPACE_POLYGON_KDTREE,
+                           &parking_space_polygon_boxes_,
+                           &parking_space_polygon_kdtree_);
+  if (!restored) {
+    AWARN << "KD-tree cache " << kdtree_cache_filename
+          << " does not match the loaded map.";
+    return false;
+  }
+  kdtree_cache_ = std::move(kdtree_cache);
+  return true;
 }
 
 LaneInfoConstPtr HDMapImpl::GetLaneById(const Id& id) const {
@@ -203,14 +471,14 @@ int HDMapImpl::GetLanes(const PointENU& point, double distance,
 
 int HDMapImpl::GetLanes(const Vec2d& point, double distance,
                         std::vector<LaneInfoConstPtr>* lanes) const {
-  if (lanes == nullptr || lane_segment_kdtree_ == nullptr) {
+  if (lanes == nullptr || !HasKDTree(&HDMapImpl::lane_segment_kdtree_)) {
     return -1;
   }
 
   lanes->clear();
   std::vector<std::string> ids;
   const int status =
-      SearchObjects(point, distance, *lane_segment_kdtree_, &ids);
+      SearchObjects(point, distance, &HDMapImpl::lane_segment_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -221,6 +489,63 @@ int HDMapImpl::GetLanes(const Vec2d& point, double distance,
   return 0;
 }
 
+int HDMapImpl::GetLanesBatch(
+    const std::vector<PointENU>& points, const double distance,
+    std::vector<std::vector<LaneInfoConstPtr>>* lanes) const {
+  std::vector<Vec2d> xy_points;
+  xy_points.reserve(points.size());
+  for (const auto& point : points) {
+    xy_points.emplace_back(point.x(), point.y());
+  }
+  return GetLanesBatch(xy_points, distance, lanes);
+}
+
+int HDMapImpl::GetLanesBatch(
+    const std::vector<Vec2d>& points, const double distance,
+    std::vector<std::vector<LaneInfoConstPtr>>* lanes) const {
+  if (lanes == nullptr || !HasKDTree(&HDMapImpl::lane_segment_kdtree_)) {
+    return -1;
+  }
+
+  std::vector<std::vector<const LaneSegmentBox*>> segments(points.size());
+  std::vector<std::vector<const LaneSegmentBox*>> tree_segments;
+  ForEachKDTree(&HDMapImpl::lane_segment_kdtree_,
+                [&](const LaneSegmentKDTree& kdtree) {
+                  kdtree.GetObjectsBatch(points, distance, &tree_segments);
+                  for (size_t i = 0; i < points.size(); ++i) {
+                    segments[i].insert(segments[i].end(),
+                                       tree_segments[i].begin(),
+                                       tree_segments[i].end());
+                  }
+                });
+  lanes->clear();
+  lanes->resize(points.size());
+  // A point is close to a few lanes only, so the lanes are deduplicated by
+  // a linear search, and looked up by id once per lane. Tiles may hold
+  // copies of a lane, so the lanes looked up are deduplicated again.
+  std::vector<const LaneInfo*> lane_infos;
+  for (size_t i = 0; i < points.size(); ++i) {
+    lane_infos.clear();
+    for (const auto* segment : segments[i]) {
+      const LaneInfo* lane_info = segment->object();
+      if (std::find(lane_infos.begin(), lane_infos.end(), lane_info) ==
+          lane_infos.end()) {
+        lane_infos.push_back(lane_info);
+      }
+    }
+    auto& point_lanes = (*lanes)[i];
+    point_lanes.reserve(lane_infos.size());
+    for (const LaneInfo* lane_info : lane_infos) {
+      auto lane = GetLaneById(lane_info->id());
+      if (tiles_.empty() || std::find(point_lanes.begin(), point_lanes.end(),
+                                      lane) == point_lanes.end()) {
+        point_lanes.emplace_back(std::move(lane));
+      }
+    }
+  }
+  return 0;
+}
+
 int HDMapImpl::GetRoads(const PointENU& point, double distance,
                         std::vector<RoadInfoConstPtr>* roads) const {
   return GetRoads({point.x(), point.y()}, distance, roads);
@@ -257,13 +582,14 @@ int HDMapImpl::GetJunctions(
 int HDMapImpl::GetJunctions(
     const Vec2d& point, double distance,
     std::vector<JunctionInfoConstPtr>* junctions) const {
-  if (junctions == nullptr || junction_polygon_kdtree_ == nullptr) {
+  if (junctions == nullptr ||
+      !HasKDTree(&HDMapImpl::junction_polygon_kdtree_)) {
     return -1;
   }
   junctions->clear();
   std::vector<std::string> ids;
-  const int status =
-      SearchObjects(point, distance, *junction_polygon_kdtree_, &ids);
+  const int status = SearchObjects(point, distance,
+                                   &HDMapImpl::junction_polygon_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -280,13 +606,13 @@ int HDMapImpl::GetSignals(const PointENU& point, double distance,
 
 int HDMapImpl::GetSignals(const Vec2d& point, double distance,
                           std::vector<SignalInfoConstPtr>* signals) const {
-  if (signals == nullptr || signal_segment_kdtree_ == nullptr) {
+  if (signals == nullptr || !HasKDTree(&HDMapImpl::signal_segment_kdtree_)) {
     return -1;
   }
   signals->clear();
   std::vector<std::string> ids;
   const int status =
-      SearchObjects(point, distance, *signal_segment_kdtree_, &ids);
+      SearchObjects(point, distance, &HDMapImpl::signal_segment_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -305,13 +631,14 @@ int HDMapImpl::GetCrosswalks(
 int HDMapImpl::GetCrosswalks(
     const Vec2d& point, double distance,
     std::vector<CrosswalkInfoConstPtr>* crosswalks) const {
-  if (crosswalks == nullptr || crosswalk_polygon_kdtree_ == nullptr) {
+  if (crosswalks == nullptr ||
+      !HasKDTree(&HDMapImpl::crosswalk_polygon_kdtree_)) {
     return -1;
   }
   crosswalks->clear();
   std::vector<std::string> ids;
-  const int status =
-      SearchObjects(point, distance, *crosswalk_polygon_kdtree_, &ids);
+  const int status = SearchObjects(point, distance,
+                                   &HDMapImpl::crosswalk_polygon_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -330,13 +657,14 @@ int HDMapImpl::GetStopSigns(
 int HDMapImpl::GetStopSigns(
     const Vec2d& point, double distance,
     std::vector<StopSignInfoConstPtr>* stop_signs) const {
-  if (stop_signs == nullptr || stop_sign_segment_kdtree_ == nullptr) {
+  if (stop_signs == nullptr ||
+      !HasKDTree(&HDMapImpl::stop_sign_segment_kdtree_)) {
     return -1;
   }
   stop_signs->clear();
   std::vector<std::string> ids;
-  const int status =
-      SearchObjects(point, distance, *stop_sign_segment_kdtree_, &ids);
+  const int status = SearchObjects(point, distance,
+                                   &HDMapImpl::stop_sign_segment_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -355,13 +683,14 @@ int HDMapImpl::GetYieldSigns(
 int HDMapImpl::GetYieldSigns(
     const Vec2d& point, double distance,
     std::vector<YieldSignInfoConstPtr>* yield_signs) const {
-  if (yield_signs == nullptr || yield_sign_segment_kdtree_ == nullptr) {
+  if (yield_signs == nullptr ||
+      !HasKDTree(&HDMapImpl::yield_sign_segment_kdtree_)) {
     return -1;
   }
   yield_signs->clear();
   std::vector<std::string> ids;
-  const int status =
-      SearchObjects(point, distance, *yield_sign_segment_kdtree_, &ids);
+  const int status = SearchObjects(
+      point, distance, &HDMapImpl::yield_sign_segment_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -381,13 +710,14 @@ int HDMapImpl::GetClearAreas(
 int HDMapImpl::GetClearAreas(
     const Vec2d& point, double distance,
     std::vector<ClearAreaInfoConstPtr>* clear_areas) const {
-  if (clear_areas == nullptr || clear_area_polygon_kdtree_ == nullptr) {
+  if (clear_areas == nullptr ||
+      !HasKDTree(&HDMapImpl::clear_area_polygon_kdtree_)) {
     return -1;
   }
   clear_areas->clear();
   std::vector<std::string> ids;
-  const int status =
-      SearchObjects(point, distance, *clear_area_polygon_kdtree_, &ids);
+  const int status = SearchObjects(
+      point, distance, &HDMapImpl::clear_area_polygon_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -407,13 +737,14 @@ int HDMapImpl::GetSpeedBumps(
 int HDMapImpl::GetSpeedBumps(
     const Vec2d& point, double distance,
     std::vector<SpeedBumpInfoConstPtr>* speed_bumps) const {
-  if (speed_bumps == nullptr || speed_bump_segment_kdtree_ == nullptr) {
+  if (speed_bumps == nullptr ||
+      !HasKDTree(&HDMapImpl::speed_bump_segment_kdtree_)) {
     return -1;
   }
   speed_bumps->clear();
   std::vector<std::string> ids;
-  const int status =
-      SearchObjects(point, distance, *speed_bump_segment_kdtree_, &ids);
+  const int status = SearchObjects(
+      point, distance, &HDMapImpl::speed_bump_segment_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -433,13 +764,14 @@ int HDMapImpl::GetParkingSpaces(
 int HDMapImpl::GetParkingSpaces(
     const Vec2d& point, double distance,
     std::vector<ParkingSpaceInfoConstPtr>* parking_spaces) const {
-  if (parking_spaces == nullptr || parking_space_polygon_kdtree_ == nullptr) {
+  if (parking_spaces == nullptr ||
+      !HasKDTree(&HDMapImpl::parking_space_polygon_kdtree_)) {
     return -1;
   }
   parking_spaces->clear();
   std::vector<std::string> ids;
-  const int status =
-      SearchObjects(point, distance, *parking_space_polygon_kdtree_, &ids);
+  const int status = SearchObjects(
+      point, distance, &HDMapImpl::parking_space_polygon_kdtree_, &ids);
   if (status < 0) {
     return status;
   }
@@ -463,7 +795,20 @@ int HDMapImpl::GetNearestLane(const Vec2d& point,
   CHECK_NOTNULL(nearest_lane);
   CHECK_NOTNULL(nearest_s);
   CHECK_NOTNULL(nearest_l);
-  const auto* segment_object = lane_segment_kdtree_->GetNearestObject(point);
+  const LaneSegmentBox* segment_object = nullptr;
+  double min_distance_sqr = std::numeric_limits<double>::infinity();
+  ForEachKDTree(&HDMapImpl::lane_segment_kdtree_,
+                [&](const LaneSegmentKDTree& kdtree) {
+                  const auto* object = kdtree.GetNearestObject(point);
+                  if (object == nullptr) {
+                    return;
+                  }
+                  const double distance_sqr = object->DistanceSquareTo(point);
+                  if (distance_sqr < min_distance_sqr) {
+                    min_distance_sqr = distance_sqr;
+                    segment_object = object;
+                  }
+                });
   if (segment_object == nullptr) {
     return -1;
   }
@@ -503,7 +848,14 @@ int HDMapImpl::GetNearestLaneWithHeading(
                           max_heading_difference, &lanes) != 0) {
     return -1;
   }
+  return SelectNearestLane(point, distance, lanes, nearest_lane, nearest_s,
+                           nearest_l);
+}
 
+int HDMapImpl::SelectNearestLane(const Vec2d& point, const double distance,
+                                 const std::vector<LaneInfoConstPtr>& lanes,
+                                 LaneInfoConstPtr* nearest_lane,
+                                 double* nearest_s, double* nearest_l) {
   double s = 0;
   size_t s_index = 0;
   Vec2d map_point;
@@ -534,6 +886,41 @@ int HDMapImpl::GetNearestLaneWithHeading(
   return 0;
 }
 
+int HDMapImpl::GetNearestLanesWithHeadingBatch(
+    const std::vector<PointENU>& points, const double distance,
+    const std::vector<double>& central_headings,
+    const double max_heading_difference,
+    std::vector<LaneInfoConstPtr>* nearest_lanes,
+    std::vector<double>* nearest_s, std::vector<double>* nearest_l) const {
+  CHECK_NOTNULL(nearest_lanes);
+  CHECK_NOTNULL(nearest_s);
+  CHECK_NOTNULL(nearest_l);
+  CHECK_EQ(points.size(), central_headings.size());
+
+  std::vector<Vec2d> xy_points;
+  xy_points.reserve(points.size());
+  for (const auto& point : points) {
+    xy_points.emplace_back(point.x(), point.y());
+  }
+  std::vector<std::vector<LaneInfoConstPtr>> all_lanes;
+  if (GetLanesBatch(xy_points, distance, &all_lanes) != 0) {
+    return -1;
+  }
+
+  nearest_lanes->assign(points.size(), nullptr);
+  nearest_s->assign(points.size(), 0.0);
+  nearest_l->assign(points.size(), 0.0);
+  std::vector<LaneInfoConstPtr> lanes;
+  for (size_t i = 0; i < points.size(); ++i) {
+    lanes.clear();
+    FilterLanesWithHeading(xy_points[i], distance, central_headings[i],
+                           max_heading_difference, all_lanes[i], &lanes);
+    SelectNearestLane(xy_points[i], distance, lanes, &(*nearest_lanes)[i],
+                      &(*nearest_s)[i], &(*nearest_l)[i]);
+  }
+  return 0;
+}
+
 int HDMapImpl::GetLanesWithHeading(const PointENU& point, const double distance,
                                    const double central_heading,
                                    const double max_heading_difference,
@@ -554,6 +941,32 @@ int HDMapImpl::GetLanesWithHeading(const Vec2d& point, const double distance,
   }
 
   lanes->clear();
+  FilterLanesWithHeading(point, distance, central_heading,
+                         max_heading_difference, all_lanes, lanes);
+  return 0;
+}
+
+int HDMapImpl::GetLanesWithHeading(
+    const PointENU& point, const double distance, const double central_heading,
+    const double max_heading_difference,
+    const std::vector<LaneInfoConstPtr>& candidate_lanes,
+    std::vector<LaneInfoConstPtr>* lanes) const {
+  CHECK_NOTNULL(lanes);
+  if (candidate_lanes.empty()) {
+    return -1;
+  }
+
+  lanes->clear();
+  FilterLanesWithHeading({point.x(), point.y()}, distance, central_heading,
+                         max_heading_difference, candidate_lanes, lanes);
+  return 0;
+}
+
+void HDMapImpl::FilterLanesWithHeading(
+    const Vec2d& point, const double distance, const double central_heading,
+    const double max_heading_difference,
+    const std::vector<LaneInfoConstPtr>& all_lanes,
+    std::vector<LaneInfoConstPtr>* lanes) {
   for (auto& lane : all_lanes) {
     Vec2d proj_pt(0.0, 0.0);
     double s_offset = 0.0;
@@ -568,8 +981,6 @@ int HDMapImpl::GetLanesWithHeading(const Vec2d& point, const double distance,
       }
     }
   }
-
-  return 0;
 }
 
 int HDMapImpl::GetRoadBoundaries(
@@ -849,6 +1260,87 @@ void HDMapImpl::BuildPolygonKDTree(const Table& table,
   kdtree->reset(new KDTree(*box_table, params));
 }
 
+template <class Table, class Elements, class BoxTable, class KDTree>
+bool HDMapImpl::RestoreSegmentKDTree(const Table& table,
+                                     const Elements& elements,
+                                     const HDMapKDTreeCache& kdtree_cache,
+                                     const MapKDTree kdtree_type,
+                                     BoxTable* const box_table,
+                                     std::unique_ptr<KDTree>* const kdtree) {
+  box_table->clear();
+  const int num_objects = kdtree_cache.num_kdtree_objects(kdtree_type);
+  const KDTreeCacheObject* objects = kdtree_cache.kdtree_objects(kdtree_type);
+  box_table->reserve(num_objects);
+  for (int i = 0; i < num_objects; ++i) {
+    if (objects[i].element < 0 || objects[i].element >= elements.size()) {
+      return false;
+    }
+    const auto iter = table.find(elements.Get(objects[i].element).id().id());
+    if (iter == table.end()) {
+      return false;
+    }
+    const auto* info = iter->second.get();
+    const int id = objects[i].sub_index;
+    if (id < 0 || id >= static_cast<int>(info->segments().size())) {
+      return false;
+    }
+    const auto& segment = info->segments()[id];
+    box_table->emplace_back(AABox2d(segment.start(), segment.end()), info,
+                            &segment, id);
+  }
+  kdtree->reset(new KDTree(*box_table, kdtree_cache.kdtree_view(kdtree_type)));
+  return true;
+}
+
+template <class Table, class Elements, class BoxTable, class KDTree>
+bool HDMapImpl::RestorePolygonKDTree(const Table& table,
+                                     const Elements& elements,
+                                     const HDMapKDTreeCache& kdtree_cache,
+                                     const MapKDTree kdtree_type,
+                                     BoxTable* const box_table,
+                                     std::unique_ptr<KDTree>* const kdtree) {
+  box_table->clear();
+  const int num_objects = kdtree_cache.num_kdtree_objects(kdtree_type);
+  const KDTreeCacheObject* objects = kdtree_cache.kdtree_objects(kdtree_type);
+  box_table->reserve(num_objects);
+  for (int i = 0; i < num_objects; ++i) {
+    if (objects[i].element < 0 || objects[i].element >= elements.size() ||
+        objects[i].sub_index != 0) {
+      return false;
+    }
+    const auto iter = table.find(elements.Get(objects[i].element).id().id());
+    if (iter == table.end()) {
+      return false;
+    }
+    const auto* info = iter->second.get();
+    const auto& polygon = info->polygon();
+    box_table->emplace_back(polygon.AABoundingBox(), info, &polygon, 0);
+  }
+  kdtree->reset(new KDTree(*box_table, kdtree_cache.kdtree_view(kdtree_type)));
+  return true;
+}
+
+template <class Elements, class BoxTable, class KDTree>
+void HDMapImpl::FlattenKDTree(const Elements& elements,
+                              const BoxTable& box_table,
+                              const std::unique_ptr<KDTree>& kdtree,
+                              KDTreeCacheTreeData* const kdtree_data) {
+  std::unordered_map<std::string, int> element_indices;
+  for (int i = 0; i < elements.size(); ++i) {
+    element_indices[elements.Get(i).id().id()] = i;
+  }
+  kdtree_data->objects.clear();
+  for (const auto& box : box_table) {
+    KDTreeCacheObject object;
+    object.element = element_indices[box.object()->id().id()];
+    object.sub_index = box.id();
+    kdtree_data->objects.push_back(object);
+  }
+  if (kdtree != nullptr) {
+    kdtree->Flatten(&kdtree_data->flat_data);
+  }
+}
+
 void HDMapImpl::BuildLaneSegmentKDTree() {
   AABoxKDTreeParams params;
   params.max_leaf_dimension = 5.0;  // meters.
@@ -922,34 +1414,126 @@ void HDMapImpl::BuildParkingSpacePolygonKDTree() {
                      &parking_space_polygon_kdtree_);
 }
 
+template <class KDTree, class Visitor>
+void HDMapImpl::ForEachKDTree(const std::unique_ptr<KDTree> HDMapImpl::*kdtree,
+                              const Visitor& visitor) const {
+  if (tiles_.empty()) {
+    if (this->*kdtree != nullptr) {
+      visitor(*(this->*kdtree));
+    }
+    return;
+  }
+  for (const auto& tile : tiles_) {
+    if ((*tile).*kdtree != nullptr) {
+      visitor(*((*tile).*kdtree));
+    }
+  }
+}
+
+template <class KDTree>
+bool HDMapImpl::HasKDTree(
+    const std::unique_ptr<KDTree> HDMapImpl::*kdtree) const {
+  bool has_kdtree = false;
+  ForEachKDTree(kdtree, [&has_kdtree](const KDTree&) { has_kdtree = true; });
+  return has_kdtree;
+}
+
 template <class KDTree>
 int HDMapImpl::SearchObjects(const Vec2d& center, const double radius,
-                             const KDTree& kdtree,
-                             std::vector<std::string>* const results) {
+                             const std::unique_ptr<KDTree> HDMapImpl::*kdtree,
+                             std::vector<std::string>* const results) const {
   if (results == nullptr) {
     return -1;
   }
-  auto objects = kdtree.GetObjects(center, radius);
   std::unordered_set<std::string> result_ids;
-  result_ids.reserve(objects.size());
-  for (const auto* object_ptr : objects) {
-    result_ids.insert(object_ptr->object()->id().id());
-  }
+  ForEachKDTree(kdtree, [&](const KDTree& tree) {
+    for (const auto* object_ptr : tree.GetObjects(center, radius)) {
+      result_ids.insert(object_ptr->object()->id().id());
+    }
+  });
 
   results->reserve(result_ids.size());
   results->assign(result_ids.begin(), result_ids.end());
   return 0;
 }
 
+template <class Table>
+void HDMapImpl::MergeTileTable(const Table& tile_table,
+                               const std::unordered_set<std::string>& skip_ids,
+                               Table* const table) {
+  for (const auto& info_with_id : tile_table) {
+    if (skip_ids.count(info_with_id.first) == 0) {
+      table->emplace(info_with_id.first, info_with_id.second);
+    }
+  }
+}
+
+void HDMapImpl::MergeTileRoads() {
+  // A tile holds a road with the lanes of its sections in the tile only, so
+  // a road crossing tiles is built again with the lanes of all its copies.
+  std::unordered_map<std::string, Road> merged_roads;
+  for (const auto& tile : tiles_) {
+    for (const auto& road_ptr_pair : tile->road_table_) {
+      const auto& road_info = road_ptr_pair.second;
+      const auto iter = road_table_.find(road_ptr_pair.first);
+      if (iter == road_table_.end()) {
+        road_table_.emplace(road_ptr_pair.first, road_info);
+        continue;
+      }
+      if (iter->second == road_info) {
+        continue;
+      }
+      auto merged_iter = merged_roads.find(road_ptr_pair.first);
+      if (merged_iter == merged_roads.end()) {
+        merged_iter =
+            merged_roads.emplace(road_ptr_pair.first, iter->second->road())
+                .first;
+      }
+      Road* road = &merged_iter->second;
+      for (const auto& section : road_info->sections()) {
+        RoadSection* merged_section = nullptr;
+        for (auto& road_section : *road->mutable_section()) {
+          if (road_section.id().id() == section.id().id()) {
+            merged_section = &road_section;
+            break;
+          }
+        }
+        if (merged_section == nullptr) {
+          *road->add_section() = section;
+          continue;
+        }
+        for (const auto& lane_id : section.lane_id()) {
+          const auto& lane_ids = merged_section->lane_id();
+          if (std::find_if(lane_ids.begin(), lane_ids.end(),
+                           [&lane_id](const Id& id) {
+                             return id.id() == lane_id.id();
+                           }) == lane_ids.end()) {
+            *merged_section->add_lane_id() = lane_id;
+          }
+        }
+      }
+    }
+  }
+  for (const auto& merged_road : merged_roads) {
+    road_table_[merged_road.first].reset(new RoadInfo(merged_road.second));
+  }
+}
+
 void HDMapImpl::Clear() {
   map_.Clear();
+  map_source_ = KDTreeCacheSource();
   lane_table_.clear();
+  lane_topology_.Clear();
   junction_table_.clear();
   signal_table_.clear();
   crosswalk_table_.clear();
   stop_sign_table_.clear();
   yield_sign_table_.clear();
+  clear_area_table_.clear();
+  speed_bump_table_.clear();
   overlap_table_.clear();
+  road_table_.clear();
+  parking_space_table_.clear();
   lane_segment_boxes_.clear();
   lane_segment_kdtree_.reset(nullptr);
   junction_polygon_boxes_.clear();
@@ -968,6 +1552,8 @@ void HDMapImpl::Clear() {
   speed_bump_segment_kdtree_.reset(nullptr);
   parking_space_polygon_boxes_.clear();
   parking_space_polygon_kdtree_.reset(nullptr);
+  kdtree_cache_.reset();
+  tiles_.clear();
 }
 
 }  // namespace hdmap
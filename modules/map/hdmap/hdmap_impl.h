@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "modules/common/math/aabox2d.h"
@@ -27,6 +28,8 @@ limitations under the License.
 #include "modules/common/math/polygon2d.h"
 #include "modules/common/math/vec2d.h"
 #include "modules/map/hdmap/hdmap_common.h"
+#include "modules/map/hdmap/hdmap_kdtree_cache.h"
+#include "modules/map/hdmap/lane_topology.h"
 #include "modules/map/proto/map.pb.h"
 #include "modules/map/proto/map_clear_area.pb.h"
 #include "modules/map/proto/map_crosswalk.pb.h"
@@ -84,6 +87,19 @@ class HDMapImpl {
    */
   int LoadMapFromFile(const std::string& map_filename);
 
+  /**
+   * @brief load map from local file, adopting the kdtrees from a KD-tree
+   *        cache saved by SaveKDTreeCache. The map file is still parsed and
+   *        its tables are still built, only the kdtree build is skipped. The
+   *        kdtrees are built as usual if the cache is missing, invalid or
+   *        built from another version of the map file.
+   * @param map_filename path of map data file
+   * @param kdtree_cache_filename path of the KD-tree cache file
+   * @return 0:success, otherwise failed
+   */
+  int LoadMapFromFile(const std::string& map_filename,
+                      const std::string& kdtree_cache_filename);
+
   /**
    * @brief load map from a protobuf message
    * @param map_proto map data in protobuf format
@@ -91,6 +107,38 @@ class HDMapImpl {
    */
   int LoadMapFromProto(const Map& map_proto);
 
+  /**
+   * @brief save the kdtrees of the loaded map as a KD-tree cache. The cache
+   *        records the size and modification time of the loaded map file.
+   * @param kdtree_cache_filename path of the KD-tree cache file
+   * @return 0:success, otherwise failed
+   */
+  int SaveKDTreeCache(const std::string& kdtree_cache_filename) const;
+
+  /**
+   * @brief build the map from the maps of its tiles, each loaded from one
+   *        tile of a larger map. The element infos and kdtrees of the tiles
+   *        are shared instead of built again, and queries search the kdtrees
+   *        of every tile, so only the id tables, the roads crossing tiles
+   *        and the lane topology are built over all tiles.
+   * @param tiles the maps of the tiles, which are held by this map
+   * @param borrowed_ids for each tile, the ids of the elements it only holds
+   *        for the overlaps of its own elements. Their own overlaps may be
+   *        incomplete in the tile, so a copy from another tile is preferred.
+   * @return 0:success, otherwise failed
+   */
+  int LoadMapFromTiles(
+      const std::vector<std::shared_ptr<const HDMapImpl>>& tiles,
+      const std::vector<std::unordered_set<std::string>>& borrowed_ids);
+
+  /**
+   * @brief estimate the memory used by the map: the map proto, the element
+   *        infos with their geometry, the id tables, the box tables and the
+   *        kdtrees. A map built from tiles does not count the tiles.
+   * @return the estimated memory in bytes
+   */
+  int64_t SpaceUsed() const;
+
   LaneInfoConstPtr GetLaneById(const Id& id) const;
   JunctionInfoConstPtr GetJunctionById(const Id& id) const;
   SignalInfoConstPtr GetSignalById(const Id& id) const;
@@ -103,6 +151,12 @@ class HDMapImpl {
   RoadInfoConstPtr GetRoadById(const Id& id) const;
   ParkingSpaceInfoConstPtr GetParkingSpaceById(const Id& id) const;
 
+  /**
+   * @brief get the integer indexed lane graph of the map, built at load time
+   * @return the lane topology
+   */
+  const LaneTopology& lane_topology() const { return lane_topology_; }
+
   /**
    * @brief get all lanes in certain range
    * @param point the central point of the range
@@ -237,6 +291,56 @@ class HDMapImpl {
                           const double distance, const double central_heading,
                           const double max_heading_difference,
                           std::vector<LaneInfoConstPtr>* lanes) const;
+  /**
+   * @brief get all lanes in certain range of each of a batch of points. The
+   *        lane segments are searched once for the whole batch.
+   * @param points the central points of the ranges
+   * @param distance the search radius
+   * @param lanes store all lanes in target range, one vector per point
+   * @return 0:success, otherwise failed
+   */
+  int GetLanesBatch(const std::vector<apollo::common::PointENU>& points,
+                    const double distance,
+                    std::vector<std::vector<LaneInfoConstPtr>>* lanes) const;
+  /**
+   * @brief get the nearest lane within a certain range by pose for each of a
+   *        batch of poses. The lane segments are searched once for the whole
+   *        batch.
+   * @param points the target positions
+   * @param distance the search radius
+   * @param central_headings the base heading of each position
+   * @param max_heading_difference the heading range
+   * @param nearest_lanes the nearest lane that match search conditions for
+   *        each position, nullptr if there is none
+   * @param nearest_s the offset from lane start point along lane center line
+   *        for each position
+   * @param nearest_l the lateral offset from lane center line for each
+   *        position
+   * @return 0:success, otherwise, failed.
+   */
+  int GetNearestLanesWithHeadingBatch(
+      const std::vector<apollo::common::PointENU>& points,
+      const double distance, const std::vector<double>& central_headings,
+      const double max_heading_difference,
+      std::vector<LaneInfoConstPtr>* nearest_lanes,
+      std::vector<double>* nearest_s, std::vector<double>* nearest_l) const;
+  /**
+   * @brief get the lanes within a certain range by pose among candidate
+   *        lanes, such as the lanes found by GetLanesBatch with a radius no
+   *        smaller than distance.
+   * @param point the target position
+   * @param distance the search radius
+   * @param central_heading the base heading
+   * @param max_heading_difference the heading range
+   * @param candidate_lanes the lanes to select from
+   * @param lanes all candidate lanes that match search conditions
+   * @return 0:success, otherwise, failed.
+   */
+  int GetLanesWithHeading(const apollo::common::PointENU& point,
+                          const double distance, const double central_heading,
+                          const double max_heading_difference,
+                          const std::vector<LaneInfoConstPtr>& candidate_lanes,
+                          std::vector<LaneInfoConstPtr>* lanes) const;
   /**
    * @brief get all road and junctions boundaries within certain range
    * @param point the target position
@@ -314,6 +418,19 @@ class HDMapImpl {
                           const double distance, const double central_heading,
                           const double max_heading_difference,
                           std::vector<LaneInfoConstPtr>* lanes) const;
+  int GetLanesBatch(const std::vector<apollo::common::math::Vec2d>& points,
+                    const double distance,
+                    std::vector<std::vector<LaneInfoConstPtr>>* lanes) const;
+  static void FilterLanesWithHeading(
+      const apollo::common::math::Vec2d& point, const double distance,
+      const double central_heading, const double max_heading_difference,
+      const std::vector<LaneInfoConstPtr>& all_lanes,
+      std::vector<LaneInfoConstPtr>* lanes);
+  static int SelectNearestLane(const apollo::common::math::Vec2d& point,
+                               const double distance,
+                               const std::vector<LaneInfoConstPtr>& lanes,
+                               LaneInfoConstPtr* nearest_lane,
+                               double* nearest_s, double* nearest_l);
   int GetRoads(const apollo::common::math::Vec2d& point, double distance,
                std::vector<RoadInfoConstPtr>* roads) const;
 
@@ -327,6 +444,30 @@ class HDMapImpl {
       const Table& table, const apollo::common::math::AABoxKDTreeParams& params,
       BoxTable* const box_table, std::unique_ptr<KDTree>* const kdtree);
 
+  template <class Table, class Elements, class BoxTable, class KDTree>
+  static bool RestoreSegmentKDTree(const Table& table, const Elements& elements,
+                                   const HDMapKDTreeCache& kdtree_cache,
+                                   const MapKDTree kdtree_type,
+                                   BoxTable* const box_table,
+                                   std::unique_ptr<KDTree>* const kdtree);
+
+  template <class Table, class Elements, class BoxTable, class KDTree>
+  static bool RestorePolygonKDTree(const Table& table, const Elements& elements,
+                                   const HDMapKDTreeCache& kdtree_cache,
+                                   const MapKDTree kdtree_type,
+                                   BoxTable* const box_table,
+                                   std::unique_ptr<KDTree>* const kdtree);
+
+  template <class Elements, class BoxTable, class KDTree>
+  static void FlattenKDTree(const Elements& elements,
+                            const BoxTable& box_table,
+                            const std::unique_ptr<KDTree>& kdtree,
+                            KDTreeCacheTreeData* const kdtree_data);
+
+  void InitTables();
+  void BuildKDTrees();
+  bool RestoreKDTrees(const std::string& kdtree_cache_filename);
+
   void BuildLaneSegmentKDTree();
   void BuildJunctionPolygonKDTree();
   void BuildCrosswalkPolygonKDTree();
@@ -337,16 +478,37 @@ class HDMapImpl {
   void BuildSpeedBumpSegmentKDTree();
   void BuildParkingSpacePolygonKDTree();
 
+  // Calls visitor with the kdtree of this map, or with the kdtree of every
+  // tile if the map is built from tiles.
+  template <class KDTree, class Visitor>
+  void ForEachKDTree(const std::unique_ptr<KDTree> HDMapImpl::*kdtree,
+                     const Visitor& visitor) const;
+
   template <class KDTree>
-  static int SearchObjects(const apollo::common::math::Vec2d& center,
-                           const double radius, const KDTree& kdtree,
-                           std::vector<std::string>* const results);
+  bool HasKDTree(const std::unique_ptr<KDTree> HDMapImpl::*kdtree) const;
+
+  template <class KDTree>
+  int SearchObjects(const apollo::common::math::Vec2d& center,
+                    const double radius,
+                    const std::unique_ptr<KDTree> HDMapImpl::*kdtree,
+                    std::vector<std::string>* const results) const;
+
+  template <class Table>
+  static void MergeTileTable(const Table& tile_table,
+                             const std::unordered_set<std::string>& skip_ids,
+                             Table* const table);
+
+  void MergeTileRoads();
 
   void Clear();
 
  private:
   Map map_;
+  // The file the map is loaded from, recorded in the KD-tree caches saved
+  // from it.
+  KDTreeCacheSource map_source_;
   LaneTable lane_table_;
+  LaneTopology lane_topology_;
   JunctionTable junction_table_;
   CrosswalkTable crosswalk_table_;
   SignalTable signal_table_;
@@ -384,6 +546,13 @@ class HDMapImpl {
 
   std::vector<ParkingSpacePolygonBox> parking_space_polygon_boxes_;
   std::unique_ptr<ParkingSpacePolygonKDTree> parking_space_polygon_kdtree_;
+
+  // The mapped cache the kdtrees are adopted from, if loaded with one.
+  std::unique_ptr<HDMapKDTreeCache> kdtree_cache_;
+
+  // The maps of the tiles whose elements and kdtrees this map shares, if it
+  // is built from tiles.
+  std::vector<std::shared_ptr<const HDMapImpl>> tiles_;
 };
 
 }  // namespace hdmap
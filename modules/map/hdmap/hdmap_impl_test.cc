@@ -14,6 +14,8 @@ limitations under the License.
 =========================================================================*/
 
 #include <algorithm>
+#include <fstream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -49,6 +51,40 @@ TEST_F(HDMapImplTestSuite, GetLaneById) {
   EXPECT_STREQ(lane_id.id().c_str(), lane_ptr->id().id().c_str());
 }
 
+TEST_F(HDMapImplTestSuite, LaneTopology) {
+  const LaneTopology& topology = hdmap_impl_.lane_topology();
+  EXPECT_EQ(LaneTopology::kInvalidLaneIndex, topology.GetLaneIndex("1"));
+  ASSERT_GT(topology.num_lanes(), 0);
+  for (int i = 0; i < topology.num_lanes(); ++i) {
+    const LaneInfoConstPtr& lane = topology.lane(i);
+    EXPECT_EQ(i, lane->index());
+    EXPECT_EQ(i, topology.GetLaneIndex(lane->id()));
+    EXPECT_EQ(lane, hdmap_impl_.GetLaneById(lane->id()));
+    EXPECT_DOUBLE_EQ(lane->total_length(), topology.lane_length(i));
+
+    std::vector<std::string> successor_ids;
+    for (const auto& id : lane->lane().successor_id()) {
+      if (hdmap_impl_.GetLaneById(id) != nullptr) {
+        successor_ids.push_back(id.id());
+      }
+    }
+    std::vector<std::string> successors;
+    for (const int successor : topology.successors(i)) {
+      successors.push_back(topology.lane(successor)->id().id());
+      EXPECT_TRUE(topology.IsRelated(LANE_SUCCESSOR, i, successor));
+    }
+    EXPECT_EQ(successor_ids, successors);
+
+    for (const auto& id : lane->lane().left_neighbor_forward_lane_id()) {
+      const int neighbor = topology.GetLaneIndex(id);
+      if (neighbor != LaneTopology::kInvalidLaneIndex) {
+        EXPECT_TRUE(
+            topology.IsRelated(LANE_LEFT_FORWARD_NEIGHBOR, i, neighbor));
+      }
+    }
+  }
+}
+
 TEST_F(HDMapImplTestSuite, GetJunctionById) {
   Id junction_id;
   junction_id.set_id("1");
@@ -191,6 +227,73 @@ TEST_F(HDMapImplTestSuite, GetLanesWithHeading) {
   EXPECT_EQ(0, hdmap_impl_.GetLanesWithHeading(point, 5, -2.35, 1.0, &lanes));
   EXPECT_EQ(1, lanes.size());
   EXPECT_EQ("773_1_-2", lanes[0]->id().id());
+
+  std::vector<LaneInfoConstPtr> candidate_lanes;
+  EXPECT_EQ(-1, hdmap_impl_.GetLanesWithHeading(point, 5, -2.35, 1.0,
+                                                candidate_lanes, &lanes));
+  EXPECT_EQ(0, hdmap_impl_.GetLanes(point, 15, &candidate_lanes));
+  EXPECT_LT(1, candidate_lanes.size());
+  EXPECT_EQ(0, hdmap_impl_.GetLanesWithHeading(point, 5, -2.35, 1.0,
+                                               candidate_lanes, &lanes));
+  EXPECT_EQ(1, lanes.size());
+  EXPECT_EQ("773_1_-2", lanes[0]->id().id());
+}
+
+TEST_F(HDMapImplTestSuite, GetLanesBatch) {
+  std::vector<apollo::common::PointENU> points;
+  for (double dx = -100.0; dx <= 100.0; dx += 20.0) {
+    for (double dy = -100.0; dy <= 100.0; dy += 20.0) {
+      apollo::common::PointENU point;
+      point.set_x(586424.09 + dx);
+      point.set_y(4140727.02 + dy);
+      point.set_z(0.0);
+      points.push_back(point);
+    }
+  }
+
+  std::vector<std::vector<LaneInfoConstPtr>> batch_lanes;
+  for (const double distance : {1e-6, 5.0, 30.0}) {
+    EXPECT_EQ(0, hdmap_impl_.GetLanesBatch(points, distance, &batch_lanes));
+    ASSERT_EQ(points.size(), batch_lanes.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      std::vector<LaneInfoConstPtr> lanes;
+      EXPECT_EQ(0, hdmap_impl_.GetLanes(points[i], distance, &lanes));
+      std::set<std::string> expected_ids;
+      std::set<std::string> actual_ids;
+      for (const auto& lane : lanes) {
+        expected_ids.insert(lane->id().id());
+      }
+      for (const auto& lane : batch_lanes[i]) {
+        actual_ids.insert(lane->id().id());
+      }
+      EXPECT_EQ(expected_ids, actual_ids);
+      EXPECT_EQ(lanes.size(), batch_lanes[i].size());
+    }
+  }
+  EXPECT_EQ(-1, hdmap_impl_.GetLanesBatch(points, 5.0, nullptr));
+}
+
+TEST_F(HDMapImplTestSuite, GetNearestLanesWithHeadingBatch) {
+  apollo::common::PointENU point;
+  point.set_x(586424.09);
+  point.set_y(4140727.02);
+  point.set_z(0.0);
+  apollo::common::PointENU far_point = point;
+  far_point.set_x(point.x() + 1000.0);
+
+  std::vector<LaneInfoConstPtr> nearest_lanes;
+  std::vector<double> nearest_s;
+  std::vector<double> nearest_l;
+  EXPECT_EQ(0, hdmap_impl_.GetNearestLanesWithHeadingBatch(
+                   {point, far_point, point}, 5, {-2.35, -2.35, 0.86}, 1.0,
+                   &nearest_lanes, &nearest_s, &nearest_l));
+  ASSERT_EQ(3, nearest_lanes.size());
+  ASSERT_TRUE(nearest_lanes[0] != nullptr);
+  EXPECT_EQ("773_1_-2", nearest_lanes[0]->id().id());
+  EXPECT_NEAR(nearest_l[0], -3.257, 1E-3);
+  EXPECT_NEAR(nearest_s[0], 25.891, 1E-3);
+  EXPECT_TRUE(nearest_lanes[1] == nullptr);
+  EXPECT_TRUE(nearest_lanes[2] == nullptr);
 }
 
 TEST_F(HDMapImplTestSuite, GetJunctions) {
@@ -372,5 +475,73 @@ TEST_F(HDMapImplTestSuite, GetForwardNearestSignalsOnLane) {
   EXPECT_EQ("1278", signals[0]->id().id());
 }
 
+TEST_F(HDMapImplTestSuite, KDTreeCache) {
+  const std::string cache_filename = "/tmp/hdmap_impl_test_base_map.kdtree";
+  EXPECT_EQ(0, hdmap_impl_.SaveKDTreeCache(cache_filename));
+  EXPECT_TRUE(HDMapKDTreeCache::MatchesSource(cache_filename, kMapFilename));
+  // The cache is not built from a file of another size.
+  EXPECT_FALSE(HDMapKDTreeCache::MatchesSource(cache_filename, cache_filename));
+
+  HDMapImpl cached_hdmap_impl;
+  EXPECT_EQ(0, cached_hdmap_impl.LoadMapFromFile(kMapFilename, cache_filename));
+
+  apollo::common::PointENU point;
+  point.set_x(586424.09);
+  point.set_y(4140727.02);
+  point.set_z(0.0);
+  LaneInfoConstPtr lane;
+  double s = 0.0;
+  double l = 0.0;
+  EXPECT_EQ(0, cached_hdmap_impl.GetNearestLane(point, &lane, &s, &l));
+  EXPECT_EQ("773_1_-2", lane->id().id());
+  EXPECT_NEAR(s, 25.891, 1e-3);
+  EXPECT_NEAR(l, -3.257, 1e-3);
+
+  for (const double distance : {1.0, 5.0, 20.0, 100.0}) {
+    std::vector<LaneInfoConstPtr> expected_lanes;
+    std::vector<LaneInfoConstPtr> actual_lanes;
+    EXPECT_EQ(0, hdmap_impl_.GetLanes(point, distance, &expected_lanes));
+    EXPECT_EQ(0, cached_hdmap_impl.GetLanes(point, distance, &actual_lanes));
+    std::set<std::string> expected_ids;
+    std::set<std::string> actual_ids;
+    for (const auto& lane : expected_lanes) {
+      expected_ids.insert(lane->id().id());
+    }
+    for (const auto& lane : actual_lanes) {
+      actual_ids.insert(lane->id().id());
+    }
+    EXPECT_EQ(expected_ids, actual_ids);
+
+    std::vector<JunctionInfoConstPtr> expected_junctions;
+    std::vector<JunctionInfoConstPtr> actual_junctions;
+    EXPECT_EQ(0,
+              hdmap_impl_.GetJunctions(point, distance, &expected_junctions));
+    EXPECT_EQ(0, cached_hdmap_impl.GetJunctions(point, distance,
+                                                &actual_junctions));
+    EXPECT_EQ(expected_junctions.size(), actual_junctions.size());
+
+    std::vector<SignalInfoConstPtr> expected_signals;
+    std::vector<SignalInfoConstPtr> actual_signals;
+    EXPECT_EQ(0, hdmap_impl_.GetSignals(point, distance, &expected_signals));
+    EXPECT_EQ(0,
+              cached_hdmap_impl.GetSignals(point, distance, &actual_signals));
+    EXPECT_EQ(expected_signals.size(), actual_signals.size());
+  }
+
+  // A corrupted cache is ignored, the kdtrees are built instead.
+  {
+    std::fstream cache_file(cache_filename,
+                            std::ios::in | std::ios::out | std::ios::binary);
+    cache_file.seekp(0);
+    cache_file.write("XXXX", 4);
+  }
+  EXPECT_FALSE(HDMapKDTreeCache::MatchesSource(cache_filename, kMapFilename));
+  HDMapImpl uncached_hdmap_impl;
+  EXPECT_EQ(0,
+            uncached_hdmap_impl.LoadMapFromFile(kMapFilename, cache_filename));
+  EXPECT_EQ(0, uncached_hdmap_impl.GetNearestLane(point, &lane, &s, &l));
+  EXPECT_EQ("773_1_-2", lane->id().id());
+}
+
 }  // namespace hdmap
 }  // namespace apollo
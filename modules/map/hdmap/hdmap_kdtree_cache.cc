@@ -0,0 +1,284 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#include "modules/map/hdmap/hdmap_kdtree_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+
+#include "modules/common/log.h"
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+using apollo::common::math::AABoxKDTree2dFlatNode;
+using apollo::common::math::AABoxKDTree2dFlatView;
+
+constexpr char kKDTreeCacheMagic[8] = {'A', 'P', 'K', 'D', 'T', 'R', 'E', 'E'};
+constexpr uint32_t kKDTreeCacheVersion = 1;
+constexpr uint64_t kKDTreeCacheAlignment = 8;
+
+uint64_t Align(const uint64_t offset) {
+  return (offset + kKDTreeCacheAlignment - 1) / kKDTreeCacheAlignment *
+         kKDTreeCacheAlignment;
+}
+
+// Appends a section to the cache buffer and records its position.
+template <class T>
+void AppendSection(const T* data, const size_t count, std::string* buffer,
+                   KDTreeCacheSection* section) {
+  buffer->resize(Align(buffer->size()), '\0');
+  section->offset = buffer->size();
+  section->size = count * sizeof(T);
+  if (count > 0) {
+    buffer->append(reinterpret_cast<const char*>(data), section->size);
+  }
+}
+
+bool ValidHeader(const KDTreeCacheHeader& header, const size_t file_size) {
+  return std::memcmp(header.magic, kKDTreeCacheMagic,
+                     sizeof(kKDTreeCacheMagic)) == 0 &&
+         header.version == kKDTreeCacheVersion &&
+         header.header_size == sizeof(KDTreeCacheHeader) &&
+         header.file_size == file_size;
+}
+
+}  // namespace
+
+HDMapKDTreeCache::~HDMapKDTreeCache() { Unmap(); }
+
+bool HDMapKDTreeCache::Load(const std::string& cache_filename) {
+  Unmap();
+  const int fd = open(cache_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    AERROR << "Failed to open KD-tree cache " << cache_filename;
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(KDTreeCacheHeader)) {
+    AERROR << "Invalid KD-tree cache size: " << cache_filename;
+    close(fd);
+    return false;
+  }
+  // The mapping is shared, so every process loading the same cache shares
+  // the same physical pages.
+  void* data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    AERROR << "Failed to mmap KD-tree cache " << cache_filename;
+    return false;
+  }
+  data_ = static_cast<const char*>(data);
+  size_ = file_stat.st_size;
+  header_ = reinterpret_cast<const KDTreeCacheHeader*>(data_);
+
+  if (!ValidHeader(*header_, size_)) {
+    AERROR << "Incompatible KD-tree cache header: " << cache_filename;
+    Unmap();
+    return false;
+  }
+  for (int i = 0; i < NUM_MAP_KDTREES; ++i) {
+    if (!ValidKDTree(header_->kdtrees[i]) ||
+        !kdtree_view(static_cast<MapKDTree>(i)).IsValid()) {
+      AERROR << "Invalid kdtree " << i << " in KD-tree cache "
+             << cache_filename;
+      Unmap();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HDMapKDTreeCache::Write(const std::string& cache_filename,
+                             const KDTreeCacheSource& source,
+                             const std::vector<KDTreeCacheTreeData>& kdtrees) {
+  if (kdtrees.size() != NUM_MAP_KDTREES) {
+    AERROR << "Expect " << NUM_MAP_KDTREES << " kdtrees, got "
+           << kdtrees.size();
+    return false;
+  }
+  KDTreeCacheHeader header;
+  std::memcpy(header.magic, kKDTreeCacheMagic, sizeof(kKDTreeCacheMagic));
+  header.version = kKDTreeCacheVersion;
+  header.header_size = sizeof(KDTreeCacheHeader);
+  header.source = source;
+
+  std::string buffer(sizeof(KDTreeCacheHeader), '\0');
+  for (int i = 0; i < NUM_MAP_KDTREES; ++i) {
+    const auto& kdtree = kdtrees[i];
+    const auto& flat_data = kdtree.flat_data;
+    auto* sections = &header.kdtrees[i];
+    AppendSection(kdtree.objects.data(), kdtree.objects.size(), &buffer,
+                  &sections->objects);
+    AppendSection(flat_data.nodes.data(), flat_data.nodes.size(), &buffer,
+                  &sections->nodes);
+    AppendSection(flat_data.objects_sorted_by_min.data(),
+                  flat_data.objects_sorted_by_min.size(), &buffer,
+                  &sections->objects_sorted_by_min);
+    AppendSection(flat_data.objects_sorted_by_max.data(),
+                  flat_data.objects_sorted_by_max.size(), &buffer,
+                  &sections->objects_sorted_by_max);
+    AppendSection(flat_data.objects_sorted_by_min_bound.data(),
+                  flat_data.objects_sorted_by_min_bound.size(), &buffer,
+                  &sections->objects_sorted_by_min_bound);
+    AppendSection(flat_data.objects_sorted_by_max_bound.data(),
+                  flat_data.objects_sorted_by_max_bound.size(), &buffer,
+                  &sections->objects_sorted_by_max_bound);
+  }
+  header.file_size = buffer.size();
+  std::memcpy(&buffer[0], &header, sizeof(header));
+
+  // Write to a temporary file first, so that processes which have the old
+  // cache mapped are not affected.
+  const std::string tmp_filename = cache_filename + ".tmp";
+  std::ofstream output(tmp_filename, std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    AERROR << "Failed to open " << tmp_filename;
+    return false;
+  }
+  output.write(buffer.data(), buffer.size());
+  output.close();
+  if (!output) {
+    AERROR << "Failed to write " << tmp_filename;
+    return false;
+  }
+  if (std::rename(tmp_filename.c_str(), cache_filename.c_str()) != 0) {
+    AERROR << "Failed to rename " << tmp_filename << " to " << cache_filename;
+    return false;
+  }
+  return true;
+}
+
+bool HDMapKDTreeCache::GetSource(const std::string& map_filename,
+                                 KDTreeCacheSource* const source) {
+  struct stat file_stat;
+  if (stat(map_filename.c_str(), &file_stat) != 0) {
+    return false;
+  }
+  source->size = file_stat.st_size;
+  source->mtime_sec = file_stat.st_mtim.tv_sec;
+  source->mtime_nsec = file_stat.st_mtim.tv_nsec;
+  return true;
+}
+
+bool HDMapKDTreeCache::MatchesSource(const std::string& cache_filename,
+                                     const std::string& map_filename) {
+  std::ifstream input(cache_filename, std::ios::binary | std::ios::ate);
+  if (!input.is_open()) {
+    return false;
+  }
+  const size_t file_size = input.tellg();
+  KDTreeCacheHeader header;
+  input.seekg(0);
+  if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      !ValidHeader(header, file_size)) {
+    AERROR << "Incompatible KD-tree cache header: " << cache_filename;
+    return false;
+  }
+  KDTreeCacheSource source;
+  if (!GetSource(map_filename, &source)) {
+    AERROR << "Failed to stat map file " << map_filename;
+    return false;
+  }
+  return SameKDTreeCacheSource(header.source, source);
+}
+
+const KDTreeCacheSource& HDMapKDTreeCache::source() const {
+  return header_->source;
+}
+
+const KDTreeCacheObject* HDMapKDTreeCache::kdtree_objects(
+    const MapKDTree kdtree) const {
+  return SectionData<KDTreeCacheObject>(header_->kdtrees[kdtree].objects);
+}
+
+int HDMapKDTreeCache::num_kdtree_objects(const MapKDTree kdtree) const {
+  return static_cast<int>(header_->kdtrees[kdtree].objects.size /
+                          sizeof(KDTreeCacheObject));
+}
+
+AABoxKDTree2dFlatView HDMapKDTreeCache::kdtree_view(
+    const MapKDTree kdtree) const {
+  const auto& sections = header_->kdtrees[kdtree];
+  AABoxKDTree2dFlatView view;
+  view.nodes = SectionData<AABoxKDTree2dFlatNode>(sections.nodes);
+  view.num_nodes =
+      static_cast<int>(sections.nodes.size / sizeof(AABoxKDTree2dFlatNode));
+  view.objects_sorted_by_min =
+      SectionData<int32_t>(sections.objects_sorted_by_min);
+  view.objects_sorted_by_max =
+      SectionData<int32_t>(sections.objects_sorted_by_max);
+  view.objects_sorted_by_min_bound =
+      SectionData<double>(sections.objects_sorted_by_min_bound);
+  view.objects_sorted_by_max_bound =
+      SectionData<double>(sections.objects_sorted_by_max_bound);
+  view.num_objects = num_kdtree_objects(kdtree);
+  return view;
+}
+
+bool HDMapKDTreeCache::ValidSection(const KDTreeCacheSection& section,
+                                    const size_t element_size) const {
+  return section.offset % kKDTreeCacheAlignment == 0 &&
+         section.offset <= size_ && section.size <= size_ - section.offset &&
+         section.size % element_size == 0;
+}
+
+bool HDMapKDTreeCache::ValidKDTree(
+    const KDTreeCacheTreeSections& sections) const {
+  if (!ValidSection(sections.objects, sizeof(KDTreeCacheObject)) ||
+      !ValidSection(sections.nodes, sizeof(AABoxKDTree2dFlatNode)) ||
+      !ValidSection(sections.objects_sorted_by_min, sizeof(int32_t)) ||
+      !ValidSection(sections.objects_sorted_by_max, sizeof(int32_t)) ||
+      !ValidSection(sections.objects_sorted_by_min_bound, sizeof(double)) ||
+      !ValidSection(sections.objects_sorted_by_max_bound, sizeof(double))) {
+    return false;
+  }
+  // Every object is held by exactly one node.
+  const uint64_t num_objects =
+      sections.objects.size / sizeof(KDTreeCacheObject);
+  return sections.objects_sorted_by_min.size / sizeof(int32_t) ==
+             num_objects &&
+         sections.objects_sorted_by_max.size / sizeof(int32_t) ==
+             num_objects &&
+         sections.objects_sorted_by_min_bound.size / sizeof(double) ==
+             num_objects &&
+         sections.objects_sorted_by_max_bound.size / sizeof(double) ==
+             num_objects;
+}
+
+void HDMapKDTreeCache::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  header_ = nullptr;
+}
+
+bool SameKDTreeCacheSource(const KDTreeCacheSource& source,
+                           const KDTreeCacheSource& other) {
+  return source.size == other.size && source.mtime_sec == other.mtime_sec &&
+         source.mtime_nsec == other.mtime_nsec;
+}
+
+}  // namespace hdmap
+}  // namespace apollo
@@ -0,0 +1,201 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#ifndef MODULES_MAP_HDMAP_HDMAP_KDTREE_CACHE_H_
+#define MODULES_MAP_HDMAP_HDMAP_KDTREE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "modules/common/math/aaboxkdtree2d.h"
+
+/**
+ * @namespace apollo::hdmap
+ * @brief apollo::hdmap
+ */
+namespace apollo {
+namespace hdmap {
+
+/**
+ * The KD-trees stored in a KD-tree cache, one per kind of map element.
+ */
+enum MapKDTree {
+  LANE_SEGMENT_KDTREE = 0,
+  JUNCTION_POLYGON_KDTREE,
+  SIGNAL_SEGMENT_KDTREE,
+  CROSSWALK_POLYGON_KDTREE,
+  STOP_SIGN_SEGMENT_KDTREE,
+  YIELD_SIGN_SEGMENT_KDTREE,
+  CLEAR_AREA_POLYGON_KDTREE,
+  SPEED_BUMP_SEGMENT_KDTREE,
+  PARKING_SPACE_POLYGON_KDTREE,
+  NUM_MAP_KDTREES,
+};
+
+/**
+ * @brief A byte range of the cache file.
+ */
+struct KDTreeCacheSection {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+
+/**
+ * @brief One object of a KD-tree. element is the index of the map element in
+ *        its repeated field of the Map proto, sub_index is the index of the
+ *        segment within the element (always 0 for polygons).
+ */
+struct KDTreeCacheObject {
+  int32_t element = 0;
+  int32_t sub_index = 0;
+};
+
+/**
+ * @brief The sections of one flattened KD-tree.
+ */
+struct KDTreeCacheTreeSections {
+  KDTreeCacheSection objects;
+  KDTreeCacheSection nodes;
+  KDTreeCacheSection objects_sorted_by_min;
+  KDTreeCacheSection objects_sorted_by_max;
+  KDTreeCacheSection objects_sorted_by_min_bound;
+  KDTreeCacheSection objects_sorted_by_max_bound;
+};
+
+/**
+ * @brief The map file a cache is built from, identified by its size and
+ *        modification time, so that a cache older than its map is detected.
+ */
+struct KDTreeCacheSource {
+  uint64_t size = 0;
+  int64_t mtime_sec = 0;
+  int64_t mtime_nsec = 0;
+};
+
+/**
+ * @brief The header at the beginning of a KD-tree cache file. All sections
+ *        are 8-byte aligned and referenced by offset from the file start, so
+ *        the file can be mapped at any address and shared between processes.
+ */
+struct KDTreeCacheHeader {
+  char magic[8];
+  uint32_t version = 0;
+  uint32_t header_size = 0;
+  uint64_t file_size = 0;
+  KDTreeCacheSource source;
+  KDTreeCacheTreeSections kdtrees[NUM_MAP_KDTREES];
+};
+
+/**
+ * @brief A flattened KD-tree and its objects, as written into a cache.
+ */
+struct KDTreeCacheTreeData {
+  std::vector<KDTreeCacheObject> objects;
+  apollo::common::math::AABoxKDTree2dFlatData flat_data;
+};
+
+/**
+ * @class HDMapKDTreeCache
+ *
+ * @brief The flattened KD-trees of a map file, mapped read-only into memory.
+ *        Only the spatial indices are cached: the map file itself is still
+ *        parsed and its element tables are still built at load time, then
+ *        HDMapImpl adopts the cached KD-trees in place instead of
+ *        partitioning and sorting the objects again.
+ */
+class HDMapKDTreeCache {
+ public:
+  HDMapKDTreeCache() = default;
+  ~HDMapKDTreeCache();
+
+  /**
+   * @brief map a cache file into memory and validate its layout
+   * @param cache_filename path of the cache file
+   * @return true if the file is a valid KD-tree cache
+   */
+  bool Load(const std::string& cache_filename);
+
+  /**
+   * @brief write a KD-tree cache file
+   * @param cache_filename path of the cache file
+   * @param source the map file the KD-trees are built from
+   * @param kdtrees the flattened KD-trees, NUM_MAP_KDTREES of them
+   * @return true on success
+   */
+  static bool Write(const std::string& cache_filename,
+                    const KDTreeCacheSource& source,
+                    const std::vector<KDTreeCacheTreeData>& kdtrees);
+
+  /**
+   * @brief get the size and modification time of a map file
+   * @param map_filename path of the map file
+   * @param source the size and modification time of the file
+   * @return true if the file exists
+   */
+  static bool GetSource(const std::string& map_filename,
+                        KDTreeCacheSource* const source);
+
+  /**
+   * @brief check if a cache is built from the current content of a map file,
+   *        reading the cache header only
+   * @param cache_filename path of the cache file
+   * @param map_filename path of the map file
+   * @return true if the cache is valid and its map file has not changed
+   */
+  static bool MatchesSource(const std::string& cache_filename,
+                            const std::string& map_filename);
+
+  const KDTreeCacheSource& source() const;
+
+  const KDTreeCacheObject* kdtree_objects(const MapKDTree kdtree) const;
+  int num_kdtree_objects(const MapKDTree kdtree) const;
+
+  /**
+   * @brief get a view of a flattened KD-tree, which stays valid as long as
+   *        this cache is alive
+   */
+  apollo::common::math::AABoxKDTree2dFlatView kdtree_view(
+      const MapKDTree kdtree) const;
+
+ private:
+  bool ValidSection(const KDTreeCacheSection& section,
+                    const size_t element_size) const;
+  bool ValidKDTree(const KDTreeCacheTreeSections& sections) const;
+  void Unmap();
+
+  template <class T>
+  const T* SectionData(const KDTreeCacheSection& section) const {
+    return reinterpret_cast<const T*>(data_ + section.offset);
+  }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  const KDTreeCacheHeader* header_ = nullptr;
+};
+
+/**
+ * @brief check if two map file sources have the same size and modification
+ *        time
+ */
+bool SameKDTreeCacheSource(const KDTreeCacheSource& source,
+                           const KDTreeCacheSource& other);
+
+}  // namespace hdmap
+}  // namespace apollo
+
+#endif  // MODULES_MAP_HDMAP_HDMAP_KDTREE_CACHE_H_
@@ -0,0 +1,157 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+/**
+ * Benchmarks of the per point and the batched lane queries of HDMap, with
+ * query points scattered around the lanes of the test map.
+ */
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/log.h"
+#include "modules/map/hdmap/hdmap.h"
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+constexpr char kMapFilename[] = "modules/map/hdmap/test-data/base_map.bin";
+constexpr double kSearchDistance = 5.0;
+constexpr double kMaxHeadingDifference = 1.0;
+
+const HDMap& TestMap() {
+  static HDMap* hdmap = [] {
+    HDMap* map = new HDMap();
+    CHECK_EQ(0, map->LoadMapFromFile(kMapFilename));
+    return map;
+  }();
+  return *hdmap;
+}
+
+// Query points close to randomly picked lane points, with the lane heading,
+// like the obstacles and the ego vehicle in a driving scenario.
+void GenerateQueries(const int num_queries,
+                     std::vector<apollo::common::PointENU>* points,
+                     std::vector<double>* headings) {
+  std::vector<LaneInfoConstPtr> lanes;
+  apollo::common::PointENU center;
+  center.set_x(586424.09);
+  center.set_y(4140727.02);
+  CHECK_EQ(0, TestMap().GetLanes(center, 500.0, &lanes));
+  CHECK(!lanes.empty());
+
+  std::mt19937 random_engine(0);
+  std::uniform_int_distribution<int> lane_distribution(
+      0, static_cast<int>(lanes.size()) - 1);
+  std::uniform_real_distribution<double> offset_distribution(-3.0, 3.0);
+  points->clear();
+  headings->clear();
+  for (int i = 0; i < num_queries; ++i) {
+    const auto& lane = lanes[lane_distribution(random_engine)];
+    std::uniform_int_distribution<int> point_distribution(
+        0, static_cast<int>(lane->headings().size()) - 1);
+    const int index = point_distribution(random_engine);
+    apollo::common::PointENU point;
+    point.set_x(lane->points()[index].x() + offset_distribution(random_engine));
+    point.set_y(lane->points()[index].y() + offset_distribution(random_engine));
+    points->push_back(point);
+    headings->push_back(lane->headings()[index]);
+  }
+}
+
+void BM_GetLanesPerPoint(benchmark::State& state) {  // NOLINT
+  std::vector<apollo::common::PointENU> points;
+  std::vector<double> headings;
+  GenerateQueries(state.range(0), &points, &headings);
+  const HDMap& hdmap = TestMap();
+  std::vector<LaneInfoConstPtr> lanes;
+  while (state.KeepRunning()) {
+    for (const auto& point : points) {
+      hdmap.GetLanes(point, kSearchDistance, &lanes);
+      benchmark::DoNotOptimize(lanes.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_GetLanesPerPoint)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+void BM_GetLanesBatch(benchmark::State& state) {  // NOLINT
+  std::vector<apollo::common::PointENU> points;
+  std::vector<double> headings;
+  GenerateQueries(state.range(0), &points, &headings);
+  const HDMap& hdmap = TestMap();
+  std::vector<std::vector<LaneInfoConstPtr>> lanes;
+  while (state.KeepRunning()) {
+    hdmap.GetLanesBatch(points, kSearchDistance, &lanes);
+    benchmark::DoNotOptimize(lanes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_GetLanesBatch)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+void BM_GetNearestLaneWithHeadingPerPoint(
+    benchmark::State& state) {  // NOLINT
+  std::vector<apollo::common::PointENU> points;
+  std::vector<double> headings;
+  GenerateQueries(state.range(0), &points, &headings);
+  const HDMap& hdmap = TestMap();
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < points.size(); ++i) {
+      LaneInfoConstPtr lane;
+      double s = 0.0;
+      double l = 0.0;
+      hdmap.GetNearestLaneWithHeading(points[i], kSearchDistance, headings[i],
+                                      kMaxHeadingDifference, &lane, &s, &l);
+      benchmark::DoNotOptimize(lane.get());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_GetNearestLaneWithHeadingPerPoint)
+    ->Arg(16)
+    ->Arg(64)
+    ->Arg(256)
+    ->Arg(1024);
+
+void BM_GetNearestLanesWithHeadingBatch(benchmark::State& state) {  // NOLINT
+  std::vector<apollo::common::PointENU> points;
+  std::vector<double> headings;
+  GenerateQueries(state.range(0), &points, &headings);
+  const HDMap& hdmap = TestMap();
+  std::vector<LaneInfoConstPtr> lanes;
+  std::vector<double> s;
+  std::vector<double> l;
+  while (state.KeepRunning()) {
+    hdmap.GetNearestLanesWithHeadingBatch(points, kSearchDistance, headings,
+                                          kMaxHeadingDifference, &lanes, &s,
+                                          &l);
+    benchmark::DoNotOptimize(lanes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_GetNearestLanesWithHeadingBatch)
+    ->Arg(16)
+    ->Arg(64)
+    ->Arg(256)
+    ->Arg(1024);
+
+}  // namespace
+}  // namespace hdmap
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -14,6 +14,10 @@ limitations under the License.
 =========================================================================*/
 #include "modules/map/hdmap/hdmap_util.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/util/file.h"
 #include "modules/common/util/string_tokenizer.h"
@@ -21,8 +25,10 @@ limitations under the License.
 namespace apollo {
 namespace hdmap {
 
+using apollo::common::PointENU;
 using apollo::common::adapter::AdapterManager;
 using apollo::relative_map::MapMsg;
+using apollo::routing::RoutingResponse;
 
 namespace {
 
@@ -43,6 +49,103 @@ std::string FindFirstExist(const std::string& dir, const std::string& files) {
   return apollo::common::util::StrCat(FLAGS_map_dir, "/", candidates[0]);
 }
 
+// Create the base map, adopting the kdtrees from its KD-tree cache if there is
+// one built from the current base map file.
+std::unique_ptr<HDMap> CreateBaseMap() {
+  const std::string map_file = BaseMapFile();
+  if (!FLAGS_test_base_map_filename.empty() ||
+      FLAGS_base_map_kdtree_cache_filename.empty()) {
+    return CreateMap(map_file);
+  }
+  const std::string cache_file = apollo::common::util::StrCat(
+      FLAGS_map_dir, "/", FLAGS_base_map_kdtree_cache_filename);
+  if (!apollo::common::util::PathExists(cache_file)) {
+    return CreateMap(map_file);
+  }
+  std::unique_ptr<HDMap> hdmap(new HDMap());
+  if (hdmap->LoadMapFromFile(map_file, cache_file) != 0) {
+    AERROR << "Failed to load HDMap " << map_file;
+    return nullptr;
+  }
+  AINFO << "Load HDMap success: " << map_file;
+  return hdmap;
+}
+
+// Get the latest ego position, if the localization adapter has any.
+bool GetEgoPosition(PointENU* position) {
+  auto* localization = AdapterManager::GetLocalization();
+  if (localization == nullptr || localization->Empty()) {
+    return false;
+  }
+  *position = localization->GetLatestObserved().pose().position();
+  return true;
+}
+
+// Points along the routing, no farther apart than the given step.
+std::vector<PointENU> RoutingPoints(const RoutingResponse& routing,
+                                    const double step) {
+  std::vector<PointENU> points;
+  for (const auto& waypoint : routing.routing_request().waypoint()) {
+    if (!waypoint.has_pose()) {
+      continue;
+    }
+    const PointENU& pose = waypoint.pose();
+    if (!points.empty()) {
+      const PointENU prev = points.back();
+      const double dx = pose.x() - prev.x();
+      const double dy = pose.y() - prev.y();
+      const int num_steps =
+          std::max(1, static_cast<int>(std::ceil(std::hypot(dx, dy) / step)));
+      for (int i = 1; i < num_steps; ++i) {
+        const double ratio = static_cast<double>(i) / num_steps;
+        PointENU point;
+        point.set_x(prev.x() + ratio * dx);
+        point.set_y(prev.y() + ratio * dy);
+        points.push_back(point);
+      }
+    }
+    points.push_back(pose);
+  }
+  return points;
+}
+
+// Create the tiled base map with its active map around the given position,
+// or the ego position if there is none, or else around the first tile.
+std::unique_ptr<TiledHDMap> CreateTiledBaseMap(const PointENU* ego_position) {
+  const std::string tile_dir = apollo::common::util::StrCat(
+      FLAGS_map_dir, "/", FLAGS_base_map_tile_dirname);
+  TiledHDMapParams params;
+  params.active_radius = FLAGS_base_map_tile_active_radius;
+  params.max_cache_bytes =
+      static_cast<int64_t>(FLAGS_base_map_tile_cache_mb) * 1024 * 1024;
+  std::unique_ptr<TiledHDMap> tiled_map(new TiledHDMap());
+  if (!tiled_map->Init(tile_dir, params)) {
+    AERROR << "Failed to load map tiles from " << tile_dir;
+    return nullptr;
+  }
+  PointENU position;
+  if (ego_position != nullptr) {
+    position = *ego_position;
+  } else if (!GetEgoPosition(&position)) {
+    const auto& tile_index = tiled_map->tile_index();
+    if (tile_index.tile_size() == 0) {
+      AERROR << "No map tile in " << tile_dir;
+      return nullptr;
+    }
+    const auto& tile = tile_index.tile(0);
+    position.set_x((tile.x() + 0.5) * tile_index.tile_length());
+    position.set_y((tile.y() + 0.5) * tile_index.tile_length());
+    position.set_z(0.0);
+  }
+  if (!tiled_map->UpdatePosition(position)) {
+    AERROR << "Failed to build the active map at "
+           << position.ShortDebugString();
+    return nullptr;
+  }
+  AINFO << "Load tiled HDMap success: " << tile_dir;
+  return tiled_map;
+}
+
 }  // namespace
 
 const SpeedControls* GetSpeedControls() {
@@ -101,14 +204,18 @@ std::unique_ptr<HDMap> CreateMap(const MapMsg& map_msg) {
   return hdmap;
 }
 
-std::unique_ptr<HDMap> HDMapUtil::base_map_ = nullptr;
+std::shared_ptr<const HDMap> HDMapUtil::base_map_ = nullptr;
 uint64_t HDMapUtil::base_map_seq_ = 0;
 std::mutex HDMapUtil::base_map_mutex_;
+std::unique_ptr<TiledHDMap> HDMapUtil::tiled_base_map_ = nullptr;
+int64_t HDMapUtil::routing_seq_ = -1;
 
-std::unique_ptr<HDMap> HDMapUtil::sim_map_ = nullptr;
+std::shared_ptr<const HDMap> HDMapUtil::sim_map_ = nullptr;
 std::mutex HDMapUtil::sim_map_mutex_;
 
-const HDMap* HDMapUtil::BaseMapPtr() {
+std::mutex HDMapUtil::reload_mutex_;
+
+std::shared_ptr<const HDMap> HDMapUtil::BaseMapSnapshot() {
   if (FLAGS_use_navigation_mode) {
     std::lock_guard<std::mutex> lock(base_map_mutex_);
     auto* relative_map = AdapterManager::GetRelativeMap();
@@ -124,46 +231,119 @@ const HDMap* HDMapUtil::BaseMapPtr() {
     if (base_map_ != nullptr &&
         base_map_seq_ == latest.header().sequence_num()) {
       // avoid re-create map in the same cycle.
-      return base_map_.get();
-    } else {
-      base_map_ = CreateMap(latest);
-      base_map_seq_ = latest.header().sequence_num();
+      return base_map_;
     }
-  } else if (base_map_ == nullptr) {
+    std::shared_ptr<const HDMap> base_map = CreateMap(latest);
+    std::atomic_store(&base_map_, base_map);
+    base_map_seq_ = latest.header().sequence_num();
+    return base_map;
+  }
+  auto base_map = std::atomic_load(&base_map_);
+  if (base_map == nullptr) {
     std::lock_guard<std::mutex> lock(base_map_mutex_);
-    if (base_map_ == nullptr) {  // Double check.
-      base_map_ = CreateMap(BaseMapFile());
+    base_map = std::atomic_load(&base_map_);
+    if (base_map == nullptr) {  // Double check.
+      if (FLAGS_base_map_tile_dirname.empty()) {
+        base_map = CreateBaseMap();
+      } else {
+        // No UpdateBaseMapPosition() yet, start around the localization.
+        tiled_base_map_ = CreateTiledBaseMap(nullptr);
+        if (tiled_base_map_ != nullptr) {
+          base_map = tiled_base_map_->map();
+        }
+      }
+      std::atomic_store(&base_map_, base_map);
     }
   }
-  return base_map_.get();
+  return base_map;
 }
 
+void HDMapUtil::UpdateBaseMapPosition(const PointENU& position) {
+  if (FLAGS_use_navigation_mode || FLAGS_base_map_tile_dirname.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(base_map_mutex_);
+  if (tiled_base_map_ == nullptr) {
+    tiled_base_map_ = CreateTiledBaseMap(&position);
+    if (tiled_base_map_ == nullptr) {
+      return;
+    }
+  } else {
+    tiled_base_map_->UpdatePosition(position);
+  }
+  auto* routing = AdapterManager::GetRoutingResponse();
+  if (routing != nullptr && !routing->Empty()) {
+    const auto& latest = routing->GetLatestObserved();
+    if (routing_seq_ != latest.header().sequence_num()) {
+      tiled_base_map_->Prefetch(
+          RoutingPoints(latest, FLAGS_base_map_tile_active_radius));
+      routing_seq_ = latest.header().sequence_num();
+    }
+  }
+  // The active map is swapped in the background as the ego vehicle moves,
+  // publish the current one.
+  std::atomic_store(&base_map_, tiled_base_map_->map());
+}
+
+const HDMap* HDMapUtil::BaseMapPtr() { return BaseMapSnapshot().get(); }
+
 const HDMap& HDMapUtil::BaseMap() { return *CHECK_NOTNULL(BaseMapPtr()); }
 
-const HDMap* HDMapUtil::SimMapPtr() {
+std::shared_ptr<const HDMap> HDMapUtil::SimMapSnapshot() {
   if (FLAGS_use_navigation_mode) {
-    return BaseMapPtr();
-  } else if (sim_map_ == nullptr) {
+    return BaseMapSnapshot();
+  }
+  auto sim_map = std::atomic_load(&sim_map_);
+  if (sim_map == nullptr) {
     std::lock_guard<std::mutex> lock(sim_map_mutex_);
-    if (sim_map_ == nullptr) {  // Double check.
-      sim_map_ = CreateMap(SimMapFile());
+    sim_map = std::atomic_load(&sim_map_);
+    if (sim_map == nullptr) {  // Double check.
+      sim_map = CreateMap(SimMapFile());
+      std::atomic_store(&sim_map_, sim_map);
     }
   }
-  return sim_map_.get();
+  return sim_map;
 }
 
+const HDMap* HDMapUtil::SimMapPtr() { return SimMapSnapshot().get(); }
+
 const HDMap& HDMapUtil::SimMap() { return *CHECK_NOTNULL(SimMapPtr()); }
 
 bool HDMapUtil::ReloadMaps() {
+  std::lock_guard<std::mutex> reload_lock(reload_mutex_);
+  // Build the new maps aside, readers keep using the current snapshots.
+  std::unique_ptr<TiledHDMap> tiled_base_map;
+  std::shared_ptr<const HDMap> base_map;
+  if (FLAGS_base_map_tile_dirname.empty()) {
+    base_map = CreateBaseMap();
+  } else {
+    tiled_base_map = CreateTiledBaseMap(nullptr);
+    if (tiled_base_map != nullptr) {
+      base_map = tiled_base_map->map();
+    }
+  }
+  std::shared_ptr<const HDMap> sim_map = CreateMap(SimMapFile());
+  if (base_map == nullptr || sim_map == nullptr) {
+    AERROR << "Failed to reload maps, keep using the current maps.";
+    return false;
+  }
   {
     std::lock_guard<std::mutex> lock(base_map_mutex_);
-    base_map_ = CreateMap(BaseMapFile());
+    // The replaced tiled map is destroyed after the lock is released.
+    tiled_base_map_.swap(tiled_base_map);
+    routing_seq_ = -1;
+    std::atomic_store(&base_map_, base_map);
   }
   {
     std::lock_guard<std::mutex> lock(sim_map_mutex_);
-    sim_map_ = CreateMap(SimMapFile());
+    std::atomic_store(&sim_map_, sim_map);
   }
-  return base_map_ != nullptr && sim_map_ != nullptr;
+  // The replaced maps are freed when their last snapshot is released.
+  return true;
+}
+
+std::future<bool> HDMapUtil::ReloadMapsAsync() {
+  return std::async(std::launch::async, &HDMapUtil::ReloadMaps);
 }
 
 }  // namespace hdmap
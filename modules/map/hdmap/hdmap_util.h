@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef MODULES_MAP_HDMAP_HDMAP_UTIL_H_
 #define MODULES_MAP_HDMAP_HDMAP_UTIL_H_
 
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -27,6 +28,7 @@ limitations under the License.
 #include "modules/common/util/file.h"
 #include "modules/common/util/string_util.h"
 #include "modules/map/hdmap/hdmap.h"
+#include "modules/map/hdmap/tiled_hdmap.h"
 
 /**
  * @namespace apollo::hdmap
@@ -87,33 +89,82 @@ inline apollo::hdmap::Id MakeMapId(const std::string& id) {
 
 std::unique_ptr<HDMap> CreateMap(const std::string& map_file_path);
 
+/**
+ * @class HDMapUtil
+ *
+ * @brief Holds the process-wide base map and sim map. Each map is an
+ *        immutable snapshot: a reload builds new maps aside and then swaps
+ *        them in atomically, so readers never take a lock or see a partially
+ *        built map. A snapshot stays alive as long as anyone holds it.
+ *        If FLAGS_base_map_tile_dirname is set, the base map is the active
+ *        map of a TiledHDMap, which the modules using it move along with the
+ *        ego vehicle by calling UpdateBaseMapPosition() once per cycle.
+ */
 class HDMapUtil {
  public:
   // Get default base map from the file specified by global flags.
   // Return nullptr if failed to load.
+  // The returned map is only guaranteed to stay alive until the next reload.
+  // In navigation mode, a new map is built for every relative map, and with
+  // a tiled base map, the active map is replaced as the ego vehicle moves,
+  // so modules which may run in navigation mode, reload the maps or see a
+  // tiled map must hold a BaseMapSnapshot() instead.
   static const HDMap* BaseMapPtr();
   // Guarantee to return a valid base_map, or else raise fatal error.
   static const HDMap& BaseMap();
 
+  // Get the current snapshot of the default base map. The snapshot stays
+  // valid while it is held, even if the maps are reloaded meanwhile.
+  // With a tiled base map, the snapshot covers the tiles around the position
+  // given to the last UpdateBaseMapPosition(), or around the localization or
+  // the first tile when the tiled map is created.
+  // Return nullptr if failed to load.
+  static std::shared_ptr<const HDMap> BaseMapSnapshot();
+
+  // Move the tiled base map to the ego position and prefetch the tiles along
+  // a new routing, then publish its active map for BaseMapSnapshot(). A new
+  // active map is built in the background and published by a later call.
+  // Called once per cycle by the modules using the base map, before taking
+  // their snapshot. Does nothing without a tiled base map.
+  static void UpdateBaseMapPosition(const apollo::common::PointENU& position);
+
   // Get default sim_map from the file specified by global flags.
   // Return nullptr if failed to load.
+  // The same lifetime rule as BaseMapPtr() applies.
   static const HDMap* SimMapPtr();
 
   // Guarantee to return a valid sim_map, or else raise fatal error.
   static const HDMap& SimMap();
 
-  // Reload maps from the file specified by global flags.
+  // Get the current snapshot of the default sim_map.
+  // Return nullptr if failed to load.
+  static std::shared_ptr<const HDMap> SimMapSnapshot();
+
+  // Reload maps from the file specified by global flags. New maps are built
+  // without blocking readers and published only if all of them are loaded,
+  // otherwise the current maps are kept.
   static bool ReloadMaps();
 
+  // Reload maps on a background thread, see ReloadMaps().
+  static std::future<bool> ReloadMapsAsync();
+
  private:
   HDMapUtil() = delete;
 
-  static std::unique_ptr<HDMap> base_map_;
+  // Guarded by base_map_mutex_ for writing; read with std::atomic_load.
+  static std::shared_ptr<const HDMap> base_map_;
   static uint64_t base_map_seq_;
   static std::mutex base_map_mutex_;
+  // Guarded by base_map_mutex_.
+  static std::unique_ptr<TiledHDMap> tiled_base_map_;
+  static int64_t routing_seq_;
 
-  static std::unique_ptr<HDMap> sim_map_;
+  // Guarded by sim_map_mutex_ for writing; read with std::atomic_load.
+  static std::shared_ptr<const HDMap> sim_map_;
   static std::mutex sim_map_mutex_;
+
+  // Serializes reloads.
+  static std::mutex reload_mutex_;
 };
 
 }  // namespace hdmap
@@ -15,10 +15,16 @@ limitations under the License.
 
 #include "modules/map/hdmap/hdmap_util.h"
 
+#include <chrono>
+#include <memory>
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "modules/common/time/time.h"
 
 #include "modules/common/adapters/adapter_manager.h"
+#include "modules/common/util/file.h"
+#include "modules/map/hdmap/tiled_hdmap.h"
 
 namespace apollo {
 namespace hdmap {
@@ -87,5 +93,118 @@ TEST_F(HDMapUtilTestSuite, ReuseMap) {
   EXPECT_NE(hdmap2, hdmap1);  // hdmap should be updated.
 }
 
+TEST_F(HDMapUtilTestSuite, ReloadMapsKeepsSnapshots) {
+  FLAGS_use_navigation_mode = false;
+  FLAGS_map_dir = "modules/map/hdmap/test-data";
+  FLAGS_test_base_map_filename = "";
+  FLAGS_base_map_kdtree_cache_filename = "";
+  FLAGS_base_map_filename = "base_map.bin";
+  FLAGS_sim_map_filename = "base_map.bin";
+  ASSERT_TRUE(HDMapUtil::ReloadMaps());
+
+  auto base_map = HDMapUtil::BaseMapSnapshot();
+  ASSERT_TRUE(base_map != nullptr);
+  EXPECT_EQ(base_map.get(), HDMapUtil::BaseMapPtr());
+  ASSERT_TRUE(HDMapUtil::SimMapSnapshot() != nullptr);
+  std::weak_ptr<const HDMap> old_base_map = base_map;
+
+  auto reload = HDMapUtil::ReloadMapsAsync();
+  // The held snapshot stays usable while the maps are reloaded.
+  EXPECT_TRUE(base_map->GetLaneById(MakeMapId("1272_1_-1")) != nullptr);
+  ASSERT_TRUE(reload.get());
+  auto new_base_map = HDMapUtil::BaseMapSnapshot();
+  ASSERT_TRUE(new_base_map != nullptr);
+  EXPECT_NE(new_base_map, base_map);
+
+  // The old map is freed when its last snapshot is released.
+  EXPECT_FALSE(old_base_map.expired());
+  base_map.reset();
+  EXPECT_TRUE(old_base_map.expired());
+
+  // A failed reload keeps the current maps.
+  FLAGS_base_map_filename = "not_exist.bin";
+  EXPECT_FALSE(HDMapUtil::ReloadMaps());
+  EXPECT_EQ(new_base_map, HDMapUtil::BaseMapSnapshot());
+  FLAGS_base_map_filename = "base_map.bin";
+}
+
+TEST_F(HDMapUtilTestSuite, TiledBaseMap) {
+  HDMap full_map;
+  ASSERT_EQ(0, full_map.LoadMapFromFile(
+                   "modules/map/hdmap/test-data/base_map.bin"));
+  Map map_proto;
+  ASSERT_TRUE(apollo::common::util::GetProtoFromFile(
+      "modules/map/hdmap/test-data/base_map.bin", &map_proto));
+  ASSERT_TRUE(TiledHDMap::GenerateTiles(map_proto, 50.0,
+                                        "/tmp/hdmap_util_test_tiles"));
+  FLAGS_use_navigation_mode = false;
+  FLAGS_map_dir = "/tmp";
+  FLAGS_base_map_tile_dirname = "hdmap_util_test_tiles";
+  FLAGS_base_map_tile_active_radius = 10.0;
+
+  AdapterManager::Reset();
+  AdapterManagerConfig adapter_config;
+  adapter_config.set_is_ros(false);
+  for (const auto type :
+       {AdapterConfig::LOCALIZATION, AdapterConfig::ROUTING_RESPONSE}) {
+    auto* config = adapter_config.add_config();
+    config->set_type(type);
+    config->set_mode(AdapterConfig::RECEIVE_ONLY);
+  }
+  AdapterManager::Init(adapter_config);
+
+  const auto lane = full_map.GetLaneById(MakeMapId("1272_1_-1"));
+  ASSERT_TRUE(lane != nullptr);
+  const auto& point = lane->points().front();
+  apollo::localization::LocalizationEstimate localization;
+  localization.mutable_pose()->mutable_position()->set_x(point.x());
+  localization.mutable_pose()->mutable_position()->set_y(point.y());
+  AdapterManager::FeedLocalizationData(localization);
+  apollo::routing::RoutingResponse routing;
+  routing.mutable_header()->set_sequence_num(1);
+  for (const double dx : {0.0, 1000.0}) {
+    auto* pose =
+        routing.mutable_routing_request()->add_waypoint()->mutable_pose();
+    pose->set_x(point.x() + dx);
+    pose->set_y(point.y());
+  }
+  AdapterManager::FeedRoutingResponseData(routing);
+  AdapterManager::Observe();
+
+  // The active map around the ego vehicle is served as the base map.
+  HDMapUtil::UpdateBaseMapPosition(localization.pose().position());
+  auto base_map = HDMapUtil::BaseMapSnapshot();
+  ASSERT_TRUE(base_map != nullptr);
+  EXPECT_EQ(base_map, HDMapUtil::BaseMapSnapshot());
+  EXPECT_TRUE(base_map->GetLaneById(MakeMapId("1272_1_-1")) != nullptr);
+
+  // Moving away builds a new active map in the background, which a later
+  // update publishes.
+  const auto other_lane = full_map.GetLaneById(MakeMapId("200_1_-1"));
+  ASSERT_TRUE(other_lane != nullptr);
+  apollo::common::PointENU other_position;
+  other_position.set_x(other_lane->points().front().x());
+  other_position.set_y(other_lane->points().front().y());
+  std::shared_ptr<const HDMap> other_map;
+  for (int i = 0; i < 100; ++i) {
+    HDMapUtil::UpdateBaseMapPosition(other_position);
+    other_map = HDMapUtil::BaseMapSnapshot();
+    if (other_map != base_map) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_NE(base_map, other_map);
+  LaneInfoConstPtr nearest_lane;
+  double s = 0.0;
+  double l = 0.0;
+  EXPECT_EQ(0, other_map->GetNearestLane(other_position, &nearest_lane, &s,
+                                         &l));
+  EXPECT_EQ(other_lane->id().id(), nearest_lane->id().id());
+  // The old snapshot stays valid.
+  EXPECT_TRUE(base_map->GetLaneById(MakeMapId("1272_1_-1")) != nullptr);
+  FLAGS_base_map_tile_dirname = "";
+}
+
 }  // namespace hdmap
 }  // namespace apollo
@@ -0,0 +1,108 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#include "modules/map/hdmap/lane_topology.h"
+
+#include <algorithm>
+
+#include "google/protobuf/repeated_field.h"
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+using google::protobuf::RepeatedPtrField;
+
+const RepeatedPtrField<Id> &RelatedLaneIds(const Lane &lane,
+                                           const LaneRelation relation) {
+  switch (relation) {
+    case LANE_SUCCESSOR:
+      return lane.successor_id();
+    case LANE_PREDECESSOR:
+      return lane.predecessor_id();
+    case LANE_LEFT_FORWARD_NEIGHBOR:
+      return lane.left_neighbor_forward_lane_id();
+    case LANE_RIGHT_FORWARD_NEIGHBOR:
+      return lane.right_neighbor_forward_lane_id();
+    case LANE_LEFT_REVERSE_NEIGHBOR:
+      return lane.left_neighbor_reverse_lane_id();
+    default:
+      return lane.right_neighbor_reverse_lane_id();
+  }
+}
+
+}  // namespace
+
+constexpr int LaneTopology::kInvalidLaneIndex;
+
+void LaneTopology::Build(const std::vector<LaneInfoConstPtr> &lanes) {
+  Clear();
+  lanes_ = lanes;
+  lane_lengths_.reserve(lanes_.size());
+  lane_indices_.reserve(lanes_.size());
+  for (size_t i = 0; i < lanes_.size(); ++i) {
+    lane_lengths_.push_back(lanes_[i]->total_length());
+    lane_indices_.emplace(lanes_[i]->id().id(), static_cast<int32_t>(i));
+  }
+  for (int r = 0; r < NUM_LANE_RELATIONS; ++r) {
+    const auto relation = static_cast<LaneRelation>(r);
+    auto *offsets = &offsets_[r];
+    auto *related_lanes = &related_lanes_[r];
+    offsets->reserve(lanes_.size() + 1);
+    offsets->push_back(0);
+    for (const auto &lane : lanes_) {
+      for (const auto &id : RelatedLaneIds(lane->lane(), relation)) {
+        const int index = GetLaneIndex(id.id());
+        if (index != kInvalidLaneIndex) {
+          related_lanes->push_back(index);
+        }
+      }
+      offsets->push_back(static_cast<int32_t>(related_lanes->size()));
+    }
+  }
+}
+
+void LaneTopology::Clear() {
+  lanes_.clear();
+  lane_lengths_.clear();
+  lane_indices_.clear();
+  for (int r = 0; r < NUM_LANE_RELATIONS; ++r) {
+    offsets_[r].clear();
+    related_lanes_[r].clear();
+  }
+}
+
+int LaneTopology::GetLaneIndex(const std::string &id) const {
+  const auto iter = lane_indices_.find(id);
+  return iter == lane_indices_.end() ? kInvalidLaneIndex : iter->second;
+}
+
+int LaneTopology::GetLaneIndex(const LaneInfo &lane) const {
+  const int index = lane.index();
+  if (index >= 0 && index < num_lanes() && lanes_[index].get() == &lane) {
+    return index;
+  }
+  return GetLaneIndex(lane.id().id());
+}
+
+bool LaneTopology::IsRelated(const LaneRelation relation, const int from,
+                             const int to) const {
+  const auto related_lanes = GetRelatedLanes(relation, from);
+  return std::find(related_lanes.begin(), related_lanes.end(), to) !=
+         related_lanes.end();
+}
+
+}  // namespace hdmap
+}  // namespace apollo
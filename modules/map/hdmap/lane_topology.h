@@ -0,0 +1,155 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#ifndef MODULES_MAP_HDMAP_LANE_TOPOLOGY_H_
+#define MODULES_MAP_HDMAP_LANE_TOPOLOGY_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/map/hdmap/hdmap_common.h"
+
+/**
+ * @namespace apollo::hdmap
+ * @brief apollo::hdmap
+ */
+namespace apollo {
+namespace hdmap {
+
+/**
+ * @brief The connections between lanes recorded in the Lane proto.
+ */
+enum LaneRelation {
+  LANE_SUCCESSOR = 0,
+  LANE_PREDECESSOR,
+  LANE_LEFT_FORWARD_NEIGHBOR,
+  LANE_RIGHT_FORWARD_NEIGHBOR,
+  LANE_LEFT_REVERSE_NEIGHBOR,
+  LANE_RIGHT_REVERSE_NEIGHBOR,
+  NUM_LANE_RELATIONS,
+};
+
+/**
+ * @class LaneIndexRange
+ * @brief A range of lane indices in a LaneTopology.
+ */
+class LaneIndexRange {
+ public:
+  LaneIndexRange(const int32_t *begin, const int32_t *end)
+      : begin_(begin), end_(end) {}
+
+  const int32_t *begin() const { return begin_; }
+  const int32_t *end() const { return end_; }
+  int size() const { return static_cast<int>(end_ - begin_); }
+  bool empty() const { return begin_ == end_; }
+  int32_t operator[](const int i) const { return begin_[i]; }
+
+ private:
+  const int32_t *begin_ = nullptr;
+  const int32_t *end_ = nullptr;
+};
+
+/**
+ * @class LaneTopology
+ *
+ * @brief An immutable, integer indexed lane graph built once when a map is
+ *        loaded. Each lane gets a dense index, which is also available as
+ *        LaneInfo::index(), and the lanes related to it are stored in
+ *        compressed sparse rows, so walking the lane graph needs no string
+ *        id lookup. Ids which do not refer to a lane of the map are dropped.
+ */
+class LaneTopology {
+ public:
+  static constexpr int kInvalidLaneIndex = -1;
+
+  LaneTopology() = default;
+
+  /**
+   * @brief build the topology of lanes
+   * @param lanes the lanes, whose positions become their indices
+   */
+  void Build(const std::vector<LaneInfoConstPtr> &lanes);
+
+  void Clear();
+
+  int num_lanes() const { return static_cast<int>(lanes_.size()); }
+
+  /**
+   * @brief get the index of a lane
+   * @param id the lane id
+   * @return the lane index, or kInvalidLaneIndex if there is no such lane
+   */
+  int GetLaneIndex(const std::string &id) const;
+  int GetLaneIndex(const Id &id) const { return GetLaneIndex(id.id()); }
+
+  /**
+   * @brief get the index of a lane, using LaneInfo::index() if the lane is
+   *        from this topology, and its id otherwise
+   * @param lane the lane, possibly from another snapshot of the map
+   * @return the lane index, or kInvalidLaneIndex if there is no such lane
+   */
+  int GetLaneIndex(const LaneInfo &lane) const;
+
+  const LaneInfoConstPtr &lane(const int index) const {
+    return lanes_[index];
+  }
+  double lane_length(const int index) const { return lane_lengths_[index]; }
+
+  /**
+   * @brief get the lanes related to a lane, in the order of the Lane proto
+   * @param relation the relation to the lane
+   * @param index the lane index
+   * @return indices of the related lanes
+   */
+  LaneIndexRange GetRelatedLanes(const LaneRelation relation,
+                                 const int index) const {
+    const auto &offsets = offsets_[relation];
+    const int32_t *related_lanes = related_lanes_[relation].data();
+    return LaneIndexRange(related_lanes + offsets[index],
+                          related_lanes + offsets[index + 1]);
+  }
+  LaneIndexRange successors(const int index) const {
+    return GetRelatedLanes(LANE_SUCCESSOR, index);
+  }
+  LaneIndexRange predecessors(const int index) const {
+    return GetRelatedLanes(LANE_PREDECESSOR, index);
+  }
+
+  /**
+   * @brief check whether a lane is related to another one
+   * @param relation the relation to check
+   * @param from index of the lane the relation starts from
+   * @param to index of the other lane
+   * @return true if lane to is in relation to lane from
+   */
+  bool IsRelated(const LaneRelation relation, const int from,
+                 const int to) const;
+
+ private:
+  std::vector<LaneInfoConstPtr> lanes_;
+  std::vector<double> lane_lengths_;
+  std::unordered_map<std::string, int32_t> lane_indices_;
+  // Lanes related to lane i are in [offsets_[r][i], offsets_[r][i + 1]) of
+  // related_lanes_[r].
+  std::vector<int32_t> offsets_[NUM_LANE_RELATIONS];
+  std::vector<int32_t> related_lanes_[NUM_LANE_RELATIONS];
+};
+
+}  // namespace hdmap
+}  // namespace apollo
+
+#endif  // MODULES_MAP_HDMAP_LANE_TOPOLOGY_H_
@@ -0,0 +1,534 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#include "modules/map/hdmap/tiled_hdmap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "modules/common/log.h"
+#include "modules/common/math/aabox2d.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/common/util/file.h"
+#include "modules/common/util/string_util.h"
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+using apollo::common::PointENU;
+using apollo::common::math::AABox2d;
+using apollo::common::math::Vec2d;
+using apollo::common::util::StrCat;
+using google::protobuf::RepeatedPtrField;
+
+using TileCoord = std::pair<int, int>;
+using TileMaps = std::map<TileCoord, Map>;
+using ElementTiles = std::unordered_map<std::string, std::set<TileCoord>>;
+using ElementAdders =
+    std::unordered_map<std::string, std::function<void(Map* map)>>;
+
+constexpr char kTileIndexFilename[] = "map_tile_index.bin";
+
+void AddPoints(const Curve& curve, std::vector<Vec2d>* points) {
+  for (const auto& segment : curve.segment()) {
+    for (const auto& point : segment.line_segment().point()) {
+      points->emplace_back(point.x(), point.y());
+    }
+  }
+}
+
+void AddPoints(const Polygon& polygon, std::vector<Vec2d>* points) {
+  for (const auto& point : polygon.point()) {
+    points->emplace_back(point.x(), point.y());
+  }
+}
+
+void GetElementPoints(const Lane& lane, std::vector<Vec2d>* points) {
+  AddPoints(lane.central_curve(), points);
+  AddPoints(lane.left_boundary().curve(), points);
+  AddPoints(lane.right_boundary().curve(), points);
+}
+
+void GetElementPoints(const Signal& signal, std::vector<Vec2d>* points) {
+  AddPoints(signal.boundary(), points);
+  for (const auto& stop_line : signal.stop_line()) {
+    AddPoints(stop_line, points);
+  }
+}
+
+void GetElementPoints(const StopSign& stop_sign, std::vector<Vec2d>* points) {
+  for (const auto& stop_line : stop_sign.stop_line()) {
+    AddPoints(stop_line, points);
+  }
+}
+
+void GetElementPoints(const YieldSign& yield_sign,
+                      std::vector<Vec2d>* points) {
+  for (const auto& stop_line : yield_sign.stop_line()) {
+    AddPoints(stop_line, points);
+  }
+}
+
+void GetElementPoints(const SpeedBump& speed_bump,
+                      std::vector<Vec2d>* points) {
+  for (const auto& position : speed_bump.position()) {
+    AddPoints(position, points);
+  }
+}
+
+template <class PolygonElement>
+void GetElementPoints(const PolygonElement& element,
+                      std::vector<Vec2d>* points) {
+  AddPoints(element.polygon(), points);
+}
+
+// Adds every element to all tiles its bounding box touches.
+template <class Element>
+void AssignToTiles(const RepeatedPtrField<Element>& elements,
+                   Element* (Map::*add_element)(), const double tile_length,
+                   TileMaps* tiles, ElementTiles* element_tiles) {
+  for (const auto& element : elements) {
+    std::vector<Vec2d> points;
+    GetElementPoints(element, &points);
+    if (points.empty()) {
+      AWARN << "Skip map element without geometry: " << element.id().id();
+      continue;
+    }
+    const AABox2d box(points);
+    const int min_x = static_cast<int>(std::floor(box.min_x() / tile_length));
+    const int max_x = static_cast<int>(std::floor(box.max_x() / tile_length));
+    const int min_y = static_cast<int>(std::floor(box.min_y() / tile_length));
+    const int max_y = static_cast<int>(std::floor(box.max_y() / tile_length));
+    for (int x = min_x; x <= max_x; ++x) {
+      for (int y = min_y; y <= max_y; ++y) {
+        *((*tiles)[{x, y}].*add_element)() = element;
+        (*element_tiles)[element.id().id()].insert({x, y});
+      }
+    }
+  }
+}
+
+// Records how to copy each element into a tile by its id.
+template <class Element>
+void AddElementAdders(const RepeatedPtrField<Element>& elements,
+                      Element* (Map::*add_element)(), ElementAdders* adders) {
+  for (const auto& element : elements) {
+    adders->emplace(element.id().id(), [&element, add_element](Map* map) {
+      *(map->*add_element)() = element;
+    });
+  }
+}
+
+// Drops the lanes of a road section which are not in the tile.
+void FilterRoadLanes(Map* tile) {
+  std::unordered_set<std::string> lane_ids;
+  for (const auto& lane : tile->lane()) {
+    lane_ids.insert(lane.id().id());
+  }
+  for (auto& road : *tile->mutable_road()) {
+    for (auto& section : *road.mutable_section()) {
+      RepeatedPtrField<Id> section_lane_ids;
+      for (const auto& lane_id : section.lane_id()) {
+        if (lane_ids.count(lane_id.id()) > 0) {
+          *section_lane_ids.Add() = lane_id;
+        }
+      }
+      section.mutable_lane_id()->Swap(&section_lane_ids);
+    }
+  }
+}
+
+}  // namespace
+
+TiledHDMap::TiledHDMap()
+    : prefetch_pool_(new apollo::common::util::ThreadPool(1)),
+      build_pool_(new apollo::common::util::ThreadPool(1)) {}
+
+TiledHDMap::~TiledHDMap() {
+  // Finish pending builds and prefetches before the cache is destroyed.
+  build_pool_.reset();
+  prefetch_pool_.reset();
+}
+
+bool TiledHDMap::GenerateTiles(const Map& map, const double tile_length,
+                               const std::string& tile_dir) {
+  if (tile_length <= 0.0) {
+    AERROR << "Invalid tile length: " << tile_length;
+    return false;
+  }
+  TileMaps tiles;
+  ElementTiles element_tiles;
+  AssignToTiles(map.lane(), &Map::add_lane, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.junction(), &Map::add_junction, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.signal(), &Map::add_signal, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.crosswalk(), &Map::add_crosswalk, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.stop_sign(), &Map::add_stop_sign, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.yield(), &Map::add_yield, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.clear_area(), &Map::add_clear_area, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.speed_bump(), &Map::add_speed_bump, tile_length, &tiles,
+                &element_tiles);
+  AssignToTiles(map.parking_space(), &Map::add_parking_space, tile_length,
+                &tiles, &element_tiles);
+
+  // Overlaps go with the objects they relate.
+  for (const auto& overlap : map.overlap()) {
+    std::set<TileCoord> overlap_tiles;
+    for (const auto& object : overlap.object()) {
+      const auto iter = element_tiles.find(object.id().id());
+      if (iter != element_tiles.end()) {
+        overlap_tiles.insert(iter->second.begin(), iter->second.end());
+      }
+    }
+    for (const auto& coord : overlap_tiles) {
+      *tiles[coord].add_overlap() = overlap;
+    }
+  }
+
+  // An object related by an overlap of a tile is copied into the tile, so
+  // the overlaps of the elements of the tile are complete when it is loaded
+  // alone. The copy is borrowed, its overlaps with other tiles are missing.
+  ElementAdders adders;
+  AddElementAdders(map.lane(), &Map::add_lane, &adders);
+  AddElementAdders(map.junction(), &Map::add_junction, &adders);
+  AddElementAdders(map.signal(), &Map::add_signal, &adders);
+  AddElementAdders(map.crosswalk(), &Map::add_crosswalk, &adders);
+  AddElementAdders(map.stop_sign(), &Map::add_stop_sign, &adders);
+  AddElementAdders(map.yield(), &Map::add_yield, &adders);
+  AddElementAdders(map.clear_area(), &Map::add_clear_area, &adders);
+  AddElementAdders(map.speed_bump(), &Map::add_speed_bump, &adders);
+  AddElementAdders(map.parking_space(), &Map::add_parking_space, &adders);
+  std::map<TileCoord, std::vector<std::string>> borrowed_ids;
+  for (auto& tile : tiles) {
+    for (const auto& overlap : tile.second.overlap()) {
+      for (const auto& object : overlap.object()) {
+        const std::string& id = object.id().id();
+        const auto adder_iter = adders.find(id);
+        if (adder_iter == adders.end() ||
+            !element_tiles[id].insert(tile.first).second) {
+          continue;
+        }
+        adder_iter->second(&tile.second);
+        borrowed_ids[tile.first].push_back(id);
+      }
+    }
+  }
+
+  // Roads go with their lanes, and list the lanes in each tile only.
+  for (const auto& road : map.road()) {
+    std::set<TileCoord> road_tiles;
+    for (const auto& section : road.section()) {
+      for (const auto& lane_id : section.lane_id()) {
+        const auto iter = element_tiles.find(lane_id.id());
+        if (iter != element_tiles.end()) {
+          road_tiles.insert(iter->second.begin(), iter->second.end());
+        }
+      }
+    }
+    for (const auto& coord : road_tiles) {
+      *tiles[coord].add_road() = road;
+    }
+  }
+  for (auto& tile : tiles) {
+    FilterRoadLanes(&tile.second);
+  }
+
+  if (!apollo::common::util::EnsureDirectory(tile_dir)) {
+    AERROR << "Failed to create tile directory " << tile_dir;
+    return false;
+  }
+  MapTileIndex tile_index;
+  tile_index.mutable_header()->CopyFrom(map.header());
+  tile_index.set_tile_length(tile_length);
+  for (auto& tile : tiles) {
+    auto* map_tile = tile_index.add_tile();
+    map_tile->set_x(tile.first.first);
+    map_tile->set_y(tile.first.second);
+    map_tile->set_filename(
+        StrCat("tile_", tile.first.first, "_", tile.first.second, ".bin"));
+    for (const auto& id : borrowed_ids[tile.first]) {
+      map_tile->add_borrowed_id(id);
+    }
+    tile.second.mutable_header()->CopyFrom(map.header());
+    if (!apollo::common::util::SetProtoToBinaryFile(
+            tile.second, StrCat(tile_dir, "/", map_tile->filename()))) {
+      AERROR << "Failed to write tile " << map_tile->filename();
+      return false;
+    }
+  }
+  AINFO << "Split map into " << tiles.size() << " tiles in " << tile_dir;
+  return apollo::common::util::SetProtoToBinaryFile(
+      tile_index, StrCat(tile_dir, "/", kTileIndexFilename));
+}
+
+bool TiledHDMap::Init(const std::string& tile_dir,
+                      const TiledHDMapParams& params) {
+  tile_dir_ = tile_dir;
+  params_ = params;
+  const std::string index_file = StrCat(tile_dir, "/", kTileIndexFilename);
+  if (!apollo::common::util::GetProtoFromFile(index_file, &tile_index_) ||
+      tile_index_.tile_length() <= 0.0) {
+    AERROR << "Failed to load map tile index " << index_file;
+    return false;
+  }
+  index_tiles_.clear();
+  for (const auto& tile : tile_index_.tile()) {
+    index_tiles_[MakeTileKey(tile.x(), tile.y())] = &tile;
+  }
+  return true;
+}
+
+bool TiledHDMap::UpdatePosition(const PointENU& position) {
+  const std::vector<TileKey> tiles =
+      TilesInRange(position.x(), position.y(), params_.active_radius);
+  bool has_map = false;
+  {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    if (map_ != nullptr && tiles == requested_tile_list_) {
+      return true;
+    }
+    requested_tile_list_ = tiles;
+    has_map = map_ != nullptr;
+  }
+  if (!has_map) {
+    return BuildActiveMap();
+  }
+  build_pool_->enqueue([this]() { BuildActiveMap(); });
+  return true;
+}
+
+void TiledHDMap::WaitForMap() { build_pool_->enqueue([]() {}).wait(); }
+
+void TiledHDMap::Prefetch(const std::vector<PointENU>& route_points) {
+  std::set<TileKey> keys;
+  for (const auto& point : route_points) {
+    const auto tiles =
+        TilesInRange(point.x(), point.y(), params_.active_radius);
+    keys.insert(tiles.begin(), tiles.end());
+  }
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  for (const TileKey key : keys) {
+    if (cache_.count(key) == 0) {
+      prefetch_pool_->enqueue([this, key]() { LoadTile(key); });
+    }
+  }
+}
+
+std::shared_ptr<const HDMap> TiledHDMap::map() const {
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  return map_;
+}
+
+int TiledHDMap::num_cached_tiles() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return static_cast<int>(cache_.size());
+}
+
+int64_t TiledHDMap::cached_bytes() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cached_bytes_;
+}
+
+int64_t TiledHDMap::map_bytes() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return map_bytes_;
+}
+
+TiledHDMap::TileKey TiledHDMap::MakeTileKey(const int x, const int y) {
+  return (static_cast<int64_t>(x) << 32) |
+         static_cast<int64_t>(static_cast<uint32_t>(y));
+}
+
+std::vector<TiledHDMap::TileKey> TiledHDMap::TilesInRange(
+    const double x, const double y, const double radius) const {
+  const double tile_length = tile_index_.tile_length();
+  const int min_x = static_cast<int>(std::floor((x - radius) / tile_length));
+  const int max_x = static_cast<int>(std::floor((x + radius) / tile_length));
+  const int min_y = static_cast<int>(std::floor((y - radius) / tile_length));
+  const int max_y = static_cast<int>(std::floor((y + radius) / tile_length));
+  std::vector<TileKey> tiles;
+  for (int tile_x = min_x; tile_x <= max_x; ++tile_x) {
+    for (int tile_y = min_y; tile_y <= max_y; ++tile_y) {
+      const TileKey key = MakeTileKey(tile_x, tile_y);
+      if (index_tiles_.count(key) == 0) {
+        continue;
+      }
+      const AABox2d tile_box({tile_x * tile_length, tile_y * tile_length},
+                             {(tile_x + 1) * tile_length,
+                              (tile_y + 1) * tile_length});
+      if (tile_box.DistanceTo(Vec2d(x, y)) <= radius) {
+        tiles.push_back(key);
+      }
+    }
+  }
+  std::sort(tiles.begin(), tiles.end());
+  return tiles;
+}
+
+std::shared_ptr<const TiledHDMap::Tile> TiledHDMap::LoadTile(
+    const TileKey key) {
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) {
+      lru_.splice(lru_.begin(), lru_, iter->second.lru_iter);
+      return iter->second.tile;
+    }
+  }
+  const auto index_iter = index_tiles_.find(key);
+  if (index_iter == index_tiles_.end()) {
+    return nullptr;
+  }
+  // Load the tile without holding the lock, so map queries and other tiles
+  // are not blocked by the file access and the map building.
+  const MapTile& map_tile = *index_iter->second;
+  std::unique_ptr<HDMap> hdmap(new HDMap());
+  const std::string tile_file = StrCat(tile_dir_, "/", map_tile.filename());
+  if (hdmap->LoadMapFromFile(tile_file) != 0) {
+    AERROR << "Failed to load map tile " << tile_file;
+    return nullptr;
+  }
+  std::shared_ptr<Tile> tile(new Tile());
+  tile->map = std::move(hdmap);
+  tile->borrowed_ids.insert(map_tile.borrowed_id().begin(),
+                            map_tile.borrowed_id().end());
+
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto iter = cache_.find(key);
+  if (iter != cache_.end()) {
+    // Loaded by another thread meanwhile.
+    lru_.splice(lru_.begin(), lru_, iter->second.lru_iter);
+    return iter->second.tile;
+  }
+  lru_.push_front(key);
+  auto& cached_tile = cache_[key];
+  cached_tile.tile = tile;
+  cached_tile.bytes = tile->map->SpaceUsed();
+  cached_tile.lru_iter = lru_.begin();
+  cached_bytes_ += cached_tile.bytes;
+  EvictTiles();
+  return tile;
+}
+
+// Builds the active map for the tiles of the last position, unless it is
+// built already. A builder which finds a newer position than the one it was
+// queued for builds the newer one, and the builders queued after it have
+// nothing left to do.
+bool TiledHDMap::BuildActiveMap() {
+  std::vector<TileKey> tiles;
+  std::vector<TileKey> active_tiles;
+  {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    if (map_ != nullptr && requested_tile_list_ == active_tile_list_) {
+      return true;
+    }
+    tiles = requested_tile_list_;
+    active_tiles = active_tile_list_;
+  }
+
+  // Pin the new tiles in addition to the current ones, so loading a tile
+  // does not evict another tile needed by the new map.
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    active_tiles_.insert(tiles.begin(), tiles.end());
+  }
+  // The tiles of the current map go first, so the elements they share with
+  // the new map are taken from the same tiles, and stay the same objects.
+  std::vector<TileKey> load_order = tiles;
+  std::stable_partition(load_order.begin(), load_order.end(),
+                        [&active_tiles](const TileKey key) {
+                          return std::binary_search(active_tiles.begin(),
+                                                    active_tiles.end(), key);
+                        });
+  std::vector<std::shared_ptr<const HDMap>> tile_maps;
+  std::vector<std::unordered_set<std::string>> borrowed_ids;
+  for (const TileKey key : load_order) {
+    auto tile = LoadTile(key);
+    if (tile == nullptr) {
+      break;
+    }
+    tile_maps.push_back(tile->map);
+    borrowed_ids.push_back(tile->borrowed_ids);
+  }
+  int64_t bytes = 0;
+  std::shared_ptr<HDMap> hdmap;
+  if (tile_maps.size() == tiles.size()) {
+    hdmap.reset(new HDMap());
+    if (hdmap->LoadMapFromTiles(tile_maps, borrowed_ids) == 0) {
+      // The tiles are counted in the cache, the map shares their elements.
+      bytes = hdmap->SpaceUsed();
+    } else {
+      AERROR << "Failed to build map from " << tiles.size() << " tiles.";
+      hdmap.reset();
+    }
+  }
+  if (hdmap == nullptr) {
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      active_tiles_.clear();
+      active_tiles_.insert(active_tiles.begin(), active_tiles.end());
+    }
+    // Retry on the next update at the same position.
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    if (requested_tile_list_ == tiles) {
+      requested_tile_list_ = active_tile_list_;
+    }
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    map_ = hdmap;
+    active_tile_list_ = tiles;
+  }
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    active_tiles_.clear();
+    active_tiles_.insert(tiles.begin(), tiles.end());
+    map_bytes_ = bytes;
+    EvictTiles();
+  }
+  ADEBUG << "Active map rebuilt from " << tiles.size() << " tiles.";
+  return true;
+}
+
+// cache_mutex_ must be held.
+void TiledHDMap::EvictTiles() {
+  auto iter = lru_.end();
+  while (cached_bytes_ + map_bytes_ > params_.max_cache_bytes &&
+         iter != lru_.begin()) {
+    --iter;
+    if (active_tiles_.count(*iter) > 0) {
+      continue;
+    }
+    const auto cache_iter = cache_.find(*iter);
+    cached_bytes_ -= cache_iter->second.bytes;
+    cache_.erase(cache_iter);
+    iter = lru_.erase(iter);
+  }
+}
+
+}  // namespace hdmap
+}  // namespace apollo
@@ -0,0 +1,185 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#ifndef MODULES_MAP_HDMAP_TILED_HDMAP_H_
+#define MODULES_MAP_HDMAP_TILED_HDMAP_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "modules/common/proto/geometry.pb.h"
+#include "modules/common/util/threadpool.h"
+#include "modules/map/hdmap/hdmap.h"
+#include "modules/map/proto/map.pb.h"
+#include "modules/map/proto/map_tile.pb.h"
+
+/**
+ * @namespace apollo::hdmap
+ * @brief apollo::hdmap
+ */
+namespace apollo {
+namespace hdmap {
+
+/**
+ * @class TiledHDMapParams
+ * @brief Parameters of the tiled map.
+ */
+struct TiledHDMapParams {
+  /// Tiles within this distance to the ego position are in the active map.
+  double active_radius = 500.0;
+  /// Memory budget of the active map and the tiles kept in cache, in bytes,
+  /// as estimated by HDMap::SpaceUsed(). Tiles of the active map are never
+  /// evicted, even if they exceed the budget.
+  int64_t max_cache_bytes = 512LL * 1024 * 1024;
+};
+
+/**
+ * @class TiledHDMap
+ *
+ * @brief A map backend for very large maps which are split into square
+ *        tiles. Each tile is loaded as a map of its own, and the tiles
+ *        around the ego position are combined into the active map, which is
+ *        a regular HDMap supporting every query. Combining tiles shares
+ *        their elements and kdtrees, so a tile is only built once while it
+ *        stays in cache. Tiles are loaded on demand, prefetched along a
+ *        route in the background, and evicted in least recently used order
+ *        beyond the memory budget.
+ */
+class TiledHDMap {
+ public:
+  TiledHDMap();
+  ~TiledHDMap();
+
+  /**
+   * @brief split a map into tiles. Each tile is a map which can be loaded
+   *        on its own: elements related by an overlap to an element of the
+   *        tile are copied into it, and roads only list the lanes in it.
+   * @param map the map to split
+   * @param tile_length side length of tiles in meters
+   * @param tile_dir output directory of the tiles and the tile index
+   * @return true on success
+   */
+  static bool GenerateTiles(const Map& map, const double tile_length,
+                            const std::string& tile_dir);
+
+  /**
+   * @brief initialize from a tile directory generated by GenerateTiles
+   * @param tile_dir the tile directory
+   * @param params parameters of the tiled map
+   * @return true on success
+   */
+  bool Init(const std::string& tile_dir, const TiledHDMapParams& params);
+
+  /**
+   * @brief load the tiles around the ego position into the active map and
+   *        evict far tiles. The active map is only rebuilt when the set of
+   *        tiles around the position changes. The first active map is built
+   *        on the calling thread; later ones are built in the background and
+   *        swapped in when they are ready, and map() returns the previous
+   *        one meanwhile.
+   * @param position the ego position
+   * @return true if the active map is built or being built for the position
+   */
+  bool UpdatePosition(const apollo::common::PointENU& position);
+
+  /**
+   * @brief wait until the active map for the last position given to
+   *        UpdatePosition has been built in the background.
+   */
+  void WaitForMap();
+
+  /**
+   * @brief read the tiles along a route into cache in the background, so
+   *        they are ready when the ego vehicle gets there.
+   * @param route_points points along the route
+   */
+  void Prefetch(const std::vector<apollo::common::PointENU>& route_points);
+
+  /**
+   * @brief get the active map. The returned snapshot stays valid while it
+   *        is held, even if the active map is rebuilt meanwhile.
+   * @return the active map, nullptr before the first UpdatePosition
+   */
+  std::shared_ptr<const HDMap> map() const;
+
+  /**
+   * @brief get the tile index read by Init.
+   * @return the tile index
+   */
+  const MapTileIndex& tile_index() const { return tile_index_; }
+
+  int num_cached_tiles() const;
+  int64_t cached_bytes() const;
+  int64_t map_bytes() const;
+
+ private:
+  using TileKey = int64_t;
+
+  struct Tile {
+    std::shared_ptr<const HDMap> map;
+    // Ids of the elements the tile holds for the overlaps of its own ones.
+    std::unordered_set<std::string> borrowed_ids;
+  };
+
+  struct CachedTile {
+    std::shared_ptr<const Tile> tile;
+    int64_t bytes = 0;
+    std::list<TileKey>::iterator lru_iter;
+  };
+
+  static TileKey MakeTileKey(const int x, const int y);
+
+  std::vector<TileKey> TilesInRange(const double x, const double y,
+                                    const double radius) const;
+  std::shared_ptr<const Tile> LoadTile(const TileKey key);
+  bool BuildActiveMap();
+  void EvictTiles();
+
+ private:
+  std::string tile_dir_;
+  TiledHDMapParams params_;
+  MapTileIndex tile_index_;
+  // Tiles of tile_index_ by their keys.
+  std::unordered_map<TileKey, const MapTile*> index_tiles_;
+
+  // Loaded tiles, the most recently used first in lru_.
+  mutable std::mutex cache_mutex_;
+  std::unordered_map<TileKey, CachedTile> cache_;
+  std::list<TileKey> lru_;
+  int64_t cached_bytes_ = 0;
+  int64_t map_bytes_ = 0;
+  std::unordered_set<TileKey> active_tiles_;
+
+  // The active map, the tiles it is built from, and the tiles of the last
+  // position, which differ while a new active map is being built.
+  mutable std::mutex map_mutex_;
+  std::shared_ptr<const HDMap> map_;
+  std::vector<TileKey> active_tile_list_;
+  std::vector<TileKey> requested_tile_list_;
+
+  std::unique_ptr<apollo::common::util::ThreadPool> prefetch_pool_;
+  std::unique_ptr<apollo::common::util::ThreadPool> build_pool_;
+};
+
+}  // namespace hdmap
+}  // namespace apollo
+
+#endif  // MODULES_MAP_HDMAP_TILED_HDMAP_H_
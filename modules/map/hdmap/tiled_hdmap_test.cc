@@ -0,0 +1,191 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#include "modules/map/hdmap/tiled_hdmap.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/common/util/file.h"
+
+namespace {
+
+constexpr char kMapFilename[] = "modules/map/hdmap/test-data/base_map.bin";
+constexpr char kTileDir[] = "/tmp/tiled_hdmap_test";
+
+}  // namespace
+
+namespace apollo {
+namespace hdmap {
+
+class TiledHDMapTestSuite : public ::testing::Test {
+ public:
+  TiledHDMapTestSuite() {
+    EXPECT_EQ(0, hdmap_.LoadMapFromFile(kMapFilename));
+    Map map;
+    EXPECT_TRUE(apollo::common::util::GetProtoFromFile(kMapFilename, &map));
+    EXPECT_TRUE(TiledHDMap::GenerateTiles(map, 50.0, kTileDir));
+  }
+
+  apollo::common::PointENU MakePoint(const double x, const double y) {
+    apollo::common::PointENU point;
+    point.set_x(x);
+    point.set_y(y);
+    point.set_z(0.0);
+    return point;
+  }
+
+  // Expects the same lanes, in the same roads, as the full map.
+  void ExpectSameLanes(const HDMap& map, const apollo::common::PointENU& point,
+                       const double distance) {
+    std::vector<LaneInfoConstPtr> expected_lanes;
+    std::vector<LaneInfoConstPtr> actual_lanes;
+    EXPECT_EQ(0, hdmap_.GetLanes(point, distance, &expected_lanes));
+    EXPECT_EQ(0, map.GetLanes(point, distance, &actual_lanes));
+    std::set<std::string> expected_ids;
+    std::set<std::string> actual_ids;
+    for (const auto& lane : expected_lanes) {
+      expected_ids.insert(lane->id().id() + "@" + lane->road_id().id());
+    }
+    for (const auto& lane : actual_lanes) {
+      actual_ids.insert(lane->id().id() + "@" + lane->road_id().id());
+    }
+    EXPECT_EQ(expected_ids, actual_ids);
+  }
+
+ public:
+  HDMap hdmap_;
+};
+
+TEST_F(TiledHDMapTestSuite, QueriesMatchFullMap) {
+  TiledHDMap tiled_hdmap;
+  TiledHDMapParams params;
+  params.active_radius = 100.0;
+  EXPECT_TRUE(tiled_hdmap.Init(kTileDir, params));
+  EXPECT_TRUE(tiled_hdmap.map() == nullptr);
+
+  const auto point = MakePoint(586424.09, 4140727.02);
+  EXPECT_TRUE(tiled_hdmap.UpdatePosition(point));
+  const auto map = tiled_hdmap.map();
+  ASSERT_TRUE(map != nullptr);
+
+  LaneInfoConstPtr lane;
+  double s = 0.0;
+  double l = 0.0;
+  EXPECT_EQ(0, map->GetNearestLaneWithHeading(point, 5, -2.35, 1.0, &lane, &s,
+                                              &l));
+  EXPECT_EQ("773_1_-2", lane->id().id());
+  EXPECT_NEAR(s, 25.891, 1e-3);
+  EXPECT_NEAR(l, -3.257, 1e-3);
+
+  for (const double distance : {1.0, 5.0, 20.0, 50.0}) {
+    ExpectSameLanes(*map, point, distance);
+  }
+
+  // The active map is not rebuilt while the ego vehicle stays in its tiles.
+  EXPECT_TRUE(tiled_hdmap.UpdatePosition(MakePoint(586424.5, 4140727.5)));
+  EXPECT_EQ(map, tiled_hdmap.map());
+}
+
+TEST_F(TiledHDMapTestSuite, SwapSharesKeptTiles) {
+  TiledHDMap tiled_hdmap;
+  TiledHDMapParams params;
+  params.active_radius = 30.0;
+  EXPECT_TRUE(tiled_hdmap.Init(kTileDir, params));
+
+  const auto old_point = MakePoint(586424.09, 4140727.02);
+  EXPECT_TRUE(tiled_hdmap.UpdatePosition(old_point));
+  const auto old_map = tiled_hdmap.map();
+  ASSERT_TRUE(old_map != nullptr);
+  const int num_old_tiles = tiled_hdmap.num_cached_tiles();
+
+  // Moving by one tile keeps two of the tiles, and loads the others.
+  const auto new_point = MakePoint(586424.09, 4140777.02);
+  EXPECT_TRUE(tiled_hdmap.UpdatePosition(new_point));
+  tiled_hdmap.WaitForMap();
+  const auto new_map = tiled_hdmap.map();
+  ASSERT_TRUE(new_map != nullptr);
+  EXPECT_NE(old_map, new_map);
+  EXPECT_GT(tiled_hdmap.num_cached_tiles(), num_old_tiles);
+
+  for (const double distance : {1.0, 5.0, 20.0}) {
+    ExpectSameLanes(*new_map, new_point, distance);
+  }
+  LaneInfoConstPtr expected_lane;
+  LaneInfoConstPtr actual_lane;
+  double expected_s = 0.0;
+  double expected_l = 0.0;
+  double actual_s = 0.0;
+  double actual_l = 0.0;
+  EXPECT_EQ(0, hdmap_.GetNearestLane(new_point, &expected_lane, &expected_s,
+                                     &expected_l));
+  EXPECT_EQ(0, new_map->GetNearestLane(new_point, &actual_lane, &actual_s,
+                                       &actual_l));
+  EXPECT_EQ(expected_lane->id().id(), actual_lane->id().id());
+  EXPECT_NEAR(expected_s, actual_s, 1e-6);
+  EXPECT_NEAR(expected_l, actual_l, 1e-6);
+
+  // The lanes of the kept tiles are shared by both maps, not built again.
+  const auto lane_id = expected_lane->id();
+  ASSERT_TRUE(old_map->GetLaneById(lane_id) != nullptr);
+  EXPECT_EQ(old_map->GetLaneById(lane_id), new_map->GetLaneById(lane_id));
+
+  // The old snapshot stays valid after the swap.
+  ExpectSameLanes(*old_map, old_point, 5.0);
+}
+
+TEST_F(TiledHDMapTestSuite, EvictFarTiles) {
+  TiledHDMap tiled_hdmap;
+  TiledHDMapParams params;
+  params.active_radius = 10.0;
+  params.max_cache_bytes = 1;
+  EXPECT_TRUE(tiled_hdmap.Init(kTileDir, params));
+
+  EXPECT_TRUE(tiled_hdmap.UpdatePosition(MakePoint(586424.09, 4140727.02)));
+  const int num_active_tiles = tiled_hdmap.num_cached_tiles();
+  EXPECT_GT(num_active_tiles, 0);
+  const auto old_map = tiled_hdmap.map();
+
+  EXPECT_GT(tiled_hdmap.map_bytes(), 0);
+
+  // The new map is built in the background, and the old one stays active
+  // until then.
+  EXPECT_TRUE(tiled_hdmap.UpdatePosition(MakePoint(586524.09, 4140827.02)));
+  tiled_hdmap.WaitForMap();
+  EXPECT_NE(old_map, tiled_hdmap.map());
+  // Only the tiles of the active map are kept beyond the budget, while the
+  // old snapshot stays valid.
+  EXPECT_LE(tiled_hdmap.num_cached_tiles(), 4);
+  std::vector<LaneInfoConstPtr> lanes;
+  EXPECT_EQ(0, old_map->GetLanes(MakePoint(586424.09, 4140727.02), 5, &lanes));
+  EXPECT_EQ(1, lanes.size());
+}
+
+TEST_F(TiledHDMapTestSuite, Prefetch) {
+  TiledHDMapParams params;
+  params.active_radius = 10.0;
+  TiledHDMap tiled_hdmap;
+  EXPECT_TRUE(tiled_hdmap.Init(kTileDir, params));
+  tiled_hdmap.Prefetch({MakePoint(586424.09, 4140727.02),
+                        MakePoint(586524.09, 4140827.02)});
+  EXPECT_TRUE(tiled_hdmap.UpdatePosition(MakePoint(586424.09, 4140727.02)));
+  EXPECT_GT(tiled_hdmap.num_cached_tiles(), 0);
+  EXPECT_GT(tiled_hdmap.cached_bytes(), 0);
+}
+
+}  // namespace hdmap
+}  // namespace apollo
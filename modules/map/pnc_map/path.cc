@@ -21,6 +21,8 @@
 #include <limits>
 #include <unordered_map>
 
+#include "modules/common/math/aabox2d.h"
+#include "modules/common/math/aaboxkdtree2d.h"
 #include "modules/common/math/line_segment2d.h"
 #include "modules/common/math/math_utils.h"
 #include "modules/common/math/polygon2d.h"
@@ -33,6 +35,9 @@ DEFINE_double(default_lane_width, 3.048, "default lane width is about 10 feet");
 namespace apollo {
 namespace hdmap {
 
+using common::math::AABox2d;
+using common::math::AABoxKDTree2d;
+using common::math::AABoxKDTreeParams;
 using common::math::Box2d;
 using common::math::kMathEpsilon;
 using common::math::LineSegment2d;
@@ -45,6 +50,52 @@ namespace {
 
 const double kSampleDistance = 0.25;
 
+// Paths with fewer segments are searched linearly.
+const int kMinNumSegmentsForIndex = 32;
+
+// Finds the forward neighbor lane of a waypoint which the waypoint projects
+// onto. Like a lookup of the neighbor ids of the lane in the map, no neighbor
+// is found once a neighbor id before the found one is missing from the map.
+LaneWaypoint NeighborWaypoint(const HDMap& hdmap, const LaneWaypoint& waypoint,
+                              const LaneRelation relation) {
+  LaneWaypoint neighbor;
+  if (!waypoint.lane) {
+    return neighbor;
+  }
+  auto point = waypoint.lane->GetSmoothPoint(waypoint.s);
+  const auto& topology = hdmap.lane_topology();
+  const int index = topology.GetLaneIndex(*waypoint.lane);
+  if (index == LaneTopology::kInvalidLaneIndex) {
+    return neighbor;
+  }
+  const auto& neighbor_ids =
+      relation == LANE_LEFT_FORWARD_NEIGHBOR
+          ? topology.lane(index)->lane().left_neighbor_forward_lane_id()
+          : topology.lane(index)->lane().right_neighbor_forward_lane_id();
+  // The topology keeps the neighbors in the order of their ids and drops the
+  // ids which are not in the map.
+  const auto neighbor_indices = topology.GetRelatedLanes(relation, index);
+  int i = 0;
+  for (const auto& lane_id : neighbor_ids) {
+    if (i == neighbor_indices.size() ||
+        topology.lane(neighbor_indices[i])->id().id() != lane_id.id()) {
+      return neighbor;
+    }
+    const auto& lane = topology.lane(neighbor_indices[i++]);
+    double s = 0.0;
+    double l = 0.0;
+    if (!lane->GetProjection({point.x(), point.y()}, &s, &l)) {
+      continue;
+    }
+    if (s < -kSampleDistance || s > lane->total_length() + kSampleDistance) {
+      continue;
+    } else {
+      return LaneWaypoint(lane, s);
+    }
+  }
+  return neighbor;
+}
+
 bool FindLaneSegment(const MapPathPoint& p1, const MapPathPoint& p2,
                      LaneSegment* const lane_segment) {
   for (const auto& wp1 : p1.lane_waypoints()) {
@@ -101,32 +152,9 @@ LaneBoundaryType::Type RightBoundaryType(const LaneWaypoint& waypoint) {
   return LaneBoundaryType::UNKNOWN;
 }
 
-LaneWaypoint LeftNeighborWaypoint(const LaneWaypoint& waypoint) {
-  LaneWaypoint neighbor;
-  if (!waypoint.lane) {
-    return neighbor;
-  }
-  auto point = waypoint.lane->GetSmoothPoint(waypoint.s);
-  auto map_ptr = HDMapUtil::BaseMapPtr();
-  for (const auto& lane_id :
-       waypoint.lane->lane().left_neighbor_forward_lane_id()) {
-    auto lane = map_ptr->GetLaneById(lane_id);
-    if (!lane) {
-      return neighbor;
-    }
-    double s = 0.0;
-    double l = 0.0;
-    if (!lane->GetProjection({point.x(), point.y()}, &s, &l)) {
-      continue;
-    }
-
-    if (s < -kSampleDistance || s > lane->total_length() + kSampleDistance) {
-      continue;
-    } else {
-      return LaneWaypoint(lane, s);
-    }
-  }
-  return neighbor;
+LaneWaypoint LeftNeighborWaypoint(const HDMap& hdmap,
+                                  const LaneWaypoint& waypoint) {
+  return NeighborWaypoint(hdmap, waypoint, LANE_LEFT_FORWARD_NEIGHBOR);
 }
 
 void LaneSegment::Join(std::vector<LaneSegment>* segments) {
@@ -156,31 +184,9 @@ void LaneSegment::Join(std::vector<LaneSegment>* segments) {
   segments->shrink_to_fit();  // release memory
 }
 
-LaneWaypoint RightNeighborWaypoint(const LaneWaypoint& waypoint) {
-  LaneWaypoint neighbor;
-  if (!waypoint.lane) {
-    return neighbor;
-  }
-  auto point = waypoint.lane->GetSmoothPoint(waypoint.s);
-  auto map_ptr = HDMapUtil::BaseMapPtr();
-  for (const auto& lane_id :
-       waypoint.lane->lane().right_neighbor_forward_lane_id()) {
-    auto lane = map_ptr->GetLaneById(lane_id);
-    if (!lane) {
-      return neighbor;
-    }
-    double s = 0.0;
-    double l = 0.0;
-    if (!lane->GetProjection({point.x(), point.y()}, &s, &l)) {
-      continue;
-    }
-    if (s < -kSampleDistance || s > lane->total_length() + kSampleDistance) {
-      continue;
-    } else {
-      return LaneWaypoint(lane, s);
-    }
-  }
-  return neighbor;
+LaneWaypoint RightNeighborWaypoint(const HDMap& hdmap,
+                                   const LaneWaypoint& waypoint) {
+  return NeighborWaypoint(hdmap, waypoint, LANE_RIGHT_FORWARD_NEIGHBOR);
 }
 
 std::string LaneSegment::DebugString() const {
@@ -222,6 +228,82 @@ std::string PathOverlap::DebugString() const {
   return common::util::StrCat(object_id, " ", start_s, " ", end_s);
 }
 
+/**
+ * @class PathSegmentIndex
+ * @brief The segments of a path in a KD-tree. The segments are copied, so
+ * that the index can be shared by the copies of the path.
+ */
+class PathSegmentIndex {
+ public:
+  // Slack of the searches around a nearest segment.
+  static constexpr double kSearchBuffer = 1e-6;  // meters.
+
+  explicit PathSegmentIndex(const std::vector<LineSegment2d>& segments) {
+    boxes_.reserve(segments.size());
+    for (size_t id = 0; id < segments.size(); ++id) {
+      boxes_.emplace_back(segments[id], static_cast<int>(id));
+    }
+    AABoxKDTreeParams params;
+    params.max_leaf_dimension = 5.0;  // meters.
+    params.max_leaf_size = 16;
+    kdtree_.reset(new AABoxKDTree2d<SegmentBox>(boxes_, params));
+  }
+
+  int GetNearestSegment(const Vec2d& point,
+                        double* const min_distance_sqr) const {
+    // The KD-tree returns a nearest segment up to kMathEpsilon, and in no
+    // particular order, so search again around it for the first segment at
+    // the minimum distance.
+    const auto* nearest = kdtree_->GetNearestObject(point);
+    const double distance = nearest->DistanceTo(point) + kSearchBuffer;
+    int min_id = nearest->id();
+    *min_distance_sqr = nearest->DistanceSquareTo(point);
+    for (const auto* box : kdtree_->GetObjects(point, distance)) {
+      const double distance_sqr = box->DistanceSquareTo(point);
+      if (distance_sqr < *min_distance_sqr ||
+          (distance_sqr == *min_distance_sqr && box->id() < min_id)) {
+        min_id = box->id();
+        *min_distance_sqr = distance_sqr;
+      }
+    }
+    return min_id;
+  }
+
+  std::vector<int> GetSegments(const Vec2d& point,
+                               const double distance) const {
+    std::vector<int> ids;
+    for (const auto* box : kdtree_->GetObjects(point, distance)) {
+      ids.push_back(box->id());
+    }
+    return ids;
+  }
+
+ private:
+  class SegmentBox {
+   public:
+    SegmentBox(const LineSegment2d& segment, const int id)
+        : aabox_(segment.start(), segment.end()), segment_(segment), id_(id) {}
+    const AABox2d& aabox() const { return aabox_; }
+    double DistanceTo(const Vec2d& point) const {
+      return segment_.DistanceTo(point);
+    }
+    double DistanceSquareTo(const Vec2d& point) const {
+      return segment_.DistanceSquareTo(point);
+    }
+    int id() const { return id_; }
+
+   private:
+    AABox2d aabox_;
+    LineSegment2d segment_;
+    int id_ = 0;
+  };
+
+  std::vector<SegmentBox> boxes_;
+  std::unique_ptr<AABoxKDTree2d<SegmentBox>> kdtree_;
+};
+
+constexpr double PathSegmentIndex::kSearchBuffer;
+
 Path::Path(const std::vector<MapPathPoint>& path_points)
     : path_points_(path_points) {
   Init();
@@ -717,15 +799,7 @@ bool Path::GetProjection(const Vec2d& point, double* accumulate_s,
                                         min_distance);
   }
   CHECK_GE(num_points_, 2);
-  *min_distance = std::numeric_limits<double>::infinity();
-  int min_index = 0;
-  for (int i = 0; i < num_segments_; ++i) {
-    const double distance = segments_[i].DistanceSquareTo(point);
-    if (distance < *min_distance) {
-      min_index = i;
-      *min_distance = distance;
-    }
-  }
+  const int min_index = GetNearestSegmentIndex(point, min_distance);
   *min_distance = std::sqrt(*min_distance);
   const auto& nearest_seg = segments_[min_index];
   const auto prod = nearest_seg.ProductOntoUnit(point);
@@ -752,6 +826,82 @@ bool Path::GetProjection(const Vec2d& point, double* accumulate_s,
   return true;
 }
 
+std::shared_ptr<const PathSegmentIndex> Path::GetSegmentIndex() const {
+  if (num_segments_ < kMinNumSegmentsForIndex) {
+    return nullptr;
+  }
+  // Paths are queried from several threads, each of them may build the
+  // index once.
+  auto segment_index = std::atomic_load(&segment_index_);
+  if (segment_index == nullptr) {
+    segment_index = std::make_shared<const PathSegmentIndex>(segments_);
+    std::atomic_store(&segment_index_, segment_index);
+  }
+  return segment_index;
+}
+
+int Path::GetNearestSegmentIndex(const Vec2d& point,
+                                 double* min_distance_sqr) const {
+  const auto segment_index = GetSegmentIndex();
+  if (segment_index != nullptr) {
+    return segment_index->GetNearestSegment(point, min_distance_sqr);
+  }
+  *min_distance_sqr = std::numeric_limits<double>::infinity();
+  int min_index = 0;
+  for (int i = 0; i < num_segments_; ++i) {
+    const double distance_sqr = segments_[i].DistanceSquareTo(point);
+    if (distance_sqr < *min_distance_sqr) {
+      min_index = i;
+      *min_distance_sqr = distance_sqr;
+    }
+  }
+  return min_index;
+}
+
+int Path::GetNearestPointIndex(const Vec2d& point) const {
+  CHECK_GE(num_points_, 2);
+  const auto segment_index = GetSegmentIndex();
+  if (segment_index == nullptr) {
+    int min_index = 0;
+    double min_distance_sqr = point.DistanceSquareTo(path_points_[0]);
+    for (int i = 1; i < num_points_; ++i) {
+      const double distance_sqr = point.DistanceSquareTo(path_points_[i]);
+      if (distance_sqr < min_distance_sqr) {
+        min_index = i;
+        min_distance_sqr = distance_sqr;
+      }
+    }
+    return min_index;
+  }
+
+  // The nearest point is an end of a segment not farther than the nearer
+  // end of the nearest segment.
+  double segment_distance_sqr = 0.0;
+  const int segment_id =
+      segment_index->GetNearestSegment(point, &segment_distance_sqr);
+  int min_index = segment_id;
+  double min_distance_sqr = point.DistanceSquareTo(path_points_[segment_id]);
+  const double end_distance_sqr =
+      point.DistanceSquareTo(path_points_[segment_id + 1]);
+  if (end_distance_sqr < min_distance_sqr) {
+    min_index = segment_id + 1;
+    min_distance_sqr = end_distance_sqr;
+  }
+  const double distance =
+      std::sqrt(min_distance_sqr) + PathSegmentIndex::kSearchBuffer;
+  for (const int id : segment_index->GetSegments(point, distance)) {
+    for (const int i : {id, id + 1}) {
+      const double distance_sqr = point.DistanceSquareTo(path_points_[i]);
+      if (distance_sqr < min_distance_sqr ||
+          (distance_sqr == min_distance_sqr && i < min_index)) {
+        min_index = i;
+        min_distance_sqr = distance_sqr;
+      }
+    }
+  }
+  return min_index;
+}
+
 bool Path::GetHeadingAlongPath(const Vec2d& point, double* heading) const {
   if (heading == nullptr) {
     return false;
@@ -65,16 +65,18 @@ LaneBoundaryType::Type LeftBoundaryType(const LaneWaypoint& waypoint);
 LaneBoundaryType::Type RightBoundaryType(const LaneWaypoint& waypoint);
 
 /**
- * @brief get left neighbor lane waypoint. If not exist, the Waypoint.lane will
- * be null.
+ * @brief get left neighbor lane waypoint in hdmap, the map which the lane of
+ * the waypoint is from. If not exist, the Waypoint.lane will be null.
  */
-LaneWaypoint LeftNeighborWaypoint(const LaneWaypoint& waypoint);
+LaneWaypoint LeftNeighborWaypoint(const HDMap& hdmap,
+                                  const LaneWaypoint& waypoint);
 
 /**
- * @brief get left neighbor lane waypoint. If not exist, the Waypoint.lane will
- * be null.
+ * @brief get right neighbor lane waypoint in hdmap, the map which the lane of
+ * the waypoint is from. If not exist, the Waypoint.lane will be null.
  */
-LaneWaypoint RightNeighborWaypoint(const LaneWaypoint& waypoint);
+LaneWaypoint RightNeighborWaypoint(const HDMap& hdmap,
+                                   const LaneWaypoint& waypoint);
 
 struct LaneSegment {
   LaneSegment() = default;
@@ -201,6 +203,8 @@ class PathApproximation {
   std::vector<int> sampled_max_original_projections_to_left_;
 };
 
+class PathSegmentIndex;
+
 class InterpolatedIndex {
  public:
   InterpolatedIndex(int id, double offset) : id(id), offset(offset) {}
@@ -258,6 +262,10 @@ class Path {
   bool GetHeadingAlongPath(const common::math::Vec2d& point,
                            double* heading) const;
 
+  // Index of the path point nearest to the point, the first one if several
+  // points are at the same distance.
+  int GetNearestPointIndex(const common::math::Vec2d& point) const;
+
   int num_points() const { return num_points_; }
   int num_segments() const { return num_segments_; }
   const std::vector<MapPathPoint>& path_points() const { return path_points_; }
@@ -332,6 +340,13 @@ class Path {
 
   double GetSample(const std::vector<double>& samples, const double s) const;
 
+  // Returns the segment index of a long path, built at its first use.
+  std::shared_ptr<const PathSegmentIndex> GetSegmentIndex() const;
+  // Index of the segment nearest to the point, the first one if several
+  // segments are at the same distance.
+  int GetNearestSegmentIndex(const common::math::Vec2d& point,
+                             double* min_distance_sqr) const;
+
   using GetOverlapFromLaneFunc =
       std::function<const std::vector<OverlapInfoConstPtr>&(const LaneInfo&)>;
   void GetAllOverlaps(GetOverlapFromLaneFunc GetOverlaps_from_lane,
@@ -350,6 +365,8 @@ class Path {
   std::vector<common::math::LineSegment2d> segments_;
   bool use_path_approximation_ = false;
   PathApproximation approximation_;
+  // A KD-tree of segments_, shared by the copies of the path.
+  mutable std::shared_ptr<const PathSegmentIndex> segment_index_;
 
   // Sampled every fixed length.
   int num_sample_points_ = 0;
@@ -17,6 +17,7 @@
 #include "modules/map/pnc_map/path.h"
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "gflags/gflags.h"
@@ -590,6 +591,53 @@ TEST(TestSuite, hdmap_jerky_path) {
   }
 }
 
+TEST(TestSuite, hdmap_path_segment_index) {
+  const int kNumSegments = 200;
+  std::vector<MapPathPoint> points;
+  double sum_x = 0;
+  for (int i = 0; i <= kNumSegments; ++i) {
+    points.push_back(MakeMapPathPoint(sum_x, RandomDouble(-5.0, 5.0)));
+    sum_x += RandomDouble(0.1, 3.0);
+  }
+  const Path path(points, {});
+  std::vector<Vec2d> original_points;
+  for (const auto& point : points) {
+    original_points.push_back(point);
+  }
+  const AABox2d box(original_points);
+
+  std::vector<Vec2d> queries = original_points;
+  for (int i = 0; i < 2000; ++i) {
+    queries.emplace_back(RandomDouble(box.min_x() - 10.0, box.max_x() + 10.0),
+                         RandomDouble(box.min_y() - 10.0, box.max_y() + 10.0));
+  }
+  for (const auto& query : queries) {
+    double min_segment_distance_sqr = std::numeric_limits<double>::infinity();
+    for (const auto& segment : path.segments()) {
+      min_segment_distance_sqr =
+          std::min(min_segment_distance_sqr, segment.DistanceSquareTo(query));
+    }
+    int min_index = 0;
+    for (int i = 1; i < path.num_points(); ++i) {
+      if (query.DistanceSquareTo(points[i]) <
+          query.DistanceSquareTo(points[min_index])) {
+        min_index = i;
+      }
+    }
+
+    // Copies of the path share the index built by the first query.
+    const Path path_copy = path;
+    for (const Path* p : {&path, &path_copy}) {
+      double accumulate_s = 0.0;
+      double lateral = 0.0;
+      double distance = 0.0;
+      EXPECT_TRUE(p->GetProjection(query, &accumulate_s, &lateral, &distance));
+      EXPECT_DOUBLE_EQ(std::sqrt(min_segment_distance_sqr), distance);
+      EXPECT_EQ(min_index, p->GetNearestPointIndex(query));
+    }
+  }
+}
+
 TEST(TestSuite, hdmap_s_path) {
   std::vector<MapPathPoint> points;
   const double kRadius = 50.0;
@@ -141,18 +141,20 @@ std::vector<routing::LaneWaypoint> PncMap::FutureRouteWaypoints() const {
 void PncMap::UpdateRoutingRange(int adc_index) {
   // track routing range.
   if (range_start_ > adc_index || range_end_ < adc_index) {
-    range_lane_ids_.clear();
+    range_lane_indices_.clear();
     range_start_ = std::max(0, adc_index - 1);
     range_end_ = range_start_;
   }
   while (range_start_ + 1 < adc_index) {
-    range_lane_ids_.erase(route_indices_[range_start_].segment.lane->id().id());
+    range_lane_indices_.erase(
+        GetLaneIndex(*route_indices_[range_start_].segment.lane));
     ++range_start_;
   }
   while (range_end_ < static_cast<int>(route_indices_.size())) {
-    const auto &lane_id = route_indices_[range_end_].segment.lane->id().id();
-    if (range_lane_ids_.count(lane_id) == 0) {
-      range_lane_ids_.insert(lane_id);
+    const int lane_index =
+        GetLaneIndex(*route_indices_[range_end_].segment.lane);
+    if (range_lane_indices_.count(lane_index) == 0) {
+      range_lane_indices_.insert(lane_index);
     } else {
       break;
     }
@@ -222,9 +224,9 @@ bool PncMap::IsNewRouting(const routing::RoutingResponse &prev,
 }
 
 bool PncMap::UpdateRoutingResponse(const routing::RoutingResponse &routing) {
-  range_lane_ids_.clear();
+  range_lane_indices_.clear();
   route_indices_.clear();
-  all_lane_ids_.clear();
+  all_lane_indices_.clear();
   for (int road_index = 0; road_index < routing.road_size(); ++road_index) {
     const auto &road_segment = routing.road(road_index);
     for (int passage_index = 0; passage_index < road_segment.passage_size();
@@ -232,7 +234,6 @@ bool PncMap::UpdateRoutingResponse(const routing::RoutingResponse &routing) {
       const auto &passage = road_segment.passage(passage_index);
       for (int lane_index = 0; lane_index < passage.segment_size();
            ++lane_index) {
-        all_lane_ids_.insert(passage.segment(lane_index).id());
         route_indices_.emplace_back();
         route_indices_.back().segment =
             ToLaneSegment(passage.segment(lane_index));
@@ -240,6 +241,8 @@ bool PncMap::UpdateRoutingResponse(const routing::RoutingResponse &routing) {
           AERROR << "Fail to get lane segment from passage.";
           return false;
         }
+        all_lane_indices_.insert(
+            GetLaneIndex(*route_indices_.back().segment.lane));
         route_indices_.back().index = {road_index, passage_index, lane_index};
       }
     }
@@ -523,19 +526,19 @@ bool PncMap::GetNearestPointFromRouting(const VehicleState &state,
   std::vector<LaneInfoConstPtr> valid_lanes;
   std::copy_if(lanes.begin(), lanes.end(), std::back_inserter(valid_lanes),
                [&](LaneInfoConstPtr ptr) {
-                 return range_lane_ids_.count(ptr->lane().id().id()) > 0;
+                 return range_lane_indices_.count(GetLaneIndex(*ptr)) > 0;
                });
   if (valid_lanes.empty()) {
     std::copy_if(lanes.begin(), lanes.end(), std::back_inserter(valid_lanes),
                  [&](LaneInfoConstPtr ptr) {
-                   return all_lane_ids_.count(ptr->lane().id().id()) > 0;
+                   return all_lane_indices_.count(GetLaneIndex(*ptr)) > 0;
                  });
   }
 
   // get nearest_wayponints for current position
   double min_distance = std::numeric_limits<double>::infinity();
   for (const auto &lane : valid_lanes) {
-    if (range_lane_ids_.count(lane->id().id()) == 0) {
+    if (range_lane_indices_.count(GetLaneIndex(*lane)) == 0) {
       continue;
     }
     {
@@ -571,32 +574,44 @@ bool PncMap::GetNearestPointFromRouting(const VehicleState &state,
   return waypoint->lane != nullptr;
 }
 
+int PncMap::GetLaneIndex(const hdmap::LaneInfo &lane) const {
+  return hdmap_->lane_topology().GetLaneIndex(lane);
+}
+
 LaneInfoConstPtr PncMap::GetRouteSuccessor(LaneInfoConstPtr lane) const {
-  if (lane->lane().successor_id_size() == 0) {
+  const auto &topology = hdmap_->lane_topology();
+  const int index = topology.GetLaneIndex(*lane);
+  if (index == hdmap::LaneTopology::kInvalidLaneIndex) {
     return nullptr;
   }
-  hdmap::Id preferred_id = lane->lane().successor_id(0);
-  for (const auto &lane_id : lane->lane().successor_id()) {
-    if (range_lane_ids_.count(lane_id.id()) != 0) {
-      preferred_id = lane_id;
-      break;
+  const auto successors = topology.successors(index);
+  if (successors.empty()) {
+    return nullptr;
+  }
+  for (const int successor : successors) {
+    if (range_lane_indices_.count(successor) != 0) {
+      return topology.lane(successor);
     }
   }
-  return hdmap_->GetLaneById(preferred_id);
+  return topology.lane(successors[0]);
 }
 
 LaneInfoConstPtr PncMap::GetRoutePredecessor(LaneInfoConstPtr lane) const {
-  if (lane->lane().predecessor_id_size() == 0) {
+  const auto &topology = hdmap_->lane_topology();
+  const int index = topology.GetLaneIndex(*lane);
+  if (index == hdmap::LaneTopology::kInvalidLaneIndex) {
     return nullptr;
   }
-  hdmap::Id preferred_id = lane->lane().predecessor_id(0);
-  for (const auto &lane_id : lane->lane().predecessor_id()) {
-    if (range_lane_ids_.count(lane_id.id()) != 0) {
-      preferred_id = lane_id;
-      break;
+  const auto predecessors = topology.predecessors(index);
+  if (predecessors.empty()) {
+    return nullptr;
+  }
+  for (const int predecessor : predecessors) {
+    if (range_lane_indices_.count(predecessor) != 0) {
+      return topology.lane(predecessor);
     }
   }
-  return hdmap_->GetLaneById(preferred_id);
+  return topology.lane(predecessors[0]);
 }
 
 bool PncMap::ExtendSegments(const RouteSegments &segments,
@@ -154,6 +154,12 @@ class PncMap {
 
   void UpdateRoutingRange(int adc_index);
 
+  /**
+   * @brief get the index of a lane in the topology of hdmap_, which also
+   * resolves lanes of another map snapshot by their ids.
+   */
+  int GetLaneIndex(const hdmap::LaneInfo &lane) const;
+
  private:
   routing::RoutingResponse routing_;
   struct RouteIndex {
@@ -163,9 +169,9 @@ class PncMap {
   std::vector<RouteIndex> route_indices_;
   int range_start_ = 0;
   int range_end_ = 0;
-  // routing ids in range
-  std::unordered_set<std::string> range_lane_ids_;
-  std::unordered_set<std::string> all_lane_ids_;
+  // lane indices of the routing in range, see hdmap::LaneTopology
+  std::unordered_set<int> range_lane_indices_;
+  std::unordered_set<int> all_lane_indices_;
 
   /**
    * The routing request waypoints
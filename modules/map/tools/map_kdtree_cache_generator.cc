@@ -0,0 +1,60 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "modules/common/log.h"
+#include "modules/common/time/time.h"
+#include "modules/map/hdmap/hdmap_util.h"
+
+/**
+ * A map tool to save the KD-trees of the base map into a KD-tree cache, which
+ * HDMapUtil adopts instead of building the KD-trees when it loads the same
+ * base map file. It reports the load time of the base map with and without
+ * the cache.
+ */
+
+DEFINE_string(output_dir, "/tmp", "output map directory");
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_alsologtostderr = true;
+
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  const auto map_filename = apollo::hdmap::BaseMapFile();
+  double start_time = apollo::common::time::Clock::NowInSeconds();
+  const auto hdmap = apollo::hdmap::CreateMap(map_filename);
+  CHECK(hdmap) << "fail to load map from : " << map_filename;
+  const double load_time =
+      apollo::common::time::Clock::NowInSeconds() - start_time;
+
+  const std::string output_cache_file =
+      FLAGS_output_dir + "/" + FLAGS_base_map_kdtree_cache_filename;
+  CHECK_EQ(0, hdmap->SaveKDTreeCache(output_cache_file))
+      << "failed to output KD-tree cache";
+
+  start_time = apollo::common::time::Clock::NowInSeconds();
+  apollo::hdmap::HDMap cached_hdmap;
+  CHECK_EQ(0, cached_hdmap.LoadMapFromFile(map_filename, output_cache_file))
+      << "failed to load map with KD-tree cache";
+  AINFO << "map " << map_filename << " loaded in " << load_time << "s, in "
+        << apollo::common::time::Clock::NowInSeconds() - start_time
+        << "s with KD-tree cache " << output_cache_file;
+
+  return 0;
+}
@@ -0,0 +1,51 @@
+/* Copyright 2018 The Apollo Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+=========================================================================*/
+
+#include <string>
+
+#include "gflags/gflags.h"
+
+#include "modules/common/log.h"
+#include "modules/common/util/file.h"
+#include "modules/map/hdmap/hdmap_util.h"
+#include "modules/map/hdmap/tiled_hdmap.h"
+#include "modules/map/proto/map.pb.h"
+
+/**
+ * A map tool to split the base map into tiles, which are loaded on demand by
+ * TiledHDMap.
+ */
+
+DEFINE_string(output_dir, "/tmp/map_tiles", "output tile directory");
+DEFINE_double(tile_length, 1000.0, "side length of map tiles in meters");
+
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_alsologtostderr = true;
+
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  const auto map_filename = apollo::hdmap::BaseMapFile();
+  apollo::hdmap::Map map;
+  CHECK(apollo::common::util::GetProtoFromFile(map_filename, &map))
+      << "fail to load map from : " << map_filename;
+
+  CHECK(apollo::hdmap::TiledHDMap::GenerateTiles(map, FLAGS_tile_length,
+                                                 FLAGS_output_dir))
+      << "failed to output map tiles";
+  AINFO << "map tiles are written to " << FLAGS_output_dir;
+
+  return 0;
+}
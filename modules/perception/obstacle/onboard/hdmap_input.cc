@@ -57,17 +57,20 @@ bool HDMapInput::GetROI(const PointD& pointd, const double map_radius,
   if (mapptr == nullptr) {
     return false;
   }
-  auto* hdmap = HDMapUtil::BaseMapPtr();
+  common::PointENU point;
+  point.set_x(pointd.x);
+  point.set_y(pointd.y);
+  point.set_z(pointd.z);
+  // The ROI is queried around the ego vehicle for every frame, move the
+  // tiled base map, if any, along with it.
+  HDMapUtil::UpdateBaseMapPosition(point);
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
   if (hdmap == nullptr) {
     return false;
   }
   if (*mapptr == nullptr) {
     (*mapptr).reset(new HdmapStruct);
   }
-  common::PointENU point;
-  point.set_x(pointd.x);
-  point.set_y(pointd.y);
-  point.set_z(pointd.z);
   std::vector<RoadROIBoundaryPtr> boundary_vec;
   std::vector<JunctionBoundaryPtr> junctions_vec;
 
@@ -89,7 +92,7 @@ bool HDMapInput::GetROI(const PointD& pointd, const double map_radius,
 
 bool HDMapInput::GetNearestLaneDirection(const pcl_util::PointD& pointd,
                                          Eigen::Vector3d* lane_direction) {
-  auto* hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
   if (hdmap == nullptr) {
     return false;
   }
@@ -30,13 +30,20 @@ HDMapInput::HDMapInput() {}
 
 bool HDMapInput::GetSignals(const Eigen::Matrix4d &pointd,
                             std::vector<apollo::hdmap::Signal> *signals) {
-  auto hdmap = HDMapUtil::BaseMapPtr();
-
-  std::vector<hdmap::SignalInfoConstPtr> forward_signals;
   apollo::common::PointENU point;
   point.set_x(pointd(0, 3));
   point.set_y(pointd(1, 3));
   point.set_z(pointd(2, 3));
+  // Signals are queried ahead of the ego vehicle for every frame, move the
+  // tiled base map, if any, along with it.
+  HDMapUtil::UpdateBaseMapPosition(point);
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
+  if (hdmap == nullptr) {
+    AERROR << "Failed to get the base map.";
+    return false;
+  }
+
+  std::vector<hdmap::SignalInfoConstPtr> forward_signals;
   int result = hdmap->GetForwardNearestSignalsOnLane(
       point, FLAGS_query_signal_range, &forward_signals);
 
@@ -58,8 +58,10 @@ FrameHistory::FrameHistory()
 Frame::Frame(uint32_t sequence_num,
              const common::TrajectoryPoint &planning_start_point,
              const double start_time, const common::VehicleState &vehicle_state,
-             ReferenceLineProvider *reference_line_provider)
+             ReferenceLineProvider *reference_line_provider,
+             std::shared_ptr<const hdmap::HDMap> hdmap)
     : sequence_num_(sequence_num),
+      hdmap_(std::move(hdmap)),
       planning_start_point_(planning_start_point),
       start_time_(start_time),
       vehicle_state_(vehicle_state),
@@ -322,7 +324,7 @@ const Obstacle *Frame::CreateStaticVirtualObstacle(const std::string &id,
 }
 
 Status Frame::Init() {
-  hdmap_ = hdmap::HDMapUtil::BaseMapPtr();
+  CHECK_NOTNULL(hdmap_);
   vehicle_state_ = common::VehicleStateProvider::instance()->vehicle_state();
   const auto &point = common::util::MakePointENU(
       vehicle_state_.x(), vehicle_state_.y(), vehicle_state_.z());
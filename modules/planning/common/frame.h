@@ -61,7 +61,8 @@ class Frame {
                  const common::TrajectoryPoint &planning_start_point,
                  const double start_time,
                  const common::VehicleState &vehicle_state,
-                 ReferenceLineProvider *reference_line_provider);
+                 ReferenceLineProvider *reference_line_provider,
+                 std::shared_ptr<const hdmap::HDMap> hdmap);
 
   const common::TrajectoryPoint &PlanningStartPoint() const;
   common::Status Init();
@@ -101,6 +102,13 @@ class Frame {
 
   const common::VehicleState &vehicle_state() const;
 
+  /**
+   * @brief The map snapshot of this planning cycle. All the users of the map
+   * in the cycle should query this one, so that they agree on the map even
+   * if the maps are reloaded meanwhile.
+   */
+  const hdmap::HDMap *hdmap() const { return hdmap_.get(); }
+
   static void AlignPredictionTime(
       const double planning_start_time,
       prediction::PredictionObstacles *prediction_obstacles);
@@ -133,7 +141,8 @@ class Frame {
 
  private:
   uint32_t sequence_num_ = 0;
-  const hdmap::HDMap *hdmap_ = nullptr;
+  // The map snapshot of this frame, taken once by Planning for the cycle.
+  std::shared_ptr<const hdmap::HDMap> hdmap_;
   common::TrajectoryPoint planning_start_point_;
   const double start_time_;
   common::VehicleState vehicle_state_;
@@ -93,6 +93,61 @@ Obstacle::Obstacle(const std::string& id,
         common::util::DistanceXY(prev.path_point(), cur.path_point());
     trajectory_points[i].mutable_path_point()->set_s(cumulative_s);
   }
+  InitTrajectorySamples();
+}
+
+void Obstacle::InitTrajectorySamples() {
+  trajectory_samples_ = TrajectorySamples();
+  for (const auto& point : trajectory_.trajectory_point()) {
+    AddTrajectorySample(point);
+  }
+}
+
+void Obstacle::AddTrajectorySample(const common::TrajectoryPoint& point) {
+  auto& samples = trajectory_samples_;
+  samples.relative_time.push_back(point.relative_time());
+  samples.x.push_back(point.path_point().x());
+  samples.y.push_back(point.path_point().y());
+  samples.theta.push_back(point.path_point().theta());
+
+  // The points are evenly spaced as long as each one follows the first one
+  // by a multiple of the time between the first two points.
+  const auto& times = samples.relative_time;
+  const int i = times.size() - 1;
+  if (i == 1) {
+    const double time_step = times[1] - times[0];
+    samples.uniform_time_step = time_step > 0.0 ? time_step : 0.0;
+    return;
+  }
+  const double time_step = samples.uniform_time_step;
+  constexpr double kTimeStepTolerance = 1e-3;
+  if (time_step > 0.0 && std::fabs(times[i] - times.front() - i * time_step) >
+                             kTimeStepTolerance * time_step) {
+    samples.uniform_time_step = 0.0;
+  }
+}
+
+int Obstacle::LowerBoundTrajectoryPoint(const double relative_time) const {
+  const auto& times = trajectory_samples_.relative_time;
+  const double time_step = trajectory_samples_.uniform_time_step;
+  if (time_step <= 0.0) {
+    return std::lower_bound(times.begin(), times.end(), relative_time) -
+           times.begin();
+  }
+  // The points are evenly spaced, so the estimated index is off by at most
+  // one point because of rounding.
+  const int num_points = times.size();
+  const double estimate =
+      std::ceil((relative_time - times.front()) / time_step);
+  int index = static_cast<int>(
+      std::min(std::max(estimate, 0.0), static_cast<double>(num_points)));
+  while (index > 0 && times[index - 1] >= relative_time) {
+    --index;
+  }
+  while (index < num_points && times[index] < relative_time) {
+    ++index;
+  }
+  return index;
 }
 
 double Obstacle::Speed() const { return speed_; }
@@ -105,8 +160,9 @@ bool Obstacle::HasTrajectory() const {
   return trajectory_.trajectory_point_size() > 0;
 }
 
-common::TrajectoryPoint* Obstacle::AddTrajectoryPoint() {
-  return trajectory_.add_trajectory_point();
+void Obstacle::AddTrajectoryPoint(const common::TrajectoryPoint& point) {
+  trajectory_.add_trajectory_point()->CopyFrom(point);
+  AddTrajectorySample(point);
 }
 
 bool Obstacle::IsStaticObstacle(const PerceptionObstacle& perception_obstacle) {
@@ -141,20 +197,14 @@ common::TrajectoryPoint Obstacle::GetPointAtTime(
     point.set_relative_time(0.0);
     return point;
   } else {
-    auto comp = [](const common::TrajectoryPoint p, const double time) {
-      return p.relative_time() < time;
-    };
-
-    auto it_lower =
-        std::lower_bound(points.begin(), points.end(), relative_time, comp);
-
-    if (it_lower == points.begin()) {
-      return *points.begin();
-    } else if (it_lower == points.end()) {
-      return *points.rbegin();
+    const int index = LowerBoundTrajectoryPoint(relative_time);
+    if (index == 0) {
+      return points.Get(0);
+    } else if (index == points.size()) {
+      return points.Get(points.size() - 1);
     }
     return common::math::InterpolateUsingLinearApproximation(
-        *(it_lower - 1), *it_lower, relative_time);
+        points.Get(index - 1), points.Get(index), relative_time);
   }
 }
 
@@ -166,6 +216,37 @@ common::math::Box2d Obstacle::GetBoundingBox(
                              perception_obstacle_.width());
 }
 
+common::math::Box2d Obstacle::GetBoundingBoxAtTime(
+    const double relative_time) const {
+  const auto& samples = trajectory_samples_;
+  const int num_points = samples.relative_time.size();
+  if (num_points < 2) {
+    return common::math::Box2d({perception_obstacle_.position().x(),
+                                perception_obstacle_.position().y()},
+                               perception_obstacle_.theta(),
+                               perception_obstacle_.length(),
+                               perception_obstacle_.width());
+  }
+
+  const int index = LowerBoundTrajectoryPoint(relative_time);
+  if (index == 0 || index == num_points) {
+    const int i = (index == 0 ? 0 : num_points - 1);
+    return common::math::Box2d({samples.x[i], samples.y[i]}, samples.theta[i],
+                               perception_obstacle_.length(),
+                               perception_obstacle_.width());
+  }
+  const double t0 = samples.relative_time[index - 1];
+  const double t1 = samples.relative_time[index];
+  return common::math::Box2d(
+      {common::math::lerp(samples.x[index - 1], t0, samples.x[index], t1,
+                          relative_time),
+       common::math::lerp(samples.y[index - 1], t0, samples.y[index], t1,
+                          relative_time)},
+      common::math::slerp(samples.theta[index - 1], t0, samples.theta[index],
+                          t1, relative_time),
+      perception_obstacle_.length(), perception_obstacle_.width());
+}
+
 const common::math::Box2d& Obstacle::PerceptionBoundingBox() const {
   return perception_bounding_box_;
 }
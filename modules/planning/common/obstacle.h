@@ -67,6 +67,14 @@ class Obstacle {
 
   common::math::Box2d GetBoundingBox(
       const common::TrajectoryPoint &point) const;
+
+  /**
+   * @brief get the bounding box at a relative time of the predicted
+   * trajectory, the same as GetBoundingBox(GetPointAtTime(relative_time))
+   * but without creating the trajectory point
+   */
+  common::math::Box2d GetBoundingBoxAtTime(const double relative_time) const;
+
   /**
    * @brief get the perception bounding box
    */
@@ -79,7 +87,7 @@ class Obstacle {
   const common::math::Polygon2d &PerceptionPolygon() const;
 
   const prediction::Trajectory &Trajectory() const;
-  common::TrajectoryPoint *AddTrajectoryPoint();
+  void AddTrajectoryPoint(const common::TrajectoryPoint &point);
   bool HasTrajectory() const;
 
   const perception::PerceptionObstacle &Perception() const;
@@ -106,12 +114,34 @@ class Obstacle {
   static bool IsValidTrajectoryPoint(const common::TrajectoryPoint &point);
 
  private:
+  void InitTrajectorySamples();
+  void AddTrajectorySample(const common::TrajectoryPoint &point);
+
+  // index of the first trajectory point whose relative time is not less than
+  // relative_time, or the number of points if there is no such point
+  int LowerBoundTrajectoryPoint(const double relative_time) const;
+
+  /**
+   * @brief The predicted trajectory points stored in arrays, so that they
+   * are interpolated without accessing the protobuf messages.
+   */
+  struct TrajectorySamples {
+    std::vector<double> relative_time;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> theta;
+    // the time between two points if they are evenly spaced in time,
+    // otherwise 0.0 and the points are found by binary search
+    double uniform_time_step = 0.0;
+  };
+
   std::string id_;
   std::int32_t perception_id_ = 0;
   bool is_static_ = false;
   bool is_virtual_ = false;
   double speed_ = 0.0;
   prediction::Trajectory trajectory_;
+  TrajectorySamples trajectory_samples_;
   perception::PerceptionObstacle perception_obstacle_;
   common::math::Box2d perception_bounding_box_;
   common::math::Polygon2d perception_polygon_;
@@ -129,6 +129,62 @@ TEST_F(ObstacleTest, GetPointAtTime) {
   EXPECT_LE(349.549888973, middle_point.path_point().y());
 }
 
+TEST_F(ObstacleTest, GetBoundingBoxAtTime) {
+  for (const auto* obstacle : indexed_obstacles_.Items()) {
+    for (double t = -1.0; t < 11.0; t += 0.05) {
+      const auto expected =
+          obstacle->GetBoundingBox(obstacle->GetPointAtTime(t));
+      const auto box = obstacle->GetBoundingBoxAtTime(t);
+      EXPECT_DOUBLE_EQ(expected.center_x(), box.center_x());
+      EXPECT_DOUBLE_EQ(expected.center_y(), box.center_y());
+      EXPECT_DOUBLE_EQ(expected.heading(), box.heading());
+      EXPECT_DOUBLE_EQ(expected.length(), box.length());
+      EXPECT_DOUBLE_EQ(expected.width(), box.width());
+    }
+  }
+}
+
+TEST(Obstacle, EvenlySpacedTrajectory) {
+  PerceptionObstacle perception_obstacle;
+  perception_obstacle.set_id(1);
+  perception_obstacle.set_length(4.0);
+  perception_obstacle.set_width(2.0);
+  prediction::Trajectory trajectory;
+  for (int i = 0; i <= 50; ++i) {
+    auto* point = trajectory.add_trajectory_point();
+    point->set_relative_time(i * 0.1);
+    point->mutable_path_point()->set_x(i * 0.1 * 2.0);
+    point->mutable_path_point()->set_y(1.0);
+  }
+  Obstacle obstacle("1_0", perception_obstacle, trajectory);
+
+  for (int i = 0; i < 50; ++i) {
+    const double t = i * 0.1;
+    EXPECT_NEAR(2.0 * t, obstacle.GetPointAtTime(t).path_point().x(), 1e-9);
+    EXPECT_NEAR(2.0 * (t + 0.03),
+                obstacle.GetBoundingBoxAtTime(t + 0.03).center_x(), 1e-9);
+  }
+  EXPECT_DOUBLE_EQ(0.0, obstacle.GetBoundingBoxAtTime(-1.0).center_x());
+  EXPECT_DOUBLE_EQ(10.0, obstacle.GetBoundingBoxAtTime(6.0).center_x());
+
+  common::TrajectoryPoint point;
+  point.set_relative_time(5.5);
+  point.mutable_path_point()->set_x(12.0);
+  obstacle.AddTrajectoryPoint(point);
+  EXPECT_NEAR(11.0, obstacle.GetBoundingBoxAtTime(5.25).center_x(), 1e-9);
+  EXPECT_DOUBLE_EQ(12.0, obstacle.GetBoundingBoxAtTime(6.0).center_x());
+
+  // The same trajectory added point by point.
+  Obstacle extended("1_0", perception_obstacle, prediction::Trajectory());
+  for (const auto& trajectory_point : trajectory.trajectory_point()) {
+    extended.AddTrajectoryPoint(trajectory_point);
+  }
+  for (int i = 0; i < 50; ++i) {
+    const double t = i * 0.1 + 0.03;
+    EXPECT_NEAR(2.0 * t, extended.GetBoundingBoxAtTime(t).center_x(), 1e-9);
+  }
+}
+
 TEST_F(ObstacleTest, PerceptionBoundingBox) {
   const auto* obstacle = indexed_obstacles_.Find("2156_0");
   ASSERT_TRUE(obstacle);
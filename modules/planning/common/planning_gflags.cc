@@ -76,6 +76,9 @@ DEFINE_double(reference_line_lateral_buffer, 0.5,
 
 DEFINE_bool(enable_smooth_reference_line, true,
             "enable smooth the map reference line");
+DEFINE_bool(enable_reference_line_smoother_warm_start, true,
+            "True to start smoothing an extended reference line from the "
+            "previous one where they overlap");
 
 DEFINE_bool(prioritize_change_lane, false,
             "change lane strategy has higher priority, always use a valid "
@@ -270,10 +273,11 @@ DEFINE_bool(enable_follow_accel_constraint, true,
 
 // SQP solver
 DEFINE_bool(enable_sqp_solver, true, "True to enable SQP solver.");
+DEFINE_bool(enable_sparse_spline_qp_solver, false,
+            "True to solve the smoothing spline QPs with the sparse ADMM "
+            "solver instead of qpOASES.");
 
 /// thread pool
-DEFINE_int32(num_thread_planning_thread_pool, 5,
-             "num of thread used in planning thread pool.");
 DEFINE_bool(use_multi_thread_to_add_obstacles, false,
             "use multiple thread to add obstacles.");
 DEFINE_bool(
@@ -281,6 +285,18 @@ DEFINE_bool(
     "Enable multiple thread to calculation curve cost in dp_poly_path.");
 DEFINE_bool(enable_multi_thread_in_dp_st_graph, false,
             "Enable multiple thread to calculation curve cost in dp_st_graph.");
+DEFINE_bool(enable_pruning_in_dp_st_graph, true,
+            "Skip the cells of dp_st_graph which cannot be reached within the "
+            "acceleration limits before computing their cost.");
+DEFINE_bool(enable_multi_thread_in_lattice_evaluation, false,
+            "Enable multiple thread to evaluate the lattice trajectory pairs, "
+            "and to check the best ones speculatively.");
+DEFINE_bool(enable_multi_thread_in_em_planner, false,
+            "Enable multiple thread to plan on the reference lines "
+            "concurrently in em planner.");
+DEFINE_int32(num_speculative_lattice_trajectory_pairs, 8,
+             "The number of the best lattice trajectory pairs combined and "
+             "checked at a time in multiple thread.");
 
 /// Lattice Planner
 DEFINE_double(lattice_epsilon, 1e-6, "Epsilon in lattice planner.");
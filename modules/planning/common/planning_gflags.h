@@ -40,6 +40,7 @@ DECLARE_double(reference_line_stitch_overlap_distance);
 DECLARE_double(reference_line_lateral_buffer);
 
 DECLARE_bool(enable_smooth_reference_line);
+DECLARE_bool(enable_reference_line_smoother_warm_start);
 
 DECLARE_bool(prioritize_change_lane);
 DECLARE_bool(reckless_change_lane);
@@ -139,12 +140,16 @@ DECLARE_double(slowdown_profile_deceleration);
 DECLARE_bool(enable_follow_accel_constraint);
 
 DECLARE_bool(enable_sqp_solver);
+DECLARE_bool(enable_sparse_spline_qp_solver);
 
 /// thread pool
-DECLARE_int32(num_thread_planning_thread_pool);
 DECLARE_bool(use_multi_thread_to_add_obstacles);
 DECLARE_bool(enable_multi_thread_in_dp_poly_path);
 DECLARE_bool(enable_multi_thread_in_dp_st_graph);
+DECLARE_bool(enable_pruning_in_dp_st_graph);
+DECLARE_bool(enable_multi_thread_in_lattice_evaluation);
+DECLARE_bool(enable_multi_thread_in_em_planner);
+DECLARE_int32(num_speculative_lattice_trajectory_pairs);
 
 // lattice planner
 DECLARE_double(lattice_epsilon);
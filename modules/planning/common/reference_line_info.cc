@@ -21,7 +21,6 @@
 #include "modules/planning/common/reference_line_info.h"
 
 #include <algorithm>
-#include <functional>
 #include <utility>
 
 #include "modules/planning/proto/sl_boundary.pb.h"
@@ -29,11 +28,11 @@
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common/util/string_util.h"
+#include "modules/common/util/task_scheduler.h"
 #include "modules/common/util/util.h"
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/planning_gflags.h"
-#include "modules/planning/common/planning_thread_pool.h"
 #include "modules/planning/common/planning_util.h"
 
 namespace apollo {
@@ -269,12 +268,9 @@ bool ReferenceLineInfo::AddObstacles(
     const std::vector<const Obstacle*>& obstacles) {
   if (FLAGS_use_multi_thread_to_add_obstacles) {
     std::vector<int> ret(obstacles.size(), 0);
-    for (size_t i = 0; i < obstacles.size(); ++i) {
-      const auto* obstacle = obstacles.at(i);
-      PlanningThreadPool::instance()->Push(std::bind(
-          &ReferenceLineInfo::AddObstacleHelper, this, obstacle, &(ret[i])));
-    }
-    PlanningThreadPool::instance()->Synchronize();
+    common::util::ParallelFor(0, obstacles.size(), 1, [&](const size_t i) {
+      AddObstacleHelper(obstacles[i], &ret[i]);
+    });
     if (std::find(ret.begin(), ret.end(), 0) != ret.end()) {
       return false;
     }
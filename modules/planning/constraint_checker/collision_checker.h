@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "modules/common/math/box2d.h"
+#include "modules/common/math/box2d_sweep_and_prune.h"
 #include "modules/planning/common/obstacle.h"
 #include "modules/planning/common/reference_line_info.h"
 #include "modules/planning/common/trajectory/discretized_trajectory.h"
@@ -44,7 +45,7 @@ class CollisionChecker {
       const ReferenceLineInfo* ptr_reference_line_info,
       const std::shared_ptr<PathTimeGraph>& ptr_path_time_graph);
 
-  bool InCollision(const DiscretizedTrajectory& discretized_trajectory);
+  bool InCollision(const DiscretizedTrajectory& discretized_trajectory) const;
 
  private:
   void BuildPredictedEnvironment(
@@ -63,7 +64,9 @@ class CollisionChecker {
  private:
   const ReferenceLineInfo* ptr_reference_line_info_;
   std::shared_ptr<PathTimeGraph> ptr_path_time_graph_;
-  std::vector<std::vector<common::math::Box2d>> predicted_bounding_rectangles_;
+  // The predicted obstacle boxes at each time step, indexed for overlap
+  // queries.
+  std::vector<common::math::Box2dSweepAndPrune> predicted_bounding_rectangles_;
 };
 
 }  // namespace planning
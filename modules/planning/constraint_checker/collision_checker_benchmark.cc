@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Compares the collision checks of CollisionChecker against every
+ *        predicted obstacle box and against the boxes indexed by
+ *        Box2dSweepAndPrune, on lattice candidate trajectories in traffic.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/box2d_sweep_and_prune.h"
+
+namespace apollo {
+namespace planning {
+namespace {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::Box2dSweepAndPrune;
+using apollo::common::math::Vec2d;
+
+// Time steps of FLAGS_trajectory_time_length and
+// FLAGS_trajectory_time_resolution.
+constexpr int kNumTimeSteps = 80;
+constexpr double kTimeResolution = 0.1;
+
+// Obstacles drive in the lanes of a straight road, and their boxes are
+// extended by the collision buffers as in CollisionChecker. The road heads
+// along x, or is rotated by a given heading.
+constexpr int kNumLanes = 4;
+constexpr double kLaneWidth = 3.5;
+constexpr double kRoadLength = 300.0;
+constexpr double kLonCollisionBuffer = 2.0;
+constexpr double kLatCollisionBuffer = 0.2;
+
+constexpr double kEgoLength = 4.933;
+constexpr double kEgoWidth = 2.11;
+
+// A box on the road, rotated by the heading of the road around the origin.
+Box2d RoadBox(const double s, const double l, const double road_heading,
+              const double length, const double width) {
+  return Box2d(Vec2d(s, l).rotate(road_heading), road_heading, length, width);
+}
+
+// Predicted obstacle boxes at each time step.
+std::vector<std::vector<Box2d>> GenerateTraffic(const int num_obstacles,
+                                                const double road_heading) {
+  std::mt19937 random_engine(0);
+  std::uniform_int_distribution<int> lane(0, kNumLanes - 1);
+  std::uniform_real_distribution<double> position(0.0, kRoadLength);
+  std::uniform_real_distribution<double> speed(0.0, 15.0);
+  std::uniform_real_distribution<double> offset(-0.3, 0.3);
+  std::vector<std::vector<Box2d>> boxes(kNumTimeSteps);
+  for (int i = 0; i < num_obstacles; ++i) {
+    const double x = position(random_engine);
+    const double y = (lane(random_engine) + 0.5) * kLaneWidth +
+                     offset(random_engine);
+    const double v = speed(random_engine);
+    for (int t = 0; t < kNumTimeSteps; ++t) {
+      Box2d box =
+          RoadBox(x + v * t * kTimeResolution, y, road_heading, 4.5, 1.9);
+      box.LongitudinalExtend(2.0 * kLonCollisionBuffer);
+      box.LateralExtend(2.0 * kLatCollisionBuffer);
+      boxes[t].push_back(box);
+    }
+  }
+  return boxes;
+}
+
+// Ego boxes of lattice candidates, which change lane to one of the lanes
+// at one of the sampled speeds.
+std::vector<std::vector<Box2d>> GenerateCandidates(const int num_candidates,
+                                                   const double road_heading) {
+  std::mt19937 random_engine(1);
+  std::uniform_int_distribution<int> lane(0, kNumLanes - 1);
+  std::uniform_real_distribution<double> speed(0.0, 20.0);
+  std::vector<std::vector<Box2d>> candidates(num_candidates);
+  for (auto &candidate : candidates) {
+    const double start_y = 1.5 * kLaneWidth;
+    const double end_y = (lane(random_engine) + 0.5) * kLaneWidth;
+    const double v = speed(random_engine);
+    for (int t = 0; t < kNumTimeSteps; ++t) {
+      const double ratio = std::min(1.0, t / (0.5 * kNumTimeSteps));
+      candidate.push_back(RoadBox(100.0 + v * t * kTimeResolution,
+                                  start_y + (end_y - start_y) * ratio,
+                                  road_heading, kEgoLength, kEgoWidth));
+    }
+  }
+  return candidates;
+}
+
+void BM_InCollision(benchmark::State &state) {  // NOLINT
+  const double road_heading = state.range(2) * M_PI / 180.0;
+  const auto traffic = GenerateTraffic(state.range(0), road_heading);
+  const auto candidates = GenerateCandidates(state.range(1), road_heading);
+  while (state.KeepRunning()) {
+    int num_collisions = 0;
+    for (const auto &candidate : candidates) {
+      bool in_collision = false;
+      for (int t = 0; t < kNumTimeSteps && !in_collision; ++t) {
+        for (const Box2d &box : traffic[t]) {
+          if (candidate[t].HasOverlap(box)) {
+            in_collision = true;
+            break;
+          }
+        }
+      }
+      num_collisions += in_collision;
+    }
+    benchmark::DoNotOptimize(num_collisions);
+  }
+  state.SetItemsProcessed(state.iterations() * candidates.size());
+}
+
+void BM_InCollisionSweepAndPrune(benchmark::State &state) {  // NOLINT
+  const double road_heading = state.range(2) * M_PI / 180.0;
+  const auto traffic = GenerateTraffic(state.range(0), road_heading);
+  const auto candidates = GenerateCandidates(state.range(1), road_heading);
+  std::vector<Box2dSweepAndPrune> indexed_traffic;
+  for (const auto &boxes : traffic) {
+    indexed_traffic.emplace_back(boxes);
+  }
+  while (state.KeepRunning()) {
+    int num_collisions = 0;
+    for (const auto &candidate : candidates) {
+      bool in_collision = false;
+      for (int t = 0; t < kNumTimeSteps && !in_collision; ++t) {
+        in_collision = indexed_traffic[t].HasOverlap(candidate[t]);
+      }
+      num_collisions += in_collision;
+    }
+    benchmark::DoNotOptimize(num_collisions);
+  }
+  state.SetItemsProcessed(state.iterations() * candidates.size());
+}
+
+void BM_BuildSweepAndPrune(benchmark::State &state) {  // NOLINT
+  const auto traffic = GenerateTraffic(state.range(0), 0.0);
+  while (state.KeepRunning()) {
+    // The boxes are moved into the index, as in CollisionChecker.
+    state.PauseTiming();
+    auto boxes = traffic;
+    std::vector<Box2dSweepAndPrune> indexed_traffic;
+    indexed_traffic.reserve(kNumTimeSteps);
+    state.ResumeTiming();
+    for (auto &boxes_at_time : boxes) {
+      indexed_traffic.emplace_back(std::move(boxes_at_time));
+    }
+    benchmark::DoNotOptimize(indexed_traffic.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumTimeSteps *
+                          state.range(0));
+}
+
+// From 100 to 400 obstacles, and from the few candidates checked in light
+// traffic to the hundreds checked when most of them are blocked, on a road
+// heading along x, diagonally, and along y, in degrees.
+BENCHMARK(BM_InCollision)
+    ->Args({100, 32, 0})
+    ->Args({100, 256, 0})
+    ->Args({100, 256, 45})
+    ->Args({100, 256, 90})
+    ->Args({400, 32, 0})
+    ->Args({400, 256, 0});
+BENCHMARK(BM_InCollisionSweepAndPrune)
+    ->Args({100, 32, 0})
+    ->Args({100, 256, 0})
+    ->Args({100, 256, 45})
+    ->Args({100, 256, 90})
+    ->Args({400, 32, 0})
+    ->Args({400, 256, 0});
+BENCHMARK(BM_BuildSweepAndPrune)->Arg(100)->Arg(400);
+
+}  // namespace
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -250,7 +250,7 @@ TEST_F(SunnyvaleLoopTest, qp_path_failure) {
 TEST_F(SunnyvaleLoopTest, change_lane_failback) {
   //// temporarly disable this test case, because a lane in routing cannot be
   //// found on test map.
-  auto target_lane = hdmap::HDMapUtil::BaseMapPtr()->GetLaneById(
+  auto target_lane = hdmap::HDMapUtil::BaseMapSnapshot()->GetLaneById(
       hdmap::MakeMapId("2020_1_-2"));
   if (target_lane == nullptr) {
     AERROR << "Could not find lane 2020_1_-2 on map " << hdmap::BaseMapFile();
@@ -41,7 +41,6 @@ using apollo::common::math::Box2d;
 using apollo::common::math::Polygon2d;
 using apollo::common::math::PathMatcher;
 using apollo::common::PathPoint;
-using apollo::common::TrajectoryPoint;
 using apollo::perception::PerceptionObstacle;
 
 PathTimeGraph::PathTimeGraph(
@@ -172,8 +171,7 @@ void PathTimeGraph::SetDynamicObstacle(
     const std::vector<PathPoint>& discretized_ref_points) {
   double relative_time = time_range_.first;
   while (relative_time < time_range_.second) {
-    TrajectoryPoint point = obstacle->GetPointAtTime(relative_time);
-    Box2d box = obstacle->GetBoundingBox(point);
+    Box2d box = obstacle->GetBoundingBoxAtTime(relative_time);
     SLBoundary sl_boundary = ComputeObstacleBoundary(box.GetAllCorners(),
         discretized_ref_points);
 
@@ -25,9 +25,11 @@
 #include <functional>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include "modules/common/log.h"
 #include "modules/common/math/path_matcher.h"
+#include "modules/common/util/task_scheduler.h"
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/constraint_checker/constraint_checker1d.h"
 #include "modules/planning/lattice/trajectory1d/piecewise_acceleration_trajectory1d.h"
@@ -47,6 +49,13 @@ using CostComponentsPair = std::pair<std::vector<double>, double>;
 
 using PtrTrajectory1d = std::shared_ptr<Trajectory1d>;
 
+namespace {
+
+// The number of trajectory pairs evaluated by a task in multiple threads.
+constexpr std::size_t kNumTrajectoryPairsPerTask = 16;
+
+}  // namespace
+
 TrajectoryEvaluator::TrajectoryEvaluator(
     const std::array<double, 3>& init_s,
     const PlanningTarget& planning_target,
@@ -70,6 +79,7 @@ TrajectoryEvaluator::TrajectoryEvaluator(
   if (planning_target.has_stop_point()) {
     stop_point = planning_target.stop_point().s();
   }
+  std::vector<Trajectory1dPair> trajectory_pairs;
   for (const auto& lon_trajectory : lon_trajectories) {
     double lon_end_s = lon_trajectory->Evaluate(0, end_time);
     if (init_s[0] < stop_point &&
@@ -88,18 +98,36 @@ TrajectoryEvaluator::TrajectoryEvaluator(
         continue;
       }
       */
-      if (!FLAGS_enable_auto_tuning) {
-        double cost = Evaluate(planning_target, lon_trajectory, lat_trajectory);
-        cost_queue_.emplace(Trajectory1dPair(lon_trajectory, lat_trajectory),
-                            cost);
-      } else {
-        std::vector<double> cost_components;
-        double cost = Evaluate(planning_target, lon_trajectory, lat_trajectory,
-                               &cost_components);
-        cost_queue_with_components_.emplace(
-            Trajectory1dPair(lon_trajectory, lat_trajectory),
-            CostComponentsPair(cost_components, cost));
-      }
+      trajectory_pairs.emplace_back(lon_trajectory, lat_trajectory);
+    }
+  }
+
+  // The pairs are evaluated independently, and queued in the same order
+  // whether they are evaluated in multiple threads or not.
+  std::vector<double> costs(trajectory_pairs.size(), 0.0);
+  std::vector<std::vector<double>> cost_components(
+      FLAGS_enable_auto_tuning ? trajectory_pairs.size() : 0);
+  auto evaluate = [&](const std::size_t i) {
+    costs[i] = Evaluate(planning_target, trajectory_pairs[i].first,
+                        trajectory_pairs[i].second,
+                        FLAGS_enable_auto_tuning ? &cost_components[i]
+                                                 : nullptr);
+  };
+  if (FLAGS_enable_multi_thread_in_lattice_evaluation) {
+    common::util::ParallelFor(0, trajectory_pairs.size(),
+                              kNumTrajectoryPairsPerTask, evaluate);
+  } else {
+    for (std::size_t i = 0; i < trajectory_pairs.size(); ++i) {
+      evaluate(i);
+    }
+  }
+  for (std::size_t i = 0; i < trajectory_pairs.size(); ++i) {
+    if (!FLAGS_enable_auto_tuning) {
+      cost_queue_.emplace(trajectory_pairs[i], costs[i]);
+    } else {
+      cost_queue_with_components_.emplace(
+          trajectory_pairs[i],
+          CostComponentsPair(std::move(cost_components[i]), costs[i]));
     }
   }
   if (!FLAGS_enable_auto_tuning) {
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/lattice/trajectory_generation/trajectory_evaluator.h"
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/lattice/trajectory1d/lattice_trajectory1d.h"
+#include "modules/planning/math/curve1d/quartic_polynomial_curve1d.h"
+#include "modules/planning/math/curve1d/quintic_polynomial_curve1d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+
+namespace {
+
+struct EvaluatedPair {
+  std::pair<std::shared_ptr<Curve1d>, std::shared_ptr<Curve1d>>
+      trajectory_pair;
+  double cost = 0.0;
+  std::vector<double> cost_components;
+};
+
+class TrajectoryEvaluatorTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    // A reference line along a circle with a radius of 100 meters.
+    const double kappa = 0.01;
+    reference_line_ = std::make_shared<std::vector<PathPoint>>();
+    for (double s = 0.0; s < 300.0; s += 1.0) {
+      PathPoint point;
+      point.set_x(std::sin(s * kappa) / kappa);
+      point.set_y((1.0 - std::cos(s * kappa)) / kappa);
+      point.set_theta(s * kappa);
+      point.set_kappa(kappa);
+      point.set_s(s);
+      reference_line_->push_back(point);
+    }
+    path_time_graph_ = std::make_shared<PathTimeGraph>(
+        std::vector<const Obstacle*>(), *reference_line_, nullptr, 0.0, 200.0,
+        0.0, FLAGS_trajectory_time_length, init_d_);
+
+    // Cruising and stopping speed profiles, as the lattice planner samples.
+    for (double t = 1.0; t <= FLAGS_trajectory_time_length; t += 1.0) {
+      for (double v = 0.0; v <= 20.0; v += 2.5) {
+        lon_trajectories_.emplace_back(
+            new LatticeTrajectory1d(std::make_shared<QuarticPolynomialCurve1d>(
+                init_s_, std::array<double, 2>{{v, 0.0}}, t)));
+      }
+    }
+    for (double s = 10.0; s <= 80.0; s += 10.0) {
+      for (double d = -0.5; d <= 0.5; d += 0.25) {
+        lat_trajectories_.emplace_back(
+            new LatticeTrajectory1d(std::make_shared<QuinticPolynomialCurve1d>(
+                init_d_, std::array<double, 3>{{d, 0.0, 0.0}}, s)));
+      }
+    }
+
+    planning_target_.set_cruise_speed(12.0);
+  }
+
+ protected:
+  // Returns the trajectory pairs in the order the lattice planner takes them.
+  std::vector<EvaluatedPair> EvaluateAll() const {
+    TrajectoryEvaluator trajectory_evaluator(
+        init_s_, planning_target_, lon_trajectories_, lat_trajectories_,
+        path_time_graph_, reference_line_);
+    std::vector<EvaluatedPair> evaluated_pairs;
+    while (trajectory_evaluator.has_more_trajectory_pairs()) {
+      EvaluatedPair evaluated_pair;
+      evaluated_pair.cost = trajectory_evaluator.top_trajectory_pair_cost();
+      if (FLAGS_enable_auto_tuning) {
+        evaluated_pair.cost_components =
+            trajectory_evaluator.top_trajectory_pair_component_cost();
+      }
+      evaluated_pair.trajectory_pair =
+          trajectory_evaluator.next_top_trajectory_pair();
+      evaluated_pairs.push_back(std::move(evaluated_pair));
+    }
+    return evaluated_pairs;
+  }
+
+  void ExpectSameOrderInMultipleThreads() const {
+    FLAGS_enable_multi_thread_in_lattice_evaluation = false;
+    const auto expected = EvaluateAll();
+    ASSERT_GT(expected.size(), 1);
+
+    FLAGS_enable_multi_thread_in_lattice_evaluation = true;
+    for (int repeat = 0; repeat < 10; ++repeat) {
+      const auto actual = EvaluateAll();
+      ASSERT_EQ(expected.size(), actual.size());
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].trajectory_pair, actual[i].trajectory_pair)
+            << "pair " << i;
+        EXPECT_EQ(expected[i].cost, actual[i].cost) << "pair " << i;
+        EXPECT_EQ(expected[i].cost_components, actual[i].cost_components)
+            << "pair " << i;
+      }
+    }
+  }
+
+  std::array<double, 3> init_s_ = {{0.0, 10.0, 0.0}};
+  std::array<double, 3> init_d_ = {{0.3, 0.0, 0.0}};
+  PlanningTarget planning_target_;
+  std::shared_ptr<std::vector<PathPoint>> reference_line_;
+  std::shared_ptr<PathTimeGraph> path_time_graph_;
+  std::vector<std::shared_ptr<Curve1d>> lon_trajectories_;
+  std::vector<std::shared_ptr<Curve1d>> lat_trajectories_;
+};
+
+}  // namespace
+
+TEST_F(TrajectoryEvaluatorTest, MultiThreadKeepsPairOrder) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_auto_tuning = false;
+  ExpectSameOrderInMultipleThreads();
+}
+
+TEST_F(TrajectoryEvaluatorTest, MultiThreadKeepsPairOrderWithComponents) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_auto_tuning = true;
+  ExpectSameOrderInMultipleThreads();
+}
+
+TEST_F(TrajectoryEvaluatorTest, MultiThreadKeepsPairOrderWithStopPoint) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_auto_tuning = false;
+  planning_target_.mutable_stop_point()->set_s(60.0);
+  ExpectSameOrderInMultipleThreads();
+}
+
+}  // namespace planning
+}  // namespace apollo
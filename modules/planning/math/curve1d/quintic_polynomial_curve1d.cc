@@ -86,6 +86,55 @@ double QuinticPolynomialCurve1d::Evaluate(const uint32_t order,
   }
 }
 
+void QuinticPolynomialCurve1d::Evaluate(const std::uint32_t order,
+                                        const double* params,
+                                        const std::size_t num_params,
+                                        double* values) const {
+  // The order is dispatched once, so the loops below have no branches.
+  switch (order) {
+    case 0: {
+      for (std::size_t i = 0; i < num_params; ++i) {
+        const double p = params[i];
+        values[i] = ((((coef_[5] * p + coef_[4]) * p + coef_[3]) * p +
+                      coef_[2]) *
+                         p +
+                     coef_[1]) *
+                        p +
+                    coef_[0];
+      }
+      break;
+    }
+    case 1: {
+      for (std::size_t i = 0; i < num_params; ++i) {
+        const double p = params[i];
+        values[i] = (((5.0 * coef_[5] * p + 4.0 * coef_[4]) * p +
+                      3.0 * coef_[3]) *
+                         p +
+                     2.0 * coef_[2]) *
+                        p +
+                    coef_[1];
+      }
+      break;
+    }
+    case 2: {
+      for (std::size_t i = 0; i < num_params; ++i) {
+        const double p = params[i];
+        values[i] =
+            (((20.0 * coef_[5] * p + 12.0 * coef_[4]) * p) + 6.0 * coef_[3]) *
+                p +
+            2.0 * coef_[2];
+      }
+      break;
+    }
+    default: {
+      for (std::size_t i = 0; i < num_params; ++i) {
+        values[i] = Evaluate(order, params[i]);
+      }
+      break;
+    }
+  }
+}
+
 void QuinticPolynomialCurve1d::ComputeCoefficients(
     const double x0, const double dx0, const double ddx0, const double x1,
     const double dx1, const double ddx1, const double p) {
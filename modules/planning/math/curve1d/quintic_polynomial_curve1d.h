@@ -22,6 +22,7 @@
 #define MODULES_PLANNING_MATH_CURVE1D_QUINTIC_POLYNOMIAL_CURVE1D_H_
 
 #include <array>
+#include <cstddef>
 #include <string>
 
 #include "modules/planning/math/curve1d/polynomial_curve1d.h"
@@ -49,6 +50,11 @@ class QuinticPolynomialCurve1d : public PolynomialCurve1d {
 
   double Evaluate(const std::uint32_t order, const double p) const override;
 
+  // Evaluates the curve at num_params params at once, with the same results
+  // as Evaluate() at each of them.
+  void Evaluate(const std::uint32_t order, const double* params,
+                const std::size_t num_params, double* values) const;
+
   double ParamLength() const { return param_; }
   std::string ToString() const override;
 
@@ -16,6 +16,8 @@
 
 #include "modules/planning/math/curve1d/quintic_polynomial_curve1d.h"
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace apollo {
@@ -54,5 +56,17 @@ TEST(QuinticPolynomialCurve1dTest, basic_test) {
   EXPECT_NEAR(t, e_t, 1.0e-6);
 }
 
+TEST(QuinticPolynomialCurve1dTest, batch_evaluate) {
+  QuinticPolynomialCurve1d curve(0.5, 0.1, -0.02, -1.5, 0.0, 0.0, 20.0);
+  const std::vector<double> params = {0.0, 0.3, 1.0, 7.7, 13.1, 19.9, 20.0};
+  std::vector<double> values(params.size());
+  for (std::uint32_t order = 0; order <= 3; ++order) {
+    curve.Evaluate(order, params.data(), params.size(), values.data());
+    for (std::size_t i = 0; i < params.size(); ++i) {
+      EXPECT_DOUBLE_EQ(curve.Evaluate(order, params[i]), values[i]);
+    }
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -84,6 +84,22 @@ bool Spline1dGenerator::Solve() {
     return false;
   }
 
+  if (FLAGS_enable_sparse_spline_qp_solver) {
+    const double start_timestamp = Clock::NowInSeconds();
+    if (!admm_solver_.SolveAffine(
+            kernel_matrix, offset, inequality_constraint_matrix,
+            inequality_constraint_boundary, equality_constraint_matrix,
+            equality_constraint_boundary, -kMaxBound, kMaxBound,
+            kMaxBound)) {
+      AERROR << "Sparse QP solver failed to solve spline 1d.";
+      return false;
+    }
+    ADEBUG << "Spline1dGenerator sparse QP solve time: "
+           << (Clock::NowInSeconds() - start_timestamp) * 1000 << " ms.";
+    return spline_.SetSplineSegs(admm_solver_.primal_solution(),
+                                 spline_.spline_order());
+  }
+
   int num_param = kernel_matrix.rows();
   int num_constraint =
       equality_constraint_matrix.rows() + inequality_constraint_matrix.rows();
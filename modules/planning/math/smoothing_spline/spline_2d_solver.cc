@@ -51,6 +51,7 @@ void Spline2dSolver::Reset(const std::vector<double>& t_knots,
   spline_ = Spline2d(t_knots, order);
   kernel_ = Spline2dKernel(t_knots, order);
   constraint_ = Spline2dConstraint(t_knots, order);
+  initial_guess_.resize(0, 0);
 }
 
 // customize setup
@@ -62,6 +63,10 @@ Spline2dKernel* Spline2dSolver::mutable_kernel() { return &kernel_; }
 
 Spline2d* Spline2dSolver::mutable_spline() { return &spline_; }
 
+void Spline2dSolver::SetInitialGuess(const MatrixXd& params) {
+  initial_guess_ = params;
+}
+
 bool Spline2dSolver::Solve() {
   const MatrixXd& kernel_matrix = kernel_.kernel_matrix();
   const MatrixXd& offset = kernel_.offset();
@@ -81,6 +86,22 @@ bool Spline2dSolver::Solve() {
     return false;
   }
 
+  if (FLAGS_enable_sparse_spline_qp_solver) {
+    const double start_timestamp = Clock::NowInSeconds();
+    if (!admm_solver_.SolveAffine(
+            kernel_matrix, offset, inequality_constraint_matrix,
+            inequality_constraint_boundary, equality_constraint_matrix,
+            equality_constraint_boundary, -kRoadBound, kRoadBound,
+            kRoadBound)) {
+      AERROR << "Sparse QP solver failed to solve spline 2d.";
+      return false;
+    }
+    ADEBUG << "Spline2dSolver sparse QP solve time: "
+           << (Clock::NowInSeconds() - start_timestamp) * 1000 << " ms.";
+    return spline_.set_splines(admm_solver_.primal_solution(),
+                               spline_.spline_order());
+  }
+
   int num_param = kernel_matrix.rows();
   int num_constraint =
       equality_constraint_matrix.rows() + inequality_constraint_matrix.rows();
@@ -192,6 +213,12 @@ bool Spline2dSolver::Solve() {
                               lower_bound, upper_bound, constraint_lower_bound,
                               constraint_upper_bound, max_iter);
     }
+  } else if (initial_guess_.rows() == kernel_matrix.rows()) {
+    ADEBUG << "Spline2dSolver is using the initial guess.";
+    ret = sqp_solver_->init(h_matrix, g_matrix, affine_constraint_matrix,
+                            lower_bound, upper_bound, constraint_lower_bound,
+                            constraint_upper_bound, max_iter, nullptr,
+                            initial_guess_.data());
   } else {
     ADEBUG << "Spline2dSolver is NOT using SQP hotstart.";
     ret = sqp_solver_->init(h_matrix, g_matrix, affine_constraint_matrix,
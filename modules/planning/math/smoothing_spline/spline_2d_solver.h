@@ -26,6 +26,7 @@
 #include <memory>
 #include <vector>
 
+#include "modules/common/math/qp_solver/admm_qp_solver.h"
 #include "modules/common/math/qp_solver/qp_solver.h"
 #include "modules/planning/math/smoothing_spline/spline_2d.h"
 #include "modules/planning/math/smoothing_spline/spline_2d_constraint.h"
@@ -45,6 +46,11 @@ class Spline2dSolver {
   Spline2dKernel* mutable_kernel();
   Spline2d* mutable_spline();
 
+  // guess of the spline parameters to start the next qpOASES Solve() from,
+  // which is cleared by Reset(). The sparse solver warm starts from its own
+  // previous solution instead.
+  void SetInitialGuess(const Eigen::MatrixXd& params);
+
   // solve
   bool Solve();
 
@@ -56,6 +62,9 @@ class Spline2dSolver {
   Spline2dKernel kernel_;
   Spline2dConstraint constraint_;
   std::unique_ptr<::qpOASES::SQProblem> sqp_solver_;
+  // Used instead of sqp_solver_ if FLAGS_enable_sparse_spline_qp_solver.
+  common::math::AdmmQpSolver admm_solver_;
+  Eigen::MatrixXd initial_guess_;
 
   int last_num_constraint_ = 0;
   int last_num_param_ = 0;
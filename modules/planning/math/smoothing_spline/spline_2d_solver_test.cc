@@ -21,6 +21,7 @@
 
 #include "gtest/gtest.h"
 
+#include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/math/curve_math.h"
 
 namespace apollo {
@@ -148,5 +149,80 @@ TEST(constraint_test, test_suit_one) {
   }
 }
 
+TEST(constraint_test, sparse_solver) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_sparse_spline_qp_solver = true;
+  std::vector<double> t_knots{0, 1, 2, 3, 4, 5};
+  std::size_t order = 5;
+  Spline2dSolver spline_solver(t_knots, order);
+
+  Spline2dConstraint* constraint = spline_solver.mutable_constraint();
+  Spline2dKernel* kernel = spline_solver.mutable_kernel();
+
+  // The points of test_suit_one, relative to the first one as in
+  // QpSplineReferenceLineSmoother.
+  std::vector<double> et{0, 0.5, 1, 1.5, 2, 2.5, 3, 3.5, 4, 4.5, 5};
+  std::vector<double> bound(11, 0.2);
+  std::vector<std::vector<double>> constraint_data{
+      {-1.211566924, 0.0, 0.0},        {-1.211572116, 1.904, -5.07},
+      {-1.21157766, 3.8079, -10.14},   {-1.211571616, 5.7118, -15.21},
+      {-1.21155227, 7.6158, -20.28},   {-1.211532017, 9.5199, -25.35},
+      {-1.21155775, 11.4239, -30.42},  {-1.211634014, 13.3278, -35.491},
+      {-1.211698593, 15.2312, -40.561}, {-1.211576177, 17.1347, -45.631},
+      {-1.211256197, 19.0393, -50.701}};
+  std::vector<double> angle;
+  std::vector<Vec2d> ref_point;
+  for (const auto& data : constraint_data) {
+    angle.push_back(data[0]);
+    ref_point.emplace_back(data[1], data[2]);
+  }
+
+  EXPECT_TRUE(constraint->Add2dBoundary(et, angle, ref_point, bound, bound));
+  EXPECT_TRUE(constraint->AddThirdDerivativeSmoothConstraint());
+  kernel->AddThirdOrderDerivativeMatrix(100);
+  kernel->AddRegularization(0.1);
+  EXPECT_TRUE(spline_solver.Solve());
+
+  for (std::size_t i = 0; i < et.size(); ++i) {
+    const auto xy = spline_solver.spline()(et[i]);
+    const double dx = xy.first - ref_point[i].x();
+    const double dy = xy.second - ref_point[i].y();
+    const double longitudinal =
+        dx * std::cos(angle[i]) + dy * std::sin(angle[i]);
+    const double lateral = -dx * std::sin(angle[i]) + dy * std::cos(angle[i]);
+    EXPECT_LE(std::fabs(longitudinal), bound[i] + 1e-4);
+    EXPECT_LE(std::fabs(lateral), bound[i] + 1e-4);
+  }
+}
+
+TEST(constraint_test, sparse_solver_with_active_bounds) {
+  google::FlagSaver flag_saver;
+  // min x0^2 + x1^2 - 4e10 * (x0 + x1) with 2 * x1 >= 0. Without bounds the
+  // solution is x0 = x1 = 2e10. Both solvers bound every parameter to
+  // [-1e10, 1e10], and the inequality constraint from above by 1e10, which
+  // give x0 = 1e10 and x1 = 5e9.
+  std::vector<double> x_at_end;
+  for (const bool sparse : {false, true}) {
+    FLAGS_enable_sparse_spline_qp_solver = sparse;
+    Spline2dSolver spline_solver({0.0, 1.0}, 1);
+    Spline2dKernel* kernel = spline_solver.mutable_kernel();
+    kernel->AddRegularization(1.0);
+    (*kernel->mutable_offset())(0, 0) = -4e10;
+    (*kernel->mutable_offset())(1, 0) = -4e10;
+    MatrixXd inequality_matrix = MatrixXd::Zero(1, 4);
+    inequality_matrix(0, 1) = 2.0;
+    EXPECT_TRUE(spline_solver.mutable_constraint()->AddInequalityConstraint(
+        inequality_matrix, MatrixXd::Zero(1, 1)));
+    EXPECT_TRUE(spline_solver.Solve());
+
+    const auto& spline = spline_solver.spline();
+    EXPECT_NEAR(1e10, spline(0.0).first, 1e4);
+    EXPECT_NEAR(1.5e10, spline(1.0).first, 1e4);
+    EXPECT_NEAR(0.0, spline(1.0).second, 1e-2);
+    x_at_end.push_back(spline(1.0).first);
+  }
+  EXPECT_NEAR(x_at_end[0], x_at_end[1], 1e4);
+}
+
 }  // namespace planning
 }  // namespace apollo
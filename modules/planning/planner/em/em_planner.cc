@@ -16,9 +16,15 @@
 
 #include "modules/planning/planner/em/em_planner.h"
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include "modules/planning/proto/planning_status.pb.h"
 
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/log.h"
@@ -26,11 +32,13 @@
 #include "modules/common/time/time.h"
 #include "modules/common/util/string_tokenizer.h"
 #include "modules/common/util/string_util.h"
+#include "modules/common/util/task_scheduler.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/map/hdmap/hdmap.h"
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/planning/common/frame.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/common/planning_util.h"
 #include "modules/planning/constraint_checker/constraint_checker.h"
 #include "modules/planning/tasks/dp_poly_path/dp_poly_path_optimizer.h"
 #include "modules/planning/tasks/dp_st_speed/dp_st_speed_optimizer.h"
@@ -56,6 +64,16 @@ namespace {
 constexpr double kPathOptimizationFallbackClost = 2e4;
 constexpr double kSpeedOptimizationFallbackClost = 2e4;
 constexpr double kStraightForwardLineCost = 10.0;
+
+// Identifies a reference line across planning cycles by the id of its route
+// segments, or by their first lane if they have no id.
+std::string ReferenceLineKey(const ReferenceLineInfo& reference_line_info) {
+  const auto& segments = reference_line_info.Lanes();
+  if (!segments.Id().empty() || segments.empty()) {
+    return segments.Id();
+  }
+  return segments.front().lane->id().id();
+}
 }  // namespace
 
 void EMPlanner::RegisterTasks() {
@@ -77,13 +95,20 @@ void EMPlanner::RegisterTasks() {
 Status EMPlanner::Init(const PlanningConfig& config) {
   AINFO << "In EMPlanner::Init()";
   RegisterTasks();
-  for (const auto task : config.em_planner_config().task()) {
-    tasks_.emplace_back(
+  config_ = config;
+  tasks_.clear();
+  task_chains_.clear();
+  return CreateTasks(&tasks_);
+}
+
+Status EMPlanner::CreateTasks(std::vector<std::unique_ptr<Task>>* const tasks) {
+  for (const auto task : config_.em_planner_config().task()) {
+    tasks->emplace_back(
         task_factory_.CreateObject(static_cast<TaskType>(task)));
-    AINFO << "Created task:" << tasks_.back()->Name();
+    AINFO << "Created task:" << tasks->back()->Name();
   }
-  for (auto& task : tasks_) {
-    if (!task->Init(config)) {
+  for (auto& task : *tasks) {
+    if (!task->Init(config_)) {
       std::string msg(
           common::util::StrCat("Init task[", task->Name(), "] failed."));
       AERROR << msg;
@@ -146,7 +171,23 @@ Status EMPlanner::Plan(const TrajectoryPoint& planning_start_point,
   bool disable_low_priority_path = false;
   auto status =
       Status(ErrorCode::PLANNING_ERROR, "reference line not drivable");
+  // The pull over status is shared by all the reference lines, so it is set
+  // here before they are planned, possibly concurrently.
+  auto* planning_state = util::GetPlanningStatus()->mutable_planning_state();
+  if (planning_state->has_pull_over() &&
+      planning_state->pull_over().in_pull_over()) {
+    planning_state->mutable_pull_over()->set_status(
+        PullOverStatus::IN_OPERATION);
+  }
+  // The concurrently planned reference lines are then picked in the same
+  // order as the serially planned ones.
+  std::vector<Status> statuses;
+  if (FLAGS_enable_multi_thread_in_em_planner) {
+    statuses = PlanOnReferenceLinesConcurrently(planning_start_point, frame);
+  }
+  std::size_t index = 0;
   for (auto& reference_line_info : frame->reference_line_info()) {
+    const std::size_t reference_line_index = index++;
     if (disable_low_priority_path) {
       reference_line_info.SetDrivable(false);
     }
@@ -154,7 +195,10 @@ Status EMPlanner::Plan(const TrajectoryPoint& planning_start_point,
       continue;
     }
     auto cur_status =
-        PlanOnReferenceLine(planning_start_point, frame, &reference_line_info);
+        statuses.empty()
+            ? PlanOnReferenceLine(planning_start_point, frame,
+                                  &reference_line_info)
+            : statuses[reference_line_index];
     if (cur_status.ok() && reference_line_info.IsDrivable()) {
       has_drivable_reference_line = true;
       if (FLAGS_prioritize_change_lane &&
@@ -169,9 +213,70 @@ Status EMPlanner::Plan(const TrajectoryPoint& planning_start_point,
   return has_drivable_reference_line ? Status::OK() : status;
 }
 
+std::vector<Status> EMPlanner::PlanOnReferenceLinesConcurrently(
+    const TrajectoryPoint& planning_start_point, Frame* frame) {
+  std::vector<Status> statuses(frame->reference_line_info().size(),
+                               Status(ErrorCode::PLANNING_ERROR,
+                                      "reference line not drivable"));
+  struct DrivableLine {
+    std::size_t index;
+    ReferenceLineInfo* reference_line_info;
+    const std::vector<std::unique_ptr<Task>>* tasks;
+  };
+  std::vector<DrivableLine> drivable_lines;
+  std::unordered_map<std::string, std::vector<std::unique_ptr<Task>>>
+      task_chains;
+  std::size_t index = 0;
+  for (auto& reference_line_info : frame->reference_line_info()) {
+    const std::size_t reference_line_index = index++;
+    if (!reference_line_info.IsDrivable()) {
+      continue;
+    }
+    // Lines sharing a key in one cycle still get a chain each.
+    std::string key = ReferenceLineKey(reference_line_info);
+    while (task_chains.count(key) > 0) {
+      key += "+";
+    }
+    auto& tasks = task_chains[key];
+    auto iter = task_chains_.find(key);
+    if (iter != task_chains_.end()) {
+      tasks = std::move(iter->second);
+    } else {
+      const auto status = CreateTasks(&tasks);
+      if (!status.ok()) {
+        // Some chains are moved out already, so they are all created again.
+        task_chains_.clear();
+        std::fill(statuses.begin(), statuses.end(), status);
+        return statuses;
+      }
+    }
+    drivable_lines.push_back({reference_line_index, &reference_line_info,
+                              &tasks});
+  }
+  // The chains of the lines which are gone are dropped.
+  task_chains_ = std::move(task_chains);
+
+  common::util::ParallelFor(
+      0, drivable_lines.size(), 1, [&](const std::size_t i) {
+        const auto& line = drivable_lines[i];
+        statuses[line.index] =
+            PlanOnReferenceLine(planning_start_point, frame,
+                                line.reference_line_info, *line.tasks);
+      });
+  return statuses;
+}
+
 Status EMPlanner::PlanOnReferenceLine(
     const TrajectoryPoint& planning_start_point, Frame* frame,
     ReferenceLineInfo* reference_line_info) {
+  return PlanOnReferenceLine(planning_start_point, frame, reference_line_info,
+                             tasks_);
+}
+
+Status EMPlanner::PlanOnReferenceLine(
+    const TrajectoryPoint& planning_start_point, Frame* frame,
+    ReferenceLineInfo* reference_line_info,
+    const std::vector<std::unique_ptr<Task>>& tasks) {
   if (!reference_line_info->IsChangeLanePath()) {
     reference_line_info->AddCost(kStraightForwardLineCost);
   }
@@ -187,7 +292,7 @@ Status EMPlanner::PlanOnReferenceLine(
 
   auto ret = Status::OK();
 
-  for (auto& optimizer : tasks_) {
+  for (auto& optimizer : tasks) {
     const double start_timestamp = Clock::NowInSeconds();
     ret = optimizer->Execute(frame, reference_line_info);
     if (!ret.ok()) {
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "modules/common/proto/pnc_point.pb.h"
@@ -84,6 +85,20 @@ class EMPlanner : public Planner {
  private:
   void RegisterTasks();
 
+  common::Status CreateTasks(std::vector<std::unique_ptr<Task>>* const tasks);
+
+  common::Status PlanOnReferenceLine(
+      const common::TrajectoryPoint& planning_init_point, Frame* frame,
+      ReferenceLineInfo* reference_line_info,
+      const std::vector<std::unique_ptr<Task>>& tasks);
+
+  /**
+   * @brief Plans on all the drivable reference lines concurrently.
+   * @return The status of each reference line, in order.
+   */
+  std::vector<common::Status> PlanOnReferenceLinesConcurrently(
+      const common::TrajectoryPoint& planning_init_point, Frame* frame);
+
   std::vector<common::SpeedPoint> GenerateInitSpeedProfile(
       const common::TrajectoryPoint& planning_init_point,
       const ReferenceLineInfo* reference_line_info);
@@ -116,8 +131,14 @@ class EMPlanner : public Planner {
   void RecordDebugInfo(ReferenceLineInfo* reference_line_info,
                        const std::string& name, const double time_diff_ms);
 
+  PlanningConfig config_;
   apollo::common::util::Factory<TaskType, Task> task_factory_;
   std::vector<std::unique_ptr<Task>> tasks_;
+  // The tasks keep the state of the reference line they run on, so each
+  // reference line planned concurrently has its own chain of tasks, kept
+  // across cycles under the key of its route segments.
+  std::unordered_map<std::string, std::vector<std::unique_ptr<Task>>>
+      task_chains_;
 };
 
 }  // namespace planning
@@ -32,6 +32,7 @@
 #include "modules/common/math/cartesian_frenet_conversion.h"
 #include "modules/common/math/path_matcher.h"
 #include "modules/common/time/time.h"
+#include "modules/common/util/task_scheduler.h"
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/constraint_checker/collision_checker.h"
 #include "modules/planning/constraint_checker/constraint_checker.h"
@@ -57,6 +58,18 @@ using apollo::common::time::Clock;
 
 namespace {
 
+// A pair of 1d trajectories, and the results of checking its combined
+// trajectory.
+struct TrajectoryPairCandidate {
+  std::pair<std::shared_ptr<Curve1d>, std::shared_ptr<Curve1d>>
+      trajectory_pair;
+  double cost = 0.0;
+  std::vector<double> cost_components;
+  DiscretizedTrajectory combined_trajectory;
+  ConstraintChecker::Result result = ConstraintChecker::Result::VALID;
+  bool in_collision = false;
+};
+
 std::vector<PathPoint> ToDiscretizedReferenceLine(
     const std::vector<ReferencePoint>& ref_points) {
   double s = 0.0;
@@ -232,65 +245,108 @@ Status LatticePlanner::PlanOnReferenceLine(
 
   std::size_t num_lattice_traj = 0;
 
+  // In multiple threads, the best pairs are combined and checked
+  // speculatively at a time, and the first feasible one in the order of cost
+  // is taken as in a single thread.
+  const std::size_t num_pairs_per_round =
+      FLAGS_enable_multi_thread_in_lattice_evaluation
+          ? static_cast<std::size_t>(
+                std::max(FLAGS_num_speculative_lattice_trajectory_pairs, 1))
+          : 1;
   while (trajectory_evaluator.has_more_trajectory_pairs()) {
-    double trajectory_pair_cost =
-        trajectory_evaluator.top_trajectory_pair_cost();
-    // For auto tuning
-    std::vector<double> trajectory_pair_cost_components;
-    if (FLAGS_enable_auto_tuning) {
-      trajectory_pair_cost_components =
-          trajectory_evaluator.top_trajectory_pair_component_cost();
-      ADEBUG << "TrajectoryPairComponentCost";
-      ADEBUG << "travel_cost = " << trajectory_pair_cost_components[0];
-      ADEBUG << "jerk_cost = " << trajectory_pair_cost_components[1];
-      ADEBUG << "obstacle_cost = " << trajectory_pair_cost_components[2];
-      ADEBUG << "lateral_cost = " << trajectory_pair_cost_components[3];
-    }
-    auto trajectory_pair = trajectory_evaluator.next_top_trajectory_pair();
-
-    // combine two 1d trajectories to one 2d trajectory
-    auto combined_trajectory = TrajectoryCombiner::Combine(
-        *ptr_reference_line, *trajectory_pair.first, *trajectory_pair.second,
-        planning_init_point.relative_time());
-
-    // check longitudinal and lateral acceleration
-    // considering trajectory curvatures
-    auto result = ConstraintChecker::ValidTrajectory(combined_trajectory);
-    if (result != ConstraintChecker::Result::VALID) {
-      ++combined_constraint_failure_count;
-
-      switch (result) {
-      case ConstraintChecker::Result::LON_VELOCITY_OUT_OF_BOUND:
-        lon_vel_failure_count += 1;
-        break;
-      case ConstraintChecker::Result::LON_ACCELERATION_OUT_OF_BOUND:
-        lon_acc_failure_count += 1;
-        break;
-      case ConstraintChecker::Result::LON_JERK_OUT_OF_BOUND:
-        lon_jerk_failure_count += 1;
-        break;
-      case ConstraintChecker::Result::CURVATURE_OUT_OF_BOUND:
-        curvature_failure_count += 1;
-        break;
-      case ConstraintChecker::Result::LAT_ACCELERATION_OUT_OF_BOUND:
-        lat_acc_failure_count += 1;
-        break;
-      case ConstraintChecker::Result::LAT_JERK_OUT_OF_BOUND:
-        lat_jerk_failure_count += 1;
-        break;
-      case ConstraintChecker::Result::VALID:
-      default:
-        // Intentional empty
-        break;
+    std::vector<TrajectoryPairCandidate> candidates;
+    while (candidates.size() < num_pairs_per_round &&
+           trajectory_evaluator.has_more_trajectory_pairs()) {
+      candidates.emplace_back();
+      auto& candidate = candidates.back();
+      candidate.cost = trajectory_evaluator.top_trajectory_pair_cost();
+      // For auto tuning
+      if (FLAGS_enable_auto_tuning) {
+        candidate.cost_components =
+            trajectory_evaluator.top_trajectory_pair_component_cost();
+        ADEBUG << "TrajectoryPairComponentCost";
+        ADEBUG << "travel_cost = " << candidate.cost_components[0];
+        ADEBUG << "jerk_cost = " << candidate.cost_components[1];
+        ADEBUG << "obstacle_cost = " << candidate.cost_components[2];
+        ADEBUG << "lateral_cost = " << candidate.cost_components[3];
       }
-      continue;
+      candidate.trajectory_pair =
+          trajectory_evaluator.next_top_trajectory_pair();
+    }
+
+    auto check_candidate = [&](const std::size_t i) {
+      auto& candidate = candidates[i];
+      // combine two 1d trajectories to one 2d trajectory
+      candidate.combined_trajectory = TrajectoryCombiner::Combine(
+          *ptr_reference_line, *candidate.trajectory_pair.first,
+          *candidate.trajectory_pair.second,
+          planning_init_point.relative_time());
+
+      // check longitudinal and lateral acceleration
+      // considering trajectory curvatures
+      candidate.result =
+          ConstraintChecker::ValidTrajectory(candidate.combined_trajectory);
+
+      // check collision with other obstacles
+      candidate.in_collision =
+          candidate.result == ConstraintChecker::Result::VALID &&
+          collision_checker.InCollision(candidate.combined_trajectory);
+    };
+    if (candidates.size() > 1) {
+      common::util::ParallelFor(0, candidates.size(), 1, check_candidate);
+    } else {
+      check_candidate(0);
     }
 
-    // check collision with other obstacles
-    if (collision_checker.InCollision(combined_trajectory)) {
-      ++collision_failure_count;
+    // The failures of the candidates after the first feasible one are not
+    // counted, as they would not have been checked in a single thread.
+    TrajectoryPairCandidate* feasible_candidate = nullptr;
+    for (auto& candidate : candidates) {
+      if (candidate.result != ConstraintChecker::Result::VALID) {
+        ++combined_constraint_failure_count;
+
+        switch (candidate.result) {
+        case ConstraintChecker::Result::LON_VELOCITY_OUT_OF_BOUND:
+          lon_vel_failure_count += 1;
+          break;
+        case ConstraintChecker::Result::LON_ACCELERATION_OUT_OF_BOUND:
+          lon_acc_failure_count += 1;
+          break;
+        case ConstraintChecker::Result::LON_JERK_OUT_OF_BOUND:
+          lon_jerk_failure_count += 1;
+          break;
+        case ConstraintChecker::Result::CURVATURE_OUT_OF_BOUND:
+          curvature_failure_count += 1;
+          break;
+        case ConstraintChecker::Result::LAT_ACCELERATION_OUT_OF_BOUND:
+          lat_acc_failure_count += 1;
+          break;
+        case ConstraintChecker::Result::LAT_JERK_OUT_OF_BOUND:
+          lat_jerk_failure_count += 1;
+          break;
+        case ConstraintChecker::Result::VALID:
+        default:
+          // Intentional empty
+          break;
+        }
+        continue;
+      }
+
+      if (candidate.in_collision) {
+        ++collision_failure_count;
+        continue;
+      }
+      feasible_candidate = &candidate;
+      break;
+    }
+    if (feasible_candidate == nullptr) {
       continue;
     }
+    const auto& trajectory_pair = feasible_candidate->trajectory_pair;
+    const auto& combined_trajectory = feasible_candidate->combined_trajectory;
+    const double trajectory_pair_cost = feasible_candidate->cost;
+    const auto& trajectory_pair_cost_components =
+        feasible_candidate->cost_components;
 
     // put combine trajectory into debug data
     const auto& combined_trajectory_points =
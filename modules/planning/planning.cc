@@ -28,7 +28,6 @@
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/planning_gflags.h"
-#include "modules/planning/common/planning_thread_pool.h"
 #include "modules/planning/common/planning_util.h"
 #include "modules/planning/common/trajectory/trajectory_stitcher.h"
 #include "modules/planning/planner/em/em_planner.h"
@@ -79,7 +78,8 @@ Status Planning::InitFrame(const uint32_t sequence_num,
                            const double start_time,
                            const VehicleState& vehicle_state) {
   frame_.reset(new Frame(sequence_num, planning_start_point, start_time,
-                         vehicle_state, reference_line_provider_.get()));
+                         vehicle_state, reference_line_provider_.get(),
+                         hdmap_));
   auto status = frame_->Init();
   if (!status.ok()) {
     AERROR << "failed to init frame:" << status.ToString();
@@ -132,9 +132,6 @@ Status Planning::Init() {
       << "Failed to load traffic rule config file "
       << FLAGS_traffic_rule_config_filename;
 
-  // initialize planning thread pool
-  PlanningThreadPool::instance()->Init();
-
   // clear planning status
   util::GetPlanningStatus()->Clear();
 
@@ -152,7 +149,7 @@ Status Planning::Init() {
   CHECK_ADAPTER(TrafficLightDetection);
 
   if (!FLAGS_use_navigation_mode) {
-    hdmap_ = HDMapUtil::BaseMapPtr();
+    hdmap_ = HDMapUtil::BaseMapSnapshot();
     CHECK(hdmap_) << "Failed to load map";
     // Prefer "std::make_unique" to direct use of "new".
     // Reference "https://herbsutter.com/gotw/_102/" for details.
@@ -240,6 +237,18 @@ void Planning::RunOnce() {
 
   const double start_timestamp = Clock::NowInSeconds();
 
+  // Move the tiled base map, if any, along with the ego vehicle.
+  if (!FLAGS_use_navigation_mode &&
+      !AdapterManager::GetLocalization()->Empty()) {
+    const auto& localization =
+        AdapterManager::GetLocalization()->GetLatestObserved();
+    HDMapUtil::UpdateBaseMapPosition(localization.pose().position());
+  }
+  // Take one map snapshot for the whole cycle. The reference line provider,
+  // the frame and the traffic rules all use it, so a reload in the middle of
+  // the cycle does not make them see different maps.
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
+
   ADCTrajectory not_ready_pb;
   auto* not_ready = not_ready_pb.mutable_decision()
                         ->mutable_main_decision()
@@ -251,7 +260,7 @@ void Planning::RunOnce() {
   } else if (!FLAGS_use_navigation_mode &&
              AdapterManager::GetRoutingResponse()->Empty()) {
     not_ready->set_reason("routing not ready");
-  } else if (HDMapUtil::BaseMapPtr() == nullptr) {
+  } else if (hdmap == nullptr) {
     not_ready->set_reason("map not ready");
   }
   if (not_ready->has_reason()) {
@@ -262,11 +271,13 @@ void Planning::RunOnce() {
 
   if (FLAGS_use_navigation_mode) {
     // recreate reference line provider in every cycle
-    hdmap_ = HDMapUtil::BaseMapPtr();
     // Prefer "std::make_unique" to direct use of "new".
     // Reference "https://herbsutter.com/gotw/_102/" for details.
-    reference_line_provider_ = std::make_unique<ReferenceLineProvider>(hdmap_);
+    reference_line_provider_ = std::make_unique<ReferenceLineProvider>(hdmap);
+  } else {
+    reference_line_provider_->UpdateMap(hdmap);
   }
+  hdmap_ = hdmap;
 
   // localization
   const auto& localization =
@@ -428,6 +439,12 @@ void Planning::RunOnce() {
   ref_line_task->set_time_ms(reference_line_provider_->LastTimeDelay() *
                              1000.0);
   ref_line_task->set_name("ReferenceLineProvider");
+  if (FLAGS_enable_record_debug) {
+    trajectory_pb->mutable_debug()
+        ->mutable_planning_data()
+        ->mutable_reference_line_smoothing()
+        ->CopyFrom(reference_line_provider_->LastSmoothingDebug());
+  }
 
   if (!status.ok()) {
     status.Save(trajectory_pb->mutable_header()->mutable_status());
@@ -490,7 +507,6 @@ void Planning::SetFallbackTrajectory(ADCTrajectory* trajectory_pb) {
 
 void Planning::Stop() {
   AERROR << "Planning Stop is called";
-  // PlanningThreadPool::instance()->Stop();
   if (reference_line_provider_) {
     reference_line_provider_->Stop();
   }
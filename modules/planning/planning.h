@@ -137,7 +137,8 @@ class Planning : public apollo::common::ApolloApp {
 
   TrafficRuleConfigs traffic_rule_configs_;
 
-  const hdmap::HDMap* hdmap_ = nullptr;
+  // The map snapshot of the current planning cycle.
+  std::shared_ptr<const hdmap::HDMap> hdmap_;
 
   std::unique_ptr<Frame> frame_;
 
@@ -20,10 +20,13 @@
 #include "modules/planning/reference_line/qp_spline_reference_line_smoother.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <string>
 #include <utility>
 
+#include "Eigen/LU"
+
 #include "modules/common/proto/pnc_point.pb.h"
 
 #include "modules/common/log.h"
@@ -49,6 +52,8 @@ bool QpSplineReferenceLineSmoother::Smooth(
     const ReferenceLine& raw_reference_line,
     ReferenceLine* const smoothed_reference_line) {
   Clear();
+  const ReferenceLine* warm_start_reference_line = warm_start_reference_line_;
+  warm_start_reference_line_ = nullptr;
   const double kEpsilon = 1e-6;
   if (!Sampling()) {
     AERROR << "Fail to sample reference line smoother points!";
@@ -67,7 +72,13 @@ bool QpSplineReferenceLineSmoother::Smooth(
     return false;
   }
 
-  if (!Solve()) {
+  if (FLAGS_enable_reference_line_smoother_warm_start &&
+      warm_start_reference_line != nullptr) {
+    SetInitialGuess(raw_reference_line, *warm_start_reference_line);
+  }
+
+  const bool solved = Solve();
+  if (!solved) {
     AERROR << "Solve spline smoother problem failed";
   }
 
@@ -204,11 +215,69 @@ bool QpSplineReferenceLineSmoother::AddKernel() {
 
 bool QpSplineReferenceLineSmoother::Solve() { return spline_solver_->Solve(); }
 
+void QpSplineReferenceLineSmoother::SetInitialGuess(
+    const ReferenceLine& raw_reference_line,
+    const ReferenceLine& warm_start_reference_line) {
+  const uint32_t spline_order = config_.qp_spline().spline_order();
+  const uint32_t num_params = spline_order + 1;
+  const uint32_t num_splines = t_knots_.size() - 1;
+  const double start_s = anchor_points_.front().path_point.s();
+  const double scale = (anchor_points_.back().path_point.s() - start_s) /
+                       (t_knots_.back() - t_knots_.front());
+
+  // Each piece interpolates evenly spaced points of the guessed line.
+  Eigen::MatrixXd vandermonde(num_params, num_params);
+  for (uint32_t i = 0; i < num_params; ++i) {
+    const double t = static_cast<double>(i) / spline_order;
+    double power = 1.0;
+    for (uint32_t j = 0; j < num_params; ++j) {
+      vandermonde(i, j) = power;
+      power *= t;
+    }
+  }
+  const Eigen::PartialPivLU<Eigen::MatrixXd> interpolation(vandermonde);
+
+  Eigen::MatrixXd params(2 * num_splines * num_params, 1);
+  uint32_t num_reused_points = 0;
+  for (uint32_t i = 0; i < num_splines; ++i) {
+    Eigen::VectorXd x(num_params);
+    Eigen::VectorXd y(num_params);
+    for (uint32_t j = 0; j < num_params; ++j) {
+      const double t =
+          t_knots_[i] + (t_knots_[i + 1] - t_knots_[i]) * j / spline_order;
+      const double s = start_s + (t - t_knots_.front()) * scale;
+      common::math::Vec2d point = raw_reference_line.GetReferencePoint(s);
+      common::SLPoint sl_point;
+      if (warm_start_reference_line.XYToSL(point, &sl_point) &&
+          sl_point.s() >= 0.0 &&
+          sl_point.s() <= warm_start_reference_line.Length() &&
+          std::fabs(sl_point.l()) <= FLAGS_smoothed_reference_line_max_diff) {
+        point = warm_start_reference_line.GetReferencePoint(sl_point.s());
+        ++num_reused_points;
+      }
+      x(j) = point.x() - ref_x_;
+      y(j) = point.y() - ref_y_;
+    }
+    params.block(2 * i * num_params, 0, num_params, 1) =
+        interpolation.solve(x);
+    params.block((2 * i + 1) * num_params, 0, num_params, 1) =
+        interpolation.solve(y);
+  }
+  ADEBUG << "Reference line smoother reused " << num_reused_points << " of "
+         << num_splines * num_params << " points for the initial guess.";
+  spline_solver_->SetInitialGuess(params);
+}
+
 void QpSplineReferenceLineSmoother::SetAnchorPoints(
     const std::vector<AnchorPoint>& anchor_points) {
   CHECK_GE(anchor_points.size(), 2);
   anchor_points_ = anchor_points;
 }
 
+void QpSplineReferenceLineSmoother::SetWarmStartReferenceLine(
+    const ReferenceLine& warm_start_reference_line) {
+  warm_start_reference_line_ = &warm_start_reference_line;
+}
+
 }  // namespace planning
 }  // namespace apollo
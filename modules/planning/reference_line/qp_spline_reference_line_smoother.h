@@ -28,6 +28,7 @@
 #include "modules/planning/proto/planning.pb.h"
 #include "modules/planning/proto/reference_line_smoother_config.pb.h"
 
+#include "modules/common/math/vec2d.h"
 #include "modules/planning/math/smoothing_spline/spline_2d_solver.h"
 #include "modules/planning/reference_line/reference_line.h"
 #include "modules/planning/reference_line/reference_line_smoother.h"
@@ -48,6 +49,9 @@ class QpSplineReferenceLineSmoother : public ReferenceLineSmoother {
 
   void SetAnchorPoints(const std::vector<AnchorPoint>& achor_points) override;
 
+  void SetWarmStartReferenceLine(
+      const ReferenceLine& warm_start_reference_line) override;
+
  private:
   void Clear();
 
@@ -59,6 +63,11 @@ class QpSplineReferenceLineSmoother : public ReferenceLineSmoother {
 
   bool Solve();
 
+  // Starts the solver from a spline through the warm start reference line
+  // where it overlaps the raw one, and through the raw one elsewhere.
+  void SetInitialGuess(const ReferenceLine& raw_reference_line,
+                       const ReferenceLine& warm_start_reference_line);
+
   bool ExtractEvaluatedPoints(
       const ReferenceLine& raw_reference_line, const std::vector<double>& vec_t,
       std::vector<common::PathPoint>* const path_points) const;
@@ -74,6 +83,9 @@ class QpSplineReferenceLineSmoother : public ReferenceLineSmoother {
 
   double ref_x_ = 0.0;
   double ref_y_ = 0.0;
+
+  // Given by SetWarmStartReferenceLine() for the next Smooth() only.
+  const ReferenceLine* warm_start_reference_line_ = nullptr;
 };
 
 }  // namespace planning
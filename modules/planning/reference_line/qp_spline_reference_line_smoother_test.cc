@@ -27,6 +27,7 @@
 #include "modules/common/util/util.h"
 #include "modules/map/hdmap/hdmap.h"
 #include "modules/map/hdmap/hdmap_util.h"
+#include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/reference_line/reference_line.h"
 #include "modules/planning/reference_line/reference_point.h"
 
@@ -99,5 +100,50 @@ TEST_F(QpSplineReferenceLineSmootherTest, smooth) {
   EXPECT_NEAR(152.0, smoothed_reference_line.Length(), 1.0);
 }
 
+TEST_F(QpSplineReferenceLineSmootherTest, warm_start) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_reference_line_smoother_warm_start = true;
+  std::vector<AnchorPoint> anchor_points;
+  std::vector<double> anchor_s;
+  common::util::uniform_slice(0.0, reference_line_->Length(), 15, &anchor_s);
+  for (const double s : anchor_s) {
+    anchor_points.emplace_back();
+    auto ref_point = reference_line_->GetReferencePoint(s);
+    anchor_points.back().path_point = ref_point.ToPathPoint(s);
+    anchor_points.back().lateral_bound = 2.0;
+    anchor_points.back().longitudinal_bound = 0.2;
+  }
+  anchor_points.front().longitudinal_bound = 1e-6;
+  anchor_points.front().lateral_bound = 1e-6;
+  anchor_points.back().longitudinal_bound = 1e-6;
+  anchor_points.back().lateral_bound = 1e-6;
+  smoother_->SetAnchorPoints(anchor_points);
+  ReferenceLine smoothed_reference_line;
+  EXPECT_TRUE(smoother_->Smooth(*reference_line_, &smoothed_reference_line));
+
+  // Smoothing the line again from the first smoothed line, or from the
+  // first half of it, ends up with the same line.
+  const auto& smoothed_points = smoothed_reference_line.reference_points();
+  const ReferenceLine half_reference_line(
+      smoothed_points.begin(),
+      smoothed_points.begin() + smoothed_points.size() / 2);
+  const std::vector<const ReferenceLine*> warm_start_reference_lines = {
+      &smoothed_reference_line, &half_reference_line};
+  for (const auto* warm_start_reference_line : warm_start_reference_lines) {
+    smoother_->SetWarmStartReferenceLine(*warm_start_reference_line);
+    ReferenceLine warm_started_reference_line;
+    EXPECT_TRUE(
+        smoother_->Smooth(*reference_line_, &warm_started_reference_line));
+    EXPECT_NEAR(smoothed_reference_line.Length(),
+                warm_started_reference_line.Length(), 1e-2);
+    for (double s = 0.0; s < smoothed_reference_line.Length(); s += 10.0) {
+      const auto point = smoothed_reference_line.GetReferencePoint(s);
+      common::SLPoint sl_point;
+      EXPECT_TRUE(warm_started_reference_line.XYToSL(point, &sl_point));
+      EXPECT_NEAR(0.0, sl_point.l(), 1e-2);
+    }
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
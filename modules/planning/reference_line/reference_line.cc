@@ -42,7 +42,6 @@ namespace planning {
 
 using MapPath = hdmap::Path;
 using apollo::common::SLPoint;
-using apollo::common::util::DistanceXY;
 using apollo::hdmap::InterpolatedIndex;
 
 ReferenceLine::ReferenceLine(
@@ -125,16 +124,7 @@ bool ReferenceLine::Stitch(const ReferenceLine& other) {
 
 ReferencePoint ReferenceLine::GetNearestReferencePoint(
     const common::math::Vec2d& xy) const {
-  double min_dist = std::numeric_limits<double>::max();
-  int min_index = 0;
-  for (std::size_t i = 0; i < reference_points_.size(); ++i) {
-    const double distance = DistanceXY(xy, reference_points_[i]);
-    if (distance < min_dist) {
-      min_dist = distance;
-      min_index = i;
-    }
-  }
-  return reference_points_[min_index];
+  return reference_points_[map_path_.GetNearestPointIndex(xy)];
 }
 
 bool ReferenceLine::Shrink(const common::math::Vec2d& point,
@@ -280,23 +270,8 @@ ReferencePoint ReferenceLine::GetReferencePoint(const double x,
                                                 const double y) const {
   CHECK_GE(reference_points_.size(), 0);
 
-  auto func_distance_square = [](const ReferencePoint& point, const double x,
-                                 const double y) {
-    double dx = point.x() - x;
-    double dy = point.y() - y;
-    return dx * dx + dy * dy;
-  };
-
-  double d_min = func_distance_square(reference_points_.front(), x, y);
-  double index_min = 0;
-
-  for (uint32_t i = 1; i < reference_points_.size(); ++i) {
-    double d_temp = func_distance_square(reference_points_[i], x, y);
-    if (d_temp < d_min) {
-      d_min = d_temp;
-      index_min = i;
-    }
-  }
+  const uint32_t index_min =
+      map_path_.GetNearestPointIndex(common::math::Vec2d(x, y));
 
   uint32_t index_start = (index_min == 0 ? index_min : index_min - 1);
   uint32_t index_end =
@@ -49,7 +49,6 @@ using apollo::common::VehicleState;
 using apollo::common::adapter::AdapterManager;
 using apollo::common::math::Vec2d;
 using apollo::common::time::Clock;
-using apollo::hdmap::HDMapUtil;
 using apollo::hdmap::LaneWaypoint;
 using apollo::hdmap::MapPathPoint;
 using apollo::hdmap::RouteSegments;
@@ -60,9 +59,13 @@ ReferenceLineProvider::~ReferenceLineProvider() {
   }
 }
 
-ReferenceLineProvider::ReferenceLineProvider(const hdmap::HDMap *base_map) {
+ReferenceLineProvider::ReferenceLineProvider(
+    std::shared_ptr<const hdmap::HDMap> base_map)
+    : hdmap_(base_map),
+      pnc_map_hdmap_(base_map),
+      reference_lines_hdmap_(base_map) {
   if (!FLAGS_use_navigation_mode) {
-    pnc_map_.reset(new hdmap::PncMap(base_map));
+    pnc_map_.reset(new hdmap::PncMap(base_map.get()));
   }
   CHECK(common::util::GetProtoFromFile(FLAGS_smoother_config_filename,
                                        &smoother_config_))
@@ -79,6 +82,29 @@ ReferenceLineProvider::ReferenceLineProvider(const hdmap::HDMap *base_map) {
   is_initialized_ = true;
 }  // namespace planning
 
+void ReferenceLineProvider::UpdateMap(
+    std::shared_ptr<const hdmap::HDMap> hdmap) {
+  {
+    std::lock_guard<std::mutex> lock(pnc_map_mutex_);
+    if (hdmap_ == hdmap) {
+      return;
+    }
+    hdmap_ = hdmap;
+  }
+  AINFO << "The map is changed, drop the reference lines of the previous map.";
+  std::lock_guard<std::mutex> lock(reference_lines_mutex_);
+  reference_lines_.clear();
+  route_segments_.clear();
+  reference_line_history_ = std::queue<std::list<ReferenceLine>>();
+  route_segments_history_ = std::queue<std::list<hdmap::RouteSegments>>();
+  reference_lines_hdmap_ = std::move(hdmap);
+}
+
+std::shared_ptr<const hdmap::HDMap> ReferenceLineProvider::GetHDMap() {
+  std::lock_guard<std::mutex> lock(pnc_map_mutex_);
+  return hdmap_;
+}
+
 bool ReferenceLineProvider::UpdateRoutingResponse(
     const routing::RoutingResponse &routing) {
   std::lock_guard<std::mutex> routing_lock(routing_mutex_);
@@ -131,7 +157,16 @@ void ReferenceLineProvider::UpdateReferenceLine(
            << ") are different";
     return;
   }
+  std::shared_ptr<const hdmap::HDMap> hdmap;
+  {
+    std::lock_guard<std::mutex> lock(pnc_map_mutex_);
+    hdmap = pnc_map_hdmap_;
+  }
   std::lock_guard<std::mutex> lock(reference_lines_mutex_);
+  if (hdmap != reference_lines_hdmap_) {
+    AWARN << "Drop the reference lines created on a previous map.";
+    return;
+  }
   if (reference_lines_.size() != reference_lines.size()) {
     reference_lines_ = reference_lines;
     route_segments_ = route_segments;
@@ -191,6 +226,7 @@ void ReferenceLineProvider::GenerateThread() {
     double end_time = Clock::NowInSeconds();
     std::lock_guard<std::mutex> lock(reference_lines_mutex_);
     last_calculation_time_ = end_time - start_time;
+    last_smoothing_debug_ = smoothing_debug_;
   }
 }
 
@@ -204,6 +240,17 @@ double ReferenceLineProvider::LastTimeDelay() {
   }
 }
 
+planning_internal::ReferenceLineSmoothingDebug
+ReferenceLineProvider::LastSmoothingDebug() {
+  if (FLAGS_enable_reference_line_provider_thread &&
+      !FLAGS_use_navigation_mode) {
+    std::lock_guard<std::mutex> lock(reference_lines_mutex_);
+    return last_smoothing_debug_;
+  } else {
+    return last_smoothing_debug_;
+  }
+}
+
 bool ReferenceLineProvider::GetReferenceLines(
     std::list<ReferenceLine> *reference_lines,
     std::list<hdmap::RouteSegments> *segments) {
@@ -248,6 +295,7 @@ bool ReferenceLineProvider::GetReferenceLines(
     UpdateReferenceLine(*reference_lines, *segments);
     double end_time = Clock::NowInSeconds();
     last_calculation_time_ = end_time - start_time;
+    last_smoothing_debug_ = smoothing_debug_;
   }
   return true;
 }
@@ -278,7 +326,7 @@ bool ReferenceLineProvider::GetReferenceLinesFromRelativeMap(
     return false;
   }
 
-  auto *hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = GetHDMap();
   if (!hdmap) {
     AERROR << "hdmap is null";
     return false;
@@ -446,7 +494,7 @@ bool ReferenceLineProvider::GetNearestWayPointFromNavigationPath(
     AERROR << "vehicle state is invalid";
     return false;
   }
-  auto *hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = GetHDMap();
   if (!hdmap) {
     AERROR << "hdmap is null";
     return false;
@@ -546,6 +594,7 @@ bool ReferenceLineProvider::CreateReferenceLine(
     std::list<hdmap::RouteSegments> *segments) {
   CHECK_NOTNULL(reference_lines);
   CHECK_NOTNULL(segments);
+  smoothing_debug_.Clear();
 
   common::VehicleState vehicle_state;
   {
@@ -558,6 +607,15 @@ bool ReferenceLineProvider::CreateReferenceLine(
     std::lock_guard<std::mutex> lock(routing_mutex_);
     routing = routing_;
   }
+  {
+    // Rebuild the PncMap on the latest map. The routing is then applied to
+    // it below, since it is new to this PncMap.
+    std::lock_guard<std::mutex> lock(pnc_map_mutex_);
+    if (pnc_map_hdmap_ != hdmap_) {
+      pnc_map_.reset(new hdmap::PncMap(hdmap_.get()));
+      pnc_map_hdmap_ = hdmap_;
+    }
+  }
   bool is_new_routing = false;
   {
     // Update routing in pnc_map
@@ -641,6 +699,7 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
     *segments = *prev_segment;
     segments->SetProperties(segment_properties);
     *reference_line = *prev_ref;
+    smoothing_debug_.set_num_reused(smoothing_debug_.num_reused() + 1);
     ADEBUG << "Reference line remain " << remain_s
            << ", which is more than required " << look_forward_required_distance
            << " and no need to extend";
@@ -664,6 +723,7 @@ bool ReferenceLineProvider::ExtendReferenceLine(const VehicleState &state,
     *segments = *prev_segment;
     segments->SetProperties(segment_properties);
     *reference_line = *prev_ref;
+    smoothing_debug_.set_num_reused(smoothing_debug_.num_reused() + 1);
     ADEBUG << "Could not further extend reference line";
     return true;
   }
@@ -850,7 +910,16 @@ bool ReferenceLineProvider::SmoothPrefixedReferenceLine(
   }
 
   smoother_->SetAnchorPoints(anchor_points);
-  if (!smoother_->Smooth(raw_ref, reference_line)) {
+  // Only the shifted tail is smoothed, starting from prefix_ref where the
+  // tail overlaps it.
+  smoother_->SetWarmStartReferenceLine(prefix_ref);
+  const double start_time = Clock::NowInSeconds();
+  const bool smoothed = smoother_->Smooth(raw_ref, reference_line);
+  smoothing_debug_.set_smoothing_time_ms(
+      smoothing_debug_.smoothing_time_ms() +
+      (Clock::NowInSeconds() - start_time) * 1000.0);
+  smoothing_debug_.set_num_extended(smoothing_debug_.num_extended() + 1);
+  if (!smoothed) {
     AERROR << "Failed to smooth prefixed reference line with anchor points";
     return false;
   }
@@ -871,7 +940,13 @@ bool ReferenceLineProvider::SmoothReferenceLine(
   std::vector<AnchorPoint> anchor_points;
   GetAnchorPoints(raw_reference_line, &anchor_points);
   smoother_->SetAnchorPoints(anchor_points);
-  if (!smoother_->Smooth(raw_reference_line, reference_line)) {
+  const double start_time = Clock::NowInSeconds();
+  const bool smoothed = smoother_->Smooth(raw_reference_line, reference_line);
+  smoothing_debug_.set_smoothing_time_ms(
+      smoothing_debug_.smoothing_time_ms() +
+      (Clock::NowInSeconds() - start_time) * 1000.0);
+  smoothing_debug_.set_num_smoothed(smoothing_debug_.num_smoothed() + 1);
+  if (!smoothed) {
     AERROR << "Failed to smooth reference line with anchor points";
     return false;
   }
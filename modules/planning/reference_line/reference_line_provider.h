@@ -37,6 +37,7 @@
 #include "modules/common/vehicle_state/proto/vehicle_state.pb.h"
 #include "modules/map/relative_map/proto/navigation.pb.h"
 #include "modules/planning/proto/planning_config.pb.h"
+#include "modules/planning/proto/planning_internal.pb.h"
 
 #include "modules/common/util/factory.h"
 #include "modules/common/util/util.h"
@@ -66,7 +67,15 @@ class ReferenceLineProvider {
    */
   ~ReferenceLineProvider();
 
-  explicit ReferenceLineProvider(const hdmap::HDMap* base_map);
+  explicit ReferenceLineProvider(std::shared_ptr<const hdmap::HDMap> base_map);
+
+  /**
+   * @brief Use a new map snapshot for the following reference lines. When
+   * the map changes, the reference lines created on the previous map are
+   * dropped, and the PncMap is rebuilt on the new map by the next
+   * computation, so the reference lines never mix two maps.
+   */
+  void UpdateMap(std::shared_ptr<const hdmap::HDMap> hdmap);
 
   bool UpdateRoutingResponse(const routing::RoutingResponse& routing);
 
@@ -81,6 +90,11 @@ class ReferenceLineProvider {
 
   double LastTimeDelay();
 
+  /**
+   * @brief The reference line smoothing statistics of the last computation.
+   */
+  planning_internal::ReferenceLineSmoothingDebug LastSmoothingDebug();
+
   std::vector<routing::LaneWaypoint> FutureRouteWaypoints();
 
   static double LookForwardDistance(const common::VehicleState& state);
@@ -103,6 +117,11 @@ class ReferenceLineProvider {
       const std::list<ReferenceLine>& reference_lines,
       const std::list<hdmap::RouteSegments>& route_segments);
 
+  /**
+   * @brief returns the latest map given to the provider.
+   */
+  std::shared_ptr<const hdmap::HDMap> GetHDMap();
+
   void GenerateThread();
   void IsValidReferenceLine();
   void PrioritzeChangeLane(std::list<hdmap::RouteSegments>* route_segments);
@@ -162,6 +181,11 @@ class ReferenceLineProvider {
   ReferenceLineSmootherConfig smoother_config_;
 
   std::mutex pnc_map_mutex_;
+  // The latest map given to the provider.
+  std::shared_ptr<const hdmap::HDMap> hdmap_;
+  // The map pnc_map_ is built on, which lags hdmap_ until the next
+  // computation.
+  std::shared_ptr<const hdmap::HDMap> pnc_map_hdmap_;
   std::unique_ptr<hdmap::PncMap> pnc_map_;
 
   std::mutex vehicle_state_mutex_;
@@ -172,9 +196,15 @@ class ReferenceLineProvider {
   bool has_routing_ = false;
 
   std::mutex reference_lines_mutex_;
+  // The map the stored reference lines and their history are created on.
+  std::shared_ptr<const hdmap::HDMap> reference_lines_hdmap_;
   std::list<ReferenceLine> reference_lines_;
   std::list<hdmap::RouteSegments> route_segments_;
   double last_calculation_time_ = 0.0;
+  // Accumulated by the thread creating reference lines, and copied to
+  // last_smoothing_debug_ with last_calculation_time_.
+  planning_internal::ReferenceLineSmoothingDebug smoothing_debug_;
+  planning_internal::ReferenceLineSmoothingDebug last_smoothing_debug_;
 
   std::queue<std::list<ReferenceLine>> reference_line_history_;
   std::queue<std::list<hdmap::RouteSegments>> route_segments_history_;
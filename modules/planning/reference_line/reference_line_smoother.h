@@ -54,6 +54,13 @@ class ReferenceLineSmoother {
    */
   virtual bool Smooth(const ReferenceLine&, ReferenceLine* const) = 0;
 
+  /**
+   * Start the next Smooth() from a smoothed reference line where it overlaps
+   * the raw one. The line must outlive the next Smooth(). Smoothers which
+   * cannot be warm started ignore it.
+   */
+  virtual void SetWarmStartReferenceLine(const ReferenceLine&) {}
+
   virtual ~ReferenceLineSmoother() = default;
 
  protected:
@@ -31,11 +31,11 @@
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common/log.h"
 #include "modules/common/math/cartesian_frenet_conversion.h"
+#include "modules/common/util/task_scheduler.h"
 #include "modules/common/util/util.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/planning/common/path/frenet_frame_path.h"
 #include "modules/planning/common/planning_gflags.h"
-#include "modules/planning/common/planning_thread_pool.h"
 #include "modules/planning/common/planning_util.h"
 #include "modules/planning/math/curve1d/quintic_polynomial_curve1d.h"
 
@@ -150,15 +150,30 @@ bool DPRoadGraph::GenerateMinCostPath(
 
     graph_nodes.emplace_back();
 
+    // The curves to this level start from the previous level or from the
+    // init point, so their samples are shared and computed once up front.
+    for (const auto &cur_point : level_points) {
+      for (const auto &prev_dp_node : prev_dp_nodes) {
+        trajectory_cost.PrecomputeSegment(prev_dp_node.sl_point.s(),
+                                          cur_point.s());
+      }
+      if (level >= 2) {
+        trajectory_cost.PrecomputeSegment(init_sl_point_.s(), cur_point.s());
+      }
+    }
+
+    // The graph is searched by its own group of tasks, so that the graphs
+    // of reference lines planned concurrently do not wait for each other.
+    common::util::TaskGroup task_group;
     for (size_t i = 0; i < level_points.size(); ++i) {
       const auto &cur_point = level_points[i];
 
       graph_nodes.back().emplace_back(cur_point, nullptr);
       auto &cur_node = graph_nodes.back().back();
       if (FLAGS_enable_multi_thread_in_dp_poly_path) {
-        PlanningThreadPool::instance()->Push(std::bind(
-            &DPRoadGraph::UpdateNode, this, std::ref(prev_dp_nodes), level,
-            total_level, &trajectory_cost, &(front), &(cur_node)));
+        task_group.Run(std::bind(&DPRoadGraph::UpdateNode, this,
+                                 std::ref(prev_dp_nodes), level, total_level,
+                                 &trajectory_cost, &(front), &(cur_node)));
 
       } else {
         UpdateNode(prev_dp_nodes, level, total_level, &trajectory_cost, &front,
@@ -166,7 +181,7 @@ bool DPRoadGraph::GenerateMinCostPath(
       }
     }
     if (FLAGS_enable_multi_thread_in_dp_poly_path) {
-      PlanningThreadPool::instance()->Synchronize();
+      task_group.Wait();
     }
   }
 
@@ -274,15 +289,15 @@ bool DPRoadGraph::SamplePathWaypoints(
   float accumulated_s = init_sl_point_.s();
   float prev_s = accumulated_s;
 
-  auto *status = util::GetPlanningStatus();
+  // The pull over status is set by EMPlanner::Plan(), and only read here
+  // since the reference lines may be planned concurrently.
+  const auto *status = util::GetPlanningStatus();
   if (status == nullptr) {
     AERROR << "Fail to  get planning status.";
     return false;
   }
   if (status->planning_state().has_pull_over() &&
       status->planning_state().pull_over().in_pull_over()) {
-    status->mutable_planning_state()->mutable_pull_over()->set_status(
-        PullOverStatus::IN_OPERATION);
     const auto &start_point =
         status->planning_state().pull_over().start_point();
     SLPoint start_point_sl;
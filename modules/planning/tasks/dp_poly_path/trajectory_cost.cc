@@ -28,14 +28,13 @@
 #include "modules/common/proto/pnc_point.pb.h"
 
 #include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/common/math/angle.h"
 #include "modules/common/math/vec2d.h"
-#include "modules/common/util/util.h"
 #include "modules/planning/common/planning_gflags.h"
 
 namespace apollo {
 namespace planning {
 
-using apollo::common::TrajectoryPoint;
 using apollo::common::math::Box2d;
 using apollo::common::math::Sigmoid;
 using apollo::common::math::Vec2d;
@@ -57,6 +56,15 @@ TrajectoryCost::TrajectoryCost(
 
   num_of_time_stamps_ = static_cast<uint32_t>(
       std::floor(total_time / config.eval_time_interval()));
+  dynamic_obstacle_boxes_.resize(num_of_time_stamps_ + 1);
+
+  float time_stamp = 0.0;
+  for (uint32_t index = 0; index < num_of_time_stamps_;
+       ++index, time_stamp += config.eval_time_interval()) {
+    common::SpeedPoint speed_point;
+    heuristic_speed_data_.EvaluateByTime(time_stamp, &speed_point);
+    time_stamp_s_.push_back(speed_point.s() + init_sl_point_.s());
+  }
 
   for (const auto *ptr_path_obstacle : obstacles) {
     if (ptr_path_obstacle->IsIgnore()) {
@@ -90,26 +98,80 @@ TrajectoryCost::TrajectoryCost(
                is_bycycle_or_pedestrian) {
       static_obstacle_sl_boundaries_.push_back(std::move(sl_boundary));
     } else {
-      std::vector<Box2d> box_by_time;
       for (uint32_t t = 0; t <= num_of_time_stamps_; ++t) {
-        TrajectoryPoint trajectory_point =
-            ptr_obstacle->GetPointAtTime(t * config.eval_time_interval());
-
-        Box2d obstacle_box = ptr_obstacle->GetBoundingBox(trajectory_point);
+        Box2d obstacle_box =
+            ptr_obstacle->GetBoundingBoxAtTime(t * config.eval_time_interval());
         constexpr float kBuff = 0.5;
         Box2d expanded_obstacle_box =
             Box2d(obstacle_box.center(), obstacle_box.heading(),
                   obstacle_box.length() + kBuff, obstacle_box.width() + kBuff);
-        box_by_time.push_back(expanded_obstacle_box);
+        dynamic_obstacle_boxes_[t].Add(expanded_obstacle_box);
       }
-      dynamic_obstacle_boxes_.push_back(std::move(box_by_time));
+      ++num_of_dynamic_obstacles_;
+    }
+  }
+}
+
+TrajectoryCost::SegmentSamples TrajectoryCost::SampleSegment(
+    const float start_s, const float end_s) const {
+  SegmentSamples samples;
+  for (float curve_s = 0.0; curve_s < (end_s - start_s);
+       curve_s += config_.path_resolution()) {
+    double left_width = 0.0;
+    double right_width = 0.0;
+    reference_line_->GetLaneWidth(curve_s + start_s, &left_width, &right_width);
+    samples.path_param.push_back(curve_s);
+    samples.lane_left_width.push_back(left_width);
+    samples.lane_right_width.push_back(right_width);
+  }
+
+  for (float curr_s = start_s; curr_s <= end_s;
+       curr_s += config_.path_resolution()) {
+    samples.static_obstacle_s.push_back(curr_s);
+    samples.static_obstacle_param.push_back(curr_s - start_s);
+  }
+
+  if (num_of_dynamic_obstacles_ == 0) {
+    return samples;
+  }
+  for (uint32_t index = 0; index < time_stamp_s_.size(); ++index) {
+    const float ref_s = time_stamp_s_[index];
+    if (ref_s < start_s) {
+      continue;
     }
+    if (ref_s > end_s) {
+      break;
+    }
+    // The same point and normal as ReferenceLine::SLToXY().
+    const ReferencePoint reference_point =
+        reference_line_->GetReferencePoint(ref_s);
+    const auto angle =
+        common::math::Angle16::from_rad(reference_point.heading());
+    samples.time_index.push_back(index);
+    samples.dynamic_obstacle_s.push_back(ref_s);
+    samples.dynamic_obstacle_param.push_back(ref_s - start_s);
+    samples.ref_x.push_back(reference_point.x());
+    samples.ref_y.push_back(reference_point.y());
+    samples.ref_normal_x.push_back(-common::math::sin(angle));
+    samples.ref_normal_y.push_back(common::math::cos(angle));
+    samples.ref_heading.push_back(reference_point.heading());
+    samples.ref_kappa.push_back(reference_point.kappa());
+  }
+  return samples;
+}
+
+void TrajectoryCost::PrecomputeSegment(const float start_s,
+                                       const float end_s) {
+  const auto key = std::make_pair(start_s, end_s);
+  if (segment_samples_.find(key) == segment_samples_.end()) {
+    segment_samples_.emplace(key, SampleSegment(start_s, end_s));
   }
 }
 
 ComparableCost TrajectoryCost::CalculatePathCost(
-    const QuinticPolynomialCurve1d &curve, const float start_s,
-    const float end_s, const uint32_t curr_level, const uint32_t total_level) {
+    const QuinticPolynomialCurve1d &curve, const SegmentSamples &samples,
+    const float start_s, const float end_s, const uint32_t curr_level,
+    const uint32_t total_level) {
   ComparableCost cost;
   float path_cost = 0.0;
   std::function<float(const float)> quasi_softmax = [this](const float x) {
@@ -123,15 +185,21 @@ ComparableCost TrajectoryCost::CalculatePathCost(
       common::VehicleConfigHelper::instance()->GetConfig();
   const float width = vehicle_config.vehicle_param().width();
 
-  for (float curve_s = 0.0; curve_s < (end_s - start_s);
-       curve_s += config_.path_resolution()) {
-    const float l = curve.Evaluate(0, curve_s);
+  const std::size_t num_samples = samples.path_param.size();
+  std::vector<double> ls(num_samples);
+  std::vector<double> dls(num_samples);
+  std::vector<double> ddls(num_samples);
+  curve.Evaluate(0, samples.path_param.data(), num_samples, ls.data());
+  curve.Evaluate(1, samples.path_param.data(), num_samples, dls.data());
+  curve.Evaluate(2, samples.path_param.data(), num_samples, ddls.data());
+
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    const float l = ls[i];
 
     path_cost += l * l * config_.path_l_cost() * quasi_softmax(std::fabs(l));
 
-    double left_width = 0.0;
-    double right_width = 0.0;
-    reference_line_->GetLaneWidth(curve_s + start_s, &left_width, &right_width);
+    const double left_width = samples.lane_left_width[i];
+    const double right_width = samples.lane_right_width[i];
 
     constexpr float kBuff = 0.2;
     if (!is_change_lane_path_ && (l + width / 2.0 + kBuff > left_width ||
@@ -139,10 +207,10 @@ ComparableCost TrajectoryCost::CalculatePathCost(
       cost.cost_items[ComparableCost::OUT_OF_BOUNDARY] = true;
     }
 
-    const float dl = std::fabs(curve.Evaluate(1, curve_s));
+    const float dl = std::fabs(dls[i]);
     path_cost += dl * dl * config_.path_dl_cost();
 
-    const float ddl = std::fabs(curve.Evaluate(2, curve_s));
+    const float ddl = std::fabs(ddls[i]);
     path_cost += ddl * ddl * config_.path_ddl_cost();
   }
   path_cost *= config_.path_resolution();
@@ -157,12 +225,18 @@ ComparableCost TrajectoryCost::CalculatePathCost(
 }
 
 ComparableCost TrajectoryCost::CalculateStaticObstacleCost(
-    const QuinticPolynomialCurve1d &curve, const float start_s,
-    const float end_s) {
+    const QuinticPolynomialCurve1d &curve, const SegmentSamples &samples) {
   ComparableCost obstacle_cost;
-  for (float curr_s = start_s; curr_s <= end_s;
-       curr_s += config_.path_resolution()) {
-    const float curr_l = curve.Evaluate(0, curr_s - start_s);
+  if (static_obstacle_sl_boundaries_.empty()) {
+    return obstacle_cost;
+  }
+  const std::size_t num_samples = samples.static_obstacle_param.size();
+  std::vector<double> ls(num_samples);
+  curve.Evaluate(0, samples.static_obstacle_param.data(), num_samples,
+                 ls.data());
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    const float curr_s = samples.static_obstacle_s[i];
+    const float curr_l = ls[i];
     for (const auto &obs_sl_boundary : static_obstacle_sl_boundaries_) {
       obstacle_cost += GetCostFromObsSL(curr_s, curr_l, obs_sl_boundary);
     }
@@ -172,31 +246,28 @@ ComparableCost TrajectoryCost::CalculateStaticObstacleCost(
 }
 
 ComparableCost TrajectoryCost::CalculateDynamicObstacleCost(
-    const QuinticPolynomialCurve1d &curve, const float start_s,
-    const float end_s) const {
+    const QuinticPolynomialCurve1d &curve,
+    const SegmentSamples &samples) const {
   ComparableCost obstacle_cost;
-  float time_stamp = 0.0;
-  for (size_t index = 0; index < num_of_time_stamps_;
-       ++index, time_stamp += config_.eval_time_interval()) {
-    common::SpeedPoint speed_point;
-    heuristic_speed_data_.EvaluateByTime(time_stamp, &speed_point);
-    float ref_s = speed_point.s() + init_sl_point_.s();
-    if (ref_s < start_s) {
-      continue;
-    }
-    if (ref_s > end_s) {
-      break;
-    }
-
-    const float s = ref_s - start_s;  // s on spline curve
-    const float l = curve.Evaluate(0, s);
-    const float dl = curve.Evaluate(1, s);
-
-    const common::SLPoint sl = common::util::MakeSLPoint(ref_s, l);
-    const Box2d ego_box = GetBoxFromSLPoint(sl, dl);
-    for (const auto &obstacle_trajectory : dynamic_obstacle_boxes_) {
-      obstacle_cost +=
-          GetCostBetweenObsBoxes(ego_box, obstacle_trajectory.at(index));
+  if (num_of_dynamic_obstacles_ == 0) {
+    return obstacle_cost;
+  }
+  const std::size_t num_samples = samples.dynamic_obstacle_param.size();
+  std::vector<double> ls(num_samples);
+  std::vector<double> dls(num_samples);
+  curve.Evaluate(0, samples.dynamic_obstacle_param.data(), num_samples,
+                 ls.data());
+  curve.Evaluate(1, samples.dynamic_obstacle_param.data(), num_samples,
+                 dls.data());
+  std::vector<double> distances(num_of_dynamic_obstacles_);
+  for (std::size_t i = 0; i < num_samples; ++i) {
+    const float l = ls[i];
+    const float dl = dls[i];
+    const Box2d ego_box = GetBoxFromSample(samples, i, l, dl);
+    dynamic_obstacle_boxes_.at(samples.time_index[i])
+        .DistanceTo(ego_box, distances.data());
+    for (const double distance : distances) {
+      obstacle_cost += GetCostFromObsDistance(distance);
     }
   }
   constexpr float kDynamicObsWeight = 1e-6;
@@ -257,11 +328,10 @@ ComparableCost TrajectoryCost::GetCostFromObsSL(
 }
 
 // Simple version: calculate obstacle cost by distance
-ComparableCost TrajectoryCost::GetCostBetweenObsBoxes(
-    const Box2d &ego_box, const Box2d &obstacle_box) const {
+ComparableCost TrajectoryCost::GetCostFromObsDistance(
+    const float distance) const {
   ComparableCost obstacle_cost;
 
-  const float distance = obstacle_box.DistanceTo(ego_box);
   if (distance > config_.obstacle_ignore_distance()) {
     return obstacle_cost;
   }
@@ -274,17 +344,16 @@ ComparableCost TrajectoryCost::GetCostBetweenObsBoxes(
   return obstacle_cost;
 }
 
-Box2d TrajectoryCost::GetBoxFromSLPoint(const common::SLPoint &sl,
-                                        const float dl) const {
-  Vec2d xy_point;
-  reference_line_->SLToXY(sl, &xy_point);
+Box2d TrajectoryCost::GetBoxFromSample(const SegmentSamples &samples,
+                                       const std::size_t index, const float l,
+                                       const float dl) const {
+  const Vec2d xy_point(samples.ref_x[index] + samples.ref_normal_x[index] * l,
+                       samples.ref_y[index] + samples.ref_normal_y[index] * l);
 
-  ReferencePoint reference_point = reference_line_->GetReferencePoint(sl.s());
-
-  const float one_minus_kappa_r_d = 1 - reference_point.kappa() * sl.l();
+  const float one_minus_kappa_r_d = 1 - samples.ref_kappa[index] * l;
   const float delta_theta = std::atan2(dl, one_minus_kappa_r_d);
-  const float theta =
-      common::math::NormalizeAngle(delta_theta + reference_point.heading());
+  const float theta = common::math::NormalizeAngle(
+      delta_theta + samples.ref_heading[index]);
   return Box2d(xy_point, theta, vehicle_param_.length(),
                vehicle_param_.width());
 }
@@ -294,16 +363,24 @@ ComparableCost TrajectoryCost::Calculate(const QuinticPolynomialCurve1d &curve,
                                          const float start_s, const float end_s,
                                          const uint32_t curr_level,
                                          const uint32_t total_level) {
+  const auto iter = segment_samples_.find(std::make_pair(start_s, end_s));
+  SegmentSamples uncached_samples;
+  if (iter == segment_samples_.end()) {
+    uncached_samples = SampleSegment(start_s, end_s);
+  }
+  const SegmentSamples &samples =
+      iter == segment_samples_.end() ? uncached_samples : iter->second;
+
   ComparableCost total_cost;
   // path cost
-  total_cost +=
-      CalculatePathCost(curve, start_s, end_s, curr_level, total_level);
+  total_cost += CalculatePathCost(curve, samples, start_s, end_s, curr_level,
+                                  total_level);
 
   // static obstacle cost
-  total_cost += CalculateStaticObstacleCost(curve, start_s, end_s);
+  total_cost += CalculateStaticObstacleCost(curve, samples);
 
   // dynamic obstacle cost
-  total_cost += CalculateDynamicObstacleCost(curve, start_s, end_s);
+  total_cost += CalculateDynamicObstacleCost(curve, samples);
   return total_cost;
 }
 
@@ -21,12 +21,16 @@
 #ifndef MODULES_PLANNING_TASKS_DP_POLY_PATH_TRAJECTORY_COST_H_
 #define MODULES_PLANNING_TASKS_DP_POLY_PATH_TRAJECTORY_COST_H_
 
+#include <cstddef>
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "modules/common/configs/proto/vehicle_config.pb.h"
 #include "modules/planning/proto/dp_poly_path_config.pb.h"
 
 #include "modules/common/math/box2d.h"
+#include "modules/common/math/box2d_batch.h"
 #include "modules/planning/common/obstacle.h"
 #include "modules/planning/common/path_decision.h"
 #include "modules/planning/common/speed/speed_data.h"
@@ -52,27 +56,59 @@ class TrajectoryCost {
                            const uint32_t curr_level,
                            const uint32_t total_level);
 
+  // Precomputes the parts of the cost which do not depend on the curve, at
+  // the points where the curves from start_s to end_s are sampled, so that
+  // Calculate() does not query the reference line and the speed data again
+  // for every curve between the same two levels. Must not be called while
+  // Calculate() runs on other threads.
+  void PrecomputeSegment(const float start_s, const float end_s);
+
  private:
+  // The sample points of the curves from a start s to an end s, with the
+  // parts of the cost which do not depend on the curve.
+  struct SegmentSamples {
+    // Path cost samples: curve parameter and lane widths.
+    std::vector<double> path_param;
+    std::vector<double> lane_left_width;
+    std::vector<double> lane_right_width;
+    // Static obstacle cost samples: s and curve parameter.
+    std::vector<float> static_obstacle_s;
+    std::vector<double> static_obstacle_param;
+    // Dynamic obstacle cost samples, at the time stamps whose heuristic s
+    // is on the curves: time stamp, s, curve parameter, and the reference
+    // point at s with its normal.
+    std::vector<uint32_t> time_index;
+    std::vector<float> dynamic_obstacle_s;
+    std::vector<double> dynamic_obstacle_param;
+    std::vector<double> ref_x;
+    std::vector<double> ref_y;
+    std::vector<double> ref_normal_x;
+    std::vector<double> ref_normal_y;
+    std::vector<double> ref_heading;
+    std::vector<double> ref_kappa;
+  };
+
+  SegmentSamples SampleSegment(const float start_s, const float end_s) const;
+
   ComparableCost CalculatePathCost(const QuinticPolynomialCurve1d &curve,
+                                   const SegmentSamples &samples,
                                    const float start_s, const float end_s,
                                    const uint32_t curr_level,
                                    const uint32_t total_level);
   ComparableCost CalculateStaticObstacleCost(
-      const QuinticPolynomialCurve1d &curve, const float start_s,
-      const float end_s);
+      const QuinticPolynomialCurve1d &curve, const SegmentSamples &samples);
   ComparableCost CalculateDynamicObstacleCost(
-      const QuinticPolynomialCurve1d &curve, const float start_s,
-      const float end_s) const;
-  ComparableCost GetCostBetweenObsBoxes(
-      const common::math::Box2d &ego_box,
-      const common::math::Box2d &obstacle_box) const;
+      const QuinticPolynomialCurve1d &curve,
+      const SegmentSamples &samples) const;
+  ComparableCost GetCostFromObsDistance(const float distance) const;
 
   FRIEND_TEST(AllTrajectoryTests, GetCostFromObsSL);
   ComparableCost GetCostFromObsSL(const float adc_s, const float adc_l,
                                   const SLBoundary &obs_sl_boundary);
 
-  common::math::Box2d GetBoxFromSLPoint(const common::SLPoint &sl,
-                                        const float dl) const;
+  common::math::Box2d GetBoxFromSample(const SegmentSamples &samples,
+                                       const std::size_t index,
+                                       const float l, const float dl) const;
 
   const DpPolyPathConfig config_;
   const ReferenceLine *reference_line_ = nullptr;
@@ -81,10 +117,16 @@ class TrajectoryCost {
   SpeedData heuristic_speed_data_;
   const common::SLPoint init_sl_point_;
   uint32_t num_of_time_stamps_ = 0;
-  std::vector<std::vector<common::math::Box2d>> dynamic_obstacle_boxes_;
+  // The heuristic s at each time stamp.
+  std::vector<float> time_stamp_s_;
+  uint32_t num_of_dynamic_obstacles_ = 0;
+  // Boxes of the dynamic obstacles at each time stamp.
+  std::vector<common::math::Box2dBatch> dynamic_obstacle_boxes_;
   std::vector<float> obstacle_probabilities_;
 
   std::vector<SLBoundary> static_obstacle_sl_boundaries_;
+
+  std::map<std::pair<float, float>, SegmentSamples> segment_samples_;
 };
 
 }  // namespace planning
@@ -21,6 +21,7 @@
 #include "modules/planning/tasks/dp_st_speed/dp_st_graph.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <string>
 #include <utility>
@@ -29,8 +30,8 @@
 
 #include "modules/common/log.h"
 #include "modules/common/math/vec2d.h"
+#include "modules/common/util/task_scheduler.h"
 #include "modules/planning/common/planning_gflags.h"
-#include "modules/planning/common/planning_thread_pool.h"
 
 namespace apollo {
 namespace planning {
@@ -44,6 +45,18 @@ using apollo::common::math::Vec2d;
 namespace {
 constexpr float kInf = std::numeric_limits<float>::infinity();
 
+// Rows of a column evaluated by one task of the multi-threaded search.
+constexpr uint32_t kNumRowsPerTask = 8;
+
+// The cost tables of the graphs searched in a thread, kept when the graphs
+// are destroyed to reuse their memory across planning cycles. A thread may
+// search several graphs at once, when it runs the tasks of another
+// reference line while waiting for its own.
+std::vector<std::vector<StGraphPoint>>& ThreadLocalCostTables() {
+  static thread_local std::vector<std::vector<StGraphPoint>> cost_tables;
+  return cost_tables;
+}
+
 bool CheckOverlapOnDpStGraph(const std::vector<const StBoundary*>& boundaries,
                              const StGraphPoint& p1, const StGraphPoint& p2) {
   const common::math::LineSegment2d seg(p1.point(), p2.point());
@@ -70,6 +83,11 @@ DpStGraph::DpStGraph(const StGraphData& st_graph_data,
       init_point_(init_point),
       dp_st_cost_(dp_config, obstacles, init_point_),
       adc_sl_boundary_(adc_sl_boundary) {
+  auto& cost_tables = ThreadLocalCostTables();
+  if (!cost_tables.empty()) {
+    cost_table_.swap(cost_tables.back());
+    cost_tables.pop_back();
+  }
   dp_st_speed_config_.set_total_path_length(
       std::fmin(dp_st_speed_config_.total_path_length(),
                 st_graph_data_.path_data_length()));
@@ -79,6 +97,10 @@ DpStGraph::DpStGraph(const StGraphData& st_graph_data,
             (dp_st_speed_config_.matrix_dimension_t() - 1);
 }
 
+DpStGraph::~DpStGraph() {
+  ThreadLocalCostTables().push_back(std::move(cost_table_));
+}
+
 Status DpStGraph::Search(SpeedData* const speed_data) {
   constexpr float kBounadryEpsilon = 1e-2;
   for (const auto& boundary : st_graph_data_.st_boundaries()) {
@@ -143,19 +165,21 @@ Status DpStGraph::Search(SpeedData* const speed_data) {
 }
 
 Status DpStGraph::InitCostTable() {
-  uint32_t dim_s = dp_st_speed_config_.matrix_dimension_s();
-  uint32_t dim_t = dp_st_speed_config_.matrix_dimension_t();
-  DCHECK_GT(dim_s, 2);
-  DCHECK_GT(dim_t, 2);
-  cost_table_ = std::vector<std::vector<StGraphPoint>>(
-      dim_t, std::vector<StGraphPoint>(dim_s, StGraphPoint()));
+  dim_s_ = dp_st_speed_config_.matrix_dimension_s();
+  dim_t_ = dp_st_speed_config_.matrix_dimension_t();
+  DCHECK_GT(dim_s_, 2);
+  DCHECK_GT(dim_t_, 2);
+  if (cost_table_.size() < dim_s_ * dim_t_) {
+    cost_table_.resize(dim_s_ * dim_t_);
+  }
 
   float curr_t = 0.0;
-  for (uint32_t i = 0; i < cost_table_.size(); ++i, curr_t += unit_t_) {
-    auto& cost_table_i = cost_table_[i];
+  for (uint32_t i = 0; i < dim_t_; ++i, curr_t += unit_t_) {
     float curr_s = 0.0;
-    for (uint32_t j = 0; j < cost_table_i.size(); ++j, curr_s += unit_s_) {
-      cost_table_i[j].Init(i, j, STPoint(curr_s, curr_t));
+    for (uint32_t j = 0; j < dim_s_; ++j, curr_s += unit_s_) {
+      auto& cost_ij = CostAt(i, j);
+      cost_ij = StGraphPoint();
+      cost_ij.Init(i, j, STPoint(curr_s, curr_t));
     }
   }
   return Status::OK();
@@ -167,25 +191,32 @@ Status DpStGraph::CalculateTotalCost() {
   // s corresponding to row
   uint32_t next_highest_row = 0;
   uint32_t next_lowest_row = 0;
+  uint32_t num_cells = 0;
+  std::atomic<uint32_t> num_cells_evaluated(0);
 
-  for (size_t c = 0; c < cost_table_.size(); ++c) {
+  // Each column only depends on the previous one, so the rows of a column
+  // are evaluated in parallel and the columns one after another.
+  for (uint32_t c = 0; c < dim_t_; ++c) {
     int highest_row = 0;
-    int lowest_row = cost_table_.back().size() - 1;
+    int lowest_row = dim_s_ - 1;
 
-    for (uint32_t r = next_lowest_row; r <= next_highest_row; ++r) {
-      if (FLAGS_enable_multi_thread_in_dp_st_graph) {
-        PlanningThreadPool::instance()->Push(
-            std::bind(&DpStGraph::CalculateCostAt, this, c, r));
-      } else {
-        CalculateCostAt(c, r);
+    auto calculate_cost = [&](const size_t r) {
+      if (CalculateCostAt(c, r)) {
+        ++num_cells_evaluated;
       }
-    }
+    };
     if (FLAGS_enable_multi_thread_in_dp_st_graph) {
-      PlanningThreadPool::instance()->Synchronize();
+      common::util::ParallelFor(next_lowest_row, next_highest_row + 1,
+                                kNumRowsPerTask, calculate_cost);
+    } else {
+      for (uint32_t r = next_lowest_row; r <= next_highest_row; ++r) {
+        calculate_cost(r);
+      }
     }
+    num_cells += next_highest_row + 1 - next_lowest_row;
 
     for (uint32_t r = next_lowest_row; r <= next_highest_row; ++r) {
-      const auto& cost_cr = cost_table_[c][r];
+      const auto& cost_cr = CostAt(c, r);
       if (cost_cr.total_cost() < std::numeric_limits<float>::infinity()) {
         int h_r = 0;
         int l_r = 0;
@@ -197,6 +228,8 @@ Status DpStGraph::CalculateTotalCost() {
     next_highest_row = highest_row;
     next_lowest_row = lowest_row;
   }
+  num_cells_evaluated_ = num_cells_evaluated;
+  num_cells_pruned_ = num_cells - num_cells_evaluated_;
 
   return Status::OK();
 }
@@ -210,7 +243,7 @@ void DpStGraph::GetRowRange(const StGraphPoint& point, int* next_highest_row,
     v0 = (point.index_s() - point.pre_point()->index_s()) * unit_s_ / unit_t_;
   }
 
-  const int max_s_size = cost_table_.back().size() - 1;
+  const int max_s_size = dim_s_ - 1;
 
   const float speed_coeff = unit_t_ * unit_t_;
 
@@ -233,118 +266,126 @@ void DpStGraph::GetRowRange(const StGraphPoint& point, int* next_highest_row,
   }
 }
 
-void DpStGraph::CalculateCostAt(const uint32_t c, const uint32_t r) {
-  auto& cost_cr = cost_table_[c][r];
-  cost_cr.SetObstacleCost(dp_st_cost_.GetObstacleCost(cost_cr));
-  if (cost_cr.obstacle_cost() > std::numeric_limits<float>::max()) {
-    return;
+uint32_t DpStGraph::GetLowestPreRow(const uint32_t r) const {
+  constexpr float kSpeedRangeBuffer = 0.20;
+  const uint32_t max_s_diff =
+      static_cast<uint32_t>(FLAGS_planning_upper_speed_limit *
+                            (1 + kSpeedRangeBuffer) * unit_t_ / unit_s_);
+  return max_s_diff < r ? r - max_s_diff : 0;
+}
+
+bool DpStGraph::IsFeasibleTransition(const uint32_t c, const uint32_t r,
+                                     const uint32_t r_pre) const {
+  if (c == 1) {
+    const float acc = (r * unit_s_ / unit_t_ - init_point_.v()) / unit_t_;
+    return acc >= dp_st_speed_config_.max_deceleration() &&
+           acc <= dp_st_speed_config_.max_acceleration();
   }
+  if (c == 2) {
+    const float acc =
+        (r * unit_s_ - 2 * r_pre * unit_s_) / (unit_t_ * unit_t_);
+    return acc >= dp_st_speed_config_.max_deceleration() &&
+           acc <= dp_st_speed_config_.max_acceleration();
+  }
+  const auto& pre_point = CostAt(c - 1, r_pre);
+  if (std::isinf(pre_point.total_cost()) || pre_point.pre_point() == nullptr) {
+    return false;
+  }
+  const float curr_a =
+      (r * unit_s_ + pre_point.pre_point()->index_s() * unit_s_ -
+       2 * pre_point.index_s() * unit_s_) /
+      (unit_t_ * unit_t_);
+  return curr_a <= vehicle_param_.max_acceleration() &&
+         curr_a >= vehicle_param_.max_deceleration();
+}
 
-  const auto& cost_init = cost_table_[0][0];
+bool DpStGraph::CalculateCostAt(const uint32_t c, const uint32_t r) {
+  auto& cost_cr = CostAt(c, r);
+  const auto& cost_init = CostAt(0, 0);
   if (c == 0) {
     DCHECK_EQ(r, 0) << "Incorrect. Row should be 0 with col = 0. row: " << r;
-    cost_cr.SetTotalCost(0.0);
-    return;
+    cost_cr.SetObstacleCost(dp_st_cost_.GetObstacleCost(cost_cr));
+    if (cost_cr.obstacle_cost() <= std::numeric_limits<float>::max()) {
+      cost_cr.SetTotalCost(0.0);
+    }
+    return true;
+  }
+
+  // Cells which no cell of the previous column reaches within the
+  // acceleration limits keep an infinite cost, skip their obstacle cost.
+  const uint32_t r_low = (c == 1 ? 0 : GetLowestPreRow(r));
+  if (FLAGS_enable_pruning_in_dp_st_graph) {
+    const uint32_t r_high = (c == 1 ? 0 : r);
+    bool reachable = false;
+    for (uint32_t r_pre = r_low; r_pre <= r_high && !reachable; ++r_pre) {
+      reachable = IsFeasibleTransition(c, r, r_pre);
+    }
+    if (!reachable) {
+      return false;
+    }
+  }
+
+  cost_cr.SetObstacleCost(dp_st_cost_.GetObstacleCost(cost_cr));
+  if (cost_cr.obstacle_cost() > std::numeric_limits<float>::max()) {
+    return true;
   }
 
   float speed_limit =
       st_graph_data_.speed_limit().GetSpeedLimitByS(unit_s_ * r);
   if (c == 1) {
-    const float acc = (r * unit_s_ / unit_t_ - init_point_.v()) / unit_t_;
-    if (acc < dp_st_speed_config_.max_deceleration() ||
-        acc > dp_st_speed_config_.max_acceleration()) {
-      return;
-    }
-
-    if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
+    if (!IsFeasibleTransition(c, r, 0) ||
+        CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
                                 cost_init)) {
-      return;
+      return true;
     }
     cost_cr.SetTotalCost(cost_cr.obstacle_cost() + cost_init.total_cost() +
                          CalculateEdgeCostForSecondCol(r, speed_limit));
     cost_cr.SetPrePoint(cost_init);
-    return;
+    return true;
   }
 
-  constexpr float kSpeedRangeBuffer = 0.20;
-  const uint32_t max_s_diff =
-      static_cast<uint32_t>(FLAGS_planning_upper_speed_limit *
-                            (1 + kSpeedRangeBuffer) * unit_t_ / unit_s_);
-  const uint32_t r_low = (max_s_diff < r ? r - max_s_diff : 0);
-
-  const auto& pre_col = cost_table_[c - 1];
-
-  if (c == 2) {
-    for (uint32_t r_pre = r_low; r_pre <= r; ++r_pre) {
-      const float acc =
-          (r * unit_s_ - 2 * r_pre * unit_s_) / (unit_t_ * unit_t_);
-      if (acc < dp_st_speed_config_.max_deceleration() ||
-          acc > dp_st_speed_config_.max_acceleration()) {
-        continue;
-      }
-
-      if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
-                                  pre_col[r_pre])) {
-        continue;
-      }
-
-      const float cost = cost_cr.obstacle_cost() + pre_col[r_pre].total_cost() +
-                         CalculateEdgeCostForThirdCol(r, r_pre, speed_limit);
-
-      if (cost < cost_cr.total_cost()) {
-        cost_cr.SetTotalCost(cost);
-        cost_cr.SetPrePoint(pre_col[r_pre]);
-      }
-    }
-    return;
-  }
   for (uint32_t r_pre = r_low; r_pre <= r; ++r_pre) {
-    if (std::isinf(pre_col[r_pre].total_cost()) ||
-        pre_col[r_pre].pre_point() == nullptr) {
-      continue;
-    }
-
-    const float curr_a = (cost_cr.index_s() * unit_s_ +
-                          pre_col[r_pre].pre_point()->index_s() * unit_s_ -
-                          2 * pre_col[r_pre].index_s() * unit_s_) /
-                         (unit_t_ * unit_t_);
-    if (curr_a > vehicle_param_.max_acceleration() ||
-        curr_a < vehicle_param_.max_deceleration()) {
+    if (!IsFeasibleTransition(c, r, r_pre)) {
       continue;
     }
+    const auto& pre_point = CostAt(c - 1, r_pre);
     if (CheckOverlapOnDpStGraph(st_graph_data_.st_boundaries(), cost_cr,
-                                pre_col[r_pre])) {
-      continue;
-    }
-
-    uint32_t r_prepre = pre_col[r_pre].pre_point()->index_s();
-    const StGraphPoint& prepre_graph_point = cost_table_[c - 2][r_prepre];
-    if (std::isinf(prepre_graph_point.total_cost())) {
+                                pre_point)) {
       continue;
     }
 
-    if (!prepre_graph_point.pre_point()) {
-      continue;
+    float cost = 0.0;
+    if (c == 2) {
+      cost = cost_cr.obstacle_cost() + pre_point.total_cost() +
+             CalculateEdgeCostForThirdCol(r, r_pre, speed_limit);
+    } else {
+      const uint32_t r_prepre = pre_point.pre_point()->index_s();
+      const StGraphPoint& prepre_graph_point = CostAt(c - 2, r_prepre);
+      if (std::isinf(prepre_graph_point.total_cost()) ||
+          !prepre_graph_point.pre_point()) {
+        continue;
+      }
+      const STPoint& triple_pre_point =
+          prepre_graph_point.pre_point()->point();
+      cost = cost_cr.obstacle_cost() + pre_point.total_cost() +
+             CalculateEdgeCost(triple_pre_point, prepre_graph_point.point(),
+                               pre_point.point(), cost_cr.point(),
+                               speed_limit);
     }
-    const STPoint& triple_pre_point = prepre_graph_point.pre_point()->point();
-    const STPoint& prepre_point = prepre_graph_point.point();
-    const STPoint& pre_point = pre_col[r_pre].point();
-    const STPoint& curr_point = cost_cr.point();
-    float cost = cost_cr.obstacle_cost() + pre_col[r_pre].total_cost() +
-                 CalculateEdgeCost(triple_pre_point, prepre_point, pre_point,
-                                   curr_point, speed_limit);
 
     if (cost < cost_cr.total_cost()) {
       cost_cr.SetTotalCost(cost);
-      cost_cr.SetPrePoint(pre_col[r_pre]);
+      cost_cr.SetPrePoint(pre_point);
     }
   }
+  return true;
 }
 
 Status DpStGraph::RetrieveSpeedProfile(SpeedData* const speed_data) {
   float min_cost = std::numeric_limits<float>::infinity();
   const StGraphPoint* best_end_point = nullptr;
-  for (const StGraphPoint& cur_point : cost_table_.back()) {
+  for (uint32_t r = 0; r < dim_s_; ++r) {
+    const StGraphPoint& cur_point = CostAt(dim_t_ - 1, r);
     if (!std::isinf(cur_point.total_cost()) &&
         cur_point.total_cost() < min_cost) {
       best_end_point = &cur_point;
@@ -352,8 +393,8 @@ Status DpStGraph::RetrieveSpeedProfile(SpeedData* const speed_data) {
     }
   }
 
-  for (const auto& row : cost_table_) {
-    const StGraphPoint& cur_point = row.back();
+  for (uint32_t c = 0; c < dim_t_; ++c) {
+    const StGraphPoint& cur_point = CostAt(c, dim_s_ - 1);
     if (!std::isinf(cur_point.total_cost()) &&
         cur_point.total_cost() < min_cost) {
       best_end_point = &cur_point;
@@ -401,8 +442,8 @@ float DpStGraph::CalculateEdgeCostForSecondCol(const uint32_t row,
                                                const float speed_limit) {
   float init_speed = init_point_.v();
   float init_acc = init_point_.a();
-  const STPoint& pre_point = cost_table_[0][0].point();
-  const STPoint& curr_point = cost_table_[1][row].point();
+  const STPoint& pre_point = CostAt(0, 0).point();
+  const STPoint& curr_point = CostAt(1, row).point();
   return dp_st_cost_.GetSpeedCost(pre_point, curr_point, speed_limit) +
          dp_st_cost_.GetAccelCostByTwoPoints(init_speed, pre_point,
                                              curr_point) +
@@ -414,9 +455,9 @@ float DpStGraph::CalculateEdgeCostForThirdCol(const uint32_t curr_row,
                                               const uint32_t pre_row,
                                               const float speed_limit) {
   float init_speed = init_point_.v();
-  const STPoint& first = cost_table_[0][0].point();
-  const STPoint& second = cost_table_[1][pre_row].point();
-  const STPoint& third = cost_table_[2][curr_row].point();
+  const STPoint& first = CostAt(0, 0).point();
+  const STPoint& second = CostAt(1, pre_row).point();
+  const STPoint& third = CostAt(2, curr_row).point();
   return dp_st_cost_.GetSpeedCost(second, third, speed_limit) +
          dp_st_cost_.GetAccelCostByThreePoints(first, second, third) +
          dp_st_cost_.GetJerkCostByThreePoints(init_speed, first, second, third);
@@ -48,15 +48,35 @@ class DpStGraph {
             const common::TrajectoryPoint& init_point,
             const SLBoundary& adc_sl_boundary);
 
+  ~DpStGraph();
+
   apollo::common::Status Search(SpeedData* const speed_data);
 
+  // Number of cells of the last Search() whose cost was evaluated, and of
+  // cells in the searched row ranges pruned before any DpStCost call.
+  uint32_t num_cells_evaluated() const { return num_cells_evaluated_; }
+  uint32_t num_cells_pruned() const { return num_cells_pruned_; }
+
  private:
   apollo::common::Status InitCostTable();
 
   apollo::common::Status RetrieveSpeedProfile(SpeedData* const speed_data);
 
   apollo::common::Status CalculateTotalCost();
-  void CalculateCostAt(const uint32_t r, const uint32_t c);
+  // Returns false if the cell is pruned, that is it cannot be reached from
+  // the previous column within the acceleration limits.
+  bool CalculateCostAt(const uint32_t c, const uint32_t r);
+
+  bool IsFeasibleTransition(const uint32_t c, const uint32_t r,
+                            const uint32_t r_pre) const;
+  uint32_t GetLowestPreRow(const uint32_t r) const;
+
+  StGraphPoint& CostAt(const uint32_t c, const uint32_t r) {
+    return cost_table_[c * dim_s_ + r];
+  }
+  const StGraphPoint& CostAt(const uint32_t c, const uint32_t r) const {
+    return cost_table_[c * dim_s_ + r];
+  }
 
   float CalculateEdgeCost(const STPoint& first, const STPoint& second,
                            const STPoint& third, const STPoint& forth,
@@ -94,9 +114,15 @@ class DpStGraph {
   float unit_s_ = 0.0;
   float unit_t_ = 0.0;
 
-  // cost_table_[t][s]
+  uint32_t dim_s_ = 0;
+  uint32_t dim_t_ = 0;
+
+  // cost_table_[t * dim_s_ + s], reused across planning cycles
   // row: s, col: t --- NOTICE: Please do NOT change.
-  std::vector<std::vector<StGraphPoint>> cost_table_;
+  std::vector<StGraphPoint> cost_table_;
+
+  uint32_t num_cells_evaluated_ = 0;
+  uint32_t num_cells_pruned_ = 0;
 };
 
 }  // namespace planning
@@ -28,7 +28,6 @@
 #include "modules/common/log.h"
 #include "modules/common/util/file.h"
 #include "modules/planning/common/planning_gflags.h"
-#include "modules/planning/common/planning_thread_pool.h"
 
 namespace apollo {
 namespace planning {
@@ -36,8 +35,6 @@ namespace planning {
 class DpStGraphTest : public ::testing::Test {
  public:
   virtual void SetUp() {
-    PlanningThreadPool::instance()->Init();
-
     // dp_config_
     PlanningConfig config;
     FLAGS_planning_config_file = "modules/planning/conf/planning_config.pb.txt";
@@ -113,6 +110,57 @@ TEST_F(DpStGraphTest, simple) {
   SpeedData speed_data;
   auto ret = dp_st_graph.Search(&speed_data);
   EXPECT_TRUE(ret.ok());
+  EXPECT_GT(dp_st_graph.num_cells_evaluated(), 0);
+}
+
+TEST_F(DpStGraphTest, pruning_keeps_speed_profile) {
+  Obstacle o1;
+  o1.SetId("o1");
+  obstacle_list_.push_back(o1);
+  path_obstacle_list_.emplace_back(&(obstacle_list_.back()));
+
+  std::vector<const PathObstacle*> obstacles;
+  obstacles.emplace_back(&(path_obstacle_list_.back()));
+
+  std::vector<std::pair<STPoint, STPoint>> point_pairs;
+  point_pairs.emplace_back(STPoint(30.0, 4.0), STPoint(45.0, 4.0));
+  point_pairs.emplace_back(STPoint(30.0, 6.0), STPoint(45.0, 6.0));
+  path_obstacle_list_.back().SetStBoundary(StBoundary(point_pairs));
+
+  std::vector<const StBoundary*> boundaries;
+  boundaries.push_back(&(obstacles.back()->st_boundary()));
+
+  init_point_.set_v(10.0);
+  init_point_.set_a(0.0);
+  st_graph_data_ = StGraphData(boundaries, init_point_, speed_limit_, 120.0);
+
+  adc_sl_boundary_.set_start_s(15.0);
+  adc_sl_boundary_.set_end_s(20.0);
+  adc_sl_boundary_.set_start_l(-1.1);
+  adc_sl_boundary_.set_end_l(1.1);
+
+  google::FlagSaver flag_saver;
+  FLAGS_enable_pruning_in_dp_st_graph = false;
+  DpStGraph unpruned_graph(st_graph_data_, dp_config_, obstacles, init_point_,
+                           adc_sl_boundary_);
+  SpeedData unpruned_speed_data;
+  ASSERT_TRUE(unpruned_graph.Search(&unpruned_speed_data).ok());
+  EXPECT_EQ(0, unpruned_graph.num_cells_pruned());
+
+  FLAGS_enable_pruning_in_dp_st_graph = true;
+  DpStGraph pruned_graph(st_graph_data_, dp_config_, obstacles, init_point_,
+                         adc_sl_boundary_);
+  SpeedData pruned_speed_data;
+  ASSERT_TRUE(pruned_graph.Search(&pruned_speed_data).ok());
+  EXPECT_GT(pruned_graph.num_cells_pruned(), 0);
+
+  const auto& unpruned_points = unpruned_speed_data.speed_vector();
+  const auto& pruned_points = pruned_speed_data.speed_vector();
+  ASSERT_EQ(unpruned_points.size(), pruned_points.size());
+  for (size_t i = 0; i < pruned_points.size(); ++i) {
+    EXPECT_EQ(unpruned_points[i].s(), pruned_points[i].s());
+    EXPECT_EQ(unpruned_points[i].t(), pruned_points[i].t());
+  }
 }
 
 }  // namespace planning
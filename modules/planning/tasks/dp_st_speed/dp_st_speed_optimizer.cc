@@ -27,6 +27,7 @@
 
 #include "modules/common/adapters/adapter_manager.h"
 #include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/common/time/time.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/tasks/dp_st_speed/dp_st_graph.h"
@@ -40,6 +41,7 @@ using apollo::common::Status;
 using apollo::common::TrajectoryPoint;
 using apollo::common::VehicleConfigHelper;
 using apollo::common::adapter::AdapterManager;
+using apollo::common::time::Clock;
 using apollo::localization::LocalizationEstimate;
 using apollo::planning_internal::STGraphDebug;
 
@@ -117,7 +119,15 @@ bool DpStSpeedOptimizer::SearchStGraph(
       reference_line_info_->path_decision()->path_obstacles().Items(),
       init_point_, adc_sl_boundary_);
 
-  if (!st_graph.Search(speed_data).ok()) {
+  const double start_time = Clock::NowInSeconds();
+  const bool search_ok = st_graph.Search(speed_data).ok();
+  auto* dp_st_graph_debug = st_graph_debug->mutable_dp_st_graph();
+  dp_st_graph_debug->set_search_time_ms(
+      (Clock::NowInSeconds() - start_time) * 1000.0);
+  dp_st_graph_debug->set_num_cells_evaluated(st_graph.num_cells_evaluated());
+  dp_st_graph_debug->set_num_cells_pruned(st_graph.num_cells_pruned());
+
+  if (!search_ok) {
     AERROR << "failed to search graph with dynamic programming.";
     RecordSTGraphDebug(st_graph_data, st_graph_debug);
     return false;
@@ -151,10 +151,7 @@ bool QpFrenetFrame::MapDynamicObstacleWithDecision(
   const auto& nudge = decision.nudge();
   for (const SpeedPoint& veh_point : discretized_vehicle_location_) {
     double time = veh_point.t();
-    common::TrajectoryPoint trajectory_point =
-        ptr_obstacle->GetPointAtTime(time);
-    common::math::Box2d obs_box =
-        ptr_obstacle->GetBoundingBox(trajectory_point);
+    common::math::Box2d obs_box = ptr_obstacle->GetBoundingBoxAtTime(time);
     // project obs_box on reference line
     std::vector<common::math::Vec2d> corners;
     obs_box.GetAllCorners(&corners);
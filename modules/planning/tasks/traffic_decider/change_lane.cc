@@ -119,17 +119,18 @@ bool ChangeLane::CreateGuardObstacle(
       return false;
     }
 
-    auto* tp = obstacle->AddTrajectoryPoint();
-    tp->set_a(0.0);
-    tp->set_v(extend_v);
-    tp->set_relative_time(t);
-    tp->mutable_path_point()->set_x(xy_point.x());
-    tp->mutable_path_point()->set_y(xy_point.y());
-    tp->mutable_path_point()->set_theta(ref_point.heading());
+    common::TrajectoryPoint tp;
+    tp.set_a(0.0);
+    tp.set_v(extend_v);
+    tp.set_relative_time(t);
+    tp.mutable_path_point()->set_x(xy_point.x());
+    tp.mutable_path_point()->set_y(xy_point.y());
+    tp.mutable_path_point()->set_theta(ref_point.heading());
 
     // this is an approximate estimate since we do not use it.
-    tp->mutable_path_point()->set_s(s);
-    tp->mutable_path_point()->set_kappa(ref_point.kappa());
+    tp.mutable_path_point()->set_s(s);
+    tp.mutable_path_point()->set_kappa(ref_point.kappa());
+    obstacle->AddTrajectoryPoint(tp);
   }
   return true;
 }
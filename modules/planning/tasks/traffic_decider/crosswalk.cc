@@ -46,7 +46,6 @@ using apollo::common::math::Polygon2d;
 using apollo::common::math::Vec2d;
 using apollo::common::time::Clock;
 using apollo::common::util::WithinBound;
-using apollo::hdmap::HDMapUtil;
 using apollo::perception::PerceptionObstacle;
 using apollo::planning::util::GetPlanningStatus;
 using apollo::planning::CrosswalkStatus;
@@ -83,7 +82,7 @@ void Crosswalk::MakeDecisions(Frame* const frame,
   CrosswalkToStop crosswalks_to_stop;
 
   for (auto crosswalk_overlap : crosswalk_overlaps_) {
-    auto crosswalk_ptr = HDMapUtil::BaseMap().GetCrosswalkById(
+    auto crosswalk_ptr = frame->hdmap()->GetCrosswalkById(
         hdmap::MakeMapId(crosswalk_overlap->object_id));
     std::string crosswalk_id = crosswalk_ptr->id().id();
 
@@ -34,7 +34,6 @@ namespace planning {
 using apollo::common::adapter::AdapterManager;
 using apollo::common::Status;
 using apollo::common::time::Clock;
-using apollo::hdmap::HDMapUtil;
 using apollo::hdmap::LaneSegment;
 using apollo::planning::util::GetPlanningStatus;
 
@@ -101,7 +100,7 @@ int Destination::BuildStopDecision(
       config_.destination().stop_distance());
 
   common::PointENU dest_point;
-  if (CheckPullOver(reference_line_info, routing_end.id(),
+  if (CheckPullOver(frame, reference_line_info, routing_end.id(),
                     dest_lane_s, &dest_point)) {
     PullOver(&dest_point);
     ADEBUG << "destination: PULL OVER";
@@ -169,17 +168,19 @@ int Destination::Stop(Frame* const frame,
  * @brief: check if adc will pull-over upon arriving destination
  */
 bool Destination::CheckPullOver(
+    Frame* const frame,
     ReferenceLineInfo* const reference_line_info,
     const std::string lane_id,
     const double lane_s,
     common::PointENU* dest_point) {
+  CHECK_NOTNULL(frame);
   CHECK_NOTNULL(reference_line_info);
 
   if (!config_.destination().enable_pull_over()) {
     return false;
   }
 
-  const auto dest_lane = HDMapUtil::BaseMapPtr()->GetLaneById(
+  const auto dest_lane = frame->hdmap()->GetLaneById(
       hdmap::MakeMapId(lane_id));
   if (!dest_lane) {
     ADEBUG << "Failed to find lane[" << lane_id << "]";
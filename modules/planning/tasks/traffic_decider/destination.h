@@ -50,7 +50,8 @@ class Destination : public TrafficRule {
            ReferenceLineInfo* const reference_line_info,
            const std::string lane_id,
            const double lane_s);
-  bool CheckPullOver(ReferenceLineInfo* const reference_line_info,
+  bool CheckPullOver(Frame* const frame,
+                     ReferenceLineInfo* const reference_line_info,
                      const std::string lane_id,
                      const double lane_s,
                      common::PointENU* dest_point);
@@ -37,7 +37,6 @@ namespace planning {
 using apollo::common::Status;
 using apollo::common::VehicleConfigHelper;
 using apollo::common::time::Clock;
-using apollo::hdmap::HDMapUtil;
 using apollo::perception::PerceptionObstacle;
 using apollo::planning::util::GetPlanningStatus;
 
@@ -62,7 +61,7 @@ void FrontVehicle::MakeDecisions(Frame* frame,
   CHECK_NOTNULL(frame);
   CHECK_NOTNULL(reference_line_info);
 
-  MakeSidePassDecision(reference_line_info);
+  MakeSidePassDecision(frame, reference_line_info);
 
   MakeStopDecision(reference_line_info);
 }
@@ -71,7 +70,8 @@ void FrontVehicle::MakeDecisions(Frame* frame,
  * @brief: make SIDEPASS decision
  */
 bool FrontVehicle::MakeSidePassDecision(
-    ReferenceLineInfo* const reference_line_info) {
+    Frame* const frame, ReferenceLineInfo* const reference_line_info) {
+  CHECK_NOTNULL(frame);
   CHECK_NOTNULL(reference_line_info);
 
   if (!config_.front_vehicle().enable_side_pass()) {
@@ -88,7 +88,7 @@ bool FrontVehicle::MakeSidePassDecision(
     return true;
   }
 
-  if (!ProcessSidePass(reference_line_info)) {
+  if (!ProcessSidePass(frame, reference_line_info)) {
     return false;
   }
 
@@ -110,7 +110,8 @@ bool FrontVehicle::MakeSidePassDecision(
 }
 
 bool FrontVehicle::ProcessSidePass(
-    ReferenceLineInfo* const reference_line_info) {
+    Frame* const frame, ReferenceLineInfo* const reference_line_info) {
+  CHECK_NOTNULL(frame);
   CHECK_NOTNULL(reference_line_info);
 
   // find obstacle being blocked, to process SIDEPASS
@@ -179,7 +180,7 @@ bool FrontVehicle::ProcessSidePass(
                 lane.right_neighbor_forward_lane_id_size() > 0) {
               bool has_city_driving = false;
               for (auto& id : lane.right_neighbor_forward_lane_id()) {
-                if (HDMapUtil::BaseMap().GetLaneById(id)->lane().type() ==
+                if (frame->hdmap()->GetLaneById(id)->lane().type() ==
                     hdmap::Lane::CITY_DRIVING) {
                   has_city_driving = true;
                   break;
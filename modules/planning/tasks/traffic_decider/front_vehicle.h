@@ -42,8 +42,10 @@ class FrontVehicle : public TrafficRule {
   void MakeDecisions(Frame* const frame,
                      ReferenceLineInfo* const reference_line_info);
 
-  bool MakeSidePassDecision(ReferenceLineInfo* const reference_line_info);
-  bool ProcessSidePass(ReferenceLineInfo* const reference_line_info);
+  bool MakeSidePassDecision(Frame* const frame,
+                            ReferenceLineInfo* const reference_line_info);
+  bool ProcessSidePass(Frame* const frame,
+                       ReferenceLineInfo* const reference_line_info);
   std::string FindPassableObstacle(
       ReferenceLineInfo* const reference_line_info);
 
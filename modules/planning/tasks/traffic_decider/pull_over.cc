@@ -39,7 +39,6 @@ namespace planning {
 using apollo::common::PointENU;
 using apollo::common::Status;
 using apollo::common::VehicleConfigHelper;
-using apollo::hdmap::HDMapUtil;
 using apollo::hdmap::PathOverlap;
 using apollo::perception::PerceptionObstacle;
 using apollo::planning::util::GetPlanningStatus;
@@ -396,7 +395,7 @@ int PullOver::FindPullOverStop(PointENU* stop_point) {
     for (auto& neighbor_lane_id :
          lane->lane().right_neighbor_forward_lane_id()) {
       const auto neighbor_lane =
-          HDMapUtil::BaseMapPtr()->GetLaneById(neighbor_lane_id);
+          frame_->hdmap()->GetLaneById(neighbor_lane_id);
       if (!neighbor_lane) {
         ADEBUG << "Failed to find lane[" << neighbor_lane_id.id() << "]";
         continue;
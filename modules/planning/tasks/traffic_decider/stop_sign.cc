@@ -43,7 +43,6 @@ using apollo::common::math::Box2d;
 using apollo::common::math::Vec2d;
 using apollo::common::time::Clock;
 using apollo::common::util::WithinBound;
-using apollo::hdmap::HDMapUtil;
 using apollo::hdmap::LaneInfo;
 using apollo::hdmap::LaneInfoConstPtr;
 using apollo::hdmap::OverlapInfoConstPtr;
@@ -63,6 +62,7 @@ Status StopSign::ApplyRule(Frame* const frame,
   CHECK_NOTNULL(frame);
   CHECK_NOTNULL(reference_line_info);
 
+  hdmap_ = frame->hdmap();
   if (!FindNextStopSign(reference_line_info)) {
     GetPlanningStatus()->clear_stop_sign();
     return Status::OK();
@@ -193,7 +193,7 @@ bool StopSign::FindNextStopSign(ReferenceLineInfo* const reference_line_info) {
     return false;
   }
 
-  next_stop_sign_ = HDMapUtil::BaseMap().GetStopSignById(
+  next_stop_sign_ = hdmap_->GetStopSignById(
       hdmap::MakeMapId(next_stop_sign_overlap_.object_id));
   if (!next_stop_sign_) {
     AERROR << "Could not find stop sign: " << next_stop_sign_overlap_.object_id;
@@ -224,8 +224,8 @@ int StopSign::GetAssociatedLanes(const StopSignInfo& stop_sign_info) {
   associated_lanes_.clear();
 
   std::vector<StopSignInfoConstPtr> associated_stop_signs;
-  HDMapUtil::BaseMap().GetStopSignAssociatedStopSigns(stop_sign_info.id(),
-                                                      &associated_stop_signs);
+  hdmap_->GetStopSignAssociatedStopSigns(stop_sign_info.id(),
+                                         &associated_stop_signs);
 
   for (const auto stop_sign : associated_stop_signs) {
     if (stop_sign == nullptr) {
@@ -234,7 +234,7 @@ int StopSign::GetAssociatedLanes(const StopSignInfo& stop_sign_info) {
 
     const auto& associated_lane_ids = stop_sign->OverlapLaneIds();
     for (const auto& lane_id : associated_lane_ids) {
-      const auto lane = HDMapUtil::BaseMap().GetLaneById(lane_id);
+      const auto lane = hdmap_->GetLaneById(lane_id);
       if (lane == nullptr) {
         continue;
       }
@@ -497,7 +497,7 @@ int StopSign::AddWatchVehicle(const PathObstacle& path_obstacle,
   double obstacle_s = 0.0;
   double obstacle_l = 0.0;
   hdmap::LaneInfoConstPtr obstacle_lane;
-  if (HDMapUtil::BaseMap().GetNearestLaneWithHeading(
+  if (hdmap_->GetNearestLaneWithHeading(
           point, 5.0, perception_obstacle.theta(), M_PI / 3.0, &obstacle_lane,
           &obstacle_s, &obstacle_l) != 0) {
     ADEBUG << "obstacle_id[" << obstacle_id << "] type[" << obstacle_type_name
@@ -603,7 +603,7 @@ int StopSign::RemoveWatchVehicle(
   double obstacle_s = 0.0;
   double obstacle_l = 0.0;
   LaneInfoConstPtr obstacle_lane;
-  if (HDMapUtil::BaseMap().GetNearestLaneWithHeading(
+  if (hdmap_->GetNearestLaneWithHeading(
           point, 5.0, perception_obstacle.theta(), M_PI / 3.0, &obstacle_lane,
           &obstacle_s, &obstacle_l) != 0) {
     ADEBUG << "obstacle_id[" << obstacle_id << "] type[" << obstacle_type_name
@@ -75,6 +75,8 @@ class StopSign : public TrafficRule {
   static constexpr const char* STOP_SIGN_VO_ID_PREFIX = "SS_";
   static constexpr const char* STOP_SIGN_CREEP_VO_ID_PREFIX = "SS_CREEP_";
 
+  // The map of the frame the rule is applied to.
+  const hdmap::HDMap* hdmap_ = nullptr;
   hdmap::PathOverlap next_stop_sign_overlap_;
   hdmap::StopSignInfoConstPtr next_stop_sign_ = nullptr;
   StopSignStatus::Status stop_status_;
@@ -16,52 +16,56 @@
 
 #include "modules/prediction/common/feature_output.h"
 
-#include <string>
-
 #include "modules/common/log.h"
-#include "modules/common/util/file.h"
-#include "modules/common/util/string_util.h"
 #include "modules/prediction/common/prediction_gflags.h"
 
 namespace apollo {
 namespace prediction {
 
-Features FeatureOutput::features_;
-size_t FeatureOutput::index_ = 0;
+std::unique_ptr<FeatureRecordWriter> FeatureOutput::writer_;
 
 void FeatureOutput::Close() {
   ADEBUG << "Close feature output";
   Write();
-  Clear();
+  writer_.reset();
 }
 
 void FeatureOutput::Clear() {
-  index_ = 0;
-  features_.Clear();
+  if (writer_ != nullptr) {
+    writer_->Reset();
+  }
 }
 
 bool FeatureOutput::Ready() {
   Clear();
-  return true;
+  return Writer() != nullptr;
 }
 
 void FeatureOutput::Insert(const Feature& feature) {
-  features_.add_feature()->CopyFrom(feature);
+  Writer()->Append(feature);
 }
 
 void FeatureOutput::Write() {
-  if (features_.feature_size() <= 0) {
+  if (Size() <= 0) {
     ADEBUG << "Skip writing empty feature.";
     return;
   }
-  std::string file_name = ::apollo::common::util::StrCat(
-      FLAGS_prediction_data_file_prefix, ".", std::to_string(index_), ".bin");
-  ::apollo::common::util::SetProtoToBinaryFile(features_, file_name);
-  features_.Clear();
-  ++index_;
+  writer_->Flush();
 }
 
-int FeatureOutput::Size() { return features_.feature_size(); }
+int FeatureOutput::Size() {
+  return writer_ == nullptr ? 0 : writer_->NumFeatures();
+}
+
+FeatureRecordWriter* FeatureOutput::Writer() {
+  if (writer_ == nullptr) {
+    writer_.reset(new FeatureRecordWriter(
+        FLAGS_prediction_data_file_prefix, FLAGS_prediction_feature_block_size,
+        FLAGS_prediction_feature_file_size,
+        FLAGS_prediction_max_pending_feature_blocks));
+  }
+  return writer_.get();
+}
 
 }  // namespace prediction
 }  // namespace apollo
@@ -17,8 +17,10 @@
 #ifndef MODULES_PREDICTION_COMMON_FEATURE_OUTPUT_H_
 #define MODULES_PREDICTION_COMMON_FEATURE_OUTPUT_H_
 
+#include <memory>
+
+#include "modules/prediction/common/feature_record_writer.h"
 #include "modules/prediction/proto/feature.pb.h"
-#include "modules/prediction/proto/offline_features.pb.h"
 
 namespace apollo {
 namespace prediction {
@@ -58,19 +60,20 @@ class FeatureOutput {
   static void Insert(const Feature& feature);
 
   /**
-   * @brief Write features to a file
+   * @brief Write the features inserted and start a new file
    */
   static void Write();
 
   /**
-   * @brief Get feature size
+   * @brief Get the number of features inserted since the last write
    * @return Feature size
    */
   static int Size();
 
  private:
-  static Features features_;
-  static size_t index_;
+  static FeatureRecordWriter* Writer();
+
+  static std::unique_ptr<FeatureRecordWriter> writer_;
 };
 
 }  // namespace prediction
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/common/feature_record_reader.h"
+
+#include "google/protobuf/io/coded_stream.h"
+
+#include "modules/common/log.h"
+
+namespace apollo {
+namespace prediction {
+
+using ::google::protobuf::io::CodedInputStream;
+using ::google::protobuf::uint32;
+using ::google::protobuf::uint8;
+
+namespace {
+
+constexpr std::size_t kChunkSize = 1 << 16;
+// Window bits of zlib for a gzip or zlib header, detected automatically.
+constexpr int kAutoWindowBits = 15 + 32;
+constexpr std::size_t kMaxVarint32Bytes = 5;
+
+}  // namespace
+
+FeatureRecordReader::FeatureRecordReader(const std::string& file_name)
+    : input_(kChunkSize), output_(kChunkSize) {
+  file_.open(file_name, std::ios::in | std::ios::binary);
+  if (!file_.is_open()) {
+    AERROR << "Failed to open feature file " << file_name;
+    ok_ = false;
+    return;
+  }
+  stream_.zalloc = Z_NULL;
+  stream_.zfree = Z_NULL;
+  stream_.opaque = Z_NULL;
+  stream_.next_in = Z_NULL;
+  stream_.avail_in = 0;
+  if (inflateInit2(&stream_, kAutoWindowBits) != Z_OK) {
+    AERROR << "Failed to initialize the decompression of " << file_name;
+    ok_ = false;
+    return;
+  }
+  stream_initialized_ = true;
+}
+
+FeatureRecordReader::~FeatureRecordReader() {
+  if (stream_initialized_) {
+    inflateEnd(&stream_);
+  }
+}
+
+bool FeatureRecordReader::Next(Feature* feature) {
+  while (ok_) {
+    const std::size_t available = buffer_.size() - position_;
+    if (available > 0) {
+      CodedInputStream input(
+          reinterpret_cast<const uint8*>(buffer_.data() + position_),
+          available);
+      uint32 size = 0;
+      if (input.ReadVarint32(&size)) {
+        const std::size_t header_size = input.CurrentPosition();
+        if (available >= header_size + size) {
+          if (!feature->ParseFromArray(
+                  buffer_.data() + position_ + header_size, size)) {
+            AERROR << "Failed to parse a feature of " << size << " bytes.";
+            ok_ = false;
+            return false;
+          }
+          position_ += header_size + size;
+          return true;
+        }
+      } else if (available >= kMaxVarint32Bytes) {
+        AERROR << "Invalid size of a feature record.";
+        ok_ = false;
+        return false;
+      }
+    }
+    if (!Fill()) {
+      if (ok_ && (position_ < buffer_.size() || in_member_)) {
+        AERROR << "The feature file is truncated.";
+        ok_ = false;
+      }
+      return false;
+    }
+  }
+  return false;
+}
+
+bool FeatureRecordReader::Fill() {
+  if (!stream_initialized_) {
+    return false;
+  }
+  buffer_.erase(0, position_);
+  position_ = 0;
+  while (true) {
+    if (stream_.avail_in == 0) {
+      file_.read(input_.data(), input_.size());
+      const std::streamsize read_size = file_.gcount();
+      if (read_size <= 0) {
+        return false;
+      }
+      stream_.next_in = reinterpret_cast<Bytef*>(input_.data());
+      stream_.avail_in = static_cast<uInt>(read_size);
+    }
+    stream_.next_out = reinterpret_cast<Bytef*>(output_.data());
+    stream_.avail_out = static_cast<uInt>(output_.size());
+    const int status = inflate(&stream_, Z_NO_FLUSH);
+    if (status == Z_STREAM_END) {
+      // Each block is a gzip member of its own.
+      in_member_ = false;
+      inflateReset(&stream_);
+    } else if (status == Z_OK || status == Z_BUF_ERROR) {
+      in_member_ = true;
+    } else {
+      AERROR << "Failed to decompress the feature file: "
+             << (stream_.msg == nullptr ? "" : stream_.msg);
+      ok_ = false;
+      return false;
+    }
+    const std::size_t output_size = output_.size() - stream_.avail_out;
+    if (output_size > 0) {
+      buffer_.append(output_.data(), output_size);
+      return true;
+    }
+  }
+}
+
+}  // namespace prediction
+}  // namespace apollo
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Streaming reader of compressed feature records
+ */
+
+#ifndef MODULES_PREDICTION_COMMON_FEATURE_RECORD_READER_H_
+#define MODULES_PREDICTION_COMMON_FEATURE_RECORD_READER_H_
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "modules/prediction/proto/feature.pb.h"
+
+/**
+ * @namespace apollo::prediction
+ * @brief apollo::prediction
+ */
+namespace apollo {
+namespace prediction {
+
+/**
+ * @class FeatureRecordReader
+ * @brief Reads the features of a file written by FeatureRecordWriter one by
+ *        one, decompressing the file a chunk at a time.
+ */
+class FeatureRecordReader {
+ public:
+  /**
+   * @brief Constructor
+   * @param file_name The name of the file to read.
+   */
+  explicit FeatureRecordReader(const std::string& file_name);
+
+  /**
+   * @brief Destructor
+   */
+  ~FeatureRecordReader();
+
+  /**
+   * @brief Read the next feature.
+   * @param feature The feature to read into.
+   * @return False at the end of the file or on an error.
+   */
+  bool Next(Feature* feature);
+
+  /**
+   * @brief Check if the file is read without error so far.
+   * @return True if there is no error.
+   */
+  bool ok() const { return ok_; }
+
+ private:
+  // Decompresses more records into the buffer, returns false at the end of
+  // the file or on an error.
+  bool Fill();
+
+  std::ifstream file_;
+  z_stream stream_;
+  bool stream_initialized_ = false;
+  // True in the middle of a gzip member.
+  bool in_member_ = false;
+  bool ok_ = true;
+  std::vector<char> input_;
+  std::vector<char> output_;
+  std::string buffer_;
+  std::size_t position_ = 0;
+
+  FeatureRecordReader(const FeatureRecordReader&) = delete;
+  FeatureRecordReader& operator=(const FeatureRecordReader&) = delete;
+};
+
+}  // namespace prediction
+}  // namespace apollo
+
+#endif  // MODULES_PREDICTION_COMMON_FEATURE_RECORD_READER_H_
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/common/feature_record_writer.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "google/protobuf/io/coded_stream.h"
+
+#include "modules/common/log.h"
+#include "modules/common/util/string_util.h"
+
+namespace apollo {
+namespace prediction {
+
+using ::google::protobuf::io::CodedOutputStream;
+using ::google::protobuf::uint8;
+
+namespace {
+
+// Window bits of zlib for a gzip header and trailer around the deflate data.
+constexpr int kGzipWindowBits = 15 + 16;
+constexpr int kMemLevel = 8;
+
+}  // namespace
+
+FeatureRecordWriter::FeatureRecordWriter(const std::string& file_prefix,
+                                         const std::size_t block_size,
+                                         const std::size_t file_size,
+                                         const std::size_t max_pending_blocks)
+    : file_prefix_(file_prefix),
+      block_size_(block_size),
+      file_size_(file_size),
+      max_pending_blocks_(std::max<std::size_t>(max_pending_blocks, 1)) {
+  records_.reserve(block_size_);
+  thread_ = std::thread(&FeatureRecordWriter::WriterLoop, this);
+}
+
+FeatureRecordWriter::~FeatureRecordWriter() {
+  Flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  block_pushed_.notify_all();
+  thread_.join();
+}
+
+void FeatureRecordWriter::Append(const Feature& feature) {
+  const int size = feature.ByteSize();
+  const std::size_t offset = records_.size();
+  records_.resize(offset + CodedOutputStream::VarintSize32(size) + size);
+  uint8* target = reinterpret_cast<uint8*>(&records_[offset]);
+  target = CodedOutputStream::WriteVarint32ToArray(size, target);
+  feature.SerializeWithCachedSizesToArray(target);
+  ++num_features_;
+  if (records_.size() >= block_size_) {
+    PushBlock(false);
+  }
+}
+
+void FeatureRecordWriter::Flush() {
+  PushBlock(true);
+  std::unique_lock<std::mutex> lock(mutex_);
+  block_written_.wait(
+      lock, [this] { return pending_blocks_.empty() && !writing_; });
+  num_features_ = 0;
+}
+
+void FeatureRecordWriter::Reset() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (Block& block : pending_blocks_) {
+    block.records.clear();
+    free_records_.push_back(std::move(block.records));
+  }
+  pending_blocks_.clear();
+  block_written_.wait(lock, [this] { return !writing_; });
+  CloseFile();
+  file_index_ = 0;
+  records_.clear();
+  num_features_ = 0;
+}
+
+void FeatureRecordWriter::PushBlock(const bool close_file) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  block_written_.wait(lock, [this] {
+    return pending_blocks_.size() < max_pending_blocks_;
+  });
+  Block block;
+  block.records.swap(records_);
+  block.close_file = close_file;
+  pending_blocks_.push_back(std::move(block));
+  if (!free_records_.empty()) {
+    records_.swap(free_records_.back());
+    free_records_.pop_back();
+  } else {
+    records_.reserve(block_size_);
+  }
+  lock.unlock();
+  block_pushed_.notify_one();
+}
+
+void FeatureRecordWriter::WriterLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    block_pushed_.wait(
+        lock, [this] { return stop_ || !pending_blocks_.empty(); });
+    if (pending_blocks_.empty()) {
+      break;
+    }
+    Block block = std::move(pending_blocks_.front());
+    pending_blocks_.pop_front();
+    writing_ = true;
+    lock.unlock();
+
+    WriteBlock(block);
+    if (block.close_file) {
+      CloseFile();
+    }
+
+    lock.lock();
+    writing_ = false;
+    block.records.clear();
+    free_records_.push_back(std::move(block.records));
+    block_written_.notify_all();
+  }
+}
+
+void FeatureRecordWriter::WriteBlock(const Block& block) {
+  if (block.records.empty()) {
+    return;
+  }
+  if (!file_.is_open()) {
+    const std::string file_name = common::util::StrCat(
+        file_prefix_, ".", std::to_string(file_index_), ".bin");
+    ++file_index_;
+    file_.open(file_name, std::ios::out | std::ios::binary);
+    if (!file_.is_open()) {
+      AERROR << "Failed to open feature file " << file_name;
+      return;
+    }
+    written_size_ = 0;
+  }
+
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, kGzipWindowBits,
+                   kMemLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+    AERROR << "Failed to initialize the compression of features.";
+    return;
+  }
+  compressed_.resize(deflateBound(&stream, block.records.size()));
+  stream.next_in = reinterpret_cast<Bytef*>(
+      const_cast<char*>(block.records.data()));
+  stream.avail_in = block.records.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed_[0]);
+  stream.avail_out = compressed_.size();
+  const int status = deflate(&stream, Z_FINISH);
+  const std::size_t compressed_size = stream.total_out;
+  deflateEnd(&stream);
+  if (status != Z_STREAM_END) {
+    AERROR << "Failed to compress " << block.records.size()
+           << " bytes of features.";
+    return;
+  }
+
+  file_.write(compressed_.data(), compressed_size);
+  if (!file_) {
+    AERROR << "Failed to write " << compressed_size << " bytes of features.";
+  }
+  written_size_ += compressed_size;
+  if (written_size_ >= file_size_) {
+    CloseFile();
+  }
+}
+
+void FeatureRecordWriter::CloseFile() {
+  if (file_.is_open()) {
+    file_.close();
+  }
+  file_.clear();
+}
+
+}  // namespace prediction
+}  // namespace apollo
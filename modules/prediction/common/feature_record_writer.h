@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Streaming writer of compressed feature records
+ */
+
+#ifndef MODULES_PREDICTION_COMMON_FEATURE_RECORD_WRITER_H_
+#define MODULES_PREDICTION_COMMON_FEATURE_RECORD_WRITER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "modules/prediction/proto/feature.pb.h"
+
+/**
+ * @namespace apollo::prediction
+ * @brief apollo::prediction
+ */
+namespace apollo {
+namespace prediction {
+
+/**
+ * @class FeatureRecordWriter
+ * @brief Writes features to the files <prefix>.<index>.bin. Each feature is
+ *        a record of its varint32 size followed by its serialized bytes.
+ *        Records are gathered in blocks, and each block is written as one
+ *        gzip member, so that a file is a plain gzip stream of records.
+ *        Blocks are compressed and written on a background thread. A new
+ *        file is started when the current one is large enough, or when the
+ *        writer is flushed.
+ */
+class FeatureRecordWriter {
+ public:
+  /**
+   * @brief Constructor
+   * @param file_prefix The prefix of the file names.
+   * @param block_size The size in bytes of uncompressed records in a block.
+   * @param file_size The compressed size in bytes after which a new file
+   *        is started.
+   * @param max_pending_blocks The maximal number of blocks waiting to be
+   *        written, after which Append waits for the background thread.
+   */
+  FeatureRecordWriter(const std::string& file_prefix,
+                      const std::size_t block_size,
+                      const std::size_t file_size,
+                      const std::size_t max_pending_blocks);
+
+  /**
+   * @brief Destructor, flushing the features appended.
+   */
+  ~FeatureRecordWriter();
+
+  /**
+   * @brief Append a feature.
+   * @param feature The feature to append.
+   */
+  void Append(const Feature& feature);
+
+  /**
+   * @brief Write all the features appended and close the current file, so
+   *        that the next feature goes to a new file.
+   */
+  void Flush();
+
+  /**
+   * @brief Drop the features which are not written yet, and start again
+   *        from the first file index.
+   */
+  void Reset();
+
+  /**
+   * @brief Get the number of features appended since the last flush.
+   * @return The number of features.
+   */
+  int NumFeatures() const { return num_features_; }
+
+ private:
+  struct Block {
+    std::string records;
+    // Close the current file once the block is written.
+    bool close_file = false;
+  };
+
+  void PushBlock(const bool close_file);
+
+  void WriterLoop();
+
+  void WriteBlock(const Block& block);
+
+  void CloseFile();
+
+  const std::string file_prefix_;
+  const std::size_t block_size_;
+  const std::size_t file_size_;
+  const std::size_t max_pending_blocks_;
+
+  // Accessed by the appending thread only.
+  std::string records_;
+  int num_features_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable block_pushed_;
+  std::condition_variable block_written_;
+  std::deque<Block> pending_blocks_;
+  // The record buffers of written blocks, reused by the next blocks.
+  std::vector<std::string> free_records_;
+  bool writing_ = false;
+  bool stop_ = false;
+
+  // Accessed by the background thread only, or under the mutex when it is
+  // idle.
+  std::ofstream file_;
+  std::size_t file_index_ = 0;
+  std::size_t written_size_ = 0;
+  std::string compressed_;
+
+  std::thread thread_;
+
+  FeatureRecordWriter(const FeatureRecordWriter&) = delete;
+  FeatureRecordWriter& operator=(const FeatureRecordWriter&) = delete;
+};
+
+}  // namespace prediction
+}  // namespace apollo
+
+#endif  // MODULES_PREDICTION_COMMON_FEATURE_RECORD_WRITER_H_
@@ -0,0 +1,193 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/common/feature_record_writer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/prediction/common/feature_record_reader.h"
+
+namespace apollo {
+namespace prediction {
+
+class FeatureRecordWriterTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    const char* temp_dir = std::getenv("TEST_TMPDIR");
+    prefix_ = std::string(temp_dir == nullptr ? "/tmp" : temp_dir) + "/" +
+              ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    RemoveFiles();
+  }
+
+  void TearDown() override { RemoveFiles(); }
+
+ protected:
+  std::string FileName(const int index) const {
+    return prefix_ + "." + std::to_string(index) + ".bin";
+  }
+
+  bool FileExists(const int index) const {
+    return std::ifstream(FileName(index)).good();
+  }
+
+  void RemoveFiles() const {
+    for (int i = 0; FileExists(i); ++i) {
+      std::remove(FileName(i).c_str());
+    }
+  }
+
+  static Feature BuildFeature(const int i) {
+    Feature feature;
+    feature.set_id(i % 7);
+    feature.set_timestamp(0.1 * i);
+    feature.mutable_position()->set_x(i);
+    feature.mutable_position()->set_y(-i);
+    feature.set_speed(0.5 * i);
+    for (int j = 0; j < i % 5; ++j) {
+      LaneSequence* lane_sequence =
+          feature.mutable_lane()->mutable_lane_graph()->add_lane_sequence();
+      lane_sequence->set_lane_sequence_id(j);
+      lane_sequence->add_lane_segment()->set_lane_id("lane_" +
+                                                     std::to_string(j));
+    }
+    return feature;
+  }
+
+  std::vector<Feature> ReadFile(const int index, bool* ok) const {
+    std::vector<Feature> features;
+    FeatureRecordReader reader(FileName(index));
+    Feature feature;
+    while (reader.Next(&feature)) {
+      features.push_back(feature);
+    }
+    *ok = reader.ok();
+    return features;
+  }
+
+  std::string prefix_;
+};
+
+TEST_F(FeatureRecordWriterTest, WriteAndRead) {
+  {
+    FeatureRecordWriter writer(prefix_, 256, 1 << 20, 1);
+    for (int i = 0; i < 200; ++i) {
+      writer.Append(BuildFeature(i));
+    }
+    EXPECT_EQ(200, writer.NumFeatures());
+    writer.Flush();
+    EXPECT_EQ(0, writer.NumFeatures());
+    EXPECT_TRUE(FileExists(0));
+    EXPECT_FALSE(FileExists(1));
+  }
+
+  bool ok = false;
+  std::vector<Feature> features = ReadFile(0, &ok);
+  EXPECT_TRUE(ok);
+  ASSERT_EQ(200, features.size());
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(BuildFeature(i).SerializeAsString(),
+              features[i].SerializeAsString());
+  }
+}
+
+TEST_F(FeatureRecordWriterTest, RollFiles) {
+  {
+    // Every block goes to a file of its own.
+    FeatureRecordWriter writer(prefix_, 512, 1, 2);
+    for (int i = 0; i < 100; ++i) {
+      writer.Append(BuildFeature(i));
+    }
+  }
+  EXPECT_TRUE(FileExists(1));
+
+  int num_features = 0;
+  for (int index = 0; FileExists(index); ++index) {
+    bool ok = false;
+    for (const Feature& feature : ReadFile(index, &ok)) {
+      EXPECT_EQ(BuildFeature(num_features).SerializeAsString(),
+                feature.SerializeAsString());
+      ++num_features;
+    }
+    EXPECT_TRUE(ok);
+  }
+  EXPECT_EQ(100, num_features);
+}
+
+TEST_F(FeatureRecordWriterTest, FlushAndReset) {
+  FeatureRecordWriter writer(prefix_, 1 << 20, 1 << 20, 4);
+  writer.Flush();
+  EXPECT_FALSE(FileExists(0));
+
+  writer.Append(BuildFeature(0));
+  writer.Flush();
+  writer.Append(BuildFeature(1));
+  writer.Flush();
+  writer.Append(BuildFeature(2));
+  writer.Reset();
+  EXPECT_EQ(0, writer.NumFeatures());
+  EXPECT_TRUE(FileExists(1));
+  EXPECT_FALSE(FileExists(2));
+
+  writer.Append(BuildFeature(3));
+  writer.Flush();
+  bool ok = false;
+  std::vector<Feature> features = ReadFile(0, &ok);
+  EXPECT_TRUE(ok);
+  ASSERT_EQ(1, features.size());
+  EXPECT_EQ(3, features[0].id());
+  features = ReadFile(1, &ok);
+  ASSERT_EQ(1, features.size());
+  EXPECT_EQ(1, features[0].id());
+}
+
+TEST_F(FeatureRecordWriterTest, TruncatedFile) {
+  {
+    FeatureRecordWriter writer(prefix_, 1 << 20, 1 << 20, 1);
+    for (int i = 0; i < 50; ++i) {
+      writer.Append(BuildFeature(i));
+    }
+  }
+  std::string content;
+  {
+    std::ifstream file(FileName(0), std::ios::in | std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file(FileName(0), std::ios::out | std::ios::binary);
+    file.write(content.data(), content.size() / 2);
+  }
+
+  bool ok = true;
+  std::vector<Feature> features = ReadFile(0, &ok);
+  EXPECT_FALSE(ok);
+  EXPECT_GT(50, features.size());
+
+  FeatureRecordReader reader(FileName(1));
+  Feature feature;
+  EXPECT_FALSE(reader.Next(&feature));
+  EXPECT_FALSE(reader.ok());
+}
+
+}  // namespace prediction
+}  // namespace apollo
@@ -20,6 +20,7 @@
 #include "gtest/gtest.h"
 
 #include "modules/common/configs/config_gflags.h"
+#include "modules/prediction/common/prediction_map.h"
 
 namespace apollo {
 namespace prediction {
@@ -29,6 +30,7 @@ class KMLMapBasedTest : public ::testing::Test {
   KMLMapBasedTest() {
     FLAGS_map_dir = "modules/prediction/testdata";
     FLAGS_base_map_filename = "kml_map.bin";
+    PredictionMap::UpdateMap();
   }
 };
 
@@ -29,6 +29,15 @@ DEFINE_string(prediction_adapter_config_filename,
               "Default conf file for prediction");
 DEFINE_string(prediction_data_file_prefix, "data/prediction/feature",
               "Prefix of files to store feature data");
+DEFINE_int32(prediction_feature_block_size, 1 << 20,
+             "Size in bytes of the features compressed together in offline "
+             "mode");
+DEFINE_int32(prediction_feature_file_size, 256 << 20,
+             "Compressed size in bytes after which features are written to "
+             "a new file in offline mode");
+DEFINE_int32(prediction_max_pending_feature_blocks, 4,
+             "Maximal number of feature blocks waiting to be written in "
+             "offline mode");
 DEFINE_bool(prediction_test_mode, false, "Set prediction to test mode");
 DEFINE_double(
     prediction_test_duration, -1.0,
@@ -36,6 +45,9 @@ DEFINE_double(
     "restrict the runtime duration.");
 
 DEFINE_bool(prediction_offline_mode, false, "Prediction offline mode");
+DEFINE_bool(enable_multi_thread_in_prediction, false,
+            "Enable multiple thread to build the features, evaluate and "
+            "predict the obstacles concurrently.");
 
 DEFINE_double(prediction_duration, 8.0, "Prediction duration (in seconds)");
 DEFINE_double(prediction_period, 0.1, "Prediction period (in seconds");
@@ -77,6 +89,9 @@ DEFINE_double(still_obstacle_position_std, 1.0,
 DEFINE_double(still_pedestrian_position_std, 0.5,
               "Position standard deviation for still obstacles");
 DEFINE_double(max_history_time, 7.0, "Obstacles' maximal historical time.");
+DEFINE_int32(max_history_length, 70,
+             "Obstacles' maximal # historical frames, which covers "
+             "max_history_time at 10 Hz");
 DEFINE_double(target_lane_gap, 2.0, "gap between two lane points.");
 DEFINE_int32(max_num_current_lane, 2, "Max number to search current lanes");
 DEFINE_int32(max_num_nearby_lane, 2, "Max number to search nearby lanes");
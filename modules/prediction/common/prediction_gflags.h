@@ -24,11 +24,15 @@ DECLARE_string(prediction_module_name);
 DECLARE_string(prediction_conf_file);
 DECLARE_string(prediction_adapter_config_filename);
 DECLARE_string(prediction_data_file_prefix);
+DECLARE_int32(prediction_feature_block_size);
+DECLARE_int32(prediction_feature_file_size);
+DECLARE_int32(prediction_max_pending_feature_blocks);
 
 DECLARE_bool(prediction_test_mode);
 DECLARE_double(prediction_test_duration);
 
 DECLARE_bool(prediction_offline_mode);
+DECLARE_bool(enable_multi_thread_in_prediction);
 
 DECLARE_double(prediction_duration);
 DECLARE_double(prediction_period);
@@ -60,6 +64,7 @@ DECLARE_double(still_pedestrian_speed_threshold);
 DECLARE_double(still_obstacle_position_std);
 DECLARE_double(still_pedestrian_position_std);
 DECLARE_double(max_history_time);
+DECLARE_int32(max_history_length);
 DECLARE_double(target_lane_gap);
 DECLARE_int32(max_num_current_lane);
 DECLARE_int32(max_num_nearby_lane);
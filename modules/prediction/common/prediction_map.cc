@@ -41,9 +41,38 @@ using apollo::hdmap::HDMapUtil;
 using apollo::hdmap::Id;
 using apollo::hdmap::JunctionInfo;
 using apollo::hdmap::LaneInfo;
+using apollo::hdmap::LaneRelation;
+using apollo::hdmap::LaneTopology;
 using apollo::hdmap::MapPathPoint;
 
-bool PredictionMap::Ready() { return HDMapUtil::BaseMapPtr() != nullptr; }
+namespace {
+
+// Checks whether other_lane is in the relation to lane in the lane topology
+// of the base map, without comparing lane id strings.
+bool IsRelatedLane(const LaneRelation relation, const LaneInfo& lane,
+                   const LaneInfo& other_lane) {
+  const LaneTopology& topology = PredictionMap::BaseMap().lane_topology();
+  const int index = topology.GetLaneIndex(lane);
+  const int other_index = topology.GetLaneIndex(other_lane);
+  return index != LaneTopology::kInvalidLaneIndex &&
+         other_index != LaneTopology::kInvalidLaneIndex &&
+         topology.IsRelated(relation, index, other_index);
+}
+
+}  // namespace
+
+std::shared_ptr<const hdmap::HDMap> PredictionMap::hdmap_ = nullptr;
+
+bool PredictionMap::Ready() {
+  return hdmap_ != nullptr || UpdateMap();
+}
+
+bool PredictionMap::UpdateMap() {
+  hdmap_ = HDMapUtil::BaseMapSnapshot();
+  return hdmap_ != nullptr;
+}
+
+const hdmap::HDMap& PredictionMap::BaseMap() { return *CHECK_NOTNULL(hdmap_); }
 
 Eigen::Vector2d PredictionMap::PositionOnLane(
     std::shared_ptr<const LaneInfo> lane_info, const double s) {
@@ -72,7 +101,7 @@ double PredictionMap::LaneTotalWidth(
 
 std::shared_ptr<const LaneInfo> PredictionMap::LaneById(
     const std::string& str_id) {
-  return HDMapUtil::BaseMap().GetLaneById(hdmap::MakeMapId(str_id));
+  return BaseMap().GetLaneById(hdmap::MakeMapId(str_id));
 }
 
 bool PredictionMap::GetProjection(const Eigen::Vector2d& position,
@@ -101,7 +130,7 @@ bool PredictionMap::ProjectionFromLane(
 
 bool PredictionMap::IsVirtualLane(const std::string& lane_id) {
   std::shared_ptr<const LaneInfo> lane_info =
-      HDMapUtil::BaseMap().GetLaneById(hdmap::MakeMapId(lane_id));
+      BaseMap().GetLaneById(hdmap::MakeMapId(lane_id));
   if (lane_info == nullptr) {
     return false;
   }
@@ -121,7 +150,7 @@ bool PredictionMap::OnVirtualLane(const Eigen::Vector2d& point,
   common::PointENU hdmap_point;
   hdmap_point.set_x(point[0]);
   hdmap_point.set_y(point[1]);
-  HDMapUtil::BaseMap().GetLanes(hdmap_point, radius, &lanes);
+  BaseMap().GetLanes(hdmap_point, radius, &lanes);
   for (const auto& lane : lanes) {
     if (IsVirtualLane(lane->id().id())) {
       return true;
@@ -141,12 +170,55 @@ void PredictionMap::OnLane(
   common::PointENU hdmap_point;
   hdmap_point.set_x(point[0]);
   hdmap_point.set_y(point[1]);
-  if (HDMapUtil::BaseMap().GetLanesWithHeading(hdmap_point, radius, heading,
+  if (BaseMap().GetLanesWithHeading(hdmap_point, radius, heading,
                                                max_lane_angle_diff,
                                                &candidate_lanes) != 0) {
     return;
   }
+  SelectLanes(prev_lanes, point, heading, on_lane, max_num_lane,
+              max_lane_angle_diff, candidate_lanes, lanes);
+}
+
+void PredictionMap::OnLane(
+    const std::vector<std::shared_ptr<const LaneInfo>>& prev_lanes,
+    const Eigen::Vector2d& point, const double heading, const double radius,
+    const bool on_lane, const int max_num_lane,
+    const double max_lane_angle_diff,
+    const std::vector<std::shared_ptr<const LaneInfo>>& candidate_lanes,
+    std::vector<std::shared_ptr<const LaneInfo>>* lanes) {
+  std::vector<std::shared_ptr<const LaneInfo>> lanes_with_heading;
 
+  common::PointENU hdmap_point;
+  hdmap_point.set_x(point[0]);
+  hdmap_point.set_y(point[1]);
+  if (BaseMap().GetLanesWithHeading(hdmap_point, radius, heading,
+                                    max_lane_angle_diff, candidate_lanes,
+                                    &lanes_with_heading) != 0) {
+    return;
+  }
+  SelectLanes(prev_lanes, point, heading, on_lane, max_num_lane,
+              max_lane_angle_diff, lanes_with_heading, lanes);
+}
+
+void PredictionMap::NearbyLanesBatch(
+    const std::vector<Eigen::Vector2d>& points, const double radius,
+    std::vector<std::vector<std::shared_ptr<const LaneInfo>>>* lanes) {
+  std::vector<common::PointENU> hdmap_points(points.size());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    hdmap_points[i].set_x(points[i][0]);
+    hdmap_points[i].set_y(points[i][1]);
+  }
+  if (BaseMap().GetLanesBatch(hdmap_points, radius, lanes) != 0) {
+    lanes->assign(points.size(), {});
+  }
+}
+
+void PredictionMap::SelectLanes(
+    const std::vector<std::shared_ptr<const LaneInfo>>& prev_lanes,
+    const Eigen::Vector2d& point, const double heading, const bool on_lane,
+    const int max_num_lane, const double max_lane_angle_diff,
+    const std::vector<std::shared_ptr<const LaneInfo>>& candidate_lanes,
+    std::vector<std::shared_ptr<const LaneInfo>>* lanes) {
   const common::math::Vec2d vec_point(point[0], point[1]);
   std::vector<std::pair<std::shared_ptr<const LaneInfo>, double>> lane_pairs;
   for (const auto& candidate_lane : candidate_lanes) {
@@ -198,7 +270,7 @@ bool PredictionMap::NearJunction(const Eigen::Vector2d& point,
   hdmap_point.set_x(point[0]);
   hdmap_point.set_y(point[1]);
   std::vector<std::shared_ptr<const JunctionInfo>> junctions;
-  HDMapUtil::BaseMap().GetJunctions(hdmap_point, radius, &junctions);
+  BaseMap().GetJunctions(hdmap_point, radius, &junctions);
   return junctions.size() > 0;
 }
 
@@ -208,7 +280,7 @@ std::vector<std::shared_ptr<const JunctionInfo>> PredictionMap::GetJunctions(
   hdmap_point.set_x(point[0]);
   hdmap_point.set_y(point[1]);
   std::vector<std::shared_ptr<const JunctionInfo>> junctions;
-  HDMapUtil::BaseMap().GetJunctions(hdmap_point, radius, &junctions);
+  BaseMap().GetJunctions(hdmap_point, radius, &junctions);
   return junctions;
 }
 
@@ -274,39 +346,54 @@ void PredictionMap::NearbyLanesByCurrentLanes(
     OnLane(prev_lanes, point, heading, radius, false, max_num_lane,
            FLAGS_max_lane_angle_diff, nearby_lanes);
   } else {
-    std::unordered_set<std::string> lane_ids;
-    for (auto& lane_ptr : lanes) {
-      if (lane_ptr == nullptr) {
-        continue;
-      }
-      for (auto& lane_id : lane_ptr->lane().left_neighbor_forward_lane_id()) {
-        const std::string& id = lane_id.id();
-        if (lane_ids.find(id) != lane_ids.end()) {
-          continue;
-        }
-        std::shared_ptr<const LaneInfo> nearby_lane = LaneById(id);
-        double s = -1.0;
-        double l = 0.0;
-        GetProjection(point, nearby_lane, &s, &l);
-        if (s >= 0.0 && std::fabs(l) > radius) {
-          continue;
-        }
-        lane_ids.insert(id);
-        nearby_lanes->push_back(nearby_lane);
-      }
-      for (auto& lane_id : lane_ptr->lane().right_neighbor_forward_lane_id()) {
-        const std::string& id = lane_id.id();
-        if (lane_ids.find(id) != lane_ids.end()) {
+    NeighborLanes(point, radius, lanes, nearby_lanes);
+  }
+}
+
+void PredictionMap::NearbyLanesByCurrentLanes(
+    const Eigen::Vector2d& point, const double heading, const double radius,
+    const std::vector<std::shared_ptr<const LaneInfo>>& lanes,
+    const int max_num_lane,
+    const std::vector<std::shared_ptr<const LaneInfo>>& candidate_lanes,
+    std::vector<std::shared_ptr<const LaneInfo>>* nearby_lanes) {
+  if (lanes.size() == 0) {
+    std::vector<std::shared_ptr<const LaneInfo>> prev_lanes(0);
+    OnLane(prev_lanes, point, heading, radius, false, max_num_lane,
+           FLAGS_max_lane_angle_diff, candidate_lanes, nearby_lanes);
+  } else {
+    NeighborLanes(point, radius, lanes, nearby_lanes);
+  }
+}
+
+void PredictionMap::NeighborLanes(
+    const Eigen::Vector2d& point, const double radius,
+    const std::vector<std::shared_ptr<const LaneInfo>>& lanes,
+    std::vector<std::shared_ptr<const LaneInfo>>* nearby_lanes) {
+  const LaneTopology& topology = BaseMap().lane_topology();
+  std::unordered_set<int> lane_indices;
+  for (auto& lane_ptr : lanes) {
+    if (lane_ptr == nullptr) {
+      continue;
+    }
+    const int lane_index = topology.GetLaneIndex(*lane_ptr);
+    if (lane_index == LaneTopology::kInvalidLaneIndex) {
+      continue;
+    }
+    for (const LaneRelation relation : {hdmap::LANE_LEFT_FORWARD_NEIGHBOR,
+                                        hdmap::LANE_RIGHT_FORWARD_NEIGHBOR}) {
+      for (const int index : topology.GetRelatedLanes(relation, lane_index)) {
+        if (lane_indices.find(index) != lane_indices.end()) {
           continue;
         }
-        std::shared_ptr<const LaneInfo> nearby_lane = LaneById(id);
+        const std::shared_ptr<const LaneInfo>& nearby_lane =
+            topology.lane(index);
         double s = -1.0;
         double l = 0.0;
         GetProjection(point, nearby_lane, &s, &l);
         if (s >= 0.0 && std::fabs(l) > radius) {
           continue;
         }
-        lane_ids.insert(id);
+        lane_indices.insert(index);
         nearby_lanes->push_back(nearby_lane);
       }
     }
@@ -320,7 +407,7 @@ std::vector<std::string> PredictionMap::NearbyLaneIds(
   common::PointENU hdmap_point;
   hdmap_point.set_x(point[0]);
   hdmap_point.set_y(point[1]);
-  HDMapUtil::BaseMap().GetLanes(hdmap_point, radius, &lanes);
+  BaseMap().GetLanes(hdmap_point, radius, &lanes);
   for (const auto& lane : lanes) {
     lane_ids.push_back(lane->id().id());
   }
@@ -336,13 +423,8 @@ bool PredictionMap::IsLeftNeighborLane(
   if (left_lane == nullptr) {
     return false;
   }
-  for (const auto& left_lane_id :
-       curr_lane->lane().left_neighbor_forward_lane_id()) {
-    if (left_lane->id().id() == left_lane_id.id()) {
-      return true;
-    }
-  }
-  return false;
+  return IsRelatedLane(hdmap::LANE_LEFT_FORWARD_NEIGHBOR, *curr_lane,
+                       *left_lane);
 }
 
 bool PredictionMap::IsLeftNeighborLane(
@@ -368,13 +450,8 @@ bool PredictionMap::IsRightNeighborLane(
   if (right_lane == nullptr) {
     return false;
   }
-  for (auto& right_lane_id :
-       curr_lane->lane().right_neighbor_forward_lane_id()) {
-    if (right_lane->id().id() == right_lane_id.id()) {
-      return true;
-    }
-  }
-  return false;
+  return IsRelatedLane(hdmap::LANE_RIGHT_FORWARD_NEIGHBOR, *curr_lane,
+                       *right_lane);
 }
 
 bool PredictionMap::IsRightNeighborLane(
@@ -399,12 +476,7 @@ bool PredictionMap::IsSuccessorLane(std::shared_ptr<const LaneInfo> succ_lane,
   if (succ_lane == nullptr) {
     return false;
   }
-  for (auto& successor_lane_id : curr_lane->lane().successor_id()) {
-    if (succ_lane->id().id() == successor_lane_id.id()) {
-      return true;
-    }
-  }
-  return false;
+  return IsRelatedLane(hdmap::LANE_SUCCESSOR, *curr_lane, *succ_lane);
 }
 
 bool PredictionMap::IsSuccessorLane(
@@ -430,12 +502,7 @@ bool PredictionMap::IsPredecessorLane(
   if (pred_lane == nullptr) {
     return false;
   }
-  for (auto& predecessor_lane_id : curr_lane->lane().predecessor_id()) {
-    if (pred_lane->id().id() == predecessor_lane_id.id()) {
-      return true;
-    }
-  }
-  return false;
+  return IsRelatedLane(hdmap::LANE_PREDECESSOR, *curr_lane, *pred_lane);
 }
 
 bool PredictionMap::IsPredecessorLane(
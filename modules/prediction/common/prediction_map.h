@@ -24,6 +24,7 @@
 #include "Eigen/Dense"
 
 #include "modules/common/macro.h"
+#include "modules/map/hdmap/hdmap.h"
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/map/hdmap/hdmap_impl.h"
 #include "modules/map/pnc_map/path.h"
@@ -39,6 +40,23 @@ class PredictionMap {
    */
   static bool Ready();
 
+  /**
+   * @brief Take the current snapshot of the base map for the following
+   *        queries. It is called once at the start of each prediction cycle,
+   *        so that all the queries of the cycle see the same map even if the
+   *        maps are reloaded meanwhile. It must not run concurrently with
+   *        queries.
+   * @return True if a map is available
+   */
+  static bool UpdateMap();
+
+  /**
+   * @brief Get the map snapshot the queries use. It must not be called
+   *        unless Ready() or the last UpdateMap() has returned true.
+   * @return The map snapshot
+   */
+  static const hdmap::HDMap& BaseMap();
+
   /**
    * @brief Get the position of a point on a specific distance along a lane.
    * @param lane_info The lane to get a position.
@@ -133,6 +151,38 @@ class PredictionMap {
       const double max_lane_angle_diff,
       std::vector<std::shared_ptr<const hdmap::LaneInfo>>* lanes);
 
+  /**
+   * @brief Get the connected lanes from some specified lanes among candidate
+   *        lanes, which are searched with a radius no smaller than radius,
+   *        such as by NearbyLanesBatch.
+   * @param prev_lanes The lanes from which to search their connected lanes.
+   * @param heading The specified heading.
+   * @param radius The searching radius.
+   * @param on_lane If the position is on lane.
+   * @param candidate_lanes The lanes to search.
+   * @param lanes The searched lanes.
+   */
+  static void OnLane(
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>& prev_lanes,
+      const Eigen::Vector2d& point, const double heading, const double radius,
+      const bool on_lane, const int max_num_lane,
+      const double max_lane_angle_diff,
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>&
+          candidate_lanes,
+      std::vector<std::shared_ptr<const hdmap::LaneInfo>>* lanes);
+
+  /**
+   * @brief Get the lanes near each of some positions, searching the lanes
+   *        of the base map once for all positions.
+   * @param points The positions to search their nearby lanes.
+   * @param radius The searching radius.
+   * @param lanes The searched lanes, one vector per position.
+   */
+  static void NearbyLanesBatch(
+      const std::vector<Eigen::Vector2d>& points, const double radius,
+      std::vector<std::vector<std::shared_ptr<const hdmap::LaneInfo>>>*
+          lanes);
+
   /**
    * @brief Check if there are any junctions within the range centered at
    *        a certain point with a radius.
@@ -195,6 +245,24 @@ class PredictionMap {
       const int max_num_lane,
       std::vector<std::shared_ptr<const hdmap::LaneInfo>>* nearby_lanes);
 
+  /**
+   * @brief Get nearby lanes by a position and current lanes, searching among
+   *        candidate lanes if there are no current lanes.
+   * @param point The position to search its nearby lanes.
+   * @param heading The heading of an obstacle.
+   * @param radius The searching radius.
+   * @param lanes The current lanes.
+   * @param candidate_lanes The lanes within a radius no smaller than radius.
+   * @param nearby_lanes The searched nearby lanes.
+   */
+  static void NearbyLanesByCurrentLanes(
+      const Eigen::Vector2d& point, const double heading, const double radius,
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>& lanes,
+      const int max_num_lane,
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>&
+          candidate_lanes,
+      std::vector<std::shared_ptr<const hdmap::LaneInfo>>* nearby_lanes);
+
   /**
    * @brief Get nearby lanes by a position.
    * @param point The position to search its nearby lanes.
@@ -311,6 +379,21 @@ class PredictionMap {
 
  private:
   PredictionMap() = delete;
+
+  static void SelectLanes(
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>& prev_lanes,
+      const Eigen::Vector2d& point, const double heading, const bool on_lane,
+      const int max_num_lane, const double max_lane_angle_diff,
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>&
+          candidate_lanes,
+      std::vector<std::shared_ptr<const hdmap::LaneInfo>>* lanes);
+
+  static void NeighborLanes(
+      const Eigen::Vector2d& point, const double radius,
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>& lanes,
+      std::vector<std::shared_ptr<const hdmap::LaneInfo>>* nearby_lanes);
+
+  static std::shared_ptr<const hdmap::HDMap> hdmap_;
 };
 
 }  // namespace prediction
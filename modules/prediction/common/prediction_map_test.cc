@@ -145,6 +145,37 @@ TEST_F(PredictionMapTest, on_lane) {
   EXPECT_EQ(0, curr_lanes.size());
 }
 
+TEST_F(PredictionMapTest, on_lane_among_nearby_lanes) {
+  const std::vector<Eigen::Vector2d> points = {{124.85931, 347.52733},
+                                               {124.85931, 357.52733},
+                                               {124.85931, 348.52733}};
+  const double heading = 0.0;
+  const double radius = 3.0;
+  std::vector<std::vector<std::shared_ptr<const LaneInfo>>> nearby_lanes;
+  PredictionMap::NearbyLanesBatch(points, radius, &nearby_lanes);
+  ASSERT_EQ(points.size(), nearby_lanes.size());
+
+  const std::vector<std::shared_ptr<const LaneInfo>> prev_lanes(0);
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    std::vector<std::shared_ptr<const LaneInfo>> expected_lanes;
+    PredictionMap::OnLane(prev_lanes, points[i], heading, radius, true,
+                          FLAGS_max_num_current_lane,
+                          FLAGS_max_lane_angle_diff, &expected_lanes);
+    std::vector<std::shared_ptr<const LaneInfo>> curr_lanes;
+    PredictionMap::OnLane(prev_lanes, points[i], heading, radius, true,
+                          FLAGS_max_num_current_lane,
+                          FLAGS_max_lane_angle_diff, nearby_lanes[i],
+                          &curr_lanes);
+    EXPECT_EQ(expected_lanes, curr_lanes);
+  }
+  std::vector<std::shared_ptr<const LaneInfo>> curr_lanes;
+  PredictionMap::OnLane(prev_lanes, points[0], heading, radius, true,
+                        FLAGS_max_num_current_lane, FLAGS_max_lane_angle_diff,
+                        nearby_lanes[0], &curr_lanes);
+  ASSERT_EQ(1, curr_lanes.size());
+  EXPECT_EQ("l20", curr_lanes[0]->id().id());
+}
+
 TEST_F(PredictionMapTest, get_path_heading) {
   std::shared_ptr<const LaneInfo> lane_info = PredictionMap::LaneById("l20");
   common::PointENU point;
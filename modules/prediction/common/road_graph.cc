@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "modules/common/util/string_util.h"
+#include "modules/map/hdmap/hdmap_util.h"
 #include "modules/prediction/common/prediction_map.h"
 
 namespace apollo {
@@ -107,10 +108,15 @@ void RoadGraph::ComputeLaneSequence(
   } else {
     const double successor_accumulated_s =
         accumulated_s + lane_info_ptr->total_length() - start_s;
-    for (const auto& successor_lane_id : lane_info_ptr->lane().successor_id()) {
-      auto successor_lane = PredictionMap::LaneById(successor_lane_id.id());
-      ComputeLaneSequence(successor_accumulated_s, 0.0, successor_lane,
-                          lane_segments, lane_graph_ptr);
+    const hdmap::LaneTopology& topology =
+        PredictionMap::BaseMap().lane_topology();
+    const int lane_index = topology.GetLaneIndex(*lane_info_ptr);
+    if (lane_index != hdmap::LaneTopology::kInvalidLaneIndex) {
+      for (const int successor : topology.successors(lane_index)) {
+        ComputeLaneSequence(successor_accumulated_s, 0.0,
+                            topology.lane(successor), lane_segments,
+                            lane_graph_ptr);
+      }
     }
   }
   lane_segments->pop_back();
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/container/obstacles/feature_history.h"
+
+#include <utility>
+
+#include "modules/common/log.h"
+
+namespace apollo {
+namespace prediction {
+
+namespace {
+
+FeatureSummary Summarize(const Feature& feature) {
+  FeatureSummary summary;
+  summary.timestamp = feature.timestamp();
+  summary.position_x = feature.position().x();
+  summary.position_y = feature.position().y();
+  summary.speed = feature.speed();
+  if (feature.has_lane() && feature.lane().has_lane_feature()) {
+    const LaneFeature& lane_feature = feature.lane().lane_feature();
+    summary.has_lane_feature = true;
+    summary.lane_turn_type = lane_feature.lane_turn_type();
+    summary.lane_l = lane_feature.lane_l();
+    summary.angle_diff = lane_feature.angle_diff();
+    summary.dist_to_left_boundary = lane_feature.dist_to_left_boundary();
+    summary.dist_to_right_boundary = lane_feature.dist_to_right_boundary();
+  }
+  return summary;
+}
+
+// Deletes the elements which a repeated field keeps for reuse once cleared.
+template <typename T>
+void ReleaseCleared(google::protobuf::RepeatedPtrField<T>* field) {
+  while (field->ClearedCount() > 0) {
+    delete field->ReleaseCleared();
+  }
+}
+
+// Deletes the messages which a reused feature keeps from the features it held
+// before, other than the ones it holds now, so that a slot never takes more
+// memory than its latest feature.
+void ReleaseClearedMessages(Feature* feature) {
+  if (!feature->has_lane()) {
+    delete feature->release_lane();
+    return;
+  }
+  Lane* lane = feature->mutable_lane();
+  ReleaseCleared(lane->mutable_current_lane_feature());
+  ReleaseCleared(lane->mutable_nearby_lane_feature());
+  if (!lane->has_lane_graph()) {
+    delete lane->release_lane_graph();
+    return;
+  }
+  LaneGraph* lane_graph = lane->mutable_lane_graph();
+  ReleaseCleared(lane_graph->mutable_lane_sequence());
+  for (LaneSequence& lane_sequence : *lane_graph->mutable_lane_sequence()) {
+    ReleaseCleared(lane_sequence.mutable_lane_segment());
+    ReleaseCleared(lane_sequence.mutable_nearby_obstacle());
+    ReleaseCleared(lane_sequence.mutable_path_point());
+    for (LaneSegment& lane_segment : *lane_sequence.mutable_lane_segment()) {
+      ReleaseCleared(lane_segment.mutable_lane_point());
+    }
+  }
+}
+
+}  // namespace
+
+FeatureHistory::FeatureHistory(const std::size_t capacity)
+    : slots_(capacity + 1) {
+  CHECK_GT(capacity, 0);
+}
+
+FeatureHistory::FeatureHistory(const FeatureHistory& other) { *this = other; }
+
+FeatureHistory& FeatureHistory::operator=(const FeatureHistory& other) {
+  if (this == &other) {
+    return *this;
+  }
+  Clear();
+  slots_.resize(other.slots_.size());
+  for (std::size_t i = other.size(); i > 0; --i) {
+    Feature* feature = NewFeature();
+    feature->CopyFrom(other.feature(i - 1));
+    PushFront(feature);
+    slots_[front_]->summary = other.summary(i - 1);
+  }
+  return *this;
+}
+
+FeatureHistory::FeatureHistory(FeatureHistory&& other)
+    : slots_(other.slots_.size()) {
+  *this = std::move(other);
+}
+
+FeatureHistory& FeatureHistory::operator=(FeatureHistory&& other) {
+  slots_.swap(other.slots_);
+  std::swap(front_, other.front_);
+  std::swap(size_, other.size_);
+  return *this;
+}
+
+const Feature& FeatureHistory::feature(const std::size_t i) const {
+  CHECK_LT(i, size_);
+  return slots_[Index(i)]->feature;
+}
+
+Feature* FeatureHistory::mutable_feature(const std::size_t i) {
+  CHECK_LT(i, size_);
+  return &slots_[Index(i)]->feature;
+}
+
+const FeatureSummary& FeatureHistory::summary(const std::size_t i) const {
+  CHECK_LT(i, size_);
+  return slots_[Index(i)]->summary;
+}
+
+Feature* FeatureHistory::NewFeature() {
+  Feature* feature = &NextSlot()->feature;
+  feature->Clear();
+  return feature;
+}
+
+void FeatureHistory::PushFront(Feature* feature) {
+  Slot* slot = NextSlot();
+  if (feature != &slot->feature) {
+    slot->feature.Swap(feature);
+  }
+  ReleaseClearedMessages(&slot->feature);
+  slot->summary = Summarize(slot->feature);
+  if (size_ == capacity()) {
+    PopBack();
+  }
+  front_ = NextIndex();
+  ++size_;
+}
+
+void FeatureHistory::PopBack() {
+  CHECK_GT(size_, 0);
+  --size_;
+}
+
+void FeatureHistory::Clear() { size_ = 0; }
+
+std::size_t FeatureHistory::Index(const std::size_t i) const {
+  return (front_ + i) % slots_.size();
+}
+
+std::size_t FeatureHistory::NextIndex() const {
+  return (front_ + slots_.size() - 1) % slots_.size();
+}
+
+FeatureHistory::Slot* FeatureHistory::NextSlot() {
+  std::unique_ptr<Slot>& slot = slots_[NextIndex()];
+  if (slot == nullptr) {
+    slot.reset(new Slot());
+  }
+  return slot.get();
+}
+
+}  // namespace prediction
+}  // namespace apollo
@@ -0,0 +1,188 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Historical features of an obstacle
+ */
+
+#ifndef MODULES_PREDICTION_CONTAINER_OBSTACLES_FEATURE_HISTORY_H_
+#define MODULES_PREDICTION_CONTAINER_OBSTACLES_FEATURE_HISTORY_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "modules/prediction/proto/feature.pb.h"
+
+/**
+ * @namespace apollo::prediction
+ * @brief apollo::prediction
+ */
+namespace apollo {
+namespace prediction {
+
+/**
+ * @struct FeatureSummary
+ * @brief The fields of a feature which are read over the history on every
+ *        frame, taken when the feature is inserted.
+ */
+struct FeatureSummary {
+  double timestamp = 0.0;
+  double position_x = 0.0;
+  double position_y = 0.0;
+  double speed = 0.0;
+  bool has_lane_feature = false;
+  int lane_turn_type = 0;
+  double lane_l = 0.0;
+  double angle_diff = 0.0;
+  double dist_to_left_boundary = 0.0;
+  double dist_to_right_boundary = 0.0;
+};
+
+/**
+ * @class FeatureHistory
+ * @brief Features of an obstacle from the latest to the earliest, kept in a
+ *        ring of a fixed capacity. The feature of a new frame reuses the
+ *        memory of a removed one, so that the lane graphs and lane points are
+ *        not allocated again on every frame. The messages which the removed
+ *        feature had beyond the new one are released once it is inserted, so
+ *        that a feature takes no more memory than a copy of it.
+ */
+class FeatureHistory {
+ public:
+  /**
+   * @brief Constructor
+   * @param capacity The maximal number of features.
+   */
+  explicit FeatureHistory(const std::size_t capacity);
+
+  /**
+   * @brief Copy constructor, copying the features in the history only
+   * @param The history to copy
+   */
+  FeatureHistory(const FeatureHistory& other);
+
+  /**
+   * @brief Copy assignment, copying the features in the history only
+   * @param The history to copy
+   * @return This history
+   */
+  FeatureHistory& operator=(const FeatureHistory& other);
+
+  /**
+   * @brief Move constructor
+   * @param The history to move
+   */
+  FeatureHistory(FeatureHistory&& other);
+
+  /**
+   * @brief Move assignment, swapping the features of the two histories
+   * @param The history to move
+   * @return This history
+   */
+  FeatureHistory& operator=(FeatureHistory&& other);
+
+  /**
+   * @brief Get the number of features.
+   * @return The number of features.
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Get the maximal number of features.
+   * @return The maximal number of features.
+   */
+  std::size_t capacity() const { return slots_.size() - 1; }
+
+  /**
+   * @brief Check if there is no feature.
+   * @return True if there is no feature.
+   */
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * @brief Get the ith feature from latest to earliest.
+   * @param i The index of the feature.
+   * @return The ith feature.
+   */
+  const Feature& feature(const std::size_t i) const;
+
+  /**
+   * @brief Get a pointer to the ith feature from latest to earliest.
+   * @param i The index of the feature.
+   * @return A pointer to the ith feature.
+   */
+  Feature* mutable_feature(const std::size_t i);
+
+  /**
+   * @brief Get the summary of the ith feature from latest to earliest.
+   * @param i The index of the feature.
+   * @return The summary of the ith feature.
+   */
+  const FeatureSummary& summary(const std::size_t i) const;
+
+  /**
+   * @brief Get an empty feature to build the next frame in, which keeps the
+   *        memory of a removed feature. No feature is removed until it is
+   *        inserted by PushFront, so the history is kept as it is if the
+   *        frame is dropped.
+   * @return A pointer to the next feature.
+   */
+  Feature* NewFeature();
+
+  /**
+   * @brief Insert a feature as the latest one. Unless it is the one returned
+   *        by NewFeature, the feature is swapped in and left with the content
+   *        of a removed feature. The earliest feature is removed if the
+   *        history is full.
+   * @param feature The feature to insert.
+   */
+  void PushFront(Feature* feature);
+
+  /**
+   * @brief Remove the earliest feature.
+   */
+  void PopBack();
+
+  /**
+   * @brief Remove all the features.
+   */
+  void Clear();
+
+ private:
+  struct Slot {
+    Feature feature;
+    FeatureSummary summary;
+  };
+
+  std::size_t Index(const std::size_t i) const;
+
+  std::size_t NextIndex() const;
+
+  Slot* NextSlot();
+
+  // One slot more than the capacity, so that the next feature is built in a
+  // slot which no feature in the history uses.
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::size_t front_ = 0;
+  std::size_t size_ = 0;
+};
+
+}  // namespace prediction
+}  // namespace apollo
+
+#endif  // MODULES_PREDICTION_CONTAINER_OBSTACLES_FEATURE_HISTORY_H_
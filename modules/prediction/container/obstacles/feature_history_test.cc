@@ -0,0 +1,208 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/container/obstacles/feature_history.h"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace prediction {
+
+namespace {
+
+void BuildFeature(const int frame, Feature* feature) {
+  feature->set_id(1);
+  feature->set_timestamp(0.1 * frame);
+  feature->mutable_position()->set_x(frame);
+  feature->set_speed(2.0 * frame);
+  if (frame % 2 == 0) {
+    LaneFeature* lane_feature = feature->mutable_lane()->mutable_lane_feature();
+    lane_feature->set_lane_l(0.5 * frame);
+    lane_feature->set_lane_turn_type(frame % 4);
+  }
+}
+
+}  // namespace
+
+TEST(FeatureHistoryTest, Empty) {
+  FeatureHistory history(4);
+  EXPECT_TRUE(history.empty());
+  EXPECT_EQ(0, history.size());
+  EXPECT_EQ(4, history.capacity());
+  history.PushFront(history.NewFeature());
+  EXPECT_EQ(1, history.size());
+  history.Clear();
+  EXPECT_TRUE(history.empty());
+}
+
+TEST(FeatureHistoryTest, PushAndPop) {
+  // Frames of up to 40 features, so that the ring is filled and wrapped around.
+  FeatureHistory history(40);
+  std::deque<int> frames;
+  for (int frame = 0; frame < 200; ++frame) {
+    if (frame % 3 == 0) {
+      Feature feature;
+      BuildFeature(frame, &feature);
+      history.PushFront(&feature);
+    } else {
+      Feature* feature = history.NewFeature();
+      EXPECT_EQ(0, feature->ByteSize());
+      BuildFeature(frame, feature);
+      history.PushFront(feature);
+    }
+    frames.push_front(frame);
+    while (frames.size() > static_cast<std::size_t>(frame % 40)) {
+      history.PopBack();
+      frames.pop_back();
+    }
+
+    ASSERT_EQ(frames.size(), history.size());
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+      Feature expected;
+      BuildFeature(frames[i], &expected);
+      EXPECT_EQ(expected.SerializeAsString(),
+                history.feature(i).SerializeAsString());
+      const FeatureSummary& summary = history.summary(i);
+      EXPECT_DOUBLE_EQ(expected.timestamp(), summary.timestamp);
+      EXPECT_DOUBLE_EQ(expected.position().x(), summary.position_x);
+      EXPECT_DOUBLE_EQ(expected.speed(), summary.speed);
+      EXPECT_EQ(expected.has_lane(), summary.has_lane_feature);
+      EXPECT_DOUBLE_EQ(expected.lane().lane_feature().lane_l(),
+                       summary.lane_l);
+      EXPECT_EQ(expected.lane().lane_feature().lane_turn_type(),
+                summary.lane_turn_type);
+    }
+  }
+}
+
+TEST(FeatureHistoryTest, Full) {
+  FeatureHistory history(5);
+  for (int frame = 0; frame < 12; ++frame) {
+    Feature* feature = history.NewFeature();
+    BuildFeature(frame, feature);
+    history.PushFront(feature);
+    EXPECT_EQ(std::min(frame + 1, 5), static_cast<int>(history.size()));
+  }
+  for (std::size_t i = 0; i < history.size(); ++i) {
+    EXPECT_DOUBLE_EQ(0.1 * (11 - static_cast<int>(i)),
+                     history.summary(i).timestamp);
+  }
+}
+
+TEST(FeatureHistoryTest, DropFrameWhenFull) {
+  FeatureHistory history(3);
+  for (int frame = 0; frame < 3; ++frame) {
+    Feature* feature = history.NewFeature();
+    BuildFeature(frame, feature);
+    history.PushFront(feature);
+  }
+
+  // A stale frame is built but never inserted, which keeps the history.
+  Feature* feature = history.NewFeature();
+  BuildFeature(1, feature);
+  ASSERT_EQ(3, history.size());
+  for (std::size_t i = 0; i < history.size(); ++i) {
+    EXPECT_DOUBLE_EQ(0.1 * (2 - static_cast<int>(i)),
+                     history.summary(i).timestamp);
+    EXPECT_DOUBLE_EQ(2 - static_cast<int>(i),
+                     history.feature(i).position().x());
+  }
+
+  // The next frame reuses the dropped one, and removes the earliest feature.
+  feature = history.NewFeature();
+  EXPECT_EQ(0, feature->ByteSize());
+  BuildFeature(3, feature);
+  history.PushFront(feature);
+  ASSERT_EQ(3, history.size());
+  for (std::size_t i = 0; i < history.size(); ++i) {
+    EXPECT_DOUBLE_EQ(0.1 * (3 - static_cast<int>(i)),
+                     history.summary(i).timestamp);
+  }
+}
+
+TEST(FeatureHistoryTest, ReleaseClearedMessages) {
+  FeatureHistory history(1);
+  Feature* feature = history.NewFeature();
+  LaneGraph* lane_graph = feature->mutable_lane()->mutable_lane_graph();
+  for (int i = 0; i < 8; ++i) {
+    LaneSegment* lane_segment =
+        lane_graph->add_lane_sequence()->add_lane_segment();
+    for (int j = 0; j < 20; ++j) {
+      lane_segment->add_lane_point()->set_width(3.5);
+    }
+  }
+  history.PushFront(feature);
+  const int large_space_used = history.feature(0).SpaceUsed();
+
+  // The next feature is built in the spare slot, and the large feature is
+  // removed once it is inserted.
+  feature = history.NewFeature();
+  BuildFeature(1, feature);
+  history.PushFront(feature);
+
+  // The slot of the large feature is reused by a small one, which keeps none
+  // of the lane sequences and lane points of the large one.
+  feature = history.NewFeature();
+  lane_graph = feature->mutable_lane()->mutable_lane_graph();
+  lane_graph->add_lane_sequence()->add_lane_segment()->add_lane_point();
+  history.PushFront(feature);
+  ASSERT_EQ(1, history.size());
+  const LaneGraph& small_lane_graph = history.feature(0).lane().lane_graph();
+  EXPECT_EQ(0, small_lane_graph.lane_sequence().ClearedCount());
+  EXPECT_EQ(0, small_lane_graph.lane_sequence(0).lane_segment(0)
+                   .lane_point().ClearedCount());
+  EXPECT_LT(history.feature(0).SpaceUsed(), large_space_used / 4);
+
+  feature = history.NewFeature();
+  BuildFeature(1, feature);
+  history.PushFront(feature);
+  EXPECT_FALSE(history.feature(0).has_lane());
+}
+
+TEST(FeatureHistoryTest, CopyAndMove) {
+  FeatureHistory history(30);
+  for (int frame = 0; frame < 20; ++frame) {
+    Feature* feature = history.NewFeature();
+    BuildFeature(frame, feature);
+    history.PushFront(feature);
+  }
+  history.PopBack();
+  history.mutable_feature(0)->set_is_still(true);
+
+  FeatureHistory copy(history);
+  ASSERT_EQ(history.size(), copy.size());
+  for (std::size_t i = 0; i < history.size(); ++i) {
+    EXPECT_EQ(history.feature(i).SerializeAsString(),
+              copy.feature(i).SerializeAsString());
+    EXPECT_DOUBLE_EQ(history.summary(i).timestamp, copy.summary(i).timestamp);
+  }
+  EXPECT_TRUE(copy.feature(0).is_still());
+
+  FeatureHistory moved(std::move(copy));
+  EXPECT_EQ(history.size(), moved.size());
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(history.capacity(), copy.capacity());
+  copy = moved;
+  EXPECT_EQ(history.size(), copy.size());
+  EXPECT_DOUBLE_EQ(history.summary(0).timestamp, copy.summary(0).timestamp);
+}
+
+}  // namespace prediction
+}  // namespace apollo
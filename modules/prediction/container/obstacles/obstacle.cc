@@ -53,7 +53,7 @@ double Damp(const double x, const double sigma) {
 
 }  // namespace
 
-Obstacle::Obstacle() {
+Obstacle::Obstacle() : feature_history_(FLAGS_max_history_length) {
   double heading_filter_param = FLAGS_heading_filter_param;
   CHECK_LT(heading_filter_param, 1.0);
   CHECK_GT(heading_filter_param, 0.0);
@@ -67,7 +67,7 @@ int Obstacle::id() const { return id_; }
 
 double Obstacle::timestamp() const {
   if (feature_history_.size() > 0) {
-    return feature_history_.front().timestamp();
+    return feature_history_.feature(0).timestamp();
   } else {
     return 0.0;
   }
@@ -75,26 +75,33 @@ double Obstacle::timestamp() const {
 
 const Feature& Obstacle::feature(size_t i) const {
   CHECK(i < feature_history_.size());
-  return feature_history_[i];
+  return feature_history_.feature(i);
 }
 
 Feature* Obstacle::mutable_feature(size_t i) {
   CHECK(i < feature_history_.size());
-  return &feature_history_[i];
+  return feature_history_.mutable_feature(i);
+}
+
+const FeatureSummary& Obstacle::feature_summary(size_t i) const {
+  CHECK(i < feature_history_.size());
+  return feature_history_.summary(i);
 }
 
 const Feature& Obstacle::latest_feature() const {
   CHECK_GT(feature_history_.size(), 0);
-  return feature_history_.front();
+  return feature_history_.feature(0);
 }
 
 Feature* Obstacle::mutable_latest_feature() {
   CHECK_GT(feature_history_.size(), 0);
-  return &(feature_history_.front());
+  return feature_history_.mutable_feature(0);
 }
 
 size_t Obstacle::history_size() const { return feature_history_.size(); }
 
+Feature* Obstacle::NewFeature() { return feature_history_.NewFeature(); }
+
 const KalmanFilter<double, 6, 2, 0>& Obstacle::kf_motion_tracker() const {
   return kf_motion_tracker_;
 }
@@ -105,16 +112,17 @@ const KalmanFilter<double, 2, 2, 4>& Obstacle::kf_pedestrian_tracker() const {
 
 bool Obstacle::IsStill() {
   if (feature_history_.size() > 0) {
-    return feature_history_.front().is_still();
+    return feature_history_.feature(0).is_still();
   }
   return true;
 }
 
 bool Obstacle::IsOnLane() {
   if (feature_history_.size() > 0) {
-    if (feature_history_.front().has_lane() &&
-        (feature_history_.front().lane().current_lane_feature_size() > 0 ||
-         feature_history_.front().lane().nearby_lane_feature_size() > 0)) {
+    const Feature& feature = feature_history_.feature(0);
+    if (feature.has_lane() &&
+        (feature.lane().current_lane_feature_size() > 0 ||
+         feature.lane().nearby_lane_feature_size() > 0)) {
       ADEBUG << "Obstacle [" << id_ << "] is on lane.";
       return true;
     }
@@ -135,49 +143,68 @@ bool Obstacle::IsNearJunction() {
 
 void Obstacle::Insert(const PerceptionObstacle& perception_obstacle,
                       const double timestamp) {
+  Feature* feature = NewFeature();
+  if (!BuildFeature(perception_obstacle, timestamp, nullptr, feature)) {
+    return;
+  }
+  SetLaneSequences(feature);
+  InsertFeature(feature);
+}
+
+bool Obstacle::BuildFeature(
+    const PerceptionObstacle& perception_obstacle, const double timestamp,
+    const std::vector<std::shared_ptr<const LaneInfo>>* nearby_lanes,
+    Feature* feature) {
   if (feature_history_.size() > 0 &&
-      timestamp <= feature_history_.front().timestamp()) {
+      timestamp <= feature_history_.feature(0).timestamp()) {
     AERROR << "Obstacle [" << id_ << "] received an older frame ["
            << std::setprecision(20) << timestamp
            << "] than the most recent timestamp [ "
-           << feature_history_.front().timestamp() << "].";
-    return;
+           << feature_history_.feature(0).timestamp() << "].";
+    return false;
   }
 
-  Feature feature;
-  if (SetId(perception_obstacle, &feature) == ErrorCode::PREDICTION_ERROR) {
-    return;
+  if (SetId(perception_obstacle, feature) == ErrorCode::PREDICTION_ERROR) {
+    return false;
   }
-  if (SetType(perception_obstacle, &feature) == ErrorCode::PREDICTION_ERROR) {
-    return;
+  if (SetType(perception_obstacle, feature) == ErrorCode::PREDICTION_ERROR) {
+    return false;
   }
 
   // Set obstacle observation for KF tracking
-  SetStatus(perception_obstacle, timestamp, &feature);
+  SetStatus(perception_obstacle, timestamp, feature);
 
   if (!FLAGS_use_navigation_mode) {
     // Update KF
     if (!kf_motion_tracker_.IsInitialized()) {
-      InitKFMotionTracker(feature);
+      InitKFMotionTracker(*feature);
     }
-    UpdateKFMotionTracker(feature);
+    UpdateKFMotionTracker(*feature);
     if (type_ == PerceptionObstacle::PEDESTRIAN) {
       if (!kf_pedestrian_tracker_.IsInitialized()) {
-        InitKFPedestrianTracker(feature);
+        InitKFPedestrianTracker(*feature);
       }
-      UpdateKFPedestrianTracker(feature);
+      UpdateKFPedestrianTracker(*feature);
     }
 
     // Update obstacle status based on KF if enabled
     if (FLAGS_enable_kf_tracking) {
-      UpdateStatus(&feature);
+      UpdateStatus(feature);
     }
   }
 
   // Set obstacle lane features
-  SetCurrentLanes(&feature);
-  SetNearbyLanes(&feature);
-  SetLaneGraphFeature(&feature);
+  SetCurrentLanes(nearby_lanes, feature);
+  SetNearbyLanes(nearby_lanes, feature);
+  return true;
+}
+
+void Obstacle::InsertFeature(Feature* feature) {
+  if (feature->has_lane() && feature->lane().has_lane_graph()) {
+    SetLanePoints(feature);
+    SetLaneSequencePath(feature->mutable_lane()->mutable_lane_graph());
+  }
+  ADEBUG << "Obstacle [" << id_ << "] set lane graph features.";
 
   // Insert obstacle feature to history
   InsertFeatureToHistory(feature);
@@ -380,11 +407,11 @@ void Obstacle::SetVelocity(const PerceptionObstacle& perception_obstacle,
       FLAGS_adjust_velocity_by_position_shift &&
       history_size() > 0) {
     double diff_x =
-        feature->position().x() - feature_history_.front().position().x();
+        feature->position().x() - feature_history_.feature(0).position().x();
     double diff_y =
-        feature->position().y() - feature_history_.front().position().y();
-    double prev_obstacle_size = std::max(feature_history_.front().length(),
-                                         feature_history_.front().width());
+        feature->position().y() - feature_history_.feature(0).position().y();
+    double prev_obstacle_size = std::max(feature_history_.feature(0).length(),
+                                         feature_history_.feature(0).width());
     double obstacle_size =
         std::max(perception_obstacle.length(), perception_obstacle.width());
     double size_diff = std::abs(obstacle_size - prev_obstacle_size);
@@ -449,10 +476,10 @@ void Obstacle::SetAcceleration(Feature* feature) {
 
   if (feature_history_.size() > 0) {
     double curr_ts = feature->timestamp();
-    double prev_ts = feature_history_.front().timestamp();
+    double prev_ts = feature_history_.feature(0).timestamp();
 
     const Point3D& curr_velocity = feature->velocity();
-    const Point3D& prev_velocity = feature_history_.front().velocity();
+    const Point3D& prev_velocity = feature_history_.feature(0).velocity();
 
     if (curr_ts > prev_ts) {
       /*
@@ -582,7 +609,7 @@ void Obstacle::InitKFMotionTracker(const Feature& feature) {
 void Obstacle::UpdateKFMotionTracker(const Feature& feature) {
   double delta_ts = 0.0;
   if (feature_history_.size() > 0) {
-    delta_ts = feature.timestamp() - feature_history_.front().timestamp();
+    delta_ts = feature.timestamp() - feature_history_.feature(0).timestamp();
   }
   if (delta_ts > FLAGS_double_precision) {
     // Set tansition matrix and predict
@@ -649,7 +676,7 @@ void Obstacle::InitKFPedestrianTracker(const Feature& feature) {
 void Obstacle::UpdateKFPedestrianTracker(const Feature& feature) {
   double delta_ts = 0.0;
   if (!feature_history_.empty()) {
-    delta_ts = feature.timestamp() - feature_history_.front().timestamp();
+    delta_ts = feature.timestamp() - feature_history_.feature(0).timestamp();
   }
   if (delta_ts > std::numeric_limits<double>::epsilon()) {
     Eigen::Matrix<double, 2, 4> B = kf_pedestrian_tracker_.GetControlMatrix();
@@ -678,7 +705,9 @@ void Obstacle::UpdateKFPedestrianTracker(const Feature& feature) {
   }
 }
 
-void Obstacle::SetCurrentLanes(Feature* feature) {
+void Obstacle::SetCurrentLanes(
+    const std::vector<std::shared_ptr<const LaneInfo>>* nearby_lanes,
+    Feature* feature) {
   Eigen::Vector2d point(feature->position().x(), feature->position().y());
   double heading = feature->velocity_heading();
   int max_num_lane = FLAGS_max_num_current_lane;
@@ -690,9 +719,16 @@ void Obstacle::SetCurrentLanes(Feature* feature) {
     lane_search_radius = FLAGS_lane_search_radius_in_junction;
   }
   std::vector<std::shared_ptr<const LaneInfo>> current_lanes;
-  PredictionMap::OnLane(current_lanes_, point, heading,
-                        lane_search_radius, true, max_num_lane,
-                        max_angle_diff, &current_lanes);
+  if (nearby_lanes != nullptr &&
+      lane_search_radius <= FLAGS_lane_search_radius) {
+    PredictionMap::OnLane(current_lanes_, point, heading,
+                          lane_search_radius, true, max_num_lane,
+                          max_angle_diff, *nearby_lanes, &current_lanes);
+  } else {
+    PredictionMap::OnLane(current_lanes_, point, heading,
+                          lane_search_radius, true, max_num_lane,
+                          max_angle_diff, &current_lanes);
+  }
   current_lanes_ = current_lanes;
   if (current_lanes_.empty()) {
     ADEBUG << "Obstacle [" << id_ << "] has no current lanes.";
@@ -751,23 +787,31 @@ void Obstacle::SetCurrentLanes(Feature* feature) {
   feature->mutable_lane()->CopyFrom(lane);
 }
 
-void Obstacle::SetNearbyLanes(Feature* feature) {
+void Obstacle::SetNearbyLanes(
+    const std::vector<std::shared_ptr<const LaneInfo>>* nearby_lanes,
+    Feature* feature) {
   Eigen::Vector2d point(feature->position().x(), feature->position().y());
   int max_num_lane = FLAGS_max_num_nearby_lane;
   if (PredictionMap::InJunction(point, FLAGS_junction_search_radius)) {
     max_num_lane = FLAGS_max_num_nearby_lane_in_junction;
   }
   double theta = feature->velocity_heading();
-  std::vector<std::shared_ptr<const LaneInfo>> nearby_lanes;
-  PredictionMap::NearbyLanesByCurrentLanes(
-      point, theta, FLAGS_lane_search_radius, current_lanes_,
-      max_num_lane, &nearby_lanes);
-  if (nearby_lanes.empty()) {
+  std::vector<std::shared_ptr<const LaneInfo>> lanes;
+  if (nearby_lanes != nullptr) {
+    PredictionMap::NearbyLanesByCurrentLanes(
+        point, theta, FLAGS_lane_search_radius, current_lanes_,
+        max_num_lane, *nearby_lanes, &lanes);
+  } else {
+    PredictionMap::NearbyLanesByCurrentLanes(
+        point, theta, FLAGS_lane_search_radius, current_lanes_,
+        max_num_lane, &lanes);
+  }
+  if (lanes.empty()) {
     ADEBUG << "Obstacle [" << id_ << "] has no nearby lanes.";
     return;
   }
 
-  for (std::shared_ptr<const LaneInfo> nearby_lane : nearby_lanes) {
+  for (std::shared_ptr<const LaneInfo> nearby_lane : lanes) {
     if (nearby_lane == nullptr) {
       continue;
     }
@@ -814,7 +858,7 @@ void Obstacle::SetNearbyLanes(Feature* feature) {
   }
 }
 
-void Obstacle::SetLaneGraphFeature(Feature* feature) {
+void Obstacle::SetLaneSequences(Feature* feature) {
   double speed = feature->speed();
   double road_graph_distance = std::max(
       speed * FLAGS_prediction_duration +
@@ -869,13 +913,6 @@ void Obstacle::SetLaneGraphFeature(Feature* feature) {
       break;
     }
   }
-
-  if (feature->has_lane() && feature->lane().has_lane_graph()) {
-    SetLanePoints(feature);
-    SetLaneSequencePath(feature->mutable_lane()->mutable_lane_graph());
-  }
-
-  ADEBUG << "Obstacle [" << id_ << "] set lane graph features.";
 }
 
 void Obstacle::SetLanePoints(Feature* feature) {
@@ -986,7 +1023,7 @@ void Obstacle::SetMotionStatus() {
     ADEBUG << "Obstacle [" << id_ << "] has no history and "
            << "is considered moving.";
     if (history_size > 0) {
-      feature_history_.front().set_is_still(false);
+      feature_history_.mutable_feature(0)->set_is_still(false);
     }
     return;
   }
@@ -999,14 +1036,13 @@ void Obstacle::SetMotionStatus() {
   len = std::max(len, FLAGS_min_still_obstacle_history_length);
   CHECK_GT(len, 1);
 
-  auto feature_riter = feature_history_.rbegin();
-  start_x = feature_riter->position().x();
-  start_y = feature_riter->position().y();
-  ++feature_riter;
-  while (feature_riter != feature_history_.rend()) {
-    avg_drift_x += (feature_riter->position().x() - start_x) / (len - 1);
-    avg_drift_y += (feature_riter->position().y() - start_y) / (len - 1);
-    ++feature_riter;
+  const FeatureSummary& start = feature_history_.summary(history_size - 1);
+  start_x = start.position_x;
+  start_y = start.position_y;
+  for (int i = history_size - 2; i >= 0; --i) {
+    const FeatureSummary& summary = feature_history_.summary(i);
+    avg_drift_x += (summary.position_x - start_x) / (len - 1);
+    avg_drift_y += (summary.position_y - start_y) / (len - 1);
   }
 
   double std = FLAGS_still_obstacle_position_std;
@@ -1016,28 +1052,28 @@ void Obstacle::SetMotionStatus() {
     speed_threshold = FLAGS_still_pedestrian_speed_threshold;
     std = FLAGS_still_pedestrian_position_std;
   }
-  double delta_ts = feature_history_.front().timestamp() -
-                    feature_history_.back().timestamp();
+  double delta_ts = feature_history_.summary(0).timestamp -
+                    feature_history_.summary(history_size - 1).timestamp;
   double speed_sensibility =
       std::sqrt(2 * history_size) * 4 * std / ((history_size + 1) * delta_ts);
-  double speed = feature_history_.front().speed();
+  double speed = feature_history_.feature(0).speed();
   if (speed < speed_threshold) {
     ADEBUG << "Obstacle [" << id_ << "] has a small speed [" << speed
            << "] and is considered stationary.";
-    feature_history_.front().set_is_still(true);
+    feature_history_.mutable_feature(0)->set_is_still(true);
   } else if (speed_sensibility < speed_threshold) {
     ADEBUG << "Obstacle [" << id_ << "]"
            << "] considered moving [sensibility = " << speed_sensibility << "]";
-    feature_history_.front().set_is_still(false);
+    feature_history_.mutable_feature(0)->set_is_still(false);
   } else {
     double distance = std::hypot(avg_drift_x, avg_drift_y);
     double distance_std = std::sqrt(2.0 / len) * std;
     if (distance > 2.0 * distance_std) {
       ADEBUG << "Obstacle [" << id_ << "] is moving.";
-      feature_history_.front().set_is_still(false);
+      feature_history_.mutable_feature(0)->set_is_still(false);
     } else {
       ADEBUG << "Obstacle [" << id_ << "] is stationary.";
-      feature_history_.front().set_is_still(true);
+      feature_history_.mutable_feature(0)->set_is_still(true);
     }
   }
 }
@@ -1048,25 +1084,25 @@ void Obstacle::SetMotionStatusBySpeed() {
     ADEBUG << "Obstacle [" << id_ << "] has no history and "
            << "is considered moving.";
     if (history_size > 0) {
-      feature_history_.front().set_is_still(false);
+      feature_history_.mutable_feature(0)->set_is_still(false);
     }
     return;
   }
 
   double speed_threshold = FLAGS_still_obstacle_speed_threshold;
-  double speed = feature_history_.front().speed();
+  double speed = feature_history_.feature(0).speed();
 
   if (FLAGS_use_navigation_mode) {
     if (speed < speed_threshold) {
-      feature_history_.front().set_is_still(true);
+      feature_history_.mutable_feature(0)->set_is_still(true);
     } else {
-      feature_history_.front().set_is_still(false);
+      feature_history_.mutable_feature(0)->set_is_still(false);
     }
   }
 }
 
-void Obstacle::InsertFeatureToHistory(const Feature& feature) {
-  feature_history_.emplace_front(feature);
+void Obstacle::InsertFeatureToHistory(Feature* feature) {
+  feature_history_.PushFront(feature);
   ADEBUG << "Obstacle [" << id_ << "] inserted a frame into the history.";
 }
 
@@ -1075,11 +1111,14 @@ void Obstacle::Trim() {
     return;
   }
   int count = 0;
-  const double latest_ts = feature_history_.front().timestamp();
-  while (!feature_history_.empty() &&
-         latest_ts - feature_history_.back().timestamp() >=
-             FLAGS_max_history_time) {
-    feature_history_.pop_back();
+  const double latest_ts = feature_history_.summary(0).timestamp;
+  while (!feature_history_.empty()) {
+    const std::size_t earliest = feature_history_.size() - 1;
+    if (latest_ts - feature_history_.summary(earliest).timestamp <
+        FLAGS_max_history_time) {
+      break;
+    }
+    feature_history_.PopBack();
     ++count;
   }
   if (count > 0) {
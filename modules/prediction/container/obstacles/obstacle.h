@@ -22,7 +22,6 @@
 #ifndef MODULES_PREDICTION_CONTAINER_OBSTACLES_OBSTACLE_H_
 #define MODULES_PREDICTION_CONTAINER_OBSTACLES_OBSTACLE_H_
 
-#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -37,6 +36,7 @@
 
 #include "modules/common/math/kalman_filter.h"
 #include "modules/map/hdmap/hdmap_common.h"
+#include "modules/prediction/container/obstacles/feature_history.h"
 
 /**
  * @namespace apollo::prediction
@@ -69,6 +69,40 @@ class Obstacle {
   void Insert(const perception::PerceptionObstacle& perception_obstacle,
               const double timestamp);
 
+  /**
+   * @brief Build the feature of a perception obstacle up to its current and
+   *        nearby lanes, which is the first stage of Insert.
+   * @param perception_obstacle The obstacle from perception.
+   * @param timestamp The timestamp when the perception obstacle was detected.
+   * @param nearby_lanes The lanes within FLAGS_lane_search_radius of the
+   *        obstacle, such as from PredictionMap::NearbyLanesBatch, among which
+   *        the current and nearby lanes are searched; or nullptr to search
+   *        the map for the obstacle alone.
+   * @param feature The feature to build.
+   * @return True if the feature is built; otherwise false.
+   */
+  bool BuildFeature(
+      const perception::PerceptionObstacle& perception_obstacle,
+      const double timestamp,
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>* nearby_lanes,
+      Feature* feature);
+
+  /**
+   * @brief Set the lane sequences of a feature from the lane graphs shared
+   *        by all obstacles, which is the second stage of Insert and runs
+   *        on one thread at a time.
+   * @param feature The feature built by BuildFeature.
+   */
+  void SetLaneSequences(Feature* feature);
+
+  /**
+   * @brief Set the lane points of a feature and insert it into the history,
+   *        which is the last stage of Insert.
+   * @param feature The feature with its lane sequences, which is swapped
+   *        into the history unless it is from NewFeature.
+   */
+  void InsertFeature(Feature* feature);
+
   /**
    * @brief Get the type of perception obstacle's type.
    * @return The type pf perception obstacle.
@@ -101,6 +135,13 @@ class Obstacle {
    */
   Feature* mutable_feature(size_t i);
 
+  /**
+   * @brief Get the summary of the ith feature from latest to earliest.
+   * @param i The index of the feature.
+   * @return The summary of the ith feature.
+   */
+  const FeatureSummary& feature_summary(size_t i) const;
+
   /**
    * @brief Get the latest feature.
    * @return The latest feature.
@@ -119,6 +160,13 @@ class Obstacle {
    */
   size_t history_size() const;
 
+  /**
+   * @brief Get an empty feature to build the next frame in, which reuses the
+   *        memory of a trimmed historical feature.
+   * @return A pointer to the new feature.
+   */
+  Feature* NewFeature();
+
   /**
    * @brief Get the motion Kalman filter.
    * @return The motion Kalman filter.
@@ -215,11 +263,13 @@ class Obstacle {
 
   void UpdateLaneBelief(Feature* feature);
 
-  void SetCurrentLanes(Feature* feature);
-
-  void SetNearbyLanes(Feature* feature);
+  void SetCurrentLanes(
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>* nearby_lanes,
+      Feature* feature);
 
-  void SetLaneGraphFeature(Feature* feature);
+  void SetNearbyLanes(
+      const std::vector<std::shared_ptr<const hdmap::LaneInfo>>* nearby_lanes,
+      Feature* feature);
 
   void SetLanePoints(Feature* feature);
 
@@ -233,7 +283,7 @@ class Obstacle {
 
   void SetMotionStatusBySpeed();
 
-  void InsertFeatureToHistory(const Feature& feature);
+  void InsertFeatureToHistory(Feature* feature);
 
   void Trim();
 
@@ -241,7 +291,7 @@ class Obstacle {
   int id_ = -1;
   perception::PerceptionObstacle::Type type_ =
       perception::PerceptionObstacle::UNKNOWN_UNMOVABLE;
-  std::deque<Feature> feature_history_;
+  FeatureHistory feature_history_;
   common::math::KalmanFilter<double, 6, 2, 0> kf_motion_tracker_;
   common::math::KalmanFilter<double, 2, 2, 4> kf_pedestrian_tracker_;
   common::DigitalFilter heading_filter_;
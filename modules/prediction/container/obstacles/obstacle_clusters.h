@@ -37,7 +37,8 @@ class ObstacleClusters {
   static void Init();
 
   /**
-   * @brief Obtain a lane graph given a lane info and s
+   * @brief Obtain a lane graph given a lane info and s, not thread-safe;
+   *        the obstacles obtain their lane graphs one after the other
    * @param lane start s
    * @param lane total length
    * @param lane info
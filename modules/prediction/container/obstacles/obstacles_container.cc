@@ -16,11 +16,16 @@
 
 #include "modules/prediction/container/obstacles/obstacles_container.h"
 
+#include <memory>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "modules/common/math/math_utils.h"
+#include "modules/common/util/task_scheduler.h"
 #include "modules/prediction/common/feature_output.h"
 #include "modules/prediction/common/prediction_gflags.h"
+#include "modules/prediction/common/prediction_map.h"
 #include "modules/prediction/container/obstacles/obstacle_clusters.h"
 
 namespace apollo {
@@ -57,6 +62,10 @@ void ObstaclesContainer::Insert(const ::google::protobuf::Message& message) {
   timestamp_ = timestamp;
   ADEBUG << "Current timestamp is [" << timestamp_ << "]";
   ObstacleClusters::Init();
+  if (FLAGS_enable_multi_thread_in_prediction) {
+    InsertPerceptionObstaclesConcurrently(perception_obstacles, timestamp_);
+    return;
+  }
   for (const PerceptionObstacle& perception_obstacle :
        perception_obstacles.perception_obstacle()) {
     ADEBUG << "Perception obstacle [" << perception_obstacle.id() << "] "
@@ -97,6 +106,78 @@ void ObstaclesContainer::InsertPerceptionObstacle(
   }
 }
 
+void ObstaclesContainer::InsertPerceptionObstaclesConcurrently(
+    const PerceptionObstacles& perception_obstacles, const double timestamp) {
+  // Add the new obstacles in the order of the message first, so that the
+  // obstacles evicted from the cache are the same as inserting them one by
+  // one, and the cache is not modified while the obstacles are inserted.
+  std::vector<const PerceptionObstacle*> valid_perception_obstacles;
+  for (const PerceptionObstacle& perception_obstacle :
+       perception_obstacles.perception_obstacle()) {
+    const int id = perception_obstacle.id();
+    if (id < -1) {
+      AERROR << "Invalid ID [" << id << "]";
+      continue;
+    }
+    if (!IsPredictable(perception_obstacle)) {
+      ADEBUG << "Perception obstacle [" << id << "] is not predictable.";
+      continue;
+    }
+    if (obstacles_.GetSilently(id) == nullptr) {
+      obstacles_.Put(id, Obstacle());
+    }
+    valid_perception_obstacles.push_back(&perception_obstacle);
+  }
+
+  // A repeated obstacle is inserted once, as a second frame of an obstacle
+  // with the same timestamp is dropped anyway.
+  std::vector<std::pair<const PerceptionObstacle*, Obstacle*>> insertions;
+  std::unordered_set<int> inserted_ids;
+  for (const PerceptionObstacle* perception_obstacle :
+       valid_perception_obstacles) {
+    const int id = perception_obstacle->id();
+    Obstacle* obstacle_ptr = obstacles_.GetSilently(id);
+    if (obstacle_ptr != nullptr && inserted_ids.insert(id).second) {
+      insertions.emplace_back(perception_obstacle, obstacle_ptr);
+    }
+  }
+
+  const std::size_t num_insertions = insertions.size();
+  // The lanes near all obstacles are searched at once, and each obstacle
+  // then selects its current and nearby lanes among them.
+  std::vector<Eigen::Vector2d> positions(num_insertions);
+  for (std::size_t i = 0; i < num_insertions; ++i) {
+    positions[i] << insertions[i].first->position().x(),
+        insertions[i].first->position().y();
+  }
+  std::vector<std::vector<std::shared_ptr<const hdmap::LaneInfo>>>
+      nearby_lanes;
+  PredictionMap::NearbyLanesBatch(positions, FLAGS_lane_search_radius,
+                                  &nearby_lanes);
+
+  std::vector<Feature*> features(num_insertions);
+  std::unique_ptr<bool[]> built(new bool[num_insertions]);
+  common::util::ParallelFor(0, num_insertions, 1, [&](const std::size_t i) {
+    features[i] = insertions[i].second->NewFeature();
+    built[i] = insertions[i].second->BuildFeature(
+        *insertions[i].first, timestamp, &nearby_lanes[i], features[i]);
+  });
+  // The lane graphs are shared by the obstacles and built by the first
+  // obstacle on a lane, so they are obtained in the order of the message to
+  // keep the features deterministic, and on this thread only, since
+  // ObstacleClusters is not thread-safe.
+  for (std::size_t i = 0; i < num_insertions; ++i) {
+    if (built[i]) {
+      insertions[i].second->SetLaneSequences(features[i]);
+    }
+  }
+  common::util::ParallelFor(0, num_insertions, 1, [&](const std::size_t i) {
+    if (built[i]) {
+      insertions[i].second->InsertFeature(features[i]);
+    }
+  });
+}
+
 bool ObstaclesContainer::IsPredictable(
     const PerceptionObstacle& perception_obstacle) {
   if (!perception_obstacle.has_type() ||
@@ -71,6 +71,15 @@ class ObstaclesContainer : public Container {
   void Clear();
 
  private:
+  /**
+   * @brief Insert the perception obstacles of a message concurrently
+   * @param Perception obstacles
+   *        Timestamp
+   */
+  void InsertPerceptionObstaclesConcurrently(
+      const perception::PerceptionObstacles& perception_obstacles,
+      const double timestamp);
+
   /**
    * @brief Check if an obstacle is predictable
    * @param An obstacle
@@ -80,6 +80,26 @@ TEST_F(ObstaclesContainerTest, Pedestrian) {
   EXPECT_TRUE(obstacle_ptr103 == nullptr);
 }
 
+TEST_F(ObstaclesContainerTest, ConcurrentInsertion) {
+  std::string file =
+      "modules/prediction/testdata/perception_vehicles_pedestrians.pb.txt";
+  perception::PerceptionObstacles perception_obstacles;
+  common::util::GetProtoFromFile(file, &perception_obstacles);
+  FLAGS_enable_multi_thread_in_prediction = true;
+  ObstaclesContainer container;
+  container.Insert(perception_obstacles);
+  FLAGS_enable_multi_thread_in_prediction = false;
+
+  for (const int id : {0, 1, 2, 3, 101, 102}) {
+    Obstacle* expected_obstacle_ptr = container_.GetObstacle(id);
+    Obstacle* obstacle_ptr = container.GetObstacle(id);
+    ASSERT_TRUE(expected_obstacle_ptr != nullptr);
+    ASSERT_TRUE(obstacle_ptr != nullptr);
+    EXPECT_EQ(expected_obstacle_ptr->latest_feature().DebugString(),
+              obstacle_ptr->latest_feature().DebugString());
+  }
+}
+
 TEST_F(ObstaclesContainerTest, ClearAll) {
   container_.Clear();
   EXPECT_TRUE(container_.GetObstacle(0) == nullptr);
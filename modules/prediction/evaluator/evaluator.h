@@ -51,6 +51,16 @@ class Evaluator {
    * @param Obstacle pointer
    */
   virtual void Evaluate(Obstacle* obstacle) = 0;
+
+  /**
+   * @brief Evaluate obstacles in order, one by one unless overridden
+   * @param Obstacle pointers
+   */
+  virtual void EvaluateBatch(const std::vector<Obstacle*>& obstacles) {
+    for (Obstacle* obstacle : obstacles) {
+      Evaluate(obstacle);
+    }
+  }
 };
 
 }  // namespace prediction
@@ -16,7 +16,13 @@
 
 #include "modules/prediction/evaluator/evaluator_manager.h"
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "modules/common/log.h"
+#include "modules/common/util/task_scheduler.h"
+#include "modules/prediction/common/prediction_gflags.h"
 #include "modules/prediction/container/container_manager.h"
 #include "modules/prediction/container/obstacles/obstacles_container.h"
 #include "modules/prediction/evaluator/vehicle/mlp_evaluator.h"
@@ -96,6 +102,7 @@ void EvaluatorManager::Run(
           AdapterConfig::PERCEPTION_OBSTACLES));
   CHECK_NOTNULL(container);
 
+  std::vector<std::pair<Obstacle*, Evaluator*>> evaluations;
   Evaluator* evaluator = nullptr;
   for (const auto& perception_obstacle :
        perception_obstacles.perception_obstacle()) {
@@ -142,9 +149,41 @@ void EvaluatorManager::Run(
       }
     }
     if (evaluator != nullptr) {
-      evaluator->Evaluate(obstacle);
+      evaluations.emplace_back(obstacle, evaluator);
+    }
+  }
+
+  // The features are dumped in the order of evaluation in offline mode.
+  if (!FLAGS_enable_multi_thread_in_prediction ||
+      FLAGS_prediction_offline_mode) {
+    // The consecutive obstacles of an evaluator are evaluated in a batch.
+    std::vector<Obstacle*> batch;
+    for (std::size_t i = 0; i < evaluations.size(); ++i) {
+      batch.push_back(evaluations[i].first);
+      if (i + 1 == evaluations.size() ||
+          evaluations[i + 1].second != evaluations[i].second) {
+        evaluations[i].second->EvaluateBatch(batch);
+        batch.clear();
+      }
     }
+    return;
   }
+
+  // A repeated obstacle is evaluated in order by a single task.
+  std::vector<std::vector<std::size_t>> tasks;
+  std::unordered_map<const Obstacle*, std::size_t> task_indices;
+  for (std::size_t i = 0; i < evaluations.size(); ++i) {
+    const auto it = task_indices.emplace(evaluations[i].first, tasks.size());
+    if (it.second) {
+      tasks.emplace_back();
+    }
+    tasks[it.first->second].push_back(i);
+  }
+  common::util::ParallelFor(0, tasks.size(), 1, [&](const std::size_t i) {
+    for (const std::size_t index : tasks[i]) {
+      evaluations[index].second->Evaluate(evaluations[index].first);
+    }
+  });
 }
 
 std::unique_ptr<Evaluator> EvaluatorManager::CreateEvaluator(
@@ -19,6 +19,7 @@
 #include <cmath>
 #include <limits>
 #include <numeric>
+#include <utility>
 
 #include "modules/common/math/math_utils.h"
 #include "modules/common/util/file.h"
@@ -45,74 +46,107 @@ double ComputeMean(const std::vector<double>& nums, size_t start, size_t end) {
   return (count == 0) ? 0.0 : sum / count;
 }
 
+double Tanh(const double value) { return std::tanh(value); }
+
 }  // namespace
 
 MLPEvaluator::MLPEvaluator() { LoadModel(FLAGS_evaluator_vehicle_mlp_file); }
 
-void MLPEvaluator::Clear() { obstacle_feature_values_map_.clear(); }
+void MLPEvaluator::Clear() {}
 
 void MLPEvaluator::Evaluate(Obstacle* obstacle_ptr) {
-  Clear();
-  CHECK_NOTNULL(obstacle_ptr);
+  EvaluateBatch({obstacle_ptr});
+}
+
+void MLPEvaluator::EvaluateBatch(const std::vector<Obstacle*>& obstacles) {
   CHECK_LE(LANE_FEATURE_SIZE, 4 * FLAGS_max_num_lane_point);
 
-  int id = obstacle_ptr->id();
-  if (!obstacle_ptr->latest_feature().IsInitialized()) {
-    AERROR << "Obstacle [" << id << "] has no latest feature.";
-    return;
-  }
+  // The feature values of all lane sequences of all obstacles, one row per
+  // lane sequence, so that the model runs once for the whole batch.
+  const int dim_input = model_ptr_->dim_input();
+  std::vector<double> batch_feature_values;
+  std::vector<std::pair<LaneSequence*, double>> batch_lane_sequences;
+  std::vector<Feature*> evaluated_features;
+  for (Obstacle* obstacle_ptr : obstacles) {
+    CHECK_NOTNULL(obstacle_ptr);
+    int id = obstacle_ptr->id();
+    if (!obstacle_ptr->latest_feature().IsInitialized()) {
+      AERROR << "Obstacle [" << id << "] has no latest feature.";
+      continue;
+    }
 
-  Feature* latest_feature_ptr = obstacle_ptr->mutable_latest_feature();
-  CHECK_NOTNULL(latest_feature_ptr);
-  if (!latest_feature_ptr->has_lane() ||
-      !latest_feature_ptr->lane().has_lane_graph()) {
-    ADEBUG << "Obstacle [" << id << "] has no lane graph.";
-    return;
-  }
+    Feature* latest_feature_ptr = obstacle_ptr->mutable_latest_feature();
+    CHECK_NOTNULL(latest_feature_ptr);
+    if (!latest_feature_ptr->has_lane() ||
+        !latest_feature_ptr->lane().has_lane_graph()) {
+      ADEBUG << "Obstacle [" << id << "] has no lane graph.";
+      continue;
+    }
 
-  double speed = latest_feature_ptr->speed();
+    double speed = latest_feature_ptr->speed();
 
-  LaneGraph* lane_graph_ptr =
-      latest_feature_ptr->mutable_lane()->mutable_lane_graph();
-  CHECK_NOTNULL(lane_graph_ptr);
-  if (lane_graph_ptr->lane_sequence_size() == 0) {
-    AERROR << "Obstacle [" << id << "] has no lane sequences.";
-    return;
+    LaneGraph* lane_graph_ptr =
+        latest_feature_ptr->mutable_lane()->mutable_lane_graph();
+    CHECK_NOTNULL(lane_graph_ptr);
+    if (lane_graph_ptr->lane_sequence_size() == 0) {
+      AERROR << "Obstacle [" << id << "] has no lane sequences.";
+      continue;
+    }
+
+    // The obstacle feature values are computed once for all lane sequences,
+    // without the cache of the evaluator, so that the obstacles can be
+    // evaluated concurrently.
+    std::vector<double> obstacle_feature_values;
+    SetObstacleFeatureValues(obstacle_ptr, &obstacle_feature_values);
+    for (int i = 0; i < lane_graph_ptr->lane_sequence_size(); ++i) {
+      LaneSequence* lane_sequence_ptr =
+          lane_graph_ptr->mutable_lane_sequence(i);
+      CHECK(lane_sequence_ptr != nullptr);
+      std::vector<double> feature_values;
+      ExtractFeatureValues(obstacle_ptr, obstacle_feature_values,
+                           lane_sequence_ptr, &feature_values);
+      if (static_cast<int>(feature_values.size()) != dim_input) {
+        ADEBUG << "Model feature size not consistent with model proto "
+               << "definition. model input dim = " << dim_input
+               << "; feature value size = " << feature_values.size();
+        lane_sequence_ptr->set_probability(0.0);
+        continue;
+      }
+      batch_feature_values.insert(batch_feature_values.end(),
+                                  feature_values.begin(),
+                                  feature_values.end());
+      batch_lane_sequences.emplace_back(lane_sequence_ptr, speed);
+    }
+    evaluated_features.push_back(latest_feature_ptr);
   }
 
-  for (int i = 0; i < lane_graph_ptr->lane_sequence_size(); ++i) {
-    LaneSequence* lane_sequence_ptr = lane_graph_ptr->mutable_lane_sequence(i);
-    CHECK(lane_sequence_ptr != nullptr);
-    std::vector<double> feature_values;
-    ExtractFeatureValues(obstacle_ptr, lane_sequence_ptr, &feature_values);
-    double probability = ComputeProbability(feature_values);
-
-    double centripetal_acc_probability =
-        ValidationChecker::ProbabilityByCentripedalAcceleration(
-            *lane_sequence_ptr, speed);
-    probability *= centripetal_acc_probability;
-    lane_sequence_ptr->set_probability(probability);
+  if (!batch_lane_sequences.empty()) {
+    const FeatureMatrix feature_values(batch_feature_values.data(),
+                                       batch_lane_sequences.size(),
+                                       dim_input);
+    Eigen::VectorXd probabilities;
+    ComputeProbabilities(feature_values, &probabilities);
+    for (std::size_t i = 0; i < batch_lane_sequences.size(); ++i) {
+      LaneSequence* lane_sequence_ptr = batch_lane_sequences[i].first;
+      double centripetal_acc_probability =
+          ValidationChecker::ProbabilityByCentripedalAcceleration(
+              *lane_sequence_ptr, batch_lane_sequences[i].second);
+      lane_sequence_ptr->set_probability(probabilities(i) *
+                                         centripetal_acc_probability);
+    }
   }
 
   if (FLAGS_prediction_offline_mode) {
-    FeatureOutput::Insert(*latest_feature_ptr);
+    for (const Feature* feature : evaluated_features) {
+      FeatureOutput::Insert(*feature);
+    }
   }
 }
 
-void MLPEvaluator::ExtractFeatureValues(Obstacle* obstacle_ptr,
-                                        LaneSequence* lane_sequence_ptr,
-                                        std::vector<double>* feature_values) {
+void MLPEvaluator::ExtractFeatureValues(
+    Obstacle* obstacle_ptr, const std::vector<double>& obstacle_feature_values,
+    LaneSequence* lane_sequence_ptr, std::vector<double>* feature_values) {
   int id = obstacle_ptr->id();
-  std::vector<double> obstacle_feature_values;
-
-  auto it = obstacle_feature_values_map_.find(id);
-  if (it == obstacle_feature_values_map_.end()) {
-    SetObstacleFeatureValues(obstacle_ptr, &obstacle_feature_values);
-    obstacle_feature_values_map_[id] = obstacle_feature_values;
-  } else {
-    obstacle_feature_values = it->second;
-  }
-
   if (obstacle_feature_values.size() != OBSTACLE_FEATURE_SIZE) {
     ADEBUG << "Obstacle [" << id << "] has fewer than "
            << "expected obstacle feature_values "
@@ -162,22 +196,18 @@ void MLPEvaluator::SetObstacleFeatureValues(
   double duration = obstacle_ptr->timestamp() - FLAGS_prediction_duration;
   int count = 0;
   for (std::size_t i = 0; i < obstacle_ptr->history_size(); ++i) {
-    const Feature& feature = obstacle_ptr->feature(i);
-    if (!feature.IsInitialized()) {
-      continue;
-    }
-    if (feature.timestamp() < duration) {
+    const FeatureSummary& summary = obstacle_ptr->feature_summary(i);
+    if (summary.timestamp < duration) {
       break;
     }
-    if (feature.has_lane() && feature.lane().has_lane_feature()) {
-      thetas.push_back(feature.lane().lane_feature().angle_diff());
-      lane_ls.push_back(feature.lane().lane_feature().lane_l());
-      dist_lbs.push_back(feature.lane().lane_feature().dist_to_left_boundary());
-      dist_rbs.push_back(
-          feature.lane().lane_feature().dist_to_right_boundary());
-      lane_types.push_back(feature.lane().lane_feature().lane_turn_type());
-      timestamps.push_back(feature.timestamp());
-      speeds.push_back(feature.speed());
+    if (summary.has_lane_feature) {
+      thetas.push_back(summary.angle_diff);
+      lane_ls.push_back(summary.lane_l);
+      dist_lbs.push_back(summary.dist_to_left_boundary);
+      dist_rbs.push_back(summary.dist_to_right_boundary);
+      lane_types.push_back(summary.lane_turn_type);
+      timestamps.push_back(summary.timestamp);
+      speeds.push_back(summary.speed);
       ++count;
     }
   }
@@ -336,69 +366,96 @@ void MLPEvaluator::LoadModel(const std::string& model_file) {
   CHECK(model_ptr_ != nullptr);
   CHECK(common::util::GetProtoFromFile(model_file, model_ptr_.get()))
       << "Unable to load model file: " << model_file << ".";
+  CompileModel();
 
   AINFO << "Succeeded in loading the model file: " << model_file << ".";
 }
 
-double MLPEvaluator::ComputeProbability(
-    const std::vector<double>& feature_values) {
-  CHECK_NOTNULL(model_ptr_.get());
-  double probability = 0.0;
-
-  if (model_ptr_->dim_input() != static_cast<int>(feature_values.size())) {
-    ADEBUG << "Model feature size not consistent with model proto definition. "
-           << "model input dim = " << model_ptr_->dim_input()
-           << "; feature value size = " << feature_values.size();
-    return probability;
-  }
-  std::vector<double> layer_input;
-  layer_input.reserve(model_ptr_->dim_input());
-  std::vector<double> layer_output;
-
-  // normalization
-  for (int i = 0; i < model_ptr_->dim_input(); ++i) {
-    double mean = model_ptr_->samples_mean().columns(i);
-    double std = model_ptr_->samples_std().columns(i);
-    layer_input.push_back(
-        apollo::prediction::math_util::Normalize(feature_values[i], mean, std));
+void MLPEvaluator::CompileModel() {
+  const int dim_input = model_ptr_->dim_input();
+  CHECK_EQ(dim_input, model_ptr_->samples_mean().columns_size());
+  CHECK_EQ(dim_input, model_ptr_->samples_std().columns_size());
+  constexpr double kEpsilon = 1e-10;  // As in math_util::Normalize.
+  samples_mean_.resize(dim_input);
+  samples_std_.resize(dim_input);
+  for (int i = 0; i < dim_input; ++i) {
+    samples_mean_(i) = model_ptr_->samples_mean().columns(i);
+    samples_std_(i) = model_ptr_->samples_std().columns(i) + kEpsilon;
   }
 
+  layers_.clear();
+  layers_.reserve(model_ptr_->num_layer());
+  int layer_input_dim = dim_input;
   for (int i = 0; i < model_ptr_->num_layer(); ++i) {
-    if (i > 0) {
-      layer_input.swap(layer_output);
-      layer_output.clear();
-    }
     const Layer& layer = model_ptr_->layer(i);
+    CHECK_EQ(layer_input_dim, layer.layer_input_dim());
+    CHECK_EQ(layer.layer_input_dim(), layer.layer_input_weight().rows_size());
+    CHECK_EQ(layer.layer_output_dim(), layer.layer_bias().columns_size());
+    CompiledLayer compiled_layer;
+    compiled_layer.weights.resize(layer.layer_input_dim(),
+                                  layer.layer_output_dim());
+    for (int row = 0; row < layer.layer_input_dim(); ++row) {
+      const Vector& weights = layer.layer_input_weight().rows(row);
+      CHECK_EQ(layer.layer_output_dim(), weights.columns_size());
+      for (int col = 0; col < layer.layer_output_dim(); ++col) {
+        compiled_layer.weights(row, col) = weights.columns(col);
+      }
+    }
+    compiled_layer.bias.resize(layer.layer_output_dim());
     for (int col = 0; col < layer.layer_output_dim(); ++col) {
-      double neuron_output = layer.layer_bias().columns(col);
-      for (int row = 0; row < layer.layer_input_dim(); ++row) {
-        double weight = layer.layer_input_weight().rows(row).columns(col);
-        neuron_output += (layer_input[row] * weight);
+      compiled_layer.bias(col) = layer.layer_bias().columns(col);
+    }
+    switch (layer.layer_activation_func()) {
+      case Layer::RELU: {
+        compiled_layer.activation_func = &math_util::Relu;
+        break;
       }
-      if (layer.layer_activation_func() == Layer::RELU) {
-        neuron_output = apollo::prediction::math_util::Relu(neuron_output);
-      } else if (layer.layer_activation_func() == Layer::SIGMOID) {
-        neuron_output = apollo::prediction::math_util::Sigmoid(neuron_output);
-      } else if (layer.layer_activation_func() == Layer::TANH) {
-        neuron_output = std::tanh(neuron_output);
-      } else {
+      case Layer::TANH: {
+        compiled_layer.activation_func = &Tanh;
+        break;
+      }
+      case Layer::SIGMOID: {
+        compiled_layer.activation_func = &math_util::Sigmoid;
+        break;
+      }
+      default: {
         AERROR << "Undefined activation function ["
                << layer.layer_activation_func()
                << "]. A default sigmoid will be used instead.";
-        neuron_output = apollo::prediction::math_util::Sigmoid(neuron_output);
+        compiled_layer.activation_func = &math_util::Sigmoid;
+        break;
       }
-      layer_output.push_back(neuron_output);
     }
+    layers_.push_back(std::move(compiled_layer));
+    layer_input_dim = layer.layer_output_dim();
   }
-
-  if (layer_output.size() != 1) {
+  if (layer_input_dim != 1) {
     AERROR << "Model output layer has incorrect # outputs: "
-           << layer_output.size();
-  } else {
-    probability = layer_output[0];
+           << layer_input_dim;
+  }
+}
+
+void MLPEvaluator::ComputeProbabilities(const FeatureMatrix& feature_values,
+                                        Eigen::VectorXd* probabilities) const {
+  // normalization
+  Eigen::MatrixXd layer_output =
+      ((feature_values.rowwise() - samples_mean_).array().rowwise() /
+       samples_std_.array())
+          .matrix();
+
+  Eigen::MatrixXd layer_input;
+  for (const CompiledLayer& layer : layers_) {
+    layer_input.swap(layer_output);
+    layer_output.noalias() = layer_input * layer.weights;
+    layer_output =
+        (layer_output.rowwise() + layer.bias).unaryExpr(layer.activation_func);
   }
 
-  return probability;
+  if (layer_output.cols() != 1) {
+    *probabilities = Eigen::VectorXd::Zero(feature_values.rows());
+  } else {
+    *probabilities = layer_output.col(0);
+  }
 }
 
 }  // namespace prediction
@@ -19,9 +19,10 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "Eigen/Dense"
+
 #include "modules/prediction/container/obstacles/obstacle.h"
 #include "modules/prediction/evaluator/evaluator.h"
 #include "modules/prediction/proto/fnn_vehicle_model.pb.h"
@@ -49,20 +50,42 @@ class MLPEvaluator : public Evaluator {
   void Evaluate(Obstacle* obstacle_ptr) override;
 
   /**
-   * @brief Extract feature vector
-   * @param Obstacle pointer
-   *        Lane Sequence pointer
+   * @brief Override EvaluateBatch, running the model once on the lane
+   *        sequences of all obstacles
+   * @param Obstacle pointers
    */
-  void ExtractFeatureValues(Obstacle* obstacle_ptr,
-                            LaneSequence* lane_sequence_ptr,
-                            std::vector<double>* feature_values);
+  void EvaluateBatch(const std::vector<Obstacle*>& obstacles) override;
 
   /**
-   * @brief Clear obstacle feature map
+   * @brief Clear
    */
   void Clear();
 
  private:
+  /**
+   * @brief A layer of the model with its weights in matrices
+   */
+  struct CompiledLayer {
+    Eigen::MatrixXd weights;  // |input_dim| x |output_dim|
+    Eigen::RowVectorXd bias;
+    double (*activation_func)(double) = nullptr;
+  };
+
+  using FeatureMatrix = Eigen::Map<const Eigen::Matrix<
+      double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
+
+  /**
+   * @brief Extract feature vector with given obstacle feature values
+   * @param Obstacle pointer
+   *        Obstacle feature values
+   *        Lane Sequence pointer
+   *        Feature container in a vector for receiving the feature values
+   */
+  void ExtractFeatureValues(Obstacle* obstacle_ptr,
+                            const std::vector<double>& obstacle_feature_values,
+                            LaneSequence* lane_sequence_ptr,
+                            std::vector<double>* feature_values);
+
   /**
    * @brief Set obstacle feature vector
    * @param Obstacle pointer
@@ -88,9 +111,17 @@ class MLPEvaluator : public Evaluator {
   void LoadModel(const std::string& model_file);
 
   /**
-   * @brief Compute probability
+   * @brief Compile the model into matrices
    */
-  double ComputeProbability(const std::vector<double>& feature_values);
+  void CompileModel();
+
+  /**
+   * @brief Compute probabilities
+   * @param Feature values, one row per lane sequence
+   *        Probabilities of the rows
+   */
+  void ComputeProbabilities(const FeatureMatrix& feature_values,
+                            Eigen::VectorXd* probabilities) const;
 
   /**
    * @brief Save offline feature values in proto
@@ -101,11 +132,16 @@ class MLPEvaluator : public Evaluator {
                            const std::vector<double>& feature_values);
 
  private:
-  std::unordered_map<int, std::vector<double>> obstacle_feature_values_map_;
   static const size_t OBSTACLE_FEATURE_SIZE = 22;
   static const size_t LANE_FEATURE_SIZE = 40;
 
   std::unique_ptr<FnnVehicleModel> model_ptr_;
+
+  // The model compiled from model_ptr_, so that the lane sequences are
+  // evaluated with a matrix product per layer.
+  Eigen::RowVectorXd samples_mean_;
+  Eigen::RowVectorXd samples_std_;
+  std::vector<CompiledLayer> layers_;
 };
 
 }  // namespace prediction
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Measures the time of MLPEvaluator in a prediction cycle, evaluating
+ *        the obstacles one by one and all at once in a batch.
+ *        Run from the root of the repository, for the model and test map.
+ */
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/configs/config_gflags.h"
+#include "modules/common/util/file.h"
+#include "modules/perception/proto/perception_obstacle.pb.h"
+#include "modules/prediction/common/prediction_gflags.h"
+#include "modules/prediction/container/obstacles/obstacles_container.h"
+#include "modules/prediction/evaluator/vehicle/mlp_evaluator.h"
+
+namespace apollo {
+namespace prediction {
+namespace {
+
+// The vehicles on the lanes of the test map, repeated with new ids up to
+// the number of obstacles of a cycle.
+std::vector<Obstacle*> InsertVehicles(const int num_obstacles,
+                                      ObstaclesContainer* container) {
+  perception::PerceptionObstacles test_obstacles;
+  CHECK(common::util::GetProtoFromFile(
+      "modules/prediction/testdata/perception_vehicles_pedestrians.pb.txt",
+      &test_obstacles));
+  std::vector<perception::PerceptionObstacle> vehicles;
+  for (const auto& perception_obstacle : test_obstacles.perception_obstacle()) {
+    if (perception_obstacle.type() == perception::PerceptionObstacle::VEHICLE) {
+      vehicles.push_back(perception_obstacle);
+    }
+  }
+
+  perception::PerceptionObstacles perception_obstacles;
+  perception_obstacles.mutable_header()->CopyFrom(test_obstacles.header());
+  for (int i = 0; i < num_obstacles; ++i) {
+    auto* perception_obstacle = perception_obstacles.add_perception_obstacle();
+    perception_obstacle->CopyFrom(vehicles[i % vehicles.size()]);
+    perception_obstacle->set_id(i);
+  }
+  container->Insert(perception_obstacles);
+
+  std::vector<Obstacle*> obstacles;
+  for (int i = 0; i < num_obstacles; ++i) {
+    obstacles.push_back(CHECK_NOTNULL(container->GetObstacle(i)));
+  }
+  return obstacles;
+}
+
+void SetUpFlags(const int num_obstacles) {
+  FLAGS_map_dir = "modules/prediction/testdata";
+  FLAGS_base_map_filename = "kml_map.bin";
+  FLAGS_max_num_obstacles = num_obstacles;
+}
+
+void BM_Evaluate(benchmark::State& state) {  // NOLINT
+  SetUpFlags(state.range(0));
+  ObstaclesContainer container;
+  const auto obstacles = InsertVehicles(state.range(0), &container);
+  MLPEvaluator mlp_evaluator;
+  while (state.KeepRunning()) {
+    for (Obstacle* obstacle : obstacles) {
+      mlp_evaluator.Evaluate(obstacle);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * obstacles.size());
+}
+
+void BM_EvaluateBatch(benchmark::State& state) {  // NOLINT
+  SetUpFlags(state.range(0));
+  ObstaclesContainer container;
+  const auto obstacles = InsertVehicles(state.range(0), &container);
+  MLPEvaluator mlp_evaluator;
+  while (state.KeepRunning()) {
+    mlp_evaluator.EvaluateBatch(obstacles);
+  }
+  state.SetItemsProcessed(state.iterations() * obstacles.size());
+}
+
+BENCHMARK(BM_Evaluate)->Arg(8)->Arg(32)->Arg(128);
+BENCHMARK(BM_EvaluateBatch)->Arg(8)->Arg(32)->Arg(128);
+
+}  // namespace
+}  // namespace prediction
+}  // namespace apollo
+
+BENCHMARK_MAIN();
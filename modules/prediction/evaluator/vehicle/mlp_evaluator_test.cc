@@ -64,5 +64,45 @@ TEST_F(MLPEvaluatorTest, OnLaneCase) {
   mlp_evaluator.Clear();
 }
 
+TEST_F(MLPEvaluatorTest, BatchCase) {
+  std::string file =
+      "modules/prediction/testdata/perception_vehicles_pedestrians.pb.txt";
+  apollo::perception::PerceptionObstacles perception_obstacles;
+  CHECK(apollo::common::util::GetProtoFromFile(file, &perception_obstacles));
+  MLPEvaluator mlp_evaluator;
+  ObstaclesContainer container;
+  container.Insert(perception_obstacles);
+  ObstaclesContainer batch_container;
+  batch_container.Insert(perception_obstacles);
+
+  std::vector<Obstacle*> batch;
+  for (const int id : {0, 1, 2, 3, 101, 102}) {
+    Obstacle* obstacle_ptr = container.GetObstacle(id);
+    ASSERT_TRUE(obstacle_ptr != nullptr);
+    mlp_evaluator.Evaluate(obstacle_ptr);
+    batch.push_back(batch_container.GetObstacle(id));
+    ASSERT_TRUE(batch.back() != nullptr);
+  }
+  mlp_evaluator.EvaluateBatch(batch);
+
+  int num_lane_sequences = 0;
+  for (const Obstacle* batch_obstacle_ptr : batch) {
+    const LaneGraph& lane_graph =
+        container.GetObstacle(batch_obstacle_ptr->id())
+            ->latest_feature().lane().lane_graph();
+    const LaneGraph& batch_lane_graph =
+        batch_obstacle_ptr->latest_feature().lane().lane_graph();
+    ASSERT_EQ(lane_graph.lane_sequence_size(),
+              batch_lane_graph.lane_sequence_size());
+    for (int i = 0; i < lane_graph.lane_sequence_size(); ++i) {
+      EXPECT_TRUE(batch_lane_graph.lane_sequence(i).has_probability());
+      EXPECT_NEAR(lane_graph.lane_sequence(i).probability(),
+                  batch_lane_graph.lane_sequence(i).probability(), 1e-12);
+      ++num_lane_sequences;
+    }
+  }
+  EXPECT_GT(num_lane_sequences, 0);
+}
+
 }  // namespace prediction
 }  // namespace apollo
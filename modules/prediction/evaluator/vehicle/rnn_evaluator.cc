@@ -16,9 +16,11 @@
 
 #include "modules/prediction/evaluator/vehicle/rnn_evaluator.h"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -34,67 +36,157 @@ using apollo::hdmap::LaneInfo;
 RNNEvaluator::RNNEvaluator() { LoadModel(FLAGS_evaluator_vehicle_rnn_file); }
 
 void RNNEvaluator::Evaluate(Obstacle* obstacle_ptr) {
-  Clear();
-  CHECK_NOTNULL(obstacle_ptr);
+  EvaluateBatch({obstacle_ptr});
+}
 
-  int id = obstacle_ptr->id();
-  if (!obstacle_ptr->latest_feature().IsInitialized()) {
-    ADEBUG << "Obstacle [" << id << "] has no latest feature.";
-    return;
+void RNNEvaluator::EvaluateBatch(const std::vector<Obstacle*>& obstacles) {
+  // The states of a repeated obstacle are advanced in order, so it starts a
+  // new batch.
+  std::vector<Obstacle*> batch;
+  std::unordered_set<int> ids;
+  for (Obstacle* obstacle_ptr : obstacles) {
+    CHECK_NOTNULL(obstacle_ptr);
+    if (!ids.insert(obstacle_ptr->id()).second) {
+      EvaluateObstacles(batch);
+      batch.clear();
+      ids = {obstacle_ptr->id()};
+    }
+    batch.push_back(obstacle_ptr);
   }
+  EvaluateObstacles(batch);
+}
 
-  Feature* latest_feature_ptr = obstacle_ptr->mutable_latest_feature();
-  CHECK_NOTNULL(latest_feature_ptr);
-  if (!latest_feature_ptr->has_lane() ||
-      !latest_feature_ptr->lane().has_lane_graph()) {
-    ADEBUG << "Obstacle [" << id << "] has no lane graph.";
+void RNNEvaluator::EvaluateObstacles(const std::vector<Obstacle*>& obstacles) {
+  Clear();
+  if (!model_ptr_->IsOk()) {
+    AWARN << "Fail to initialize rnn model.";
     return;
   }
 
-  LaneGraph* lane_graph_ptr =
-      latest_feature_ptr->mutable_lane()->mutable_lane_graph();
-  CHECK_NOTNULL(lane_graph_ptr);
-  if (lane_graph_ptr->lane_sequence_size() == 0) {
-    ADEBUG << "Obstacle [" << id << "] has no lane sequences.";
-    return;
+  std::vector<Obstacle*> evaluated_obstacles;
+  std::vector<Obstacle*> reset_obstacles;
+  Eigen::MatrixXf obstacle_features(obstacles.size(), DIM_OBSTACLE_FEATURE);
+  std::vector<std::unordered_map<int, Eigen::MatrixXf>> lane_feature_mats(
+      obstacles.size());
+  std::vector<const Eigen::MatrixXf*> lane_features;
+  std::vector<int> obstacle_rows;
+  std::vector<LaneSequence*> lane_sequences;
+  for (Obstacle* obstacle_ptr : obstacles) {
+    int id = obstacle_ptr->id();
+    if (!obstacle_ptr->latest_feature().IsInitialized()) {
+      ADEBUG << "Obstacle [" << id << "] has no latest feature.";
+      continue;
+    }
+
+    Feature* latest_feature_ptr = obstacle_ptr->mutable_latest_feature();
+    CHECK_NOTNULL(latest_feature_ptr);
+    if (!latest_feature_ptr->has_lane() ||
+        !latest_feature_ptr->lane().has_lane_graph()) {
+      ADEBUG << "Obstacle [" << id << "] has no lane graph.";
+      continue;
+    }
+
+    LaneGraph* lane_graph_ptr =
+        latest_feature_ptr->mutable_lane()->mutable_lane_graph();
+    CHECK_NOTNULL(lane_graph_ptr);
+    if (lane_graph_ptr->lane_sequence_size() == 0) {
+      ADEBUG << "Obstacle [" << id << "] has no lane sequences.";
+      continue;
+    }
+
+    const int row = static_cast<int>(evaluated_obstacles.size());
+    Eigen::MatrixXf obstacle_feature_mat;
+    std::unordered_map<int, Eigen::MatrixXf>& obstacle_lane_feature_mats =
+        lane_feature_mats[row];
+    obstacle_lane_feature_mats.clear();
+    bool reset_state = !obstacle_ptr->RNNEnabled();
+    int ret = ExtractFeatureValues(obstacle_ptr, &obstacle_feature_mat,
+                                   &obstacle_lane_feature_mats, &reset_state);
+    if (reset_state) {
+      reset_obstacles.push_back(obstacle_ptr);
+    }
+    if (ret != 0) {
+      ADEBUG << "Fail to extract feature from obstacle";
+      continue;
+    }
+    if (obstacle_feature_mat.rows() != 1 ||
+        obstacle_feature_mat.size() != DIM_OBSTACLE_FEATURE) {
+      ADEBUG << "Dim of obstacle feature is wrong!";
+      continue;
+    }
+
+    bool has_lane_feature = false;
+    for (int i = 0; i < lane_graph_ptr->lane_sequence_size(); ++i) {
+      LaneSequence* lane_sequence_ptr =
+          lane_graph_ptr->mutable_lane_sequence(i);
+      int seq_id = lane_sequence_ptr->lane_sequence_id();
+      auto it = obstacle_lane_feature_mats.find(seq_id);
+      if (it == obstacle_lane_feature_mats.end()) {
+        ADEBUG << "Fail to access seq-" << seq_id << " feature!";
+        continue;
+      }
+      if (it->second.cols() != DIM_LANE_POINT_FEATURE) {
+        ADEBUG << "Lane feature dim of seq-" << seq_id << " is wrong!";
+        continue;
+      }
+      lane_features.push_back(&it->second);
+      obstacle_rows.push_back(row);
+      lane_sequences.push_back(lane_sequence_ptr);
+      has_lane_feature = true;
+    }
+    if (has_lane_feature) {
+      obstacle_features.row(row) = obstacle_feature_mat;
+      evaluated_obstacles.push_back(obstacle_ptr);
+    }
   }
 
-  Eigen::MatrixXf obstacle_feature_mat;
-  std::unordered_map<int, Eigen::MatrixXf> lane_feature_mats;
-  if (ExtractFeatureValues(obstacle_ptr, &obstacle_feature_mat,
-                           &lane_feature_mats) != 0) {
-    ADEBUG << "Fail to extract feature from obstacle";
-    return;
+  std::lock_guard<std::mutex> lock(model_mutex_);
+  ++num_batches_;
+  // The row of an obstacle which has not been evaluated for a while may have
+  // been taken by another one, so the obstacle is reset as a new one is.
+  for (Obstacle* obstacle_ptr : evaluated_obstacles) {
+    if (obstacle_ptr->RNNEnabled() &&
+        state_rows_.find(obstacle_ptr->id()) == state_rows_.end() &&
+        std::find(reset_obstacles.begin(), reset_obstacles.end(),
+                  obstacle_ptr) == reset_obstacles.end()) {
+      ADEBUG << "Obstacle [" << obstacle_ptr->id()
+             << "] lost its rnn states, reset";
+      reset_obstacles.push_back(obstacle_ptr);
+    }
   }
-  if (obstacle_feature_mat.rows() != 1 ||
-      obstacle_feature_mat.size() != DIM_OBSTACLE_FEATURE) {
-    ADEBUG << "Dim of obstacle feature is wrong!";
+  for (Obstacle* obstacle_ptr : reset_obstacles) {
+    obstacle_ptr->InitRNNStates();
+    const int state_row = GetStateRow(obstacle_ptr->id());
+    hidden_states_.row(state_row).setZero();
+    cell_states_.row(state_row).setZero();
+  }
+  if (evaluated_obstacles.empty()) {
     return;
   }
 
+  const int num_obstacles = static_cast<int>(evaluated_obstacles.size());
+  std::vector<int> state_rows(num_obstacles);
+  Eigen::MatrixXf hidden_states(num_obstacles, hidden_states_.cols());
+  Eigen::MatrixXf cell_states(num_obstacles, cell_states_.cols());
+  for (int i = 0; i < num_obstacles; ++i) {
+    state_rows[i] = GetStateRow(evaluated_obstacles[i]->id());
+    hidden_states.row(i) = hidden_states_.row(state_rows[i]);
+    cell_states.row(i) = cell_states_.row(state_rows[i]);
+  }
+  obstacle_features.conservativeResize(num_obstacles, Eigen::NoChange);
+
   Eigen::MatrixXf pred_mat;
-  std::vector<Eigen::MatrixXf> states;
-  if (!obstacle_ptr->RNNEnabled()) {
-    obstacle_ptr->InitRNNStates();
+  model_ptr_->RunBatch(obstacle_features, lane_features, obstacle_rows,
+                       &hidden_states, &cell_states, &pred_mat);
+  for (int i = 0; i < num_obstacles; ++i) {
+    hidden_states_.row(state_rows[i]) = hidden_states.row(i);
+    cell_states_.row(state_rows[i]) = cell_states.row(i);
   }
-  obstacle_ptr->GetRNNStates(&states);
-  for (int i = 0; i < lane_graph_ptr->lane_sequence_size(); ++i) {
-    LaneSequence* lane_sequence_ptr = lane_graph_ptr->mutable_lane_sequence(i);
-    int seq_id = lane_sequence_ptr->lane_sequence_id();
-    if (lane_feature_mats.find(seq_id) == lane_feature_mats.end()) {
-      ADEBUG << "Fail to access seq-" << seq_id << " feature!";
-      continue;
-    }
-    const Eigen::MatrixXf& lane_feature_mat = lane_feature_mats[seq_id];
-    if (lane_feature_mat.cols() != DIM_LANE_POINT_FEATURE) {
-      ADEBUG << "Lane feature dim of seq-" << seq_id << " is wrong!";
-      continue;
-    }
-    model_ptr_->SetState(states);
-    model_ptr_->Run({obstacle_feature_mat, lane_feature_mat}, &pred_mat);
-    double probability = pred_mat(0, 0);
+
+  for (std::size_t i = 0; i < lane_sequences.size(); ++i) {
+    double probability = pred_mat(i, 0);
     ADEBUG << "-------- Probability = " << probability;
-    double acceleration = pred_mat(0, 1);
+    double acceleration = pred_mat(i, 1);
     if (std::isnan(probability) || std::isinf(probability)) {
       ADEBUG << "Fail to compute probability.";
       continue;
@@ -103,11 +195,40 @@ void RNNEvaluator::Evaluate(Obstacle* obstacle_ptr) {
       ADEBUG << "Fail to compute acceleration.";
       continue;
     }
-    lane_sequence_ptr->set_probability(probability);
-    lane_sequence_ptr->set_acceleration(acceleration);
+    lane_sequences[i]->set_probability(probability);
+    lane_sequences[i]->set_acceleration(acceleration);
   }
-  model_ptr_->State(&states);
-  obstacle_ptr->SetRNNStates(states);
+}
+
+int RNNEvaluator::GetStateRow(const int obstacle_id) {
+  auto it = state_rows_.find(obstacle_id);
+  int row = 0;
+  if (it != state_rows_.end()) {
+    row = it->second;
+  } else {
+    row = static_cast<int>(std::min_element(state_row_batches_.begin(),
+                                            state_row_batches_.end()) -
+                           state_row_batches_.begin());
+    if (state_row_batches_[row] == num_batches_) {
+      // All the rows are taken by the obstacles of this batch.
+      row = static_cast<int>(hidden_states_.rows());
+      hidden_states_.conservativeResize(2 * row, Eigen::NoChange);
+      cell_states_.conservativeResize(2 * row, Eigen::NoChange);
+      state_row_ids_.resize(2 * row, 0);
+      state_row_batches_.resize(2 * row, 0);
+    } else {
+      auto owner = state_rows_.find(state_row_ids_[row]);
+      if (owner != state_rows_.end() && owner->second == row) {
+        state_rows_.erase(owner);
+      }
+    }
+    state_rows_[obstacle_id] = row;
+    state_row_ids_[row] = obstacle_id;
+    hidden_states_.row(row).setZero();
+    cell_states_.row(row).setZero();
+  }
+  state_row_batches_[row] = num_batches_;
+  return row;
 }
 
 void RNNEvaluator::Clear() {}
@@ -119,17 +240,41 @@ void RNNEvaluator::LoadModel(const std::string& model_file) {
 
   ADEBUG << "Succeeded in loading the model file: " << model_file << ".";
   model_ptr_ = network::RnnModel::instance();
-  model_ptr_->LoadModel(net_parameter);
+  if (!model_ptr_->LoadModel(net_parameter)) {
+    return;
+  }
+
+  std::vector<Eigen::MatrixXf> states;
+  model_ptr_->State(&states);
+  const int num_rows = std::max(FLAGS_max_num_obstacles, 1);
+  hidden_states_ = Eigen::MatrixXf::Zero(num_rows, states[0].cols());
+  cell_states_ = Eigen::MatrixXf::Zero(num_rows, states[1].cols());
+  state_rows_.clear();
+  state_row_ids_.assign(num_rows, 0);
+  state_row_batches_.assign(num_rows, 0);
 }
 
 int RNNEvaluator::ExtractFeatureValues(
     Obstacle* obstacle, Eigen::MatrixXf* const obstacle_feature_mat,
     std::unordered_map<int, Eigen::MatrixXf>* const lane_feature_mats) {
+  bool reset_state = false;
+  int ret = ExtractFeatureValues(obstacle, obstacle_feature_mat,
+                                 lane_feature_mats, &reset_state);
+  if (reset_state) {
+    obstacle->InitRNNStates();
+  }
+  return ret;
+}
+
+int RNNEvaluator::ExtractFeatureValues(
+    Obstacle* obstacle, Eigen::MatrixXf* const obstacle_feature_mat,
+    std::unordered_map<int, Eigen::MatrixXf>* const lane_feature_mats,
+    bool* const reset_state) {
   std::vector<float> obstacle_features;
   std::vector<float> lane_features;
   if (SetupObstacleFeature(obstacle, &obstacle_features) != 0) {
     ADEBUG << "Reset rnn state";
-    obstacle->InitRNNStates();
+    *reset_state = true;
   }
   if (static_cast<int>(obstacle_features.size()) != DIM_OBSTACLE_FEATURE) {
     AWARN << "Obstacle feature size: " << obstacle_features.size();
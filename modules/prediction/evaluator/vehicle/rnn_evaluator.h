@@ -17,7 +17,9 @@
 #ifndef MODULES_PREDICTION_EVALUATOR_VEHICLE_RNN_EVALUATOR_H_
 #define MODULES_PREDICTION_EVALUATOR_VEHICLE_RNN_EVALUATOR_H_
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -50,6 +52,13 @@ class RNNEvaluator : public Evaluator {
    */
   void Evaluate(Obstacle* obstacle_ptr) override;
 
+  /**
+   * @brief Override EvaluateBatch, running the model once on the lane
+   *        sequences of all obstacles and advancing their states together
+   * @param Obstacle pointers
+   */
+  void EvaluateBatch(const std::vector<Obstacle*>& obstacles) override;
+
   /**
    * @brief Extract feature vector
    * @param obstacle a pointer to the target obstacle
@@ -72,6 +81,26 @@ class RNNEvaluator : public Evaluator {
    */
   void LoadModel(const std::string& model_file);
 
+  /**
+   * @brief Evaluate obstacles of distinct ids in a batch
+   * @param Obstacle pointers
+   */
+  void EvaluateObstacles(const std::vector<Obstacle*>& obstacles);
+
+  int ExtractFeatureValues(
+      Obstacle* obstacle, Eigen::MatrixXf* const obstacle_feature_mat,
+      std::unordered_map<int, Eigen::MatrixXf>* const lane_feature_mats,
+      bool* const reset_state);
+
+  /**
+   * @brief Get the row of the states of an obstacle, taking the least
+   *        recently used row with zero states for a new obstacle. The
+   *        obstacle which used the row is reset when it is evaluated again.
+   * @param Obstacle id
+   * @return Row of the states
+   */
+  int GetStateRow(const int obstacle_id);
+
   int SetupObstacleFeature(Obstacle* obstacle,
                            std::vector<float>* const feature_values);
 
@@ -87,6 +116,18 @@ class RNNEvaluator : public Evaluator {
   static const int DIM_LANE_POINT_FEATURE = 4;
   static const int LENGTH_LANE_POINT_SEQUENCE = 20;
   network::RnnModel* model_ptr_;
+  // The states below are shared by the obstacles, so the obstacles
+  // evaluated concurrently advance them one batch at a time. The model keeps
+  // no state of a batch, see RnnModel::RunBatch().
+  std::mutex model_mutex_;
+  // The hidden and cell states of the obstacles, kept across frames in a row
+  // per obstacle, with the obstacle id and the last batch of each row.
+  Eigen::MatrixXf hidden_states_;
+  Eigen::MatrixXf cell_states_;
+  std::unordered_map<int, int> state_rows_;
+  std::vector<int> state_row_ids_;
+  std::vector<int64_t> state_row_batches_;
+  int64_t num_batches_ = 0;
 };
 
 }  // namespace prediction
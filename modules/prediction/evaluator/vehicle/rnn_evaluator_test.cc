@@ -64,5 +64,99 @@ TEST_F(RNNEvaluatorTest, OnLaneCase) {
   rnn_evaluator.Clear();
 }
 
+TEST_F(RNNEvaluatorTest, BatchCase) {
+  std::string file =
+      "modules/prediction/testdata/perception_vehicles_pedestrians.pb.txt";
+  apollo::perception::PerceptionObstacles perception_obstacles;
+  CHECK(apollo::common::util::GetProtoFromFile(file, &perception_obstacles));
+  RNNEvaluator rnn_evaluator;
+  RNNEvaluator batch_rnn_evaluator;
+  ObstaclesContainer container;
+  container.Insert(perception_obstacles);
+  ObstaclesContainer batch_container;
+  batch_container.Insert(perception_obstacles);
+
+  // The second round runs from the states advanced by the first one.
+  for (int round = 0; round < 2; ++round) {
+    std::vector<Obstacle*> batch;
+    for (const int id : {0, 1, 2, 3, 101, 102}) {
+      Obstacle* obstacle_ptr = container.GetObstacle(id);
+      ASSERT_TRUE(obstacle_ptr != nullptr);
+      rnn_evaluator.Evaluate(obstacle_ptr);
+      batch.push_back(batch_container.GetObstacle(id));
+      ASSERT_TRUE(batch.back() != nullptr);
+    }
+    batch_rnn_evaluator.EvaluateBatch(batch);
+
+    int num_lane_sequences = 0;
+    for (const Obstacle* batch_obstacle_ptr : batch) {
+      const LaneGraph& lane_graph =
+          container.GetObstacle(batch_obstacle_ptr->id())
+              ->latest_feature().lane().lane_graph();
+      const LaneGraph& batch_lane_graph =
+          batch_obstacle_ptr->latest_feature().lane().lane_graph();
+      ASSERT_EQ(lane_graph.lane_sequence_size(),
+                batch_lane_graph.lane_sequence_size());
+      for (int i = 0; i < lane_graph.lane_sequence_size(); ++i) {
+        EXPECT_TRUE(batch_lane_graph.lane_sequence(i).has_probability());
+        EXPECT_NEAR(lane_graph.lane_sequence(i).probability(),
+                    batch_lane_graph.lane_sequence(i).probability(), 1e-5);
+        EXPECT_NEAR(lane_graph.lane_sequence(i).acceleration(),
+                    batch_lane_graph.lane_sequence(i).acceleration(), 1e-5);
+        ++num_lane_sequences;
+      }
+    }
+    EXPECT_GT(num_lane_sequences, 0);
+  }
+}
+
+TEST_F(RNNEvaluatorTest, EvictedStateCase) {
+  apollo::perception::PerceptionObstacles perception_obstacles =
+      perception_obstacles_;
+  perception_obstacles.add_perception_obstacle()->CopyFrom(
+      perception_obstacles.perception_obstacle(0));
+  perception_obstacles.mutable_perception_obstacle(1)->set_id(2);
+  ObstaclesContainer container;
+  container.Insert(perception_obstacles);
+  Obstacle* obstacle_ptr = container.GetObstacle(1);
+  Obstacle* other_obstacle_ptr = container.GetObstacle(2);
+  ASSERT_TRUE(obstacle_ptr != nullptr);
+  ASSERT_TRUE(other_obstacle_ptr != nullptr);
+
+  // A single row of states, which the two obstacles take from each other.
+  google::FlagSaver flag_saver;
+  FLAGS_max_num_obstacles = 1;
+  RNNEvaluator rnn_evaluator;
+  rnn_evaluator.Evaluate(obstacle_ptr);
+  EXPECT_TRUE(obstacle_ptr->RNNEnabled());
+  std::vector<Eigen::MatrixXf> reset_states;
+  obstacle_ptr->GetRNNStates(&reset_states);
+  ASSERT_FALSE(reset_states.empty());
+
+  // Mark the states of the obstacle, which are only set again on a reset.
+  std::vector<Eigen::MatrixXf> marked_states = reset_states;
+  for (Eigen::MatrixXf& state : marked_states) {
+    state.setConstant(1.0f);
+  }
+  obstacle_ptr->SetRNNStates(marked_states);
+  rnn_evaluator.Evaluate(obstacle_ptr);
+  std::vector<Eigen::MatrixXf> states;
+  obstacle_ptr->GetRNNStates(&states);
+  EXPECT_TRUE(states[0].isApprox(marked_states[0]));
+
+  // The other obstacle takes the row, so the first one is reset when it is
+  // evaluated again.
+  rnn_evaluator.Evaluate(other_obstacle_ptr);
+  rnn_evaluator.Evaluate(obstacle_ptr);
+  EXPECT_TRUE(obstacle_ptr->RNNEnabled());
+  obstacle_ptr->GetRNNStates(&states);
+  EXPECT_TRUE((states[0] - reset_states[0]).isZero());
+  const LaneGraph& lane_graph =
+      obstacle_ptr->latest_feature().lane().lane_graph();
+  for (const auto& lane_sequence : lane_graph.lane_sequence()) {
+    EXPECT_TRUE(lane_sequence.has_probability());
+  }
+}
+
 }  // namespace prediction
 }  // namespace apollo
@@ -262,43 +262,58 @@ bool LSTM::Load(const LayerParameter& layer_pb) {
     AERROR << "Fail to Load reccurent output weights!";
     return false;
   }
+  w_.resize(wi_.rows(), 4 * units_);
+  w_ << wi_, wf_, wc_, wo_;
+  r_w_.resize(r_wi_.rows(), 4 * units_);
+  r_w_ << r_wi_, r_wf_, r_wc_, r_wo_;
+  b_.resize(4 * units_);
+  b_ << bi_.transpose(), bf_.transpose(), bc_.transpose(), bo_.transpose();
+  gates_.resize(0, 4 * units_);
   ResetState();
   return true;
 }
 
-void LSTM::Step(const Eigen::MatrixXf& input, Eigen::MatrixXf* output,
-                Eigen::MatrixXf* ht_1, Eigen::MatrixXf* ct_1) {
-  Eigen::MatrixXf x_i = input * wi_ + bi_.transpose();
-  Eigen::MatrixXf x_f = input * wf_ + bf_.transpose();
-  Eigen::MatrixXf x_c = input * wc_ + bc_.transpose();
-  Eigen::MatrixXf x_o = input * wo_ + bo_.transpose();
+void LSTM::Step(const Eigen::Ref<const Eigen::MatrixXf>& inputs,
+                Eigen::Ref<Eigen::MatrixXf> ht_1,
+                Eigen::Ref<Eigen::MatrixXf> ct_1,
+                Eigen::MatrixXf* gates_buffer) const {
+  const int batch_size = static_cast<int>(inputs.rows());
+  if (gates_buffer->rows() < batch_size ||
+      gates_buffer->cols() != 4 * units_) {
+    gates_buffer->resize(batch_size, 4 * units_);
+  }
+  auto gates = gates_buffer->topRows(batch_size);
+  gates.noalias() = inputs * w_;
+  gates.rowwise() += b_;
+  gates.noalias() += ht_1 * r_w_;
 
-  Eigen::MatrixXf i = (x_i + (*ht_1) * r_wi_).unaryExpr(krecurrent_activation_);
-  Eigen::MatrixXf f = (x_f + (*ht_1) * r_wf_).unaryExpr(krecurrent_activation_);
-  Eigen::MatrixXf c =
-      f.array() * ct_1->array() +
-      i.array() * ((x_c + (*ht_1) * r_wc_).unaryExpr(kactivation_)).array();
-  Eigen::MatrixXf o = (x_o + (*ht_1) * r_wo_).unaryExpr(krecurrent_activation_);
-  Eigen::MatrixXf h = o.array() * (c.unaryExpr(kactivation_)).array();
+  auto i = gates.leftCols(units_);
+  auto f = gates.middleCols(units_, units_);
+  auto c = gates.middleCols(2 * units_, units_);
+  auto o = gates.rightCols(units_);
+  i = i.unaryExpr(krecurrent_activation_);
+  f = f.unaryExpr(krecurrent_activation_);
+  c = c.unaryExpr(kactivation_);
+  o = o.unaryExpr(krecurrent_activation_);
 
-  *ht_1 = h;
-  *ct_1 = c;
-  *output = h;
+  ct_1.array() = f.array() * ct_1.array() + i.array() * c.array();
+  ht_1.array() = o.array() * ct_1.unaryExpr(kactivation_).array();
 }
 
 void LSTM::Run(const std::vector<Eigen::MatrixXf>& inputs,
                Eigen::MatrixXf* output) {
   CHECK_EQ(inputs.size(), 1);
-  Eigen::MatrixXf sequences(inputs[0].rows(), units_);
-  Eigen::MatrixXf temp;
+  if (return_sequences_) {
+    output->resize(inputs[0].rows(), units_);
+  }
   for (int i = 0; i < inputs[0].rows(); ++i) {
-    Step(inputs[0].row(i), &temp, &ht_1_, &ct_1_);
-    sequences.row(i) = temp.row(0);
+    Step(inputs[0].middleRows(i, 1), ht_1_, ct_1_, &gates_);
+    if (return_sequences_) {
+      output->row(i) = ht_1_.row(0);
+    }
   }
-  if (return_sequences_) {
-    *output = sequences;
-  } else {
-    *output = temp.row(0);
+  if (!return_sequences_) {
+    *output = ht_1_;
   }
 }
 
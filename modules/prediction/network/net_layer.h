@@ -237,17 +237,24 @@ class LSTM : public Layer {
    */
   void State(std::vector<Eigen::MatrixXf>* states) const override;
 
- private:
   /**
-   * @brief Compute the output of LSTM step by step
-   * @param Input of current step
-   * @param Output of current step
-   * @param Hidden state of previous step and return current hidden state
-   * @param Cell state of previous step and return current cell state
+   * @brief Compute one step of a batch of independent sequences, whose
+   *        states are kept by the caller with one row per sequence
+   * @param Inputs of current step, one row per sequence
+   * @param Hidden states of previous step and return current hidden states,
+   *        which are also the outputs of current step
+   * @param Cell states of previous step and return current cell states
+   * @param Buffer of the gates, owned by the caller so that concurrent
+   *        steps share no state, which is reallocated only when the batch
+   *        outgrows it or the buffer is passed to a layer of other units
    */
-  void Step(const Eigen::MatrixXf& input, Eigen::MatrixXf* output,
-            Eigen::MatrixXf* ht_1, Eigen::MatrixXf* ct_1);
+  void Step(const Eigen::Ref<const Eigen::MatrixXf>& inputs,
+            Eigen::Ref<Eigen::MatrixXf> ht_1, Eigen::Ref<Eigen::MatrixXf> ct_1,
+            Eigen::MatrixXf* gates_buffer) const;
+
+  int Units() const { return units_; }
 
+ private:
   Eigen::MatrixXf wi_;
   Eigen::MatrixXf wf_;
   Eigen::MatrixXf wc_;
@@ -262,6 +269,14 @@ class LSTM : public Layer {
   Eigen::MatrixXf r_wc_;
   Eigen::MatrixXf r_wo_;
 
+  // The weights and bias of the input, forget, cell and output gates side by
+  // side, so that a step computes all of them with two products.
+  Eigen::MatrixXf w_;
+  Eigen::MatrixXf r_w_;
+  Eigen::RowVectorXf b_;
+  // The gates of the steps of Run().
+  Eigen::MatrixXf gates_;
+
   Eigen::MatrixXf ht_1_;
   Eigen::MatrixXf ct_1_;
   std::function<float(float)> kactivation_;
@@ -16,6 +16,8 @@
 
 #include "modules/prediction/network/rnn_model/rnn_model.h"
 
+#include <algorithm>
+
 #include "modules/common/log.h"
 
 namespace apollo {
@@ -64,6 +66,105 @@ void RnnModel::Run(const std::vector<Eigen::MatrixXf>& inputs,
   *output << prob, acc;
 }
 
+void RnnModel::RunBatch(
+    const Eigen::MatrixXf& obstacle_features,
+    const std::vector<const Eigen::MatrixXf*>& lane_features,
+    const std::vector<int>& obstacle_rows,
+    Eigen::MatrixXf* obstacle_hidden_states,
+    Eigen::MatrixXf* obstacle_cell_states, Eigen::MatrixXf* outputs) const {
+  CHECK_EQ(lane_features.size(), obstacle_rows.size());
+  const int num_sequences = static_cast<int>(lane_features.size());
+  if (num_sequences == 0) {
+    outputs->resize(0, 2);
+    return;
+  }
+  const LSTM* obstacle_lstm = dynamic_cast<const LSTM*>(layers_[4].get());
+  const LSTM* lane_lstm = dynamic_cast<const LSTM*>(layers_[5].get());
+  CHECK_NOTNULL(obstacle_lstm);
+  CHECK_NOTNULL(lane_lstm);
+
+  Eigen::MatrixXf inp1;
+  Eigen::MatrixXf bn1;
+  layers_[0]->Run({obstacle_features}, &inp1);
+  layers_[2]->Run({inp1}, &bn1);
+  // The gates are computed in a local buffer, so that concurrent batches do
+  // not share any state of the model.
+  Eigen::MatrixXf gates;
+  obstacle_lstm->Step(bn1, *obstacle_hidden_states, *obstacle_cell_states,
+                      &gates);
+
+  // The lane sequences run from the longest one, so that the sequences still
+  // running at a step are always the first rows of the batch.
+  std::vector<int> order(num_sequences);
+  for (int i = 0; i < num_sequences; ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) {
+    return lane_features[a]->rows() > lane_features[b]->rows();
+  });
+  const int num_steps = static_cast<int>(lane_features[order[0]]->rows());
+  std::vector<int> step_sizes(num_steps, 0);
+  int num_points = 0;
+  for (const auto* lane_feature : lane_features) {
+    for (int t = 0; t < lane_feature->rows(); ++t) {
+      ++step_sizes[t];
+    }
+    num_points += static_cast<int>(lane_feature->rows());
+  }
+  Eigen::MatrixXf lane_points(num_points, lane_features[order[0]]->cols());
+  int num_rows = 0;
+  for (int t = 0; t < num_steps; ++t) {
+    for (int i = 0; i < step_sizes[t]; ++i) {
+      lane_points.row(num_rows++) = lane_features[order[i]]->row(t);
+    }
+  }
+
+  Eigen::MatrixXf inp2;
+  Eigen::MatrixXf bn2;
+  layers_[1]->Run({lane_points}, &inp2);
+  layers_[3]->Run({inp2}, &bn2);
+  Eigen::MatrixXf hidden_states =
+      Eigen::MatrixXf::Zero(num_sequences, lane_lstm->Units());
+  Eigen::MatrixXf cell_states =
+      Eigen::MatrixXf::Zero(num_sequences, lane_lstm->Units());
+  num_rows = 0;
+  for (int t = 0; t < num_steps; ++t) {
+    lane_lstm->Step(bn2.middleRows(num_rows, step_sizes[t]),
+                    hidden_states.topRows(step_sizes[t]),
+                    cell_states.topRows(step_sizes[t]), &gates);
+    num_rows += step_sizes[t];
+  }
+
+  Eigen::MatrixXf lstm1(num_sequences, obstacle_lstm->Units());
+  Eigen::MatrixXf lstm2(num_sequences, lane_lstm->Units());
+  for (int i = 0; i < num_sequences; ++i) {
+    lstm1.row(order[i]) = obstacle_hidden_states->row(obstacle_rows[order[i]]);
+    lstm2.row(order[i]) = hidden_states.row(i);
+  }
+
+  Eigen::MatrixXf merge;
+  Eigen::MatrixXf dense1;
+  Eigen::MatrixXf act1;
+  layers_[6]->Run({lstm1, lstm2}, &merge);
+  layers_[7]->Run({merge}, &dense1);
+  layers_[8]->Run({dense1}, &bn1);
+  layers_[9]->Run({bn1}, &act1);
+
+  Eigen::MatrixXf dense2;
+  Eigen::MatrixXf prob;
+  layers_[10]->Run({act1}, &dense2);
+  layers_[12]->Run({dense2}, &bn1);
+  layers_[14]->Run({bn1}, &prob);
+
+  Eigen::MatrixXf acc;
+  layers_[11]->Run({act1}, &dense2);
+  layers_[13]->Run({dense2}, &bn1);
+  layers_[15]->Run({bn1}, &acc);
+
+  outputs->resize(num_sequences, 2);
+  *outputs << prob, acc;
+}
+
 void RnnModel::SetState(const std::vector<Eigen::MatrixXf>& states) {
   layers_[4]->SetState(states);
   layers_[5]->ResetState();
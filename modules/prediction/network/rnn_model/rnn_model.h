@@ -48,6 +48,26 @@ class RnnModel : public NetModel {
   void Run(const std::vector<Eigen::MatrixXf>& inputs,
            Eigen::MatrixXf* output) const override;
 
+  /**
+   * @brief Compute the model outputs of a batch of obstacles at once, which
+   *        keeps the internal state untouched, so that batches may run
+   *        concurrently
+   * @param Obstacle features, one row per obstacle
+   * @param Lane features of the lane sequences to evaluate
+   * @param Row of the obstacle in obstacle features of each lane sequence
+   * @param Hidden states of the obstacles, one row per obstacle, which are
+   *        advanced by one step
+   * @param Cell states of the obstacles, one row per obstacle, which are
+   *        advanced by one step
+   * @param Outputs of the network will be returned, one row per lane sequence
+   */
+  void RunBatch(const Eigen::MatrixXf& obstacle_features,
+                const std::vector<const Eigen::MatrixXf*>& lane_features,
+                const std::vector<int>& obstacle_rows,
+                Eigen::MatrixXf* obstacle_hidden_states,
+                Eigen::MatrixXf* obstacle_cell_states,
+                Eigen::MatrixXf* outputs) const;
+
   /**
    * @brief Set the internal state of a network model
    * @param A specified internal state in a vector of Eigen::MatrixXf
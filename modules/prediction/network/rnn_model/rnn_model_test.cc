@@ -15,6 +15,9 @@
  *****************************************************************************/
 
 #include <string>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "modules/common/util/file.h"
@@ -54,6 +57,124 @@ TEST(NetModelTest, verification_test) {
   }
 }
 
+TEST(NetModelTest, batch_test) {
+  const std::string rnn_filename =
+      "modules/prediction/data/rnn_vehicle_model.bin";
+  NetParameter net_parameter = NetParameter();
+  EXPECT_TRUE(common::util::GetProtoFromFile(rnn_filename, &net_parameter));
+  EXPECT_TRUE(RnnModel::instance()->LoadModel(net_parameter));
+
+  // Three obstacles with lane sequences of different lengths, from states
+  // advanced by a first step.
+  const int num_obstacles = 3;
+  const std::vector<int> obstacle_rows = {0, 1, 1, 2, 0};
+  const std::vector<int> num_lane_points = {5, 21, 4, 12, 21};
+  Eigen::MatrixXf obstacle_features = Eigen::MatrixXf::Random(3, 6);
+  std::vector<Eigen::MatrixXf> lane_feature_mats;
+  std::vector<const Eigen::MatrixXf*> lane_features;
+  for (const int num_points : num_lane_points) {
+    lane_feature_mats.push_back(Eigen::MatrixXf::Random(num_points, 4));
+  }
+  for (const auto& lane_feature_mat : lane_feature_mats) {
+    lane_features.push_back(&lane_feature_mat);
+  }
+  std::vector<Eigen::MatrixXf> states;
+  RnnModel::instance()->ResetState();
+  RnnModel::instance()->State(&states);
+  Eigen::MatrixXf hidden_states =
+      Eigen::MatrixXf::Zero(num_obstacles, states[0].cols());
+  Eigen::MatrixXf cell_states =
+      Eigen::MatrixXf::Zero(num_obstacles, states[1].cols());
+  Eigen::MatrixXf outputs;
+  RnnModel::instance()->RunBatch(obstacle_features, lane_features,
+                                 obstacle_rows, &hidden_states, &cell_states,
+                                 &outputs);
+  std::vector<std::vector<Eigen::MatrixXf>> obstacle_states(num_obstacles);
+  for (int i = 0; i < num_obstacles; ++i) {
+    obstacle_states[i] = {hidden_states.row(i), cell_states.row(i)};
+  }
+  RnnModel::instance()->RunBatch(obstacle_features, lane_features,
+                                 obstacle_rows, &hidden_states, &cell_states,
+                                 &outputs);
+  ASSERT_EQ(outputs.rows(), 5);
+  ASSERT_EQ(outputs.cols(), 2);
+
+  Eigen::MatrixXf output;
+  for (std::size_t i = 0; i < lane_features.size(); ++i) {
+    const int row = obstacle_rows[i];
+    RnnModel::instance()->SetState(obstacle_states[row]);
+    RnnModel::instance()->Run({obstacle_features.row(row), *lane_features[i]},
+                              &output);
+    EXPECT_NEAR(output(0, 0), outputs(i, 0), 1e-5);
+    EXPECT_NEAR(output(0, 1), outputs(i, 1), 1e-5);
+    RnnModel::instance()->State(&states);
+    EXPECT_NEAR(states[0](0, 0), hidden_states(row, 0), 1e-5);
+    EXPECT_NEAR(states[1](0, 0), cell_states(row, 0), 1e-5);
+  }
+}
+
+TEST(NetModelTest, concurrent_batch_test) {
+  const std::string rnn_filename =
+      "modules/prediction/data/rnn_vehicle_model.bin";
+  NetParameter net_parameter = NetParameter();
+  EXPECT_TRUE(common::util::GetProtoFromFile(rnn_filename, &net_parameter));
+  EXPECT_TRUE(RnnModel::instance()->LoadModel(net_parameter));
+
+  // Batches of different sizes run by several threads give the outputs of
+  // the same batches run one after the other.
+  const int num_threads = 4;
+  std::vector<Eigen::MatrixXf> obstacle_features(num_threads);
+  std::vector<std::vector<Eigen::MatrixXf>> lane_feature_mats(num_threads);
+  std::vector<std::vector<const Eigen::MatrixXf*>> lane_features(num_threads);
+  std::vector<std::vector<int>> obstacle_rows(num_threads);
+  std::vector<Eigen::MatrixXf> expected_outputs(num_threads);
+  std::vector<Eigen::MatrixXf> expected_states(num_threads);
+  std::vector<Eigen::MatrixXf> states;
+  RnnModel::instance()->State(&states);
+  const int num_units = static_cast<int>(states[0].cols());
+  for (int i = 0; i < num_threads; ++i) {
+    const int num_obstacles = 2 * i + 1;
+    obstacle_features[i] = Eigen::MatrixXf::Random(num_obstacles, 6);
+    for (int row = 0; row < num_obstacles; ++row) {
+      lane_feature_mats[i].push_back(Eigen::MatrixXf::Random(5 + 4 * row, 4));
+      obstacle_rows[i].push_back(row);
+    }
+    for (const auto& lane_feature_mat : lane_feature_mats[i]) {
+      lane_features[i].push_back(&lane_feature_mat);
+    }
+    Eigen::MatrixXf cell_states = Eigen::MatrixXf::Zero(num_obstacles,
+                                                        num_units);
+    expected_states[i] = Eigen::MatrixXf::Zero(num_obstacles, num_units);
+    RnnModel::instance()->RunBatch(obstacle_features[i], lane_features[i],
+                                   obstacle_rows[i], &expected_states[i],
+                                   &cell_states, &expected_outputs[i]);
+  }
+
+  std::vector<Eigen::MatrixXf> outputs(num_threads);
+  std::vector<Eigen::MatrixXf> hidden_states(num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int repeat = 0; repeat < 20; ++repeat) {
+        const int num_obstacles = static_cast<int>(obstacle_features[i].rows());
+        hidden_states[i] = Eigen::MatrixXf::Zero(num_obstacles, num_units);
+        Eigen::MatrixXf cell_states =
+            Eigen::MatrixXf::Zero(num_obstacles, num_units);
+        RnnModel::instance()->RunBatch(obstacle_features[i], lane_features[i],
+                                       obstacle_rows[i], &hidden_states[i],
+                                       &cell_states, &outputs[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    EXPECT_TRUE(outputs[i].isApprox(expected_outputs[i]));
+    EXPECT_TRUE(hidden_states[i].isApprox(expected_states[i]));
+  }
+}
+
 }  // namespace network
 }  // namespace prediction
 }  // namespace apollo
@@ -22,6 +22,7 @@
 #include "modules/common/math/vec2d.h"
 #include "modules/common/time/time.h"
 #include "modules/common/util/file.h"
+#include "modules/map/hdmap/hdmap_util.h"
 #include "modules/prediction/common/feature_output.h"
 #include "modules/prediction/common/prediction_gflags.h"
 #include "modules/prediction/common/prediction_map.h"
@@ -122,6 +123,10 @@ void Prediction::OnLocalization(const LocalizationEstimate& localization) {
 }
 
 void Prediction::OnPlanning(const planning::ADCTrajectory& adc_trajectory) {
+  if (!PredictionMap::Ready()) {
+    AERROR << "Map is not ready for the planning message.";
+    return;
+  }
   ADCTrajectoryContainer* adc_trajectory_container =
       dynamic_cast<ADCTrajectoryContainer*>(
           ContainerManager::instance()->GetContainer(
@@ -142,8 +147,19 @@ void Prediction::RunOnce(const PerceptionObstacles& perception_obstacles) {
 
   // Update relative map if needed
   AdapterManager::Observe();
-  if (FLAGS_use_navigation_mode && !PredictionMap::Ready()) {
-    AERROR << "Relative map is empty.";
+  // Move the tiled base map, if any, along with the ego vehicle.
+  if (!FLAGS_use_navigation_mode &&
+      !AdapterManager::GetLocalization()->Empty()) {
+    const auto& localization =
+        AdapterManager::GetLocalization()->GetLatestObserved();
+    hdmap::HDMapUtil::UpdateBaseMapPosition(localization.pose().position());
+  }
+  // Take one map snapshot for the whole cycle, so that all the map queries of
+  // the cycle see the same map even if the maps are reloaded meanwhile. The
+  // cycle is skipped without a map, since the queries run concurrently.
+  if (!PredictionMap::UpdateMap()) {
+    AERROR << (FLAGS_use_navigation_mode ? "Relative map is empty."
+                                         : "Base map is not available.");
     return;
   }
 
@@ -17,7 +17,11 @@
 #include "modules/prediction/predictor/predictor_manager.h"
 
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "modules/common/util/task_scheduler.h"
 #include "modules/prediction/common/prediction_gflags.h"
 #include "modules/prediction/container/adc_trajectory/adc_trajectory_container.h"
 #include "modules/prediction/container/container_manager.h"
@@ -138,7 +142,7 @@ void PredictorManager::Run(const PerceptionObstacles& perception_obstacles) {
 
   CHECK_NOTNULL(obstacles_container);
 
-  Predictor* predictor = nullptr;
+  std::vector<std::pair<const PerceptionObstacle*, Obstacle*>> obstacles;
   for (const auto& perception_obstacle :
        perception_obstacles.perception_obstacle()) {
     if (!perception_obstacle.has_id()) {
@@ -151,69 +155,124 @@ void PredictorManager::Run(const PerceptionObstacles& perception_obstacles) {
       AERROR << "A perception obstacle has invalid id [" << id << "].";
       continue;
     }
+    obstacles.emplace_back(&perception_obstacle,
+                           obstacles_container->GetObstacle(id));
+  }
 
-    PredictionObstacle prediction_obstacle;
-    prediction_obstacle.set_timestamp(perception_obstacle.timestamp());
-    Obstacle* obstacle = obstacles_container->GetObstacle(id);
-    if (obstacle != nullptr) {
-      if (obstacle->IsStill()) {
-        predictor = GetPredictor(ObstacleConf::EMPTY_PREDICTOR);
-      } else {
-        switch (perception_obstacle.type()) {
-          case PerceptionObstacle::VEHICLE: {
-            if (obstacle->IsOnLane()) {
-              predictor = GetPredictor(vehicle_on_lane_predictor_);
-            } else {
-              predictor = GetPredictor(vehicle_off_lane_predictor_);
-            }
-            break;
-          }
-          case PerceptionObstacle::PEDESTRIAN: {
-            predictor = GetPredictor(pedestrian_predictor_);
-            break;
-          }
-          case PerceptionObstacle::BICYCLE: {
-            if (obstacle->IsOnLane() && !obstacle->IsNearJunction()) {
-              predictor = GetPredictor(cyclist_on_lane_predictor_);
-            } else {
-              predictor = GetPredictor(cyclist_off_lane_predictor_);
-            }
-            break;
-          }
-          default: {
-            if (obstacle->IsOnLane()) {
-              predictor = GetPredictor(default_on_lane_predictor_);
-            } else {
-              predictor = GetPredictor(default_off_lane_predictor_);
-            }
-            break;
-          }
-        }
+  if (FLAGS_enable_multi_thread_in_prediction) {
+    RunConcurrently(obstacles, adc_trajectory_container);
+  } else {
+    for (const auto& obstacle : obstacles) {
+      Predictor* predictor = nullptr;
+      if (obstacle.second != nullptr) {
+        predictor = GetPredictor(
+            GetPredictorType(obstacle.first->type(), obstacle.second));
       }
+      PredictObstacle(*obstacle.first, obstacle.second, predictor,
+                      adc_trajectory_container,
+                      prediction_obstacles_.add_prediction_obstacle());
+    }
+  }
+  prediction_obstacles_.set_perception_error_code(
+      perception_obstacles.error_code());
+}
 
-      if (predictor != nullptr) {
-        predictor->Predict(obstacle);
-        if (FLAGS_enable_trim_prediction_trajectory &&
-            obstacle->type() == PerceptionObstacle::VEHICLE) {
-          CHECK_NOTNULL(adc_trajectory_container);
-          predictor->TrimTrajectories(obstacle, adc_trajectory_container);
-        }
-        for (const auto& trajectory : predictor->trajectories()) {
-          prediction_obstacle.add_trajectory()->CopyFrom(trajectory);
-        }
+void PredictorManager::RunConcurrently(
+    const std::vector<std::pair<const PerceptionObstacle*, Obstacle*>>&
+        obstacles,
+    const ADCTrajectoryContainer* adc_trajectory_container) {
+  // The predictors keep the trajectories of the obstacle they predict, so
+  // each obstacle is predicted by predictors of its own. A repeated obstacle
+  // is predicted in order by a single task.
+  std::vector<std::vector<std::size_t>> tasks;
+  std::unordered_map<const Obstacle*, std::size_t> task_indices;
+  for (std::size_t i = 0; i < obstacles.size(); ++i) {
+    if (obstacles[i].second == nullptr) {
+      tasks.emplace_back(1, i);
+      continue;
+    }
+    const auto it = task_indices.emplace(obstacles[i].second, tasks.size());
+    if (it.second) {
+      tasks.emplace_back();
+    }
+    tasks[it.first->second].push_back(i);
+  }
+
+  std::vector<PredictionObstacle> prediction_obstacles(obstacles.size());
+  common::util::ParallelFor(0, tasks.size(), 1, [&](const std::size_t i) {
+    for (const std::size_t index : tasks[i]) {
+      const PerceptionObstacle& perception_obstacle = *obstacles[index].first;
+      Obstacle* obstacle = obstacles[index].second;
+      std::unique_ptr<Predictor> predictor;
+      if (obstacle != nullptr) {
+        predictor = CreatePredictor(
+            GetPredictorType(perception_obstacle.type(), obstacle));
       }
-      prediction_obstacle.set_timestamp(obstacle->timestamp());
+      PredictObstacle(perception_obstacle, obstacle, predictor.get(),
+                      adc_trajectory_container, &prediction_obstacles[index]);
     }
+  });
+
+  for (auto& prediction_obstacle : prediction_obstacles) {
+    prediction_obstacles_.add_prediction_obstacle()->Swap(
+        &prediction_obstacle);
+  }
+}
 
-    prediction_obstacle.set_predicted_period(FLAGS_prediction_duration);
-    prediction_obstacle.mutable_perception_obstacle()->CopyFrom(
-        perception_obstacle);
+ObstacleConf::PredictorType PredictorManager::GetPredictorType(
+    const PerceptionObstacle::Type& type, Obstacle* obstacle) const {
+  if (obstacle->IsStill()) {
+    return ObstacleConf::EMPTY_PREDICTOR;
+  }
+  switch (type) {
+    case PerceptionObstacle::VEHICLE: {
+      if (obstacle->IsOnLane()) {
+        return vehicle_on_lane_predictor_;
+      }
+      return vehicle_off_lane_predictor_;
+    }
+    case PerceptionObstacle::PEDESTRIAN: {
+      return pedestrian_predictor_;
+    }
+    case PerceptionObstacle::BICYCLE: {
+      if (obstacle->IsOnLane() && !obstacle->IsNearJunction()) {
+        return cyclist_on_lane_predictor_;
+      }
+      return cyclist_off_lane_predictor_;
+    }
+    default: {
+      if (obstacle->IsOnLane()) {
+        return default_on_lane_predictor_;
+      }
+      return default_off_lane_predictor_;
+    }
+  }
+}
 
-    prediction_obstacles_.add_prediction_obstacle()->CopyFrom(
-        prediction_obstacle);
+void PredictorManager::PredictObstacle(
+    const PerceptionObstacle& perception_obstacle, Obstacle* obstacle,
+    Predictor* predictor,
+    const ADCTrajectoryContainer* adc_trajectory_container,
+    PredictionObstacle* const prediction_obstacle) {
+  prediction_obstacle->set_timestamp(perception_obstacle.timestamp());
+  if (obstacle != nullptr) {
+    if (predictor != nullptr) {
+      predictor->Predict(obstacle);
+      if (FLAGS_enable_trim_prediction_trajectory &&
+          obstacle->type() == PerceptionObstacle::VEHICLE) {
+        CHECK_NOTNULL(adc_trajectory_container);
+        predictor->TrimTrajectories(obstacle, adc_trajectory_container);
+      }
+      for (const auto& trajectory : predictor->trajectories()) {
+        prediction_obstacle->add_trajectory()->CopyFrom(trajectory);
+      }
+    }
+    prediction_obstacle->set_timestamp(obstacle->timestamp());
   }
-  prediction_obstacles_.set_perception_error_code(
-      perception_obstacles.error_code());
+
+  prediction_obstacle->set_predicted_period(FLAGS_prediction_duration);
+  prediction_obstacle->mutable_perception_obstacle()->CopyFrom(
+      perception_obstacle);
 }
 
 std::unique_ptr<Predictor> PredictorManager::CreatePredictor(
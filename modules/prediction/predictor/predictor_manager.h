@@ -24,6 +24,8 @@
 
 #include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "modules/perception/proto/perception_obstacle.pb.h"
 #include "modules/prediction/proto/prediction_conf.pb.h"
@@ -71,6 +73,40 @@ class PredictorManager {
   const PredictionObstacles& prediction_obstacles();
 
  private:
+  /**
+   * @brief Predict the obstacles concurrently
+   * @param Perception obstacles with their obstacles in the container
+   *        ADC trajectory container
+   */
+  void RunConcurrently(
+      const std::vector<std::pair<const perception::PerceptionObstacle*,
+                                  Obstacle*>>& obstacles,
+      const ADCTrajectoryContainer* adc_trajectory_container);
+
+  /**
+   * @brief Get the predictor type of an obstacle
+   * @param Perception obstacle type
+   *        Obstacle
+   * @return Predictor type
+   */
+  ObstacleConf::PredictorType GetPredictorType(
+      const perception::PerceptionObstacle::Type& type,
+      Obstacle* obstacle) const;
+
+  /**
+   * @brief Predict an obstacle
+   * @param Perception obstacle
+   *        Obstacle, nullptr if it is not in the container
+   *        Predictor, nullptr if the obstacle is not predicted
+   *        ADC trajectory container
+   *        Prediction obstacle to set
+   */
+  void PredictObstacle(
+      const perception::PerceptionObstacle& perception_obstacle,
+      Obstacle* obstacle, Predictor* predictor,
+      const ADCTrajectoryContainer* adc_trajectory_container,
+      PredictionObstacle* const prediction_obstacle);
+
   /**
    * @brief Register a predictor by type
    * @param Predictor type
@@ -79,5 +79,39 @@ TEST_F(PredictorManagerTest, General) {
   EXPECT_EQ(prediction_obstacles.prediction_obstacle_size(), 1);
 }
 
+TEST_F(PredictorManagerTest, Concurrent) {
+  FLAGS_enable_trim_prediction_trajectory = false;
+  std::string conf_file = "modules/prediction/testdata/adapter_conf.pb.txt";
+  EXPECT_TRUE(common::util::GetProtoFromFile(conf_file, &adapter_conf_));
+
+  ContainerManager::instance()->Init(adapter_conf_);
+  EvaluatorManager::instance()->Init(prediction_conf_);
+  PredictorManager::instance()->Init(prediction_conf_);
+
+  std::string file =
+      "modules/prediction/testdata/perception_vehicles_pedestrians.pb.txt";
+  apollo::perception::PerceptionObstacles perception_obstacles;
+  CHECK(common::util::GetProtoFromFile(file, &perception_obstacles));
+  ObstaclesContainer* obstacles_container = dynamic_cast<ObstaclesContainer*>(
+      ContainerManager::instance()->GetContainer(
+          AdapterConfig::PERCEPTION_OBSTACLES));
+  CHECK_NOTNULL(obstacles_container);
+  obstacles_container->Insert(perception_obstacles);
+  EvaluatorManager::instance()->Run(perception_obstacles);
+
+  PredictorManager::instance()->Run(perception_obstacles);
+  const PredictionObstacles expected_prediction_obstacles =
+      PredictorManager::instance()->prediction_obstacles();
+  FLAGS_enable_multi_thread_in_prediction = true;
+  PredictorManager::instance()->Run(perception_obstacles);
+  FLAGS_enable_multi_thread_in_prediction = false;
+
+  const PredictionObstacles& prediction_obstacles =
+      PredictorManager::instance()->prediction_obstacles();
+  EXPECT_EQ(6, prediction_obstacles.prediction_obstacle_size());
+  EXPECT_EQ(expected_prediction_obstacles.DebugString(),
+            prediction_obstacles.DebugString());
+}
+
 }  // namespace prediction
 }  // namespace apollo
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Prints the features of files dumped in prediction offline mode,
+ *        e.g. feature_dump data/prediction/feature.*.bin
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_set>
+
+#include "gflags/gflags.h"
+
+#include "modules/common/log.h"
+#include "modules/prediction/common/feature_record_reader.h"
+#include "modules/prediction/proto/feature.pb.h"
+
+DEFINE_bool(print_features, false, "Print the features in text format");
+DEFINE_int32(obstacle_id, -1,
+             "Only print the features of the obstacle, or all if negative");
+
+using apollo::prediction::Feature;
+using apollo::prediction::FeatureRecordReader;
+
+namespace {
+
+bool DumpFile(const std::string& file_name) {
+  FeatureRecordReader reader(file_name);
+  Feature feature;
+  int num_features = 0;
+  std::unordered_set<int> obstacle_ids;
+  double min_timestamp = std::numeric_limits<double>::max();
+  double max_timestamp = std::numeric_limits<double>::lowest();
+  while (reader.Next(&feature)) {
+    ++num_features;
+    obstacle_ids.insert(feature.id());
+    min_timestamp = std::min(min_timestamp, feature.timestamp());
+    max_timestamp = std::max(max_timestamp, feature.timestamp());
+    if (FLAGS_print_features &&
+        (FLAGS_obstacle_id < 0 || FLAGS_obstacle_id == feature.id())) {
+      std::cout << feature.DebugString() << std::endl;
+    }
+  }
+
+  std::cout << file_name << ": " << num_features << " features of "
+            << obstacle_ids.size() << " obstacles";
+  if (num_features > 0) {
+    std::cout.precision(16);
+    std::cout << " from " << min_timestamp << " to " << max_timestamp;
+  }
+  std::cout << std::endl;
+  return reader.ok();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (argc < 2) {
+    AERROR << "Usage: " << argv[0] << " [--print_features] [--obstacle_id=N] "
+           << "<feature files>";
+    return 1;
+  }
+  bool ok = true;
+  for (int i = 1; i < argc; ++i) {
+    ok = DumpFile(argv[i]) && ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -42,7 +42,7 @@ apollo::common::Status Routing::Init() {
 
   AINFO << "Conf file: " << FLAGS_routing_conf_file << " is loaded.";
 
-  hdmap_ = apollo::hdmap::HDMapUtil::BaseMapPtr();
+  hdmap_ = apollo::hdmap::HDMapUtil::BaseMapSnapshot();
   CHECK(hdmap_) << "Failed to load map file:" << apollo::hdmap::BaseMapFile();
 
   AdapterManager::Init(FLAGS_routing_adapter_config_filename);
@@ -142,7 +142,7 @@ double Distance(const Point& point1, const Point& point2) {
 }
 
 double GetNearestLaneHeading(const PointENU& point_enu) {
-  auto* hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
   if (hdmap == nullptr) {
     AERROR << "Failed to get nearest lane for point "
            << point_enu.DebugString();
@@ -167,7 +167,7 @@ double GetNearestLaneHeading(const PointENU& point_enu) {
 }
 
 double GetNearestLaneHeading(const Point& point) {
-  auto* hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
   if (hdmap == nullptr) {
     AERROR << "Failed to get nearest lane for point " << point.DebugString();
     return -1.0;
@@ -182,7 +182,7 @@ double GetNearestLaneHeading(const Point& point) {
 }
 
 double GetNearestLaneHeading(const double x, const double y, const double z) {
-  auto* hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
   if (hdmap == nullptr) {
     AERROR << "Failed to get nearest lane for point (" << x << ", " << y << ", "
            << z << ")";
@@ -198,7 +198,7 @@ double GetNearestLaneHeading(const double x, const double y, const double z) {
 }
 
 double GetLateralDistanceToNearestLane(const Point& point) {
-  auto* hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
   if (hdmap == nullptr) {
     AERROR << "Failed to get nearest lane for point " << point.DebugString();
     return -1.0;
@@ -77,7 +77,7 @@ bool GetAllTrafficLights(std::vector<SignalInfoConstPtr> *traffic_lights) {
       return false;
     }
     for (const auto &signal : map_proto.signal()) {
-      const auto *hdmap = HDMapUtil::BaseMapPtr();
+      const auto hdmap = HDMapUtil::BaseMapSnapshot();
       map_traffic_lights.push_back(hdmap->GetSignalById(signal.id()));
     }
   }
@@ -93,7 +93,7 @@ bool GetTrafficLightsWithinDistance(
     AERROR << "No localization received";
     return false;
   }
-  const auto *hdmap = HDMapUtil::BaseMapPtr();
+  const auto hdmap = HDMapUtil::BaseMapSnapshot();
   auto position =
       AdapterManager::GetLocalization()->GetLatestObserved().pose().position();
   int ret = hdmap->GetForwardNearestSignalsOnLane(
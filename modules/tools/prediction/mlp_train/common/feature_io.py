@@ -18,13 +18,13 @@
 
 import sys
 import copy
+import gzip
 import logging
 
 from google.protobuf.internal import decoder
 from google.protobuf.internal import encoder
 import google.protobuf.text_format as text_format
 from modules.prediction.proto import feature_pb2
-from modules.prediction.proto import offline_features_pb2
 
 
 def readVarint32(stream):
@@ -43,35 +43,37 @@ def readVarint32(stream):
     return raw_varint32
 
 
-def load_protobuf(filename):
+def load_features(stream):
     """
-    read a file in protobuf binary
+    read features each following its varint32 size from a stream
     """
     features = []
-    offline_features = offline_features_pb2.Features()
-    with open(filename, 'rb') as file_in:
-        offline_features.ParseFromString(file_in.read())
-    for i in range(len(offline_features.feature)):
-        features.append(offline_features.feature[i])
-
+    size = readVarint32(stream)
+    while size:
+        read_bytes, _ = decoder._DecodeVarint32(size, 0)
+        data = stream.read(read_bytes)
+        if len(data) < read_bytes:
+            print "Fail to load protobuf"
+            break
+        fea = feature_pb2.Feature()
+        fea.ParseFromString(data)
+        features.append(fea)
+        size = readVarint32(stream)
     return features
 
 
+def load_protobuf(filename):
+    """
+    read a feature file dumped by prediction, which is a gzip stream of
+    features each following its varint32 size
+    """
+    with gzip.open(filename, 'rb') as file_in:
+        return load_features(file_in)
+
+
 def load_label_feature(filename):
-    features = []
     with open(filename, 'rb') as f:
-        size = readVarint32(f)
-        while size:
-            read_bytes, _ = decoder._DecodeVarint32(size, 0)
-            data = f.read(read_bytes)
-            if len(data) < read_bytes:
-                print "Fail to load protobuf"
-                break
-            fea = feature_pb2.Feature()
-            fea.ParseFromString(data)
-            features.append(fea)
-            size = readVarint32(f)
-    return features
+        return load_features(f)
 
 
 def save_protobuf(filename, feature_trajectories):